@@ -20,20 +20,27 @@
 #import "ScanditSDKBarcodePicker.h"
 #import "ScanditSDKOverlayController.h"
 
-@interface ScanditSDK : CDVPlugin <ScanditSDKOverlayControllerDelegate> {
-    NSString *callbackId;
+@interface ScanditSDK : CDVPlugin <ScanditSDKOverlayControllerDelegate, ScanditSDKNextFrameDelegate,
+                                   UIGestureRecognizerDelegate> {
     BOOL wasStatusBarHidden;
 	
 	BOOL startAnimationDone;
 	NSDictionary *bufferedResult;
 	
 	ScanditSDKBarcodePicker *scanditSDKBarcodePicker;
+	
+	BOOL parkedInBackground;
+	NSDate *resumedAt;
+	NSUInteger resumeCount;
+	NSTimeInterval lastResumeToDecode;
 }
 
+// Callback of the current scan or show session, nil while no page is attached to it.
 @property (nonatomic, copy) NSString *callbackId;
 @property (readwrite, assign) BOOL hasPendingOperation;
 @property (nonatomic, retain) NSDictionary *bufferedResult;
 @property (nonatomic, retain) ScanditSDKBarcodePicker *scanditSDKBarcodePicker;
+@property (nonatomic, assign) BOOL embedded;
 
 /**
  * Starts the scanning. You call this the following way from java script (success and failure are
@@ -156,6 +163,21 @@
  * torch: true
  * Enables or disables the torch toggle button for all devices that support a torch.
  *
+ * autoTorch: false
+ * Switches the torch on by itself when sampled frames are dark (below autoTorchDarkLevel, mean
+ * luminance 0-255, default 60), or dim (below autoTorchDimLevel, default 110) and nothing was
+ * decoded for autoTorchNoDecodeSeconds (default 4), and off again once nothing was decoded for
+ * autoTorchHoldSeconds (default 10), after which it stays off for at least that long. Frames are
+ * sampled twice a second. May override the torch button.
+ *
+ * dutyCycle: false
+ * Saves battery when the picker stays up for a long time. Once nothing was decoded for
+ * dutyCycleIdleSeconds (default 20) the picker only probes: it scans for dutyCycleProbeOnSeconds
+ * (default 1.5) at the start of every dutyCycleProbePeriodSeconds (default 6) and stops the
+ * camera in between. A decode, a touch on the picker (or on the page around an embedded one) or
+ * a change of the mean luminance by dutyCyclePresenceDelta (0-255, default 12) while probing
+ * returns to full rate at once.
+ *
  * torchButtonPositionAndSize: "0.05/0.01/67/33" (x/y/width/height)
  * Sets the position at which the button to enable the torch is drawn. The X and Y coordinates are
  * relative to the screen size, which means they have to be between 0 and 1.
@@ -197,8 +219,170 @@
  *
  * maxSearchBarBarcodeLength: 100
  * Sets the maximum size a barcode in the manual entry field can have to possibly be valid.
+ *
+ * reattachTimeout: 10
+ * Seconds the picker keeps running after the web view reloads, waiting for the new page to
+ * attach. Results scanned in between are queued for it. 0 takes the picker down right away.
  */
 - (void)scan:(CDVInvokedUrlCommand *)command;
 
+/**
+ * Shows the picker embedded in a rectangle above the web view instead of presenting it
+ * modally. The web view stays visible and interactive, no status bar changes or view
+ * controller transitions are involved and scanning starts right away:
+ *
+ * cordova.exec(success, failure, "ScanditSDK", "show", ["___your_app_key___",
+ *              {"option1":"value1", "option2":true}, "0/0/320/240"]);
+ *
+ * The options are the same as for scan. The third argument is the frame of the picker as
+ * "x/y/width/height" in points relative to the Cordova view. The success callback is kept
+ * alive and called for every scanned or manually entered code until hide is called; the
+ * picker keeps scanning in between.
+ */
+- (void)show:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Moves or resizes the embedded picker. The only argument is the new frame as
+ * "x/y/width/height".
+ */
+- (void)resize:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Starts or stops scanning of the embedded picker without removing it. Both report whether an
+ * embedded picker is currently shown.
+ */
+- (void)start:(CDVInvokedUrlCommand *)command;
+- (void)stop:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Removes the embedded picker and releases the callback of the show call.
+ */
+- (void)hide:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Returns a dictionary with statistics about the current plugin instance:
+ *
+ * resumeCount: how often a parked picker was resumed after the app returned to the foreground.
+ * reattachCount: how often a page attached to a session that outlived the previous page.
+ * torchOn, torchOnMs, torchSwitches: state of the auto torch, how long it was on and how often
+ * it was switched on for the current picker; only present with the autoTorch option.
+ * dutyState, dutyActiveMs, dutyProbeMs, dutyProbeScanningMs, dutyProbes, dutyWakes: state of the
+ * duty cycle ("active", "probing" or "paused"), time spent at full rate and probing (of which
+ * with the camera running) for the current picker, how often it started probing, and what woke it
+ * ({decode, presence, touch}); only present with the dutyCycle option.
+ * lastResumeToDecodeMs: time from the last resume to the first decode after it, -1 if there was
+ * none yet.
+ */
+- (void)stats:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Samples frames of the running picker every intervalMs milliseconds (default 1000, at least 100)
+ * and calls the kept success callback with image quality metrics for each sample:
+ *
+ * cordova.exec(success, failure, "ScanditSDK", "metrics", [1000]);
+ *
+ * {luminance: 0..255, sharpness: Laplacian variance (low means blurred), glare: share of
+ *  saturated pixels, rolling: the same three averaged over the last 16 samples, frames,
+ *  decodes, lastTimeToDecodeMs, meanTimeToDecodeMs, analysisMs}, plus the auto torch keys of
+ * stats when the autoTorch option is on and its duty cycle keys with the dutyCycle option.
+ *
+ * Frames are analyzed off the main thread. An interval of 0 stops sampling and releases the
+ * callback.
+ */
+- (void)metrics:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Takes over the scan or show session of a previous page after a reload. Results scanned while
+ * no page was attached are delivered right away, then the callback keeps receiving results like
+ * the callback of the original call. Fails with "No session" if nothing is running. Calling scan,
+ * or show for an embedded picker, while a detached session exists attaches as well.
+ */
+- (void)attach:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Returns the current session as {sessionId, mode, attached, pending, dropped, detachedMs, frame},
+ * or {mode: "none"}. mode is "modal", "embedded" or "finished" (only queued results are left).
+ */
+- (void)session:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Validates the check digits of many codes at once without the picker, e.g. for an imported
+ * manifest:
+ *
+ * cordova.exec(success, failure, "ScanditSDK", "validate", [codes, "ean13"]);
+ *
+ * codes is an array of strings or a single string with one code per line. The second argument
+ * is one of "ean13", "upc12", "ean8", "upce", "itf", "code39" (mod 43), the MSI Plessey checks
+ * "mod10", "mod11", "mod1010", "mod1110", or "auto" (the default). The success callback receives
+ * a string with one character per code: "1" or "0" for a named check, and for "auto" the inferred
+ * ScanResult.Symbology value in base 36, "0" meaning none. Runs on a background thread.
+ */
+- (void)validate:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Returns the schema name of the symbology a code most likely belongs to, as inferred for codes
+ * typed into the search bar ("ean13", ..., "unknown"). Cheap enough to be called synchronously:
+ *
+ * cordova.require("cordova/exec").sync(success, failure, "ScanditSDK", "symbology", [code]);
+ *
+ * Fails with "Expected a code" if code is not a string. Listed in nonBlockingActions.
+ */
+- (void)symbology:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Loads the expected items of a receiving manifest (e.g. an ASN). Every scanned or entered code is
+ * then counted against it:
+ *
+ * cordova.exec(success, failure, "ScanditSDK", "loadManifest", [rows]);
+ *
+ * rows is either a string with one "code,expected" row per line (tab works as well; the count
+ * defaults to 1) or an array of codes or [code, expected] pairs. Repeated codes add up. Replaces
+ * the previous manifest and its counts; success receives the totals as returned by manifestDiff.
+ * A count that is not a positive integer fails with "Expected a positive count ..." and keeps
+ * the previous manifest.
+ */
+- (void)loadManifest:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Registers a callback that is called for every counted code with the changed line only:
+ * [line, code, expected, received, status], the same order as the lines of manifestDiff. status
+ * is "short", "complete", "over" or "unexpected"; codes that are not on the manifest get a line
+ * of their own with 0 expected.
+ */
+- (void)reconcile:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Returns {totals: {lines, expected, received, short, complete, over, unexpected}, lines: [...]}
+ * with a [line, code, expected, received, status] entry for every line that is not complete, or
+ * for all lines if the first argument is true.
+ *
+ * With {cursor: true} as the second argument success receives (totals, cursor) instead, and the
+ * lines are read page by page with cursor.next(pageSize, success). Reading ends early when the
+ * manifest is replaced or cleared.
+ */
+- (void)manifestDiff:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Drops the manifest; codes are no longer counted.
+ */
+- (void)clearManifest:(CDVInvokedUrlCommand *)command;
+
+/**
+ * Serves images of codes to the page, e.g. for cross-dock displays and label reprints:
+ *
+ * <img src="/!gap_res/barcode/EAN13.png?d=4006381333931&scale=3">
+ *
+ * The file name is the schema name of the symbology: EAN13, UPC12, EAN8, UPCE, CODE39, CODE128,
+ * ITF, QR, DATAMATRIX or PDF417. d is the code (URL encoded UTF-8). Optional parameters are scale
+ * (pixels per module, default 2), height (bar height of linear codes in modules, default half the
+ * width), quiet (quiet zone in modules, default what the symbology needs), ec (QR error
+ * correction L, M, Q or H, default M; PDF417 level 0 to 8, default by length) and check (1 to add
+ * the Code 39 mod 43 check character). Codes that cannot be encoded and images over 4096 pixels
+ * give a 404. Recently rendered images are cached.
+ *
+ * Called from pluginInitialize; the plugin is loaded at startup (onload) for this.
+ */
++ (void)registerBarcodeRenderer;
+
 
 @end
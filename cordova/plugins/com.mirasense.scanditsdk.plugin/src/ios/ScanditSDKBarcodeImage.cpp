@@ -0,0 +1,197 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKBarcodeImage.hpp"
+
+#include <string.h>
+#include <zlib.h>
+
+namespace scanditsdk {
+namespace image {
+
+namespace {
+
+struct Layout {
+    unsigned quietZone;
+    unsigned moduleRows; // rows of the symbol, stretched to barHeight for linear ones
+    unsigned rowHeight;  // pixel rows per symbol row
+    unsigned width;
+    unsigned height;
+};
+
+bool layout(const encoder::Symbol &symbol, const RenderOptions &options, Layout *out) {
+    unsigned scale = options.scale > 0 ? options.scale : 1;
+    out->quietZone = options.quietZone >= 0 ? (unsigned)options.quietZone : symbol.quietZone;
+    if (symbol.width == 0 || symbol.height == 0 || scale > kMaxSide || out->quietZone > kMaxSide) {
+        return false;
+    }
+    unsigned modulesWide = symbol.width + 2 * out->quietZone;
+    unsigned modulesHigh;
+    if (symbol.isLinear()) {
+        unsigned barHeight = options.barHeight > 0 ? options.barHeight : (symbol.width + 1) / 2;
+        if (barHeight > kMaxSide) {
+            return false;
+        }
+        out->moduleRows = 1;
+        out->rowHeight = barHeight * scale;
+        modulesHigh = barHeight + 2 * out->quietZone;
+    } else {
+        out->moduleRows = symbol.height;
+        out->rowHeight = scale;
+        modulesHigh = symbol.height + 2 * out->quietZone;
+    }
+    if (modulesWide > kMaxSide / scale || modulesHigh > kMaxSide / scale) {
+        return false;
+    }
+    out->width = modulesWide * scale;
+    out->height = modulesHigh * scale;
+    return true;
+}
+
+void put32(std::vector<uint8_t> &out, uint32_t value) {
+    out.push_back((uint8_t)(value >> 24));
+    out.push_back((uint8_t)(value >> 16));
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+void putChunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, size_t length) {
+    put32(out, (uint32_t)length);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    if (length > 0) {
+        out.insert(out.end(), data, data + length);
+    }
+    put32(out, (uint32_t)crc32(crc32(0, Z_NULL, 0), &out[start], (uInt)(out.size() - start)));
+}
+
+} // namespace
+
+bool imageSize(const encoder::Symbol &symbol, const RenderOptions &options, unsigned *width, unsigned *height) {
+    Layout l;
+    if (!layout(symbol, options, &l)) {
+        return false;
+    }
+    *width = l.width;
+    *height = l.height;
+    return true;
+}
+
+bool renderPNG(const encoder::Symbol &symbol, const RenderOptions &options, std::vector<uint8_t> *png) {
+    Layout l;
+    if (!layout(symbol, options, &l)) {
+        return false;
+    }
+    unsigned scale = options.scale > 0 ? options.scale : 1;
+
+    // Each scanline is a filter byte (0, none) and the pixels at one bit each, 1 for white.
+    size_t stride = 1 + (l.width + 7) / 8;
+    std::vector<uint8_t> raw(stride * l.height);
+    std::vector<uint8_t> light(stride, 0xFF);
+    light[0] = 0;
+    size_t margin = (size_t)l.quietZone * scale;
+    for (size_t y = 0; y < margin; ++y) {
+        memcpy(&raw[y * stride], &light[0], stride);
+        memcpy(&raw[(l.height - 1 - y) * stride], &light[0], stride);
+    }
+    size_t y = margin;
+    for (unsigned row = 0; row < l.moduleRows; ++row) {
+        uint8_t *line = &raw[y * stride];
+        memcpy(line, &light[0], stride);
+        for (unsigned x = 0; x < symbol.width; ++x) {
+            if (!symbol.dark(x, row)) {
+                continue;
+            }
+            size_t px = margin + (size_t)x * scale;
+            for (unsigned k = 0; k < scale; ++k, ++px) {
+                line[1 + px / 8] &= (uint8_t)~(0x80 >> (px % 8));
+            }
+        }
+        for (unsigned k = 1; k < l.rowHeight; ++k) {
+            memcpy(&raw[(y + k) * stride], line, stride);
+        }
+        y += l.rowHeight;
+    }
+
+    uLongf compressedLength = compressBound((uLong)raw.size());
+    std::vector<uint8_t> compressed(compressedLength);
+    if (compress2(&compressed[0], &compressedLength, &raw[0], (uLong)raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return false;
+    }
+
+    static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> header;
+    put32(header, l.width);
+    put32(header, l.height);
+    header.push_back(1); // bit depth
+    header.push_back(0); // grayscale
+    header.push_back(0); // deflate
+    header.push_back(0); // adaptive filtering
+    header.push_back(0); // not interlaced
+
+    png->clear();
+    png->reserve(8 + 25 + 12 + compressedLength + 12);
+    png->insert(png->end(), kSignature, kSignature + 8);
+    putChunk(*png, "IHDR", &header[0], header.size());
+    putChunk(*png, "IDAT", &compressed[0], compressedLength);
+    putChunk(*png, "IEND", NULL, 0);
+    return true;
+}
+
+Cache::Cache(size_t maxBytes, size_t maxEntries) : maxBytes_(maxBytes), maxEntries_(maxEntries), bytes_(0),
+        hits_(0), misses_(0) {}
+
+bool Cache::get(const std::string &key, std::vector<uint8_t> *data) {
+    std::map<std::string, Entries::iterator>::iterator found = index_.find(key);
+    if (found == index_.end()) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    *data = found->second->second;
+    return true;
+}
+
+void Cache::put(const std::string &key, const std::vector<uint8_t> &data) {
+    std::map<std::string, Entries::iterator>::iterator found = index_.find(key);
+    if (found != index_.end()) {
+        erase(found->second);
+    }
+    if (data.size() > maxBytes_ || maxEntries_ == 0) {
+        return;
+    }
+    while (!entries_.empty() && (entries_.size() >= maxEntries_ || bytes_ + data.size() > maxBytes_)) {
+        erase(--entries_.end());
+    }
+    entries_.push_front(std::make_pair(key, data));
+    index_[key] = entries_.begin();
+    bytes_ += data.size();
+}
+
+void Cache::clear() {
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+void Cache::erase(Entries::iterator entry) {
+    bytes_ -= entry->second.size();
+    index_.erase(entry->first);
+    entries_.erase(entry);
+}
+
+} // namespace image
+} // namespace scanditsdk
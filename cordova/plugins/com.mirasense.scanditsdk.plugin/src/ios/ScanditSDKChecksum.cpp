@@ -0,0 +1,330 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKChecksum.hpp"
+
+#include <string.h>
+
+namespace scanditsdk {
+namespace checksum {
+
+namespace {
+
+const uint8_t kInvalid = 0xFF;
+
+// Digit value of every byte, kInvalid for non-digits.
+struct DigitTable {
+    uint8_t value[256];
+    DigitTable() {
+        memset(value, kInvalid, sizeof(value));
+        for (int c = '0'; c <= '9'; ++c) {
+            value[c] = (uint8_t)(c - '0');
+        }
+    }
+};
+
+// Code 39 character values for the mod 43 check, kInvalid outside the character set.
+struct Code39Table {
+    uint8_t value[256];
+    Code39Table() {
+        static const char kAlphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%";
+        memset(value, kInvalid, sizeof(value));
+        for (int i = 0; i < 43; ++i) {
+            value[(uint8_t)kAlphabet[i]] = (uint8_t)i;
+        }
+    }
+};
+
+const DigitTable kDigits;
+const Code39Table kCode39;
+
+// Digit sum of twice the digit, for Luhn.
+const uint8_t kLuhnDoubled[10] = { 0, 2, 4, 6, 8, 1, 3, 5, 7, 9 };
+
+bool allDigits(const char *code, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (kDigits.value[(uint8_t)code[i]] == kInvalid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Weighted GS1 sum; the rightmost digit (the check digit) has weight 1.
+unsigned gs1Sum(const char *code, size_t length) {
+    unsigned sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned digit = kDigits.value[(uint8_t)code[length - 1 - i]];
+        sum += (i & 1) ? digit * 3 : digit;
+    }
+    return sum;
+}
+
+// Luhn sum over data plus check digit; the check digit is not doubled.
+unsigned luhnSum(const char *code, size_t length) {
+    unsigned sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned digit = kDigits.value[(uint8_t)code[length - 1 - i]];
+        sum += (i & 1) ? kLuhnDoubled[digit] : digit;
+    }
+    return sum;
+}
+
+bool msiMod11CheckDigit(const char *data, size_t length, unsigned *checkDigit) {
+    unsigned sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        sum += kDigits.value[(uint8_t)data[length - 1 - i]] * (unsigned)(2 + i % 6);
+    }
+    unsigned check = (11 - sum % 11) % 11;
+    // A remainder that needs the two-digit check "10" cannot be encoded in one digit.
+    if (check == 10) {
+        return false;
+    }
+    *checkDigit = check;
+    return true;
+}
+
+size_t fixedLengthForCheck(Check check) {
+    switch (check) {
+        case CheckEAN13: return 13;
+        case CheckUPC12: return 12;
+        case CheckEAN8: return 8;
+        default: return 0;
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SCANDITSDK_HAVE_VECTORS 1
+
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+
+inline u8x16 splat(uint8_t value) {
+    u8x16 v = { value, value, value, value, value, value, value, value,
+                value, value, value, value, value, value, value, value };
+    return v;
+}
+
+// Sum of the 8 bytes of x; every byte must be below 32 so the 16-bit lanes cannot overflow.
+inline unsigned horizontalSum(uint64_t x) {
+    x = (x & 0x00FF00FF00FF00FFULL) + ((x >> 8) & 0x00FF00FF00FF00FFULL);
+    return (unsigned)((x * 0x0001000100010001ULL) >> 48);
+}
+#endif
+
+} // namespace
+
+bool gs1Mod10Valid(const char *code, size_t length) {
+    return length >= 2 && allDigits(code, length) && gs1Sum(code, length) % 10 == 0;
+}
+
+char gs1Mod10CheckDigit(const char *data, size_t length) {
+    if (!allDigits(data, length)) {
+        return 0;
+    }
+    // Weights 3,1,... from the rightmost data digit, as the check digit will take weight 1.
+    unsigned sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned digit = kDigits.value[(uint8_t)data[length - 1 - i]];
+        sum += (i & 1) ? digit : digit * 3;
+    }
+    return (char)('0' + (10 - sum % 10) % 10);
+}
+
+bool msiMod10Valid(const char *code, size_t length) {
+    return length >= 2 && allDigits(code, length) && luhnSum(code, length) % 10 == 0;
+}
+
+bool msiMod11Valid(const char *code, size_t length) {
+    unsigned check;
+    return length >= 2 && allDigits(code, length) &&
+           msiMod11CheckDigit(code, length - 1, &check) &&
+           kDigits.value[(uint8_t)code[length - 1]] == check;
+}
+
+bool code39Mod43Valid(const char *code, size_t length) {
+    if (length < 2) {
+        return false;
+    }
+    unsigned sum = 0;
+    for (size_t i = 0; i + 1 < length; ++i) {
+        uint8_t value = kCode39.value[(uint8_t)code[i]];
+        if (value == kInvalid) {
+            return false;
+        }
+        sum += value;
+    }
+    uint8_t check = kCode39.value[(uint8_t)code[length - 1]];
+    return check != kInvalid && check == sum % 43;
+}
+
+bool expandUPCE(const char *code, size_t length, char upca[12]) {
+    if (length != 8 || !allDigits(code, length) || (code[0] != '0' && code[0] != '1')) {
+        return false;
+    }
+    const char *d = code + 1; // six data digits
+    memset(upca, '0', 12);
+    upca[0] = code[0];
+    upca[11] = code[7];
+    switch (d[5]) {
+        case '0': case '1': case '2':
+            upca[1] = d[0]; upca[2] = d[1]; upca[3] = d[5];
+            upca[8] = d[2]; upca[9] = d[3]; upca[10] = d[4];
+            break;
+        case '3':
+            upca[1] = d[0]; upca[2] = d[1]; upca[3] = d[2];
+            upca[9] = d[3]; upca[10] = d[4];
+            break;
+        case '4':
+            upca[1] = d[0]; upca[2] = d[1]; upca[3] = d[2]; upca[4] = d[3];
+            upca[10] = d[4];
+            break;
+        default:
+            upca[1] = d[0]; upca[2] = d[1]; upca[3] = d[2]; upca[4] = d[3]; upca[5] = d[4];
+            upca[10] = d[5];
+            break;
+    }
+    return true;
+}
+
+bool validate(Check check, const char *code, size_t length) {
+    switch (check) {
+        case CheckEAN13:
+        case CheckUPC12:
+        case CheckEAN8:
+            return length == fixedLengthForCheck(check) && gs1Mod10Valid(code, length);
+        case CheckUPCE: {
+            char upca[12];
+            return expandUPCE(code, length, upca) && gs1Mod10Valid(upca, 12);
+        }
+        case CheckITF:
+            return length % 2 == 0 && gs1Mod10Valid(code, length);
+        case CheckCode39Mod43:
+            return code39Mod43Valid(code, length);
+        case CheckMSIMod10:
+            return msiMod10Valid(code, length);
+        case CheckMSIMod11:
+            return msiMod11Valid(code, length);
+        case CheckMSIMod1010:
+            return length >= 3 && msiMod10Valid(code, length - 1) && msiMod10Valid(code, length);
+        case CheckMSIMod1110:
+            return length >= 3 && msiMod11Valid(code, length - 1) && msiMod10Valid(code, length);
+        case CheckNone:
+            break;
+    }
+    return false;
+}
+
+size_t validateGS1Fixed(const char *codes, size_t length, size_t stride, size_t count, uint8_t *results) {
+    size_t valid = 0;
+    if (length < 2 || length > 16) {
+        memset(results, 0, count);
+        return 0;
+    }
+#ifdef SCANDITSDK_HAVE_VECTORS
+    // Lane i holds digit i of the code; weights are zero past the end of the code,
+    // so whatever follows it in memory does not contribute.
+    u8x16 weights = splat(0), mask = splat(0);
+    for (size_t i = 0; i < length; ++i) {
+        weights[i] = ((length - 1 - i) & 1) ? 3 : 1;
+        mask[i] = 0xFF;
+    }
+    const u8x16 zero = splat('0'), nine = splat(9);
+    for (size_t n = 0; n < count; ++n) {
+        u8x16 v;
+        memcpy(&v, codes + n * stride, sizeof(v));
+        u8x16 digits = v - zero;
+        u8x16 bad = (u8x16)(digits > nine) & mask;
+        u8x16 weighted = digits * weights;
+        uint64_t halves[2], badHalves[2];
+        memcpy(halves, &weighted, sizeof(halves));
+        memcpy(badHalves, &bad, sizeof(badHalves));
+        unsigned sum = horizontalSum(halves[0]) + horizontalSum(halves[1]);
+        uint8_t ok = ((badHalves[0] | badHalves[1]) == 0 && sum % 10 == 0) ? 1 : 0;
+        results[n] = ok;
+        valid += ok;
+    }
+#else
+    for (size_t n = 0; n < count; ++n) {
+        results[n] = gs1Mod10Valid(codes + n * stride, length) ? 1 : 0;
+        valid += results[n];
+    }
+#endif
+    return valid;
+}
+
+size_t validateBatch(Check check, const char *const *codes, const size_t *lengths, size_t count,
+                     uint8_t *results) {
+    size_t valid = 0;
+    size_t fixedLength = fixedLengthForCheck(check);
+
+    if (fixedLength == 0) {
+        for (size_t n = 0; n < count; ++n) {
+            results[n] = validate(check, codes[n], lengths[n]) ? 1 : 0;
+            valid += results[n];
+        }
+        return valid;
+    }
+
+    // Pack codes of the right length into 16-byte slots so the vector kernel
+    // never reads past the caller's buffers; anything else is invalid anyway.
+    enum { kBlock = 64 };
+    char packed[kBlock * 16] = { 0 };
+    uint8_t packedResults[kBlock];
+    size_t indices[kBlock];
+    size_t pending = 0;
+
+    for (size_t n = 0; n < count; ++n) {
+        results[n] = 0;
+        if (lengths[n] == fixedLength) {
+            memcpy(packed + pending * 16, codes[n], fixedLength);
+            indices[pending++] = n;
+        }
+        if (pending == kBlock || (n + 1 == count && pending > 0)) {
+            valid += validateGS1Fixed(packed, fixedLength, 16, pending, packedResults);
+            for (size_t i = 0; i < pending; ++i) {
+                results[indices[i]] = packedResults[i];
+            }
+            pending = 0;
+        }
+    }
+    return valid;
+}
+
+Check infer(const char *code, size_t length) {
+    if (length == 0) {
+        return CheckNone;
+    }
+    if (allDigits(code, length)) {
+        switch (length) {
+            case 13: return gs1Mod10Valid(code, length) ? CheckEAN13 : CheckNone;
+            case 12: return gs1Mod10Valid(code, length) ? CheckUPC12 : CheckNone;
+            case 8:
+                if (gs1Mod10Valid(code, length)) {
+                    return CheckEAN8;
+                }
+                return validate(CheckUPCE, code, length) ? CheckUPCE : CheckNone;
+            case 14: return gs1Mod10Valid(code, length) ? CheckITF : CheckNone;
+            default: return CheckNone;
+        }
+    }
+    // A one-in-43 chance of passing by accident is acceptable only for longer codes.
+    if (length >= 4 && code39Mod43Valid(code, length)) {
+        return CheckCode39Mod43;
+    }
+    return CheckNone;
+}
+
+} // namespace checksum
+} // namespace scanditsdk
@@ -0,0 +1,92 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_CHECKSUM_HPP
+#define SCANDITSDK_CHECKSUM_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Check digit validation for the symbologies whose codes carry one, in portable C++
+ * (no Foundation, no platform intrinsics) so it can be built and measured anywhere.
+ *
+ * Codes are ASCII byte ranges without a terminator. Each check has a table-driven
+ * scalar kernel; fixed-length GS1 codes (EAN-13, UPC-A, EAN-8) also have a batch kernel
+ * that uses GCC/clang vector extensions, which map to NEON on iOS and SSE2 on x86.
+ */
+namespace scanditsdk {
+namespace checksum {
+
+enum Check {
+    CheckNone = 0,
+    CheckEAN13,      // GS1 mod 10, 13 digits
+    CheckUPC12,      // GS1 mod 10, 12 digits
+    CheckEAN8,       // GS1 mod 10, 8 digits
+    CheckUPCE,       // 8 digits, check digit of the expanded UPC-A
+    CheckITF,        // GS1 mod 10, even number of digits
+    CheckCode39Mod43,
+    CheckMSIMod10,   // CHECKSUM_MOD_10
+    CheckMSIMod11,   // CHECKSUM_MOD_11
+    CheckMSIMod1010, // CHECKSUM_MOD_1010
+    CheckMSIMod1110  // CHECKSUM_MOD_1110
+};
+
+/** GS1 mod 10 (weights 3,1,... from the right of the data) over a digit string incl. its check digit. */
+bool gs1Mod10Valid(const char *code, size_t length);
+
+/** GS1 mod 10 check digit ('0'..'9') for a digit string without one; 0 if it has other characters. */
+char gs1Mod10CheckDigit(const char *data, size_t length);
+
+/** Luhn mod 10 as used by MSI Plessey. */
+bool msiMod10Valid(const char *code, size_t length);
+
+/** IBM mod 11 (weights 2..7 from the right of the data) as used by MSI Plessey. */
+bool msiMod11Valid(const char *code, size_t length);
+
+/** Code 39 with a trailing mod 43 check character; start/stop asterisks must be stripped. */
+bool code39Mod43Valid(const char *code, size_t length);
+
+/** Expands an 8-digit UPC-E code to its 12-digit UPC-A form. Returns false for malformed input. */
+bool expandUPCE(const char *code, size_t length, char upca[12]);
+
+/** Validates one code; also checks the length and character set the symbology requires. */
+bool validate(Check check, const char *code, size_t length);
+
+/**
+ * Validates count codes, writing 1 (valid) or 0 to results[i]. Returns the number of valid codes.
+ * Codes of the fixed-length GS1 checks are routed through the vector kernel.
+ */
+size_t validateBatch(Check check, const char *const *codes, const size_t *lengths, size_t count,
+                     uint8_t *results);
+
+/**
+ * Vector kernel for count GS1 codes of the same length (at most 16) stored stride bytes apart
+ * starting at codes. Reads 16 bytes per code, so stride must be at least 16 or the buffer must
+ * extend 16 bytes past the start of the last code. Returns the number of valid codes.
+ */
+size_t validateGS1Fixed(const char *codes, size_t length, size_t stride, size_t count, uint8_t *results);
+
+/**
+ * Infers the symbology of a manually entered code from its shape and check digit. Only
+ * checks that are unlikely to pass by accident are considered; MSI is never inferred.
+ * Returns CheckNone when nothing matches.
+ */
+Check infer(const char *code, size_t length);
+
+} // namespace checksum
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_CHECKSUM_HPP
@@ -0,0 +1,250 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKFrameStats.hpp"
+
+#include <string.h>
+
+namespace scanditsdk {
+namespace framestats {
+
+namespace {
+
+// Running sums of one pass; turned into Stats at the end.
+struct Sums {
+    uint64_t luminance;
+    uint64_t glare;
+    int64_t laplacian;
+    uint64_t laplacianSquared;
+};
+
+inline int laplacianAt(const uint8_t *up, const uint8_t *row, const uint8_t *down, size_t x) {
+    return 4 * row[x] - row[x - 1] - row[x + 1] - up[x] - down[x];
+}
+
+void rowScalar(const uint8_t *row, size_t from, size_t to, uint8_t glareThreshold, Sums &sums) {
+    for (size_t x = from; x < to; ++x) {
+        sums.luminance += row[x];
+        sums.glare += row[x] >= glareThreshold;
+    }
+}
+
+void laplacianScalar(const uint8_t *up, const uint8_t *row, const uint8_t *down, size_t from, size_t to,
+                     Sums &sums) {
+    for (size_t x = from; x < to; ++x) {
+        int lap = laplacianAt(up, row, down, x);
+        sums.laplacian += lap;
+        sums.laplacianSquared += (uint64_t)(lap * lap);
+    }
+}
+
+Stats finish(const Sums &sums, size_t width, size_t height) {
+    Stats stats = { 0, 0, 0 };
+    size_t pixels = width * height;
+    if (pixels == 0) {
+        return stats;
+    }
+    stats.meanLuminance = (float)((double)sums.luminance / pixels);
+    stats.glareFraction = (float)((double)sums.glare / pixels);
+    if (width >= 3 && height >= 3) {
+        double n = (double)(width - 2) * (height - 2);
+        double mean = sums.laplacian / n;
+        stats.sharpness = (float)(sums.laplacianSquared / n - mean * mean);
+    }
+    return stats;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SCANDITSDK_HAVE_VECTORS 1
+
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+typedef int8_t i8x16 __attribute__((vector_size(16)));
+typedef int16_t i16x16 __attribute__((vector_size(32)));
+typedef uint16_t u16x16 __attribute__((vector_size(32)));
+typedef int32_t i32x16 __attribute__((vector_size(64)));
+
+inline u8x16 load(const uint8_t *p) {
+    u8x16 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// The 32 and 64 byte vectors only ever go by reference: passed or returned by value their ABI
+// depends on -mavx/-mavx512f (-Wpsabi), and these helpers are meant to be inlined anyway.
+inline void widen(const uint8_t *p, i16x16 &out) {
+    out = __builtin_convertvector(load(p), i16x16);
+}
+
+template <typename V>
+inline int64_t lanes(const V &v) {
+    int64_t sum = 0;
+    for (int i = 0; i < 16; ++i) {
+        sum += v[i];
+    }
+    return sum;
+}
+
+// Sums are kept in 16-bit lanes, which is what makes the vector path pay off, and flushed
+// before they can overflow: luminance after 256 chunks of at most 255 per lane.
+const size_t kLuminanceChunks = 256;
+// |lap| <= 1020, so 16-bit lane sums of lap are safe for 32 chunks.
+const size_t kLaplacianChunks = 32;
+
+void rowVector(const uint8_t *row, size_t width, uint8_t glareThreshold, Sums &sums) {
+    u8x16 threshold;
+    memset(&threshold, glareThreshold, sizeof(threshold));
+    size_t x = 0;
+    while (x + 16 <= width) {
+        u16x16 luminance = { 0 }, glare = { 0 };
+        for (size_t n = 0; n < kLuminanceChunks && x + 16 <= width; ++n, x += 16) {
+            u8x16 v = load(row + x);
+            luminance += __builtin_convertvector(v, u16x16);
+            glare -= __builtin_convertvector((i8x16)(v >= threshold), u16x16);
+        }
+        sums.luminance += lanes(luminance);
+        sums.glare += lanes(glare);
+    }
+    rowScalar(row, x, width, glareThreshold, sums);
+}
+
+void laplacianVector(const uint8_t *up, const uint8_t *row, const uint8_t *down, size_t width,
+                     Sums &sums) {
+    size_t x = 1;
+    while (x + 17 <= width) {
+        i16x16 sum = { 0 };
+        i32x16 squared = { 0 };
+        for (size_t n = 0; n < kLaplacianChunks && x + 17 <= width; ++n, x += 16) {
+            i16x16 centre, left, right, above, below;
+            widen(row + x, centre);
+            widen(row + x - 1, left);
+            widen(row + x + 1, right);
+            widen(up + x, above);
+            widen(down + x, below);
+            i16x16 lap = 4 * centre - left - right - above - below;
+            sum += lap;
+            i32x16 wide = __builtin_convertvector(lap, i32x16);
+            squared += wide * wide;
+        }
+        sums.laplacian += lanes(sum);
+        sums.laplacianSquared += (uint64_t)lanes(squared);
+    }
+    laplacianScalar(up, row, down, x, width - 1, sums);
+}
+#endif
+
+} // namespace
+
+float meanLuminanceScalar(const uint8_t *pixels, size_t width, size_t height, size_t stride, size_t rowStep) {
+    uint64_t sum = 0;
+    size_t rows = 0;
+    rowStep = rowStep == 0 ? 1 : rowStep;
+    for (size_t y = 0; y < height; y += rowStep, ++rows) {
+        const uint8_t *row = pixels + y * stride;
+        for (size_t x = 0; x < width; ++x) {
+            sum += row[x];
+        }
+    }
+    return rows * width == 0 ? 0 : (float)((double)sum / (rows * width));
+}
+
+float meanLuminance(const uint8_t *pixels, size_t width, size_t height, size_t stride, size_t rowStep) {
+#ifdef SCANDITSDK_HAVE_VECTORS
+    uint64_t sum = 0;
+    size_t rows = 0;
+    rowStep = rowStep == 0 ? 1 : rowStep;
+    for (size_t y = 0; y < height; y += rowStep, ++rows) {
+        const uint8_t *row = pixels + y * stride;
+        size_t x = 0;
+        while (x + 16 <= width) {
+            u16x16 luminance = { 0 };
+            for (size_t n = 0; n < kLuminanceChunks && x + 16 <= width; ++n, x += 16) {
+                luminance += __builtin_convertvector(load(row + x), u16x16);
+            }
+            sum += lanes(luminance);
+        }
+        for (; x < width; ++x) {
+            sum += row[x];
+        }
+    }
+    return rows * width == 0 ? 0 : (float)((double)sum / (rows * width));
+#else
+    return meanLuminanceScalar(pixels, width, height, stride, rowStep);
+#endif
+}
+
+Stats analyzeScalar(const uint8_t *pixels, size_t width, size_t height, size_t stride, uint8_t glareThreshold) {
+    Sums sums = { 0, 0, 0, 0 };
+    for (size_t y = 0; y < height; ++y) {
+        const uint8_t *row = pixels + y * stride;
+        rowScalar(row, 0, width, glareThreshold, sums);
+        if (y > 0 && y + 1 < height && width >= 3) {
+            laplacianScalar(row - stride, row, row + stride, 1, width - 1, sums);
+        }
+    }
+    return finish(sums, width, height);
+}
+
+Stats analyze(const uint8_t *pixels, size_t width, size_t height, size_t stride, uint8_t glareThreshold) {
+#ifdef SCANDITSDK_HAVE_VECTORS
+    Sums sums = { 0, 0, 0, 0 };
+    for (size_t y = 0; y < height; ++y) {
+        const uint8_t *row = pixels + y * stride;
+        rowVector(row, width, glareThreshold, sums);
+        if (y > 0 && y + 1 < height && width >= 3) {
+            laplacianVector(row - stride, row, row + stride, width, sums);
+        }
+    }
+    return finish(sums, width, height);
+#else
+    return analyzeScalar(pixels, width, height, stride, glareThreshold);
+#endif
+}
+
+Window::Window() {
+    clear();
+}
+
+void Window::clear() {
+    memset(samples_, 0, sizeof(samples_));
+    next_ = 0;
+    count_ = 0;
+}
+
+void Window::push(const Stats &stats) {
+    samples_[next_] = stats;
+    next_ = (next_ + 1) % kSize;
+    if (count_ < kSize) {
+        count_++;
+    }
+}
+
+Stats Window::mean() const {
+    Stats mean = { 0, 0, 0 };
+    if (count_ == 0) {
+        return mean;
+    }
+    for (size_t i = 0; i < count_; ++i) {
+        mean.meanLuminance += samples_[i].meanLuminance;
+        mean.sharpness += samples_[i].sharpness;
+        mean.glareFraction += samples_[i].glareFraction;
+    }
+    mean.meanLuminance /= count_;
+    mean.sharpness /= count_;
+    mean.glareFraction /= count_;
+    return mean;
+}
+
+} // namespace framestats
+} // namespace scanditsdk
@@ -0,0 +1,77 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_FRAMESTATS_HPP
+#define SCANDITSDK_FRAMESTATS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Image quality statistics of sampled camera frames, in portable C++ like ScanditSDKChecksum.
+ *
+ * Frames are 8-bit luminance planes (width bytes per row, stride bytes apart). The kernels make
+ * one pass over the plane; with GCC/clang vector extensions 16 pixels are processed at a time,
+ * otherwise a scalar loop computes the same values. Nothing here allocates.
+ */
+namespace scanditsdk {
+namespace framestats {
+
+struct Stats {
+    float meanLuminance; // 0..255
+    float sharpness;     // variance of the 4-neighbour Laplacian; low for blurred frames
+    float glareFraction; // share of pixels at or above the glare threshold
+};
+
+const uint8_t kDefaultGlareThreshold = 250;
+
+/**
+ * Mean luminance of a plane, 0 for an empty one. Only every rowStep-th row is read, which is
+ * plenty for exposure decisions and makes the kernel cheap enough to run on every sample.
+ */
+float meanLuminance(const uint8_t *pixels, size_t width, size_t height, size_t stride, size_t rowStep = 1);
+
+/** Scalar reference of meanLuminance. */
+float meanLuminanceScalar(const uint8_t *pixels, size_t width, size_t height, size_t stride, size_t rowStep = 1);
+
+/** All statistics in one pass. The Laplacian needs at least 3x3 pixels, sharpness is 0 otherwise. */
+Stats analyze(const uint8_t *pixels, size_t width, size_t height, size_t stride,
+              uint8_t glareThreshold = kDefaultGlareThreshold);
+
+/** Scalar reference of analyze, for checking and measuring the vector path. */
+Stats analyzeScalar(const uint8_t *pixels, size_t width, size_t height, size_t stride,
+                    uint8_t glareThreshold = kDefaultGlareThreshold);
+
+/** Rolling mean of the last kSize samples. */
+class Window {
+public:
+    enum { kSize = 16 };
+
+    Window();
+    void push(const Stats &stats);
+    Stats mean() const;
+    size_t count() const { return count_; }
+    void clear();
+
+private:
+    Stats samples_[kSize];
+    size_t next_;
+    size_t count_;
+};
+
+} // namespace framestats
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_FRAMESTATS_HPP
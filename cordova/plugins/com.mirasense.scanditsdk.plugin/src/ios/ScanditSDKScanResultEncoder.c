@@ -0,0 +1,137 @@
+// Generated by tools/gen-scan-result.js from schema/scan-result.json. Do not edit.
+
+#include <math.h>
+#include <stdio.h>
+#include "ScanditSDKScanResultEncoder.h"
+
+static const char* const kScanditSDKSymbologyNames[ScanditSDKSymbologyCount] = {
+    "UNKNOWN", "EAN13", "UPC12", "EAN8", "UPCE", "CODE128", "CODE39", "CODE93", "ITF", "MSI", "CODABAR", "GS1-DATABAR", "GS1-DATABAR-EXPANDED", "QR", "DATAMATRIX", "PDF417", "AZTEC"
+};
+
+const char* scanditsdk_symbology_name(ScanditSDKSymbology value)
+{
+    return ((unsigned)value < ScanditSDKSymbologyCount) ? kScanditSDKSymbologyNames[value] : kScanditSDKSymbologyNames[0];
+}
+
+// The index of name in kScanditSDKSymbologyNames, or -1.
+static int scanditsdk_symbology_index(const uint16_t* name, size_t length)
+{
+    for (int i = 0; i < ScanditSDKSymbologyCount; ++i) {
+        const char* candidate = kScanditSDKSymbologyNames[i];
+        size_t j = 0;
+        while ((j < length) && (candidate[j] != '\0') && (name[j] == (uint8_t)candidate[j])) {
+            ++j;
+        }
+        if ((j == length) && (candidate[j] == '\0')) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ScanditSDKSymbology scanditsdk_symbology_from_utf16(const uint16_t* name, size_t length)
+{
+    int i = scanditsdk_symbology_index(name, length);
+
+    return (i >= 0) ? (ScanditSDKSymbology)i : ScanditSDKSymbologyUnknown;
+}
+
+size_t scanditsdk_js_string(uint16_t* out, const uint16_t* chars, size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t n = 0;
+
+    out[n++] = '"';
+    for (size_t i = 0; i < length; ++i) {
+        uint16_t c = chars[i];
+        if ((c == '"') || (c == '\\')) {
+            out[n++] = '\\';
+            out[n++] = c;
+        } else if ((c < 0x20) || (c == 0x2028) || (c == 0x2029)) {
+            out[n++] = '\\';
+            out[n++] = 'u';
+            out[n++] = hex[(c >> 12) & 0xf];
+            out[n++] = hex[(c >> 8) & 0xf];
+            out[n++] = hex[(c >> 4) & 0xf];
+            out[n++] = hex[c & 0xf];
+        } else {
+            out[n++] = c;
+        }
+    }
+    out[n++] = '"';
+    return n;
+}
+
+// Writes text, which has nothing to escape.
+static size_t scanditsdk_js_ascii(uint16_t* out, const char* text)
+{
+    size_t n = 0;
+
+    while (text[n] != '\0') {
+        out[n] = (uint8_t)text[n];
+        ++n;
+    }
+    return n;
+}
+
+// Writes at most 24 characters; 0 for NaN and infinities, which have no literal.
+static size_t scanditsdk_js_number(uint16_t* out, double value)
+{
+    char digits[32];
+    int length = snprintf(digits, sizeof(digits), "%.17g", isfinite(value) ? value : 0.0);
+
+    for (int i = 0; i < length; ++i) {
+        // Not even a locale with a decimal comma may break the literal.
+        out[i] = (digits[i] == ',') ? '.' : (uint8_t)digits[i];
+    }
+    return (size_t)length;
+}
+
+size_t scanditsdk_scan_result_bound(size_t codeLength, size_t symbologyLength, size_t gtinLength)
+{
+    // Brackets and commas, then every field at its longest.
+    size_t bound = 6;
+
+    bound += 6 * codeLength + 2;
+    bound += (6 * symbologyLength + 2 > 22) ? 6 * symbologyLength + 2 : 22;
+    bound += 24;
+    bound += 5;
+    bound += 6 * gtinLength + 2;
+    return bound;
+}
+
+size_t scanditsdk_scan_result_encode(uint16_t* out, const uint16_t* code, size_t codeLength, const uint16_t* symbology, size_t symbologyLength, double timestamp, int manual, const uint16_t* gtin, size_t gtinLength)
+{
+    size_t n = 0;
+    int last = 3;
+
+    if (gtin != NULL) {
+        last = 4;
+    }
+
+    out[n++] = '[';
+    n += scanditsdk_js_string(out + n, code, (code != NULL) ? codeLength : 0);
+    out[n++] = ',';
+    int symbologyIndex = (symbology != NULL) ? scanditsdk_symbology_index(symbology, symbologyLength) : 0;
+    if (symbologyIndex < 0) {
+        n += scanditsdk_js_string(out + n, symbology, symbologyLength);
+    } else {
+        out[n++] = '"';
+        n += scanditsdk_js_ascii(out + n, kScanditSDKSymbologyNames[symbologyIndex]);
+        out[n++] = '"';
+    }
+    out[n++] = ',';
+    n += scanditsdk_js_number(out + n, timestamp);
+    out[n++] = ',';
+    n += scanditsdk_js_ascii(out + n, manual ? "true" : "false");
+    if (last >= 4) {
+        out[n++] = ',';
+        if (gtin == NULL) {
+            n += scanditsdk_js_ascii(out + n, "null");
+        } else {
+            n += scanditsdk_js_string(out + n, gtin, gtinLength);
+        }
+    }
+    out[n++] = ']';
+    return n;
+}
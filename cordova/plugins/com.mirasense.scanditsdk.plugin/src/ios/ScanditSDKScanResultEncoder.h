@@ -0,0 +1,74 @@
+// Generated by tools/gen-scan-result.js from schema/scan-result.json. Do not edit.
+
+/*
+ The encoder behind ScanditSDKEncodeScanResult, in plain C on UTF-16 text and with no
+ allocations of its own, so it builds and can be tested and benchmarked outside
+ of iOS; tests/ does that on Linux.
+ */
+
+#ifndef SCANDITSDK_SCAN_RESULT_ENCODER_H
+#define SCANDITSDK_SCAN_RESULT_ENCODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ScanditSDKSymbologyUnknown = 0,
+    ScanditSDKSymbologyEan13,
+    ScanditSDKSymbologyUpc12,
+    ScanditSDKSymbologyEan8,
+    ScanditSDKSymbologyUpce,
+    ScanditSDKSymbologyCode128,
+    ScanditSDKSymbologyCode39,
+    ScanditSDKSymbologyCode93,
+    ScanditSDKSymbologyItf,
+    ScanditSDKSymbologyMsi,
+    ScanditSDKSymbologyCodabar,
+    ScanditSDKSymbologyGs1Databar,
+    ScanditSDKSymbologyGs1DatabarExpanded,
+    ScanditSDKSymbologyQr,
+    ScanditSDKSymbologyDatamatrix,
+    ScanditSDKSymbologyPdf417,
+    ScanditSDKSymbologyAztec,
+    ScanditSDKSymbologyCount
+} ScanditSDKSymbology;
+
+// The schema name of value, that of ScanditSDKSymbologyUnknown if it is out of range.
+const char* scanditsdk_symbology_name(ScanditSDKSymbology value);
+// Returns ScanditSDKSymbologyUnknown for names outside the schema.
+ScanditSDKSymbology scanditsdk_symbology_from_utf16(const uint16_t* name, size_t length);
+
+// Writes chars as a quoted JS string literal to out, which has room for 6 * length + 2
+// characters, and returns the number of characters written. Besides quotes, backslashes
+// and control characters, U+2028/U+2029 are escaped: they end a line in JS source.
+size_t scanditsdk_js_string(uint16_t* out, const uint16_t* chars, size_t length);
+
+/*
+ One decoded or manually entered code. Fields are sent positionally in this order, so the first two keep the legacy [barcode, symbology] layout.
+
+ 0: code (string)
+ 1: symbology (enum)
+ 2: timestamp (double) - milliseconds since 1970
+ 3: manual (bool) - entered in the search bar instead of scanned
+ 4: gtin (string, optional, nil to omit) - GTIN-14 for retail codes
+
+ Strings are passed as UTF-16 characters and their length. A nil string is
+ written as "", a nil enum as its first value and a nil optional field as null,
+ or not at all when no later field is set. Enum names outside the schema are
+ passed through as strings.
+
+ scanditsdk_scan_result_encode writes the JS array literal to out, which has room for
+ scanditsdk_scan_result_bound() characters, and returns the number of characters written.
+ */
+size_t scanditsdk_scan_result_bound(size_t codeLength, size_t symbologyLength, size_t gtinLength);
+size_t scanditsdk_scan_result_encode(uint16_t* out, const uint16_t* code, size_t codeLength, const uint16_t* symbology, size_t symbologyLength, double timestamp, int manual, const uint16_t* gtin, size_t gtinLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+//  ScanditSDKSession is the state of one scan or show call. It lives in the plugin instance,
+//  which outlives the page, so a reloaded page can take over a running picker and receive the
+//  results that were scanned while no page was listening.
+//
+
+#import <Foundation/Foundation.h>
+#import <Cordova/CDVPluginResult.h>
+
+typedef enum {
+    ScanditSDKSessionModeFinished = 0, // the picker is gone, only queued results are left
+    ScanditSDKSessionModeModal,
+    ScanditSDKSessionModeEmbedded
+} ScanditSDKSessionMode;
+
+@interface ScanditSDKSession : NSObject
+
+@property (nonatomic, readonly) NSString *sessionId;
+@property (nonatomic, assign) ScanditSDKSessionMode mode;
+@property (nonatomic, readonly) NSString *appKey;
+@property (nonatomic, readonly) NSDictionary *options;
+// Frame of an embedded picker as passed to show or resize.
+@property (nonatomic, copy) NSString *frame;
+// The callback results go to, nil while detached.
+@property (nonatomic, readonly) NSString *callbackId;
+@property (nonatomic, readonly) NSDate *detachedAt;
+@property (nonatomic, readonly) NSUInteger pendingCount;
+@property (nonatomic, readonly) NSUInteger droppedCount;
+
+- (id)initWithMode:(ScanditSDKSessionMode)mode appKey:(NSString *)appKey options:(NSDictionary *)options
+        callbackId:(NSString *)callbackId;
+
+- (void)attachCallbackId:(NSString *)callbackId;
+- (void)detach;
+
+/**
+ * Keeps a result for the next attach. At most 256 results are kept; older ones are dropped first.
+ */
+- (void)enqueueResult:(CDVPluginResult *)result asError:(BOOL)asError;
+
+/**
+ * Calls block with every queued result in order and empties the queue.
+ */
+- (void)drainResultsWithBlock:(void (^)(CDVPluginResult *result, BOOL asError))block;
+
+/**
+ * Description for the page: {sessionId, mode, attached, pending, dropped, detachedMs, frame}.
+ */
+- (NSDictionary *)descriptor;
+
+@end
@@ -0,0 +1,108 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#import "ScanditSDKSession.h"
+
+#define kScanditSDKSessionMaxPending 256
+
+static NSString *const kScanditSDKSessionModeNames[] = { @"finished", @"modal", @"embedded" };
+
+@interface ScanditSDKSession () {
+    NSMutableArray *pendingResults;
+    NSMutableArray *pendingErrorFlags;
+}
+@end
+
+
+@implementation ScanditSDKSession
+
+@synthesize sessionId;
+@synthesize mode;
+@synthesize appKey;
+@synthesize options;
+@synthesize frame;
+@synthesize callbackId;
+@synthesize detachedAt;
+@synthesize droppedCount;
+
+- (id)initWithMode:(ScanditSDKSessionMode)aMode appKey:(NSString *)anAppKey options:(NSDictionary *)someOptions
+        callbackId:(NSString *)aCallbackId {
+    self = [super init];
+    if (self != nil) {
+        CFUUIDRef uuid = CFUUIDCreate(kCFAllocatorDefault);
+        sessionId = (__bridge_transfer NSString *)CFUUIDCreateString(kCFAllocatorDefault, uuid);
+        CFRelease(uuid);
+        mode = aMode;
+        appKey = [anAppKey copy];
+        options = [someOptions isKindOfClass:[NSDictionary class]] ? [someOptions copy] : [NSDictionary dictionary];
+        callbackId = [aCallbackId copy];
+        pendingResults = [NSMutableArray array];
+        pendingErrorFlags = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)attachCallbackId:(NSString *)aCallbackId {
+    callbackId = [aCallbackId copy];
+    detachedAt = nil;
+}
+
+- (void)detach {
+    callbackId = nil;
+    detachedAt = [NSDate date];
+}
+
+- (NSUInteger)pendingCount {
+    return [pendingResults count];
+}
+
+- (void)enqueueResult:(CDVPluginResult *)result asError:(BOOL)asError {
+    if ([pendingResults count] == kScanditSDKSessionMaxPending) {
+        [pendingResults removeObjectAtIndex:0];
+        [pendingErrorFlags removeObjectAtIndex:0];
+        droppedCount++;
+    }
+    [pendingResults addObject:result];
+    [pendingErrorFlags addObject:[NSNumber numberWithBool:asError]];
+}
+
+- (void)drainResultsWithBlock:(void (^)(CDVPluginResult *result, BOOL asError))block {
+    NSArray *results = pendingResults;
+    NSArray *errorFlags = pendingErrorFlags;
+    pendingResults = [NSMutableArray array];
+    pendingErrorFlags = [NSMutableArray array];
+    for (NSUInteger i = 0; i < [results count]; i++) {
+        block([results objectAtIndex:i], [[errorFlags objectAtIndex:i] boolValue]);
+    }
+}
+
+- (NSDictionary *)descriptor {
+    NSMutableDictionary *descriptor = [NSMutableDictionary dictionaryWithCapacity:7];
+    [descriptor setObject:sessionId forKey:@"sessionId"];
+    [descriptor setObject:kScanditSDKSessionModeNames[mode] forKey:@"mode"];
+    [descriptor setObject:[NSNumber numberWithBool:(callbackId != nil)] forKey:@"attached"];
+    [descriptor setObject:[NSNumber numberWithUnsignedInteger:[pendingResults count]] forKey:@"pending"];
+    [descriptor setObject:[NSNumber numberWithUnsignedInteger:droppedCount] forKey:@"dropped"];
+    if (detachedAt != nil) {
+        [descriptor setObject:[NSNumber numberWithDouble:-[detachedAt timeIntervalSinceNow] * 1000.0]
+                       forKey:@"detachedMs"];
+    }
+    if (frame != nil) {
+        [descriptor setObject:frame forKey:@"frame"];
+    }
+    return descriptor;
+}
+
+@end
@@ -0,0 +1,91 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_TORCH_HPP
+#define SCANDITSDK_TORCH_HPP
+
+#include <stdint.h>
+
+/**
+ * Automatic torch decisions from sampled frame luminance and decode times, in portable C++ like
+ * ScanditSDKFrameStats. The controller only decides; switching the torch is up to the caller.
+ *
+ * The torch goes on when the smoothed luminance of the frames is below darkLevel, or when it is
+ * below dimLevel and nothing was decoded for noDecodeSeconds; a bright scene that simply holds
+ * no barcode never turns the torch on. Frames taken with the torch on say nothing about the
+ * ambient light, so they are ignored. The torch goes off once it has been on for holdSeconds
+ * and nothing was decoded for holdSeconds, and then stays off for at least holdSeconds. An idle
+ * picker in a dark aisle therefore cycles the torch, holdSeconds on and holdSeconds off, until a
+ * decode keeps it on; this is intended, as it caps the torch at half of the time of a picker left
+ * open with nothing to scan. Times are in seconds on any monotonic clock.
+ */
+namespace scanditsdk {
+namespace torch {
+
+struct Config {
+    Config() : darkLevel(60), dimLevel(110), noDecodeSeconds(4), holdSeconds(10), smoothing(0.5f) {}
+
+    float darkLevel;        // mean luminance 0..255
+    float dimLevel;         // mean luminance 0..255 below which a no-decode streak counts
+    double noDecodeSeconds;
+    double holdSeconds;
+    float smoothing;        // weight of a new sample in the moving average, 0..1
+};
+
+enum Reason {
+    ReasonNone = 0,
+    ReasonDark,     // switched on, frames too dark
+    ReasonNoDecode, // switched on, frames dim and no decode for too long
+    ReasonIdle      // switched off after the hold period without decodes
+};
+
+class Controller {
+public:
+    explicit Controller(const Config &config = Config());
+
+    /** Resets the controller for a picker that starts scanning at now, with the torch off. */
+    void start(double now);
+
+    /**
+     * Feeds the mean luminance of a frame taken at now. Returns the reason if the torch should be
+     * switched, ReasonNone otherwise; isOn() tells the new state.
+     */
+    Reason sample(double now, float luminance);
+
+    void decoded(double now);
+
+    bool isOn() const { return on_; }
+    uint32_t switchCount() const { return switches_; }
+    /** Total time the torch was on since start, including the current period. */
+    double onSeconds(double now) const;
+    const Config &config() const { return config_; }
+
+private:
+    Config config_;
+    bool on_;
+    bool haveLuminance_;
+    float luminance_;
+    double lastActivity_; // start, last decode or last switch-off, for the no-decode streak
+    double lastDecode_;
+    double onSince_;
+    double quietUntil_;
+    double onTotal_;
+    uint32_t switches_;
+};
+
+} // namespace torch
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_TORCH_HPP
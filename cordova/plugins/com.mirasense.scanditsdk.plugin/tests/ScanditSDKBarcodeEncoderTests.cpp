@@ -0,0 +1,1922 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+#include "ScanditSDKBarcodeEncoder.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace scanditsdk::encoder;
+
+/**
+ * Round trips through the encoder: every symbol is read back by an independent decoder written
+ * from the symbology specifications (own pattern tables, an own QR, Data Matrix and PDF417 reader
+ * with Reed-Solomon syndrome checks), and the result must be the code that went in.
+ */
+namespace {
+
+bool encodeCode(Symbology symbology, const std::string &code, const Options &options, Symbol *symbol) {
+    return encode(symbology, code.data(), code.size(), options, symbol) == ErrorNone;
+}
+
+Error encodeError(Symbology symbology, const std::string &code, const Options &options = Options()) {
+    Symbol symbol;
+    return encode(symbology, code.data(), code.size(), options, &symbol);
+}
+
+std::string randomString(scanditsdk::test::Random &random, const char *alphabet, size_t length) {
+    std::string result;
+    size_t size = strlen(alphabet);
+    for (size_t i = 0; i < length; ++i) {
+        result += alphabet[random.below((uint32_t)size)];
+    }
+    return result;
+}
+
+const char kDigits[] = "0123456789";
+
+char gs1Check(const std::string &data) {
+    unsigned sum = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        // The digit next to the check digit has weight 3.
+        sum += (unsigned)(data[data.size() - 1 - i] - '0') * (i % 2 == 0 ? 3 : 1);
+    }
+    return (char)('0' + (10 - sum % 10) % 10);
+}
+
+// Linear symbols
+
+std::string rowOf(const Symbol &symbol) {
+    std::string row;
+    for (unsigned x = 0; x < symbol.width; ++x) {
+        row += symbol.dark(x, 0) ? '1' : '0';
+    }
+    return row;
+}
+
+// Widths of the alternating dark and light elements, starting with dark.
+std::vector<unsigned> elementWidths(const std::string &row) {
+    std::vector<unsigned> widths;
+    for (size_t i = 0; i < row.size(); ++i) {
+        if (i == 0 || row[i] != row[i - 1]) {
+            widths.push_back(0);
+        }
+        ++widths.back();
+    }
+    return widths;
+}
+
+// EAN / UPC: L (odd parity) patterns; R is L inverted and G is R reversed.
+const char *const kL[10] = {
+    "0001101", "0011001", "0010011", "0111101", "0100011",
+    "0110001", "0101111", "0111011", "0110111", "0001011"
+};
+const char *const kFirstDigitParity[10] = {
+    "LLLLLL", "LLGLGG", "LLGGLG", "LLGGGL", "LGLLGG", "LGGLLG", "LGGGLL", "LGLGLG", "LGLGGL", "LGGLGL"
+};
+const char *const kUPCEParity[10] = {
+    "GGGLLL", "GGLGLL", "GGLLGL", "GGLLLG", "GLGGLL", "GLLGGL", "GLLLGG", "GLGLGL", "GLGLLG", "GLLGLG"
+};
+
+std::string invert(const std::string &pattern) {
+    std::string result(pattern);
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = result[i] == '0' ? '1' : '0';
+    }
+    return result;
+}
+
+// Digit of a 7-module pattern and its parity ('L', 'G' or 'R'); -1 if none matches.
+int eanDigit(const std::string &pattern, char *parity) {
+    for (int d = 0; d < 10; ++d) {
+        std::string r = invert(kL[d]);
+        if (pattern == kL[d]) {
+            *parity = 'L';
+            return d;
+        }
+        if (pattern == r) {
+            *parity = 'R';
+            return d;
+        }
+        if (pattern == std::string(r.rbegin(), r.rend())) {
+            *parity = 'G';
+            return d;
+        }
+    }
+    return -1;
+}
+
+// Reads count digits from offset; their parities go to parities. Empty on a bad pattern.
+std::string eanDigits(const std::string &row, size_t offset, int count, std::string *parities) {
+    std::string digits;
+    for (int i = 0; i < count; ++i) {
+        char parity;
+        int digit = eanDigit(row.substr(offset + 7 * (size_t)i, 7), &parity);
+        if (digit < 0) {
+            return std::string();
+        }
+        digits += (char)('0' + digit);
+        *parities += parity;
+    }
+    return digits;
+}
+
+int indexOf(const char *const *table, int count, const std::string &value) {
+    for (int i = 0; i < count; ++i) {
+        if (value == table[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::string decodeEAN13(const std::string &row) {
+    if (row.size() != 95 || row.compare(0, 3, "101") != 0 || row.compare(45, 5, "01010") != 0 ||
+            row.compare(92, 3, "101") != 0) {
+        return std::string();
+    }
+    std::string left, right;
+    std::string digits = eanDigits(row, 3, 6, &left);
+    std::string rightDigits = eanDigits(row, 50, 6, &right);
+    int first = indexOf(kFirstDigitParity, 10, left);
+    if (digits.empty() || rightDigits.empty() || right != "RRRRRR" || first < 0) {
+        return std::string();
+    }
+    return (char)('0' + first) + digits + rightDigits;
+}
+
+std::string decodeEAN8(const std::string &row) {
+    if (row.size() != 67 || row.compare(0, 3, "101") != 0 || row.compare(31, 5, "01010") != 0 ||
+            row.compare(64, 3, "101") != 0) {
+        return std::string();
+    }
+    std::string left, right;
+    std::string digits = eanDigits(row, 3, 4, &left) + eanDigits(row, 36, 4, &right);
+    return (digits.size() == 8 && left == "LLLL" && right == "RRRR") ? digits : std::string();
+}
+
+std::string expandUPCE(const std::string &upce) {
+    std::string d = upce.substr(1, 6), middle;
+    switch (d[5]) {
+        case '0': case '1': case '2': middle = d.substr(0, 2) + d[5] + "0000" + d.substr(2, 3); break;
+        case '3': middle = d.substr(0, 3) + "00000" + d.substr(3, 2); break;
+        case '4': middle = d.substr(0, 4) + "00000" + d[4]; break;
+        default: middle = d.substr(0, 5) + "0000" + d[5]; break;
+    }
+    return upce[0] + middle + upce[7];
+}
+
+// The number system and check digit are in the parities of the six digits.
+std::string decodeUPCE(const std::string &row) {
+    if (row.size() != 51 || row.compare(0, 3, "101") != 0 || row.compare(45, 6, "010101") != 0) {
+        return std::string();
+    }
+    std::string parities;
+    std::string digits = eanDigits(row, 3, 6, &parities);
+    if (digits.empty()) {
+        return std::string();
+    }
+    char numberSystem = '0';
+    int check = indexOf(kUPCEParity, 10, parities);
+    if (check < 0) {
+        for (size_t i = 0; i < parities.size(); ++i) {
+            parities[i] = parities[i] == 'L' ? 'G' : 'L';
+        }
+        numberSystem = '1';
+        check = indexOf(kUPCEParity, 10, parities);
+    }
+    if (check < 0) {
+        return std::string();
+    }
+    std::string upce = numberSystem + digits + (char)('0' + check);
+    std::string upca = expandUPCE(upce);
+    return gs1Check(upca.substr(0, 11)) == upca[11] ? upce : std::string();
+}
+
+void testEANUPC() {
+    scanditsdk::test::Random random(2);
+    Options options;
+    for (int n = 0; n < 300; ++n) {
+        std::string d = randomString(random, kDigits, 12);
+        Symbol symbol;
+        CHECK(encodeCode(SymbologyEAN13, d, options, &symbol) && symbol.isLinear());
+        CHECK(decodeEAN13(rowOf(symbol)) == d + gs1Check(d) && symbol.quietZone == 11);
+        Symbol withCheck;
+        CHECK(encodeCode(SymbologyEAN13, d + gs1Check(d), options, &withCheck) &&
+              withCheck.modules == symbol.modules);
+        char wrong = (char)('0' + (gs1Check(d) - '0' + 1) % 10);
+        CHECK(encodeError(SymbologyEAN13, d + wrong) == ErrorCheckDigit);
+
+        std::string upca = d.substr(0, 11);
+        CHECK(encodeCode(SymbologyUPCA, upca, options, &symbol));
+        CHECK(decodeEAN13(rowOf(symbol)) == "0" + upca + gs1Check(upca) && symbol.quietZone == 9);
+
+        std::string ean8 = d.substr(0, 7);
+        CHECK(encodeCode(SymbologyEAN8, ean8, options, &symbol));
+        CHECK(decodeEAN8(rowOf(symbol)) == ean8 + gs1Check(ean8) && symbol.quietZone == 7);
+
+        CHECK(encodeCode(SymbologyUPCE, d.substr(0, 6), options, &symbol));
+        CHECK(decodeUPCE(rowOf(symbol)).compare(0, 7, "0" + d.substr(0, 6)) == 0);
+        CHECK(encodeCode(SymbologyUPCE, "1" + d.substr(0, 6), options, &symbol));
+        std::string upce = decodeUPCE(rowOf(symbol));
+        CHECK(upce.compare(0, 7, "1" + d.substr(0, 6)) == 0);
+        Symbol again;
+        CHECK(encodeCode(SymbologyUPCE, upce, options, &again) && again.modules == symbol.modules);
+    }
+    CHECK(encodeError(SymbologyEAN13, "59012341234") == ErrorLength);
+    CHECK(encodeError(SymbologyEAN13, "59012341234X") == ErrorCharacters);
+    CHECK(encodeError(SymbologyUPCE, "2123456") == ErrorCharacters); // number system 0 or 1 only
+    CHECK(encodeError(SymbologyUPCE, "12345") == ErrorLength);
+}
+
+// Code 39: nine elements per character, three of them wide.
+const char kCode39Alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%";
+
+// Characters separated by '|', as 'n'/'w' strings.
+std::vector<std::string> code39Patterns(const std::string &row, unsigned wide) {
+    std::vector<unsigned> widths = elementWidths(row);
+    std::vector<std::string> patterns;
+    for (size_t i = 0; i < widths.size(); i += 10) {
+        std::string pattern;
+        for (size_t k = i; k < i + 9 && k < widths.size(); ++k) {
+            pattern += widths[k] == wide ? 'w' : (widths[k] == 1 ? 'n' : '?');
+        }
+        // Characters are separated by one narrow space.
+        if (i + 9 < widths.size() && widths[i + 9] != 1) {
+            pattern += '?';
+        }
+        patterns.push_back(pattern);
+    }
+    return patterns;
+}
+
+void testCode39() {
+    // Reference patterns from the specification.
+    static const struct { char c; const char *pattern; } kReference[] = {
+        { '0', "nnnwwnwnn" }, { '1', "wnnwnnnnw" }, { 'A', "wnnnnwnnw" }, { 'Z', "nwwnwnnnn" },
+        { '-', "nwnnnnwnw" }, { '$', "nwnwnwnnn" }, { '%', "nnnwnwnwn" }, { '.', "wwnnnnwnn" },
+        { ' ', "nwwnnnwnn" }, { '9', "nnwwnnwnn" }, { 'J', "nnnnwwwnn" }, { 'M', "wnwnnnnwn" }
+    };
+    Options options;
+    Symbol symbol;
+    CHECK(encodeCode(SymbologyCode39, kCode39Alphabet, options, &symbol) && symbol.quietZone == 10);
+    std::vector<std::string> patterns = code39Patterns(rowOf(symbol), 3);
+    CHECK(patterns.size() == 45);
+    std::string alphabet = std::string("*") + kCode39Alphabet;
+    std::vector<std::string> table(alphabet.size());
+    for (size_t i = 0; i + 1 < patterns.size() && i < table.size(); ++i) {
+        table[i] = patterns[i];
+        unsigned wideCount = 0;
+        for (size_t k = 0; k < patterns[i].size(); ++k) {
+            wideCount += patterns[i][k] == 'w';
+        }
+        CHECK(patterns[i].size() == 9 && wideCount == 3);
+        for (size_t k = 0; k < i; ++k) {
+            CHECK(patterns[k] != patterns[i]);
+        }
+    }
+    CHECK(patterns.back() == table[0]); // stop
+    for (size_t i = 0; i < sizeof(kReference) / sizeof(kReference[0]); ++i) {
+        size_t index = alphabet.find(kReference[i].c);
+        CHECK(index < table.size() && table[index] == kReference[i].pattern);
+    }
+    CHECK(table[0] == "nwnnwnwnn");
+
+    // Decode with the table just verified, with the check character and a 2:1 ratio.
+    options.code39CheckCharacter = true;
+    options.wideRatio = 2;
+    const std::string code = "CODE 39-X";
+    CHECK(encodeCode(SymbologyCode39, code, options, &symbol));
+    patterns = code39Patterns(rowOf(symbol), 2);
+    std::string decoded;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        size_t index = 0;
+        while (index < table.size() && table[index] != patterns[i]) {
+            ++index;
+        }
+        decoded += index < table.size() ? alphabet[index] : '?';
+    }
+    unsigned sum = 0;
+    for (size_t i = 0; i < code.size(); ++i) {
+        sum += (unsigned)(strchr(kCode39Alphabet, code[i]) - kCode39Alphabet);
+    }
+    CHECK(decoded == "*" + code + kCode39Alphabet[sum % 43] + "*");
+
+    CHECK(encodeError(SymbologyCode39, "abc") == ErrorCharacters);
+    CHECK(encodeError(SymbologyCode39, "A*B") == ErrorCharacters);
+    CHECK(encodeError(SymbologyCode39, "") == ErrorLength);
+}
+
+// Code 128 element widths by symbol value, from the specification; 103-105 are Start A/B/C.
+const char *const kCode128[106] = {
+    "212222", "222122", "222221", "121223", "121322", "131222", "122213", "122312", "132212", "221213",
+    "221312", "231212", "112232", "122132", "122231", "113222", "123122", "123221", "223211", "221132",
+    "221231", "213212", "223112", "312131", "311222", "321122", "321221", "312212", "322112", "322211",
+    "212123", "212321", "232121", "111323", "131123", "131321", "112313", "132113", "132311", "211313",
+    "231113", "231311", "112133", "112331", "132131", "113123", "113321", "133121", "313121", "211331",
+    "231131", "213113", "213311", "213131", "311123", "311321", "331121", "312113", "312311", "332111",
+    "314111", "221411", "431111", "111224", "111422", "121124", "121421", "141122", "141221", "112214",
+    "112412", "122114", "122411", "142112", "142211", "241211", "221114", "413111", "241112", "134111",
+    "111242", "121142", "121241", "114212", "124112", "124211", "411212", "421112", "421211", "212141",
+    "214121", "412121", "111143", "111341", "131141", "114113", "114311", "411113", "411311", "113141",
+    "114131", "311141", "411131", "211412", "211214", "211232"
+};
+
+std::string widthsToBits(const char *widths) {
+    std::string bits;
+    for (bool dark = true; *widths; ++widths, dark = !dark) {
+        bits.append((size_t)(*widths - '0'), dark ? '1' : '0');
+    }
+    return bits;
+}
+
+// Decodes a Code 128 row; the number of symbol values (without the check) goes to symbols.
+bool decodeCode128(const std::string &row, std::string *out, size_t *symbols) {
+    const std::string stop = widthsToBits("2331112");
+    if (row.size() < stop.size() + 33 || row.compare(row.size() - stop.size(), stop.size(), stop) != 0 ||
+            (row.size() - stop.size()) % 11 != 0) {
+        return false;
+    }
+    std::vector<int> values;
+    for (size_t i = 0; i + stop.size() < row.size(); i += 11) {
+        int value = -1;
+        for (int v = 0; v < 106 && value < 0; ++v) {
+            if (row.compare(i, 11, widthsToBits(kCode128[v])) == 0) {
+                value = v;
+            }
+        }
+        if (value < 0) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    int check = values.back();
+    values.pop_back();
+    unsigned sum = (unsigned)values[0];
+    for (size_t i = 1; i < values.size(); ++i) {
+        sum += (unsigned)values[i] * (unsigned)i;
+    }
+    if (values[0] < 103 || (int)(sum % 103) != check) {
+        return false;
+    }
+    char set = (char)('A' + values[0] - 103);
+    out->clear();
+    for (size_t i = 1; i < values.size(); ++i) {
+        int v = values[i];
+        if (set == 'C' && v < 100) {
+            *out += (char)('0' + v / 10);
+            *out += (char)('0' + v % 10);
+        } else if (v == 99) {
+            set = 'C';
+        } else if (v == 100 && set != 'B') {
+            set = 'B';
+        } else if (v == 101 && set != 'A') {
+            set = 'A';
+        } else if (v >= 96) {
+            return false; // FNC and shift symbols are not produced
+        } else if (set == 'A') {
+            *out += (char)(v < 64 ? v + 32 : v - 64);
+        } else {
+            *out += (char)(v + 32);
+        }
+    }
+    *symbols = values.size();
+    return true;
+}
+
+void testCode128() {
+    // Every pattern is 11 modules with an even dark width, and they are all different.
+    for (int v = 0; v < 106; ++v) {
+        const char *p = kCode128[v];
+        CHECK(strlen(p) == 6 && (p[0] + p[2] + p[4] - 3 * '0') % 2 == 0);
+        CHECK(widthsToBits(p).size() == 11);
+        for (int k = 0; k < v; ++k) {
+            CHECK(strcmp(kCode128[k], p) != 0);
+        }
+    }
+    static const struct { int value; const char *bits; } kKnown[] = {
+        { 0, "11011001100" }, { 16, "10011101100" }, { 33, "10100011000" }, { 65, "10010110000" },
+        { 99, "10111011110" }, { 100, "10111101110" }, { 101, "11101011110" }, { 103, "11010000100" },
+        { 104, "11010010000" }, { 105, "11010011100" }
+    };
+    for (size_t i = 0; i < sizeof(kKnown) / sizeof(kKnown[0]); ++i) {
+        CHECK(widthsToBits(kCode128[kKnown[i].value]) == kKnown[i].bits);
+    }
+
+    Options options;
+    Symbol symbol;
+    std::string decoded;
+    size_t symbols;
+    const char *const fixed[] = {
+        "A", "12", "123", "1234", "12345", "ABC1234567", "abc\001def", "x123456y", "0123456789012",
+        "Hello, World!", "\t\n", "a\177b"
+    };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); ++i) {
+        CHECK(encodeCode(SymbologyCode128, fixed[i], options, &symbol) && symbol.quietZone == 10);
+        CHECK(decodeCode128(rowOf(symbol), &decoded, &symbols) && decoded == fixed[i]);
+    }
+    // Set C packs digit pairs: start, 10 pairs.
+    CHECK(encodeCode(SymbologyCode128, "12345678901234567890", options, &symbol));
+    CHECK(decodeCode128(rowOf(symbol), &decoded, &symbols) && symbols == 11);
+
+    scanditsdk::test::Random random(3);
+    const char *const alphabets[] = { "0123456789", "0123456789AB", "abc019\003", NULL };
+    for (int n = 0; n < 2000; ++n) {
+        size_t length = 1 + random.below(40);
+        const char *alphabet = alphabets[random.below(4)];
+        std::string code;
+        if (alphabet != NULL) {
+            code = randomString(random, alphabet, length);
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                code += (char)(1 + random.below(127));
+            }
+        }
+        CHECK(encodeCode(SymbologyCode128, code, options, &symbol));
+        CHECK(decodeCode128(rowOf(symbol), &decoded, &symbols) && decoded == code);
+    }
+    CHECK(encodeError(SymbologyCode128, "") == ErrorLength);
+    CHECK(encodeError(SymbologyCode128, "caf\xe9") == ErrorCharacters);
+}
+
+// ITF: pairs of digits, the first in the bars and the second in the spaces.
+const char *const kITF[10] = {
+    "nnwwn", "wnnnw", "nwnnw", "wwnnn", "nnwnw", "wnwnn", "nwwnn", "nnnww", "wnnwn", "nwnwn"
+};
+
+std::string decodeITF(const std::string &row, unsigned wide) {
+    std::vector<unsigned> widths = elementWidths(row);
+    if (widths.size() < 17 || (widths.size() - 7) % 10 != 0) {
+        return std::string();
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        if (widths[i] != 1) {
+            return std::string();
+        }
+    }
+    size_t end = widths.size() - 3;
+    if (widths[end] != wide || widths[end + 1] != 1 || widths[end + 2] != 1) {
+        return std::string();
+    }
+    std::string digits;
+    for (size_t i = 4; i < end; i += 10) {
+        for (size_t first = 0; first < 2; ++first) {
+            std::string pattern;
+            for (size_t k = 0; k < 5; ++k) {
+                unsigned w = widths[i + first + 2 * k];
+                pattern += w == wide ? 'w' : (w == 1 ? 'n' : '?');
+            }
+            int digit = indexOf(kITF, 10, pattern);
+            if (digit < 0) {
+                return std::string();
+            }
+            digits += (char)('0' + digit);
+        }
+    }
+    return digits;
+}
+
+void testITF() {
+    scanditsdk::test::Random random(4);
+    Options options;
+    Symbol symbol;
+    static const size_t kLengths[] = { 2, 4, 6, 10, 14, 20 };
+    for (int n = 0; n < 200; ++n) {
+        std::string code = randomString(random, kDigits, kLengths[random.below(6)]);
+        CHECK(encodeCode(SymbologyITF, code, options, &symbol) && symbol.quietZone == 10);
+        CHECK(decodeITF(rowOf(symbol), 3) == code);
+        std::string itf14 = randomString(random, kDigits, 13);
+        CHECK(encodeCode(SymbologyITF, itf14, options, &symbol));
+        CHECK(decodeITF(rowOf(symbol), 3) == itf14 + gs1Check(itf14));
+    }
+    options.wideRatio = 2;
+    CHECK(encodeCode(SymbologyITF, "1234567890", options, &symbol));
+    CHECK(decodeITF(rowOf(symbol), 2) == "1234567890");
+    CHECK(encodeError(SymbologyITF, "123") == ErrorLength);
+    CHECK(encodeError(SymbologyITF, "") == ErrorLength);
+    CHECK(encodeError(SymbologyITF, "12a4") == ErrorCharacters);
+}
+
+// Reed-Solomon over GF(256)
+
+struct Field {
+    uint8_t exp[512];
+    uint8_t log[256];
+
+    explicit Field(unsigned polynomial) {
+        unsigned x = 1;
+        for (int i = 0; i < 255; ++i) {
+            exp[i] = exp[i + 255] = (uint8_t)x;
+            log[x] = (uint8_t)i;
+            x = (x << 1) ^ ((x & 0x80) ? polynomial : 0);
+        }
+        exp[510] = exp[0];
+        exp[511] = exp[1];
+    }
+
+    uint8_t multiply(uint8_t a, uint8_t b) const {
+        return (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+    }
+
+    // True if the codeword (highest power first) evaluates to 0 at a^first .. a^(first + count - 1).
+    bool syndromesZero(const std::vector<uint8_t> &codeword, unsigned first, unsigned count) const {
+        for (unsigned j = first; j < first + count; ++j) {
+            uint8_t value = 0;
+            for (size_t i = 0; i < codeword.size(); ++i) {
+                value = multiply(value, exp[j % 255]) ^ codeword[i];
+            }
+            if (value != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+const Field kQRField(0x11D);
+const Field kDataMatrixField(0x12D);
+
+// QR
+
+// ISO/IEC 18004 table 9, by level (L, M, Q, H) and version.
+const uint8_t kQREcc[4][41] = {
+    { 0, 7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28, 28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30 },
+    { 0, 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26, 26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28 },
+    { 0, 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30, 28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30 },
+    { 0, 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28, 30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30 }
+};
+const uint8_t kQRBlocks[4][41] = {
+    { 0, 1, 1, 1, 1, 1, 2, 2, 2, 2, 4, 4, 4, 4, 4, 6, 6, 6, 6, 7, 8, 8, 9, 9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25 },
+    { 0, 1, 1, 1, 2, 2, 4, 4, 4, 5, 5, 5, 8, 9, 9, 10, 10, 11, 13, 14, 16, 17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49 },
+    { 0, 1, 1, 2, 2, 4, 4, 6, 6, 8, 8, 8, 10, 12, 16, 12, 17, 16, 18, 21, 20, 23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68 },
+    { 0, 1, 1, 2, 4, 4, 4, 5, 6, 8, 8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25, 25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81 }
+};
+const char kQRAlphanumeric[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+// Remainder of value << degree divided by the generator polynomial, for the format and version.
+unsigned bchRemainder(unsigned value, unsigned degree, unsigned generator) {
+    unsigned remainder = value << degree;
+    for (int bit = 31; bit >= (int)degree; --bit) {
+        if (remainder & (1u << bit)) {
+            remainder ^= generator << (bit - degree);
+        }
+    }
+    return remainder;
+}
+
+unsigned qrFormatBits(unsigned levelBits, unsigned mask) {
+    unsigned data = levelBits << 3 | mask;
+    return (data << 10 | bchRemainder(data, 10, 0x537)) ^ 0x5412;
+}
+
+// Alignment pattern centers: 6, then evenly spaced back from size - 7 by an even step.
+std::vector<unsigned> qrAlignmentCenters(unsigned version) {
+    std::vector<unsigned> centers;
+    if (version > 1) {
+        unsigned count = version / 7 + 2;
+        unsigned last = version * 4 + 10;
+        unsigned step = (last - 6 + count - 2) / (count - 1);
+        step += step % 2;
+        if (version == 32) {
+            step = 26; // the standard's exception to the rule
+        }
+        centers.push_back(6);
+        for (unsigned i = 1; i < count; ++i) {
+            centers.insert(centers.begin() + 1, last - (i - 1) * step);
+        }
+    }
+    return centers;
+}
+
+unsigned takeBits(const std::vector<uint8_t> &data, size_t *position, unsigned count) {
+    unsigned value = 0;
+    for (unsigned i = 0; i < count; ++i, ++*position) {
+        value = value << 1 | ((data[*position / 8] >> (7 - *position % 8)) & 1);
+    }
+    return value;
+}
+
+struct QRReading {
+    unsigned version;
+    QRLevel level;
+    unsigned mask;
+    std::string text;
+};
+
+class QRReader {
+public:
+    explicit QRReader(const Symbol &symbol) : symbol_(symbol), size_(symbol.width) {}
+
+    // Empty error on success.
+    std::string read(QRReading *out) {
+        if (size_ != symbol_.height || size_ < 21 || size_ > 177 || (size_ - 17) % 4 != 0) {
+            return "size";
+        }
+        version_ = (size_ - 17) / 4;
+        out->version = version_;
+        std::string error = checkFunctionPatterns();
+        if (error.empty()) error = readFormat(out);
+        if (error.empty()) error = readVersion();
+        if (error.empty()) error = readCodewords(out);
+        return error;
+    }
+
+private:
+    bool dark(unsigned x, unsigned y) const { return symbol_.dark(x, y); }
+
+    bool isFunction(unsigned x, unsigned y) const {
+        if ((x < 9 && y < 9) || (x >= size_ - 8 && y < 9) || (x < 9 && y >= size_ - 8)) {
+            return true; // finders, separators, format information
+        }
+        if (x == 6 || y == 6) {
+            return true;
+        }
+        if (version_ >= 7 && ((x >= size_ - 11 && y < 6) || (y >= size_ - 11 && x < 6))) {
+            return true;
+        }
+        for (size_t i = 0; i < centers_.size(); ++i) {
+            for (size_t j = 0; j < centers_.size(); ++j) {
+                unsigned cx = centers_[i], cy = centers_[j];
+                if (cx + 2 >= x && x + 2 >= cx && cy + 2 >= y && y + 2 >= cy &&
+                        !((cx < 9 && cy < 9) || (cx >= size_ - 9 && cy < 9) || (cx < 9 && cy >= size_ - 9))) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    std::string checkFunctionPatterns() {
+        centers_ = qrAlignmentCenters(version_);
+        static const unsigned kOrigins[3][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 } };
+        for (int f = 0; f < 3; ++f) {
+            unsigned ox = kOrigins[f][0] ? size_ - 7 : 0, oy = kOrigins[f][1] ? size_ - 7 : 0;
+            for (unsigned y = 0; y < 7; ++y) {
+                for (unsigned x = 0; x < 7; ++x) {
+                    unsigned ring = std::max(std::max(x, 6 - x), std::max(y, 6 - y));
+                    if (dark(ox + x, oy + y) != (ring != 5)) {
+                        return "finder";
+                    }
+                }
+            }
+        }
+        for (unsigned i = 8; i < size_ - 8; ++i) {
+            if (dark(i, 6) != (i % 2 == 0) || dark(6, i) != (i % 2 == 0)) {
+                return "timing";
+            }
+        }
+        for (size_t i = 0; i < centers_.size(); ++i) {
+            for (size_t j = 0; j < centers_.size(); ++j) {
+                unsigned cx = centers_[i], cy = centers_[j];
+                if ((cx < 9 && cy < 9) || (cx >= size_ - 9 && cy < 9) || (cx < 9 && cy >= size_ - 9)) {
+                    continue;
+                }
+                for (int dy = -2; dy <= 2; ++dy) {
+                    for (int dx = -2; dx <= 2; ++dx) {
+                        bool ring = std::max(abs(dx), abs(dy)) == 1;
+                        if (dark(cx + dx, cy + dy) == ring) {
+                            return "alignment";
+                        }
+                    }
+                }
+            }
+        }
+        return dark(8, size_ - 8) ? std::string() : "dark module";
+    }
+
+    std::string readFormat(QRReading *out) {
+        unsigned first = 0, second = 0;
+        for (unsigned i = 0; i < 15; ++i) {
+            // Around the top left finder: up column 8, then left along row 8.
+            unsigned x = i < 8 ? 8 : (i == 8 ? 7 : 14 - i);
+            unsigned y = i < 6 ? i : (i < 8 ? i + 1 : 8);
+            first |= (unsigned)dark(x, y) << i;
+            // Split between the other two finders.
+            if (i < 8) {
+                second |= (unsigned)dark(size_ - 1 - i, 8) << i;
+            } else {
+                second |= (unsigned)dark(8, size_ - 15 + i) << i;
+            }
+        }
+        if (first != second) {
+            return "format copies differ";
+        }
+        static const QRLevel kLevels[4] = { QRLevelM, QRLevelL, QRLevelH, QRLevelQ };
+        for (unsigned data = 0; data < 32; ++data) {
+            if (qrFormatBits(data >> 3, data & 7) == first) {
+                out->level = kLevels[data >> 3];
+                out->mask = data & 7;
+                mask_ = data & 7;
+                level_ = out->level;
+                return std::string();
+            }
+        }
+        return "format BCH";
+    }
+
+    std::string readVersion() {
+        if (version_ < 7) {
+            return std::string();
+        }
+        unsigned bottomLeft = 0, topRight = 0;
+        for (unsigned i = 0; i < 18; ++i) {
+            topRight |= (unsigned)dark(size_ - 11 + i % 3, i / 3) << i;
+            bottomLeft |= (unsigned)dark(i / 3, size_ - 11 + i % 3) << i;
+        }
+        unsigned expected = version_ << 12 | bchRemainder(version_, 12, 0x1F25);
+        return (topRight == expected && bottomLeft == expected) ? std::string() : "version BCH";
+    }
+
+    bool masked(unsigned x, unsigned y) const {
+        unsigned i = y, j = x; // row, column
+        switch (mask_) {
+            case 0: return (i + j) % 2 == 0;
+            case 1: return i % 2 == 0;
+            case 2: return j % 3 == 0;
+            case 3: return (i + j) % 3 == 0;
+            case 4: return (i / 2 + j / 3) % 2 == 0;
+            case 5: return (i * j) % 2 + (i * j) % 3 == 0;
+            case 6: return ((i * j) % 2 + (i * j) % 3) % 2 == 0;
+            default: return ((i + j) % 2 + (i * j) % 3) % 2 == 0;
+        }
+    }
+
+    std::string readCodewords(QRReading *out) {
+        // Two-column strips from the right, alternately upwards and downwards.
+        std::vector<uint8_t> bits;
+        int direction = -1;
+        unsigned y = size_ - 1;
+        for (int right = (int)size_ - 1; right > 0; right -= 2) {
+            if (right == 6) {
+                right = 5;
+            }
+            for (;;) {
+                for (int c = 0; c < 2; ++c) {
+                    unsigned x = (unsigned)(right - c);
+                    if (!isFunction(x, y)) {
+                        bits.push_back((uint8_t)(dark(x, y) != masked(x, y)));
+                    }
+                }
+                if ((direction < 0 && y == 0) || (direction > 0 && y == size_ - 1)) {
+                    direction = -direction;
+                    break;
+                }
+                y += direction;
+            }
+        }
+        static const unsigned kRemainderBits[41] = {
+            0, 0, 7, 7, 7, 7, 7, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3,
+            4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 0, 0, 0
+        };
+        if (bits.size() % 8 != kRemainderBits[version_]) {
+            return "data module count";
+        }
+        std::vector<uint8_t> codewords(bits.size() / 8, 0);
+        for (size_t i = 0; i < codewords.size() * 8; ++i) {
+            codewords[i / 8] |= (uint8_t)(bits[i] << (7 - i % 8));
+        }
+        for (size_t i = codewords.size() * 8; i < bits.size(); ++i) {
+            if (bits[i]) {
+                return "remainder bits";
+            }
+        }
+
+        // De-interleave: data codewords round robin over the blocks, then their error correction.
+        unsigned blocks = kQRBlocks[level_][version_], ecc = kQREcc[level_][version_];
+        unsigned total = (unsigned)codewords.size();
+        unsigned shortBlocks = blocks - total % blocks;
+        unsigned shortData = total / blocks - ecc;
+        std::vector<std::vector<uint8_t> > blockData(blocks);
+        size_t next = 0;
+        for (unsigned i = 0; i <= shortData; ++i) {
+            for (unsigned b = 0; b < blocks; ++b) {
+                if (i < shortData || b >= shortBlocks) {
+                    blockData[b].push_back(codewords[next++]);
+                }
+            }
+        }
+        std::vector<uint8_t> data;
+        for (unsigned b = 0; b < blocks; ++b) {
+            data.insert(data.end(), blockData[b].begin(), blockData[b].end());
+        }
+        for (unsigned i = 0; i < ecc; ++i) {
+            for (unsigned b = 0; b < blocks; ++b) {
+                blockData[b].push_back(codewords[next++]);
+            }
+        }
+        for (unsigned b = 0; b < blocks; ++b) {
+            if (!kQRField.syndromesZero(blockData[b], 0, ecc)) {
+                return "syndromes";
+            }
+        }
+        return parseSegment(data, &out->text);
+    }
+
+    std::string parseSegment(const std::vector<uint8_t> &data, std::string *text) const {
+        size_t position = 0, bitCount = data.size() * 8;
+        unsigned mode = takeBits(data, &position, 4);
+        unsigned sizeClass = version_ <= 9 ? 0 : (version_ <= 26 ? 1 : 2);
+        static const unsigned kCountBits[3][3] = { { 10, 12, 14 }, { 9, 11, 13 }, { 8, 16, 16 } };
+        int modeIndex = mode == 1 ? 0 : (mode == 2 ? 1 : (mode == 4 ? 2 : -1));
+        if (modeIndex < 0) {
+            return "mode";
+        }
+        unsigned count = takeBits(data, &position, kCountBits[modeIndex][sizeClass]);
+        text->clear();
+        while (text->size() < count) {
+            size_t left = count - text->size();
+            if (mode == 1) {
+                unsigned n = left >= 3 ? 3 : (unsigned)left;
+                if (position + n * 3 + 1 > bitCount) {
+                    return "truncated";
+                }
+                unsigned value = takeBits(data, &position, n * 3 + 1);
+                if (value >= (n == 3 ? 1000u : (n == 2 ? 100u : 10u))) {
+                    return "numeric value";
+                }
+                char digits[4];
+                snprintf(digits, sizeof(digits), "%0*u", (int)n, value);
+                text->append(digits, n);
+            } else if (mode == 2) {
+                unsigned n = left >= 2 ? 11 : 6;
+                if (position + n > bitCount) {
+                    return "truncated";
+                }
+                unsigned value = takeBits(data, &position, n);
+                if (n == 11) {
+                    if (value >= 45 * 45) {
+                        return "alphanumeric value";
+                    }
+                    *text += kQRAlphanumeric[value / 45];
+                    *text += kQRAlphanumeric[value % 45];
+                } else {
+                    if (value >= 45) {
+                        return "alphanumeric value";
+                    }
+                    *text += kQRAlphanumeric[value];
+                }
+            } else {
+                if (position + 8 > bitCount) {
+                    return "truncated";
+                }
+                *text += (char)takeBits(data, &position, 8);
+            }
+        }
+        // Terminator (shortened at the end), zero bits to the byte, then 0xEC 0x11 pads.
+        unsigned terminator = bitCount - position < 4 ? (unsigned)(bitCount - position) : 4;
+        if (takeBits(data, &position, terminator) != 0) {
+            return "terminator";
+        }
+        if (takeBits(data, &position, (unsigned)((8 - position % 8) % 8)) != 0) {
+            return "bit padding";
+        }
+        for (unsigned pad = 0xEC; position < bitCount; pad ^= 0xEC ^ 0x11) {
+            if (takeBits(data, &position, 8) != pad) {
+                return "pad codewords";
+            }
+        }
+        return std::string();
+    }
+
+    const Symbol &symbol_;
+    unsigned size_;
+    unsigned version_;
+    unsigned mask_;
+    QRLevel level_;
+    std::vector<unsigned> centers_;
+};
+
+bool readQR(const std::string &code, const Options &options, QRReading *reading) {
+    Symbol symbol;
+    if (!encodeCode(SymbologyQR, code, options, &symbol)) {
+        return false;
+    }
+    std::string error = QRReader(symbol).read(reading);
+    if (!error.empty()) {
+        fprintf(stderr, "QR of %lu bytes: %s\n", (unsigned long)code.size(), error.c_str());
+        return false;
+    }
+    return symbol.quietZone == 4;
+}
+
+unsigned qrDataCapacity(unsigned version, QRLevel level) {
+    unsigned size = version * 4 + 17;
+    unsigned modules = size * size - 3 * 64 - 2 * (size - 16) - 31; // finders, timing, format
+    if (version >= 2) {
+        unsigned count = version / 7 + 2;
+        modules -= (count * count - 3) * 25 - 2 * (count - 2) * 5; // alignments off the timing lines
+        if (version >= 7) {
+            modules -= 36;
+        }
+    }
+    return modules / 8 - kQREcc[level][version] * kQRBlocks[level][version];
+}
+
+void testQR() {
+    CHECK(qrFormatBits(1, 0) == 0x77C4); // L, mask 0
+    CHECK(qrFormatBits(0, 0) == 0x5412); // M, mask 0
+    CHECK((7u << 12 | bchRemainder(7, 12, 0x1F25)) == 0x07C94);
+    // Data codewords of ISO/IEC 18004 table 7.
+    static const unsigned kCapacity[][5] = {
+        { 1, 19, 16, 13, 9 }, { 2, 34, 28, 22, 16 }, { 5, 108, 86, 62, 46 }, { 7, 156, 124, 88, 66 },
+        { 10, 274, 216, 154, 122 }, { 21, 932, 714, 512, 406 }, { 40, 2956, 2334, 1666, 1276 }
+    };
+    for (size_t i = 0; i < sizeof(kCapacity) / sizeof(kCapacity[0]); ++i) {
+        for (int level = 0; level < 4; ++level) {
+            CHECK(qrDataCapacity(kCapacity[i][0], (QRLevel)level) == kCapacity[i][1 + level]);
+        }
+    }
+
+    static const struct { unsigned version; unsigned centers[7]; } kAlignment[] = {
+        { 2, { 6, 18 } }, { 7, { 6, 22, 38 } }, { 15, { 6, 26, 48, 70 } }, { 32, { 6, 34, 60, 86, 112, 138 } },
+        { 36, { 6, 24, 50, 76, 102, 128, 154 } }, { 40, { 6, 30, 58, 86, 114, 142, 170 } }
+    };
+    for (size_t i = 0; i < sizeof(kAlignment) / sizeof(kAlignment[0]); ++i) {
+        std::vector<unsigned> centers = qrAlignmentCenters(kAlignment[i].version);
+        CHECK(centers.size() == kAlignment[i].version / 7 + 2);
+        for (size_t k = 0; k < centers.size() && k < 7; ++k) {
+            CHECK(centers[k] == kAlignment[i].centers[k]);
+        }
+    }
+
+    scanditsdk::test::Random random(5);
+    QRReading reading;
+    static const size_t kLengths[] = { 0, 1, 5, 14, 17, 30, 60, 100, 150, 250, 400, 700, 1000, 1500, 2000, 2300 };
+    static const char *const kAlphabets[] = { "0123456789", "0123456789ABCXYZ $%*+-./:", "abcxyz0129-/?&=" };
+    // Characters of version 40 (table 7) in numeric, alphanumeric and byte mode by level.
+    static const size_t kVersion40Limits[3][4] = {
+        { 7089, 5596, 3993, 3057 }, { 4296, 3391, 2420, 1852 }, { 2953, 2331, 1663, 1273 }
+    };
+    for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l) {
+        for (int level = 0; level < 4; ++level) {
+            for (int alphabet = 0; alphabet < 3; ++alphabet) {
+                std::string code = randomString(random, kAlphabets[alphabet], kLengths[l]);
+                Options options;
+                options.qrLevel = (QRLevel)level;
+                options.qrMask = kLengths[l] > 300 ? -1 : (int)random.below(9) - 1;
+                if (kLengths[l] > kVersion40Limits[alphabet][level]) {
+                    CHECK(encodeError(SymbologyQR, code, options) == ErrorCapacity);
+                    continue;
+                }
+                CHECK(readQR(code, options, &reading) && reading.text == code);
+                CHECK(reading.level == options.qrLevel);
+                CHECK(options.qrMask < 0 || reading.mask == (unsigned)options.qrMask);
+            }
+        }
+    }
+    std::string bytes;
+    for (int c = 0; c < 256; ++c) {
+        bytes += (char)c;
+    }
+    CHECK(readQR(bytes, Options(), &reading) && reading.text == bytes);
+
+    // Smallest version: the characters of version 1 (table 7) fit, one more needs version 2.
+    static const struct { const char *alphabet; QRLevel level; size_t fits; } kVersion1[] = {
+        { "0123456789", QRLevelL, 41 }, { "0123456789", QRLevelH, 17 }, { "ABC123", QRLevelQ, 16 },
+        { "ABC123", QRLevelL, 25 }, { "abc", QRLevelM, 14 }, { "abc", QRLevelH, 7 }
+    };
+    for (size_t i = 0; i < sizeof(kVersion1) / sizeof(kVersion1[0]); ++i) {
+        Options options;
+        options.qrLevel = kVersion1[i].level;
+        std::string code = randomString(random, kVersion1[i].alphabet, kVersion1[i].fits);
+        CHECK(readQR(code, options, &reading) && reading.version == 1);
+        CHECK(readQR(code + kVersion1[i].alphabet[0], options, &reading) && reading.version == 2);
+    }
+    // Largest version (table 7): the limit fits, one more does not.
+    static const struct { const char *alphabet; QRLevel level; size_t limit; } kVersion40[] = {
+        { "0123456789", QRLevelL, 7089 }, { "ABC123", QRLevelL, 4296 }, { "abc", QRLevelL, 2953 },
+        { "0123456789", QRLevelH, 3057 }, { "ABC123", QRLevelH, 1852 }, { "abc", QRLevelH, 1273 }
+    };
+    for (size_t i = 0; i < sizeof(kVersion40) / sizeof(kVersion40[0]); ++i) {
+        Options options;
+        options.qrLevel = kVersion40[i].level;
+        std::string code = randomString(random, kVersion40[i].alphabet, kVersion40[i].limit);
+        CHECK(readQR(code, options, &reading) && reading.version == 40 && reading.text == code);
+        CHECK(encodeError(SymbologyQR, code + kVersion40[i].alphabet[0], options) == ErrorCapacity);
+    }
+}
+
+// Data Matrix
+
+struct DataMatrixSize {
+    unsigned size, region, data, ecc, blocks;
+};
+
+// ISO/IEC 16022 table 7, square symbols.
+const DataMatrixSize kDataMatrixSizes[] = {
+    { 10, 8, 3, 5, 1 }, { 12, 10, 5, 7, 1 }, { 14, 12, 8, 10, 1 }, { 16, 14, 12, 12, 1 },
+    { 18, 16, 18, 14, 1 }, { 20, 18, 22, 18, 1 }, { 22, 20, 30, 20, 1 }, { 24, 22, 36, 24, 1 },
+    { 26, 24, 44, 28, 1 }, { 32, 14, 62, 36, 1 }, { 36, 16, 86, 42, 1 }, { 40, 18, 114, 48, 1 },
+    { 44, 20, 144, 56, 1 }, { 48, 22, 174, 68, 1 }, { 52, 24, 204, 84, 2 }, { 64, 14, 280, 112, 2 },
+    { 72, 16, 368, 144, 4 }, { 80, 18, 456, 192, 4 }, { 88, 20, 576, 224, 4 }, { 96, 22, 696, 272, 4 },
+    { 104, 24, 816, 336, 6 }, { 120, 18, 1050, 408, 6 }, { 132, 20, 1304, 496, 8 }, { 144, 22, 1558, 620, 10 }
+};
+
+// The annex F placement as a map from mapping matrix cells to codeword bits.
+class DataMatrixMap {
+public:
+    explicit DataMatrixMap(int side) : n_(side), codeword_((size_t)(side * side), -1),
+            bit_((size_t)(side * side), 0), count_(0) {
+        int r = 4, c = 0;
+        do {
+            if (r == n_ && c == 0) corner(kCornerA);
+            if (r == n_ - 2 && c == 0 && n_ % 4 != 0) corner(kCornerB);
+            if (r == n_ - 2 && c == 0 && n_ % 8 == 4) corner(kCornerC);
+            if (r == n_ + 4 && c == 2 && n_ % 8 == 0) corner(kCornerD);
+            do {
+                if (r < n_ && c >= 0 && codeword_[(size_t)(r * n_ + c)] < 0) utah(r, c);
+                r -= 2;
+                c += 2;
+            } while (r >= 0 && c < n_);
+            r += 1;
+            c += 3;
+            do {
+                if (r >= 0 && c < n_ && codeword_[(size_t)(r * n_ + c)] < 0) utah(r, c);
+                r += 2;
+                c -= 2;
+            } while (r < n_ && c >= 0);
+            r += 3;
+            c += 1;
+        } while (r < n_ || c < n_);
+    }
+
+    int count() const { return count_; }
+    int codeword(int r, int c) const { return codeword_[(size_t)(r * n_ + c)]; }
+    int bit(int r, int c) const { return bit_[(size_t)(r * n_ + c)]; }
+
+private:
+    // Corner shapes as (row, column) with negative values counted from the far edge, bit 7 first.
+    static const int kCornerA[8][2], kCornerB[8][2], kCornerC[8][2], kCornerD[8][2];
+
+    void module(int r, int c, int bit) {
+        if (r < 0) {
+            r += n_;
+            c += 4 - ((n_ + 4) % 8);
+        }
+        if (c < 0) {
+            c += n_;
+            r += 4 - ((n_ + 4) % 8);
+        }
+        codeword_[(size_t)(r * n_ + c)] = count_;
+        bit_[(size_t)(r * n_ + c)] = bit;
+    }
+
+    void utah(int r, int c) {
+        static const int kShape[8][2] = { { -2, -2 }, { -2, -1 }, { -1, -2 }, { -1, -1 }, { -1, 0 }, { 0, -2 }, { 0, -1 }, { 0, 0 } };
+        for (int i = 0; i < 8; ++i) {
+            module(r + kShape[i][0], c + kShape[i][1], 7 - i);
+        }
+        ++count_;
+    }
+
+    void corner(const int shape[8][2]) {
+        for (int i = 0; i < 8; ++i) {
+            int r = shape[i][0] < 0 ? n_ + shape[i][0] : shape[i][0];
+            int c = shape[i][1] < 0 ? n_ + shape[i][1] : shape[i][1];
+            module(r, c, 7 - i);
+        }
+        ++count_;
+    }
+
+    int n_;
+    std::vector<int> codeword_;
+    std::vector<int> bit_;
+    int count_;
+};
+
+const int DataMatrixMap::kCornerA[8][2] = { { -1, 0 }, { -1, 1 }, { -1, 2 }, { 0, -2 }, { 0, -1 }, { 1, -1 }, { 2, -1 }, { 3, -1 } };
+const int DataMatrixMap::kCornerB[8][2] = { { -3, 0 }, { -2, 0 }, { -1, 0 }, { 0, -4 }, { 0, -3 }, { 0, -2 }, { 0, -1 }, { 1, -1 } };
+const int DataMatrixMap::kCornerC[8][2] = { { -3, 0 }, { -2, 0 }, { -1, 0 }, { 0, -2 }, { 0, -1 }, { 1, -1 }, { 2, -1 }, { 3, -1 } };
+const int DataMatrixMap::kCornerD[8][2] = { { -1, 0 }, { -1, -1 }, { 0, -3 }, { 0, -2 }, { 0, -1 }, { 1, -3 }, { 1, -2 }, { 1, -1 } };
+
+// Reads the codewords of a symbol; empty error on success.
+std::string readDataMatrix(const Symbol &symbol, const DataMatrixSize **sizeOut, std::vector<uint8_t> *codewords) {
+    const DataMatrixSize *size = NULL;
+    for (size_t i = 0; i < sizeof(kDataMatrixSizes) / sizeof(kDataMatrixSizes[0]); ++i) {
+        if (kDataMatrixSizes[i].size == symbol.width) {
+            size = &kDataMatrixSizes[i];
+        }
+    }
+    if (size == NULL || symbol.height != symbol.width) {
+        return "size";
+    }
+    unsigned region = size->region, cell = region + 2;
+    for (unsigned y = 0; y < size->size; ++y) {
+        for (unsigned x = 0; x < size->size; ++x) {
+            unsigned ry = y % cell, rx = x % cell;
+            // Solid left and bottom edges, alternating top and right edges of every region.
+            if ((rx == 0 || ry == cell - 1) && !symbol.dark(x, y)) {
+                return "solid edge";
+            }
+            if (rx != 0 && ry == 0 && symbol.dark(x, y) != (rx % 2 == 0)) {
+                return "top edge";
+            }
+            if (rx == cell - 1 && ry != 0 && ry != cell - 1 && symbol.dark(x, y) != (ry % 2 == 1)) {
+                return "right edge";
+            }
+        }
+    }
+    int side = (int)(size->size / cell * region);
+    DataMatrixMap map(side);
+    if ((unsigned)map.count() != size->data + size->ecc) {
+        return "placement count";
+    }
+    codewords->assign((size_t)map.count(), 0);
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            bool dark = symbol.dark((unsigned)(c / (int)region * (int)cell + c % (int)region + 1),
+                                    (unsigned)(r / (int)region * (int)cell + r % (int)region + 1));
+            if (map.codeword(r, c) < 0) {
+                // The unused corner is a fixed checker: dark on the diagonal.
+                if (dark != ((side - 1 - r) == (side - 1 - c))) {
+                    return "fixed corner";
+                }
+            } else if (dark) {
+                (*codewords)[(size_t)map.codeword(r, c)] |= (uint8_t)(1 << map.bit(r, c));
+            }
+        }
+    }
+    *sizeOut = size;
+    return std::string();
+}
+
+bool dataMatrixSyndromesZero(const DataMatrixSize &size, const std::vector<uint8_t> &codewords) {
+    unsigned eccPerBlock = size.ecc / size.blocks;
+    for (unsigned b = 0; b < size.blocks; ++b) {
+        std::vector<uint8_t> block;
+        for (unsigned i = b; i < size.data; i += size.blocks) {
+            block.push_back(codewords[i]);
+        }
+        for (unsigned k = 0; k < eccPerBlock; ++k) {
+            block.push_back(codewords[size.data + b + k * size.blocks]);
+        }
+        if (!kDataMatrixField.syndromesZero(block, 1, eccPerBlock)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ASCII encodation, with the pad codewords checked against the 253-state randomizer.
+bool decodeDataMatrixASCII(const std::vector<uint8_t> &codewords, unsigned dataCount, std::string *out) {
+    out->clear();
+    unsigned i = 0;
+    while (i < dataCount) {
+        uint8_t c = codewords[i++];
+        if (c == 129) {
+            break;
+        }
+        if (c == 235) {
+            if (i == dataCount) {
+                return false;
+            }
+            *out += (char)(codewords[i++] - 1 + 128);
+        } else if (c >= 130 && c <= 229) {
+            *out += (char)('0' + (c - 130) / 10);
+            *out += (char)('0' + (c - 130) % 10);
+        } else if (c >= 1 && c <= 128) {
+            *out += (char)(c - 1);
+        } else {
+            return false;
+        }
+    }
+    for (; i < dataCount; ++i) {
+        unsigned pseudo = 149 * (i + 1) % 253 + 1;
+        unsigned pad = 129 + pseudo;
+        if (codewords[i] != (pad > 254 ? pad - 254 : pad)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool readDataMatrixCode(const std::string &code, std::string *text, const DataMatrixSize **size) {
+    Symbol symbol;
+    std::vector<uint8_t> codewords;
+    if (!encodeCode(SymbologyDataMatrix, code, Options(), &symbol)) {
+        return false;
+    }
+    std::string error = readDataMatrix(symbol, size, &codewords);
+    if (!error.empty()) {
+        fprintf(stderr, "Data Matrix of %lu bytes: %s\n", (unsigned long)code.size(), error.c_str());
+        return false;
+    }
+    return symbol.quietZone == 1 && dataMatrixSyndromesZero(**size, codewords) &&
+           decodeDataMatrixASCII(codewords, (*size)->data, text);
+}
+
+void testDataMatrix() {
+    // The example of ISO/IEC 16022 annex O.
+    Symbol symbol;
+    const DataMatrixSize *size = NULL;
+    std::vector<uint8_t> codewords;
+    CHECK(encodeCode(SymbologyDataMatrix, "123456", Options(), &symbol));
+    CHECK(readDataMatrix(symbol, &size, &codewords).empty() && size != NULL && size->size == 10);
+    static const uint8_t kExample[8] = { 142, 164, 186, 114, 25, 5, 88, 102 };
+    CHECK(codewords.size() == 8 && memcmp(&codewords[0], kExample, 8) == 0);
+
+    scanditsdk::test::Random random(1);
+    std::string text;
+    static const char *const kAlphabets[] = { "0123456789", "ABCxyz0129 -/", NULL };
+    std::vector<size_t> lengths;
+    for (size_t length = 0; length < 40; ++length) {
+        lengths.push_back(length);
+    }
+    static const size_t kLong[] = { 60, 100, 150, 200, 300, 500, 800, 1000, 1200, 1500, 1556, 1557, 1558, 2000, 3116 };
+    lengths.insert(lengths.end(), kLong, kLong + sizeof(kLong) / sizeof(kLong[0]));
+    unsigned read = 0;
+    for (size_t l = 0; l < lengths.size(); ++l) {
+        for (int kind = 0; kind < 3; ++kind) {
+            std::string code;
+            if (kAlphabets[kind] != NULL) {
+                code = randomString(random, kAlphabets[kind], lengths[l]);
+            } else {
+                for (size_t i = 0; i < lengths[l]; ++i) {
+                    code += (char)(32 + random.below(95));
+                }
+            }
+            if (encodeError(SymbologyDataMatrix, code) == ErrorCapacity) {
+                CHECK(lengths[l] > 1558 && (kind != 0 || lengths[l] > 3116));
+                continue;
+            }
+            CHECK(readDataMatrixCode(code, &text, &size) && text == code);
+            ++read;
+        }
+    }
+    CHECK(read > 140);
+    // Every size is reachable and the largest holds 3116 digits.
+    std::string digits = randomString(random, kDigits, 3116);
+    CHECK(readDataMatrixCode(digits, &text, &size) && text == digits && size->size == 144);
+    CHECK(encodeError(SymbologyDataMatrix, digits + "12") == ErrorCapacity);
+    for (size_t i = 0; i < sizeof(kDataMatrixSizes) / sizeof(kDataMatrixSizes[0]); ++i) {
+        std::string code = randomString(random, kDigits, kDataMatrixSizes[i].data * 2);
+        CHECK(readDataMatrixCode(code, &text, &size) && text == code && size == &kDataMatrixSizes[i]);
+    }
+
+    // Bytes above 127 take an upper shift.
+    const std::string high("\xC3\xA9" "A\xC8\xFF" "01", 7);
+    CHECK(readDataMatrixCode(high, &text, &size) && text == high);
+}
+
+// PDF417
+
+// ISO/IEC 15438 annex A: the bar and space widths of every value, 929 per cluster (0, 3, 6).
+const char *const kPDF417Widths[3] = {
+    // Cluster 0
+    "311111364111114451111152311112354111124351111251211113263111133421111425111115162111152411111615"
+    "211121363111214441112152211122353111224341112251111123262111233411112425111131362111314431113152"
+    "111132352111324331113251111133342111334211114144211141521111424321114251111151525111611131121135"
+    "411211435112115121121226311212344112124221121325311213331112141621121424311214321112151521121523"
+    "111216142112213531122143411221511112222621122234311222421112232521122333311223411112242421122432"
+    "111231352112314331123151111232342112324211123333211233411112414321124151111242421112434121131126"
+    "311311344113114221131225311312334113124111131316211313243113133211131415211314231113151411131613"
+    "111321262113213431132142111322252113223331132241111323242113233211132423111325221113313421133142"
+    "111332332113324111133332111341422114112531141133411411411114121621141224311412321114131521141323"
+    "311413311114141421141422111415132114152111142125211421333114214111142224211422321114232321142331"
+    "111424221114252121143141111433311115111621151124311511321115121521151223311512311115131421151322"
+    "111514132115142111151512111521241115222311152322111611153116113121161222211613211116151132111135"
+    "421111435211115122111226321112344211124222111325321113334211134112111416221114241211151522112135"
+    "321121434211215112112226221122343211224212112325221123331211242412112523121131352211314332113151"
+    "121132342211324212113333121134321211414322114151121142421211515131211126412111345121114231211225"
+    "412112335121124121211316312113244121133221211415312114234121143121211514312115222212112632121134"
+    "421211422121212622121225321212334212124121212225312122334121224111212316121214152212142332121431"
+    "112124152121242311212514121221262212213432122142112131261212222522122233321222411121322521213233"
+    "312132411121332412122423112134231212313422123142112141341212323322123241112142332121424111214332"
+    "121241421121514212124241112152413122112541221133512211412122121631221224412212322122131531221323"
+    "412213312122141431221422212215132122161222131125321311334213114121222125221312243213123211222216"
+    "121313153122223232131331112223151213141422131422112224142122242222131521121316121213212522132133"
+    "321321411122312512132224221322321122322421223232221323311122332312132422121325211213313322133141"
+    "112241331213323211224232121333311122433111225141212311163123112441231132212312153123122341231231"
+    "212313143123132221231413312314212123151221231611121411162214112432141132112321161214121522141223"
+    "321412311123221521232223312322311123231412141413221414211123241321232421112325121214212422142132"
+    "112331241214222322142231112332232123323111233322121424211123342111234132112342312124111531241123"
+    "412411312124121431241222212413133124132121241412212415111215111522151123321511311124211512151214"
+    "221512221124221421242222221513211124231312151412112424121215151112152123112431231124322211243321"
+    "312511223125122121251411221611221216121311252213112523121125241123111126331111344311114223111225"
+    "331112331311131623111324331113321311141523111423131115141311161313112126231121343311214213112225"
+    "231122333311224113112324231123321311242313112522131131342311314213113233231132411311333213114142"
+    "131142413221112542211133522111412221121632211224422112322221131532211323422113312221141432211422"
+    "222115133221152123121125331211334312114122212125231212243312123212212216131213153221223233121331"
+    "122123152221232323121422122124141312151312212513131221252312213333122141122131251312222432213141"
+    "122132242221323223122331122133231312242212213422131231332312314112214133131232321221423213123331"
+    "131241411221514131311116413111245131113231311215413112235131123131311314413113223131141341311421"
+    "313115122222111632221124422211322131211622221215413121324222123121312215313122234131223121312314"
+    "222214133222142121312413313124212222161113131116231311243313113212222116131312152313122333131231"
+    "113131161222221522222223322222311131321521313223313132312313142111313314122224132222242111313413"
+    "131316111313212423132132122231241313222323132231113141241222322322223231113142232131423113132421"
+    "122234211313313212224132131332311131513212224231313211154132112351321131313212144132122231321313"
+    "413213213132141231321511222311153223112342231131213221152223121441322131213222143132222232231321"
+    "213223132223141221322412222315112132251113141115231411233314113112232115131412142314122211323115"
+    "122322142223222223141321113232142132322213141412113233131223241213141511122325111314212323142131"
+    "122331231314222211324123122332221314232111324222122333211314313111325131313311144133112231331213"
+    "413312213133131231331411222411143224112221332114222412133224122121332213313322212133231222241411"
+    "213324111315111423151122122421141315121323151221113331141224221322242221113332132133322113151411"
+    "113333121224241111333411122431221133412211334221413411213134131132251121222512122225131113161113"
+    "122521131134311313161311122523112411112514111216241112241411131524111323341113311411141424111422"
+    "141115132411152114112125241121333411214114112224241122321411232324112331141124221411252114113133"
+    "241131411411323214113331141141412321111633211124432111322321121533211223232113143321132223211413"
+    "332114212321151214121116241211243412113213212116141212153321213234121231132122152321222333212231"
+    "132123141412141324121421132124132321242114121611141221242412213213213124141222232412223113213223"
+    "232132311321332214122421141231321321413214123231132142313231111542311123523111313231121442311222"
+    "323113134231132132311412323115112322111533221123223121152322121433221222223122143231222233221321"
+    "223123132322141222312412232215112231251114131115241311231322211514131214332221311231311513222214"
+    "232222222413132112313214223132221413141212313313132224121413151113222511141321232413213113223123"
+    "141322221231412313223222141323211231422213223321141331311322413112315131414111145141112241411213"
+    "514112214141131241411411323211144232112231412114414121224232122131412213414122213141231232321411"
+    "314124112323111433231122223221142323121333231221214131142232221332322221214132133141322123231411"
+    "214133122232241121413411141411142414112213232114141412132414122112323114132322132323222111414114"
+    "123232132232322114141411114142132141422113232411114143121414212213233122141422211232412213233221"
+    "114151221232422111415221414211135142112141421212414213113233111342331121314221133233121231422212"
+    "323313113142231123241113332411212233211323241212214231132233221223241311214232122233231121423311"
+    "141511132415112113242113232421211233311313242212141513111142411312333212132423111142421212333311"
+    "114243111324312111425121414312113143211231432211223421122143311221433211132521121234311211434112"
+    "114342111511111615111215251112231511131415111413151115121511212415112223151123221511242115113132"
+    "151132312421111524211214342112222421131334211321242114122421151115121115251211231421211524212123"
+    "251212221421221424212222142123132421232114212412151215111421251115122123251221311421312324213131"
+    "142132221512232114213321151231311421413133311114333112133331131233311411242211142331211433312122"
+    "342212212331221333312221233123122422141123312411151311141422211415131213251312211331311414222213"
+    "151313121331321314222312151314111331331214222411151321221422312215132221133141221422322113314221"
+    "424111134241121242411311333211133241211342412121324122123332131132412311242311133423112123322113"
+    "242312122241311323322212242313112241321223322311224133111514111325141121142321132423212113323113"
+    "142322121514131112414113133232121423231112414212133233111514212114233121133241211241512151511112"
+    "515112114242111241512112424212114151221133331112324221123333121131513112324222113151321124241112"
+    "2333211224241211224231122333221121514112",
+    // Cluster 3
+    "511111256111113341111216511112246111123241111315511113236111133141111414511114224111151351111521"
+    "411116124111212551112133611121413111221641112224511122323111231541112323511123313111241441112422"
+    "311125134111252131112612311131254111313351113141211132163111322441113232211133153111332341113331"
+    "211134143111342221113513311135212111361221114125311141334111414111114216211142243111423211114315"
+    "211143233111433111114414211144221111451321114521111151252111513331115141111152242111523211115323"
+    "211153311111542211116133211161411111623211116331411211165112112461121132411212155112122361121231"
+    "411213145112132241121413511214214112151241121611311221164112212451122132311222154112222351122231"
+    "311223144112232231122413411224213112251231122611211231163112312441123132211232153112322341123231"
+    "211233143112332221123413311234212112351221123611111241162112412431124132111242152112422331124231"
+    "111243142112432211124413211244211112451211125124211251321112522321125231111253221112542111126132"
+    "111262314113111551131123611311314113121451131222411313135113132141131412411315113113211541132123"
+    "511321313113221441132222311323134113232131132412311325112113311531133123411331312113321431133222"
+    "211333133113332121133412211335111113411521134123311341311113421421134222111343132113432111134412"
+    "111345111113512321135131111352221113532111136131411411145114112241141213511412214114131241141411"
+    "311421144114212231142213411422213114231231142411211431143114312221143213311432212114331221143411"
+    "111441142114412211144213211442211114431211144411111451221114522141151113511511214115121241151311"
+    "311521134115212131152212311523112115311331153121211532122115331111154113211541211115421211154311"
+    "411611124116121131162112311622112116311221163211421111165211112462111132421112155211122362111231"
+    "421113145211132242111413521114214211151242111611321121164211212452112132321122154211222352112231"
+    "321123144211232232112413421124213211251232112611221131163211312442113132221132153211322342113231"
+    "221133143211332222113413321134212211351222113611121141162211412432114132121142152211422332114231"
+    "121143142211432212114413221144211211451212115124221151321211522322115231121153221211542112116132"
+    "121162315121111561211123112111645121121461211222112112635121131361211321112113625121141251211511"
+    "421211155212112362121131412121154212121461212131412122145121222252121321412123134212141241212412"
+    "421215114121251132122115421221235212213131213115321222144212222231213214412132224212232131213313"
+    "321224123121341232122511312135112212311532123123421231312121411522123214321232222121421431214222"
+    "321233212121431322123412212144122212351121214511121241152212412332124131112151151212421422124222"
+    "112152142121522222124321112153131212441211215412121245111212512322125131112161231212522211216222"
+    "121253211121632112126131512211146122112211221163512212136122122111221262512213121122136151221411"
+    "421311145213112241222114421312135213122141222213512222214122231242131411412224113213211442132122"
+    "312231143213221342132221312232134122322131223312321324113122341122133114321331222122411422133213"
+    "321332212122421331224221212243122213341121224411121341142213412211225114121342132213422111225213"
+    "212252211122531212134411112254111213512211226122121352211122622151231113612311211123116251231212"
+    "112312615123131142141113521411214123211351232121412322124214131141232311321421134214212131233113"
+    "321422123123321232142311312333112214311332143121212341133123412121234212221433112123431112144113"
+    "221441211123511312144212112352121214431111235311121451211123612151241112112411615124121142151112"
+    "412421124215121141242211321521123124311232152211312432112215311221244112221532112124421112154112"
+    "112451121215421111245211512511114216111141252111321621113125311122163111212541114311111553111123"
+    "631111314311121453111222431113135311132143111412431115113311211543112123531121313311221443112222"
+    "331123134311232133112412331125112311311533113123431131312311321433113222231133133311332123113412"
+    "231135111311411523114123331141311311421423114222131143132311432113114412131145111311512323115131"
+    "131152221311532113116131522111146221112212211163522112136221122112211262522113121221136152211411"
+    "431211145312112242212114431212135312122142212213522122214221231243121411422124113312211443122122"
+    "322131143312221343122221322132134221322132213312331224113221341123123114331231222221411423123213"
+    "331232212221421332214221222143122312341122214411131241142312412212215114131242132312422112215213"
+    "222152211221531213124411122154111312512212216122131252211221622161311113113111542131116261311212"
+    "113112532131126161311311113113521131145152221113622211211222116251312113613121211131216212221261"
+    "513122125222131111312261513123114313111353131121422221134313121241313113513131214313131141313212"
+    "422223114131331133132113431321213222311333132212313141133222321233132311313142123222331131314311"
+    "231331133313312122224113231332122131511322224212231333112131521222224311213153111313411323134121"
+    "122251131313421211316113122252121313431111316212122253111131631113135121122261216132111211321153"
+    "213211616132121111321252113213515223111212231161513221125223121111322161513222114314111242232112"
+    "431412114132311242232211413232113314211232233112331422113132411232233211313242112314311222234112"
+    "231432112132511222234211213252111314411212235112131442111132611212235211113262116133111111331152"
+    "113312515224111151332111431511114224211141333111331521113224311131334111231531112224411121335111"
+    "131541111224511111336111113411514411111454111122441112135411122144111312441114113411211444112122"
+    "341122134411222134112312341124112411311434113122241132133411322124113312241134111411411424114122"
+    "141142132411422114114312141144111411512214115221532111136321112113211162532112121321126153211311"
+    "441211135412112143212113441212124321221244121311432123113412211344122121332131133412221233213212"
+    "341223113321331124123113341231212321411324123212232142122412331123214311141241132412412113215113"
+    "141242121321521214124311132153111412512113216121623111121231115322311161623112111231125212311351"
+    "532211121322116152312112532212111231216152312211441311124322211244131211423131124322221142313211"
+    "341321123322311234132211323141123322321132314211241331122322411224133211223151122322421122315211"
+    "141341121322511214134211123161121322521112316211114111442141115211411243214112511141134211411441"
+    "623211111232115261412111114121521232125111412251532311115232211151413111441411114323211142323111"
+    "414141113414211133233111323241113141511124143111232341112232511121416111141441111323511112326111"
+    "114211432142115111421242114213411233115111422151114311421143124111441141451111134511121245111311"
+    "351121134511212135112212351123112511311335113121251132122511331115114113251141211511421215114311"
+    "151151215421111214211161542112114512111244212112451212114421221135122112342131123512221134213211"
+    "251231122421411225123211242142111512411214215112151242111421521163311111133111521331125154221111"
+    "533121114513111144222111433131113513211134223111333141112513311124224111233151111513411114225111"
+    "133161111241114322411151124112421241134113321151124121511151113421511142115112332151124111511332"
+    "115114311242114211512142124212411151224111521133215211411152123211521331124311411152214111531132"
+    "115312311154113136112112361122112611311226113211161141121611421145212111361221113521311126123111"
+    "252141111612411115215111143111511341114213411241125111332251114112511232125113311342114112512141"
+    "116111242161113211611223216112311161132211611421125211321161213212521231116122311162112321621131"
+    "116212221162132112531131116221311163112211631221144111411351113213511231126111232261113112611222"
+    "1261132113521131126121311262112212621221",
+    // Cluster 6
+    "211111553111116311111246211112543111126211111345211113533111136111111444211114521111154361112114"
+    "111121552111216361112213111122542111226261112312111123532111236161112411111124525111311461113122"
+    "111131635111321361113221111132625111331211113361511134114111411451114122411142135111422141114312"
+    "411144113111511441115122311152134111522131115312311154112111611431116122211162133111622121116312"
+    "111211462112115431121162111212452112125331121261111213442112135211121443211214511112154261122113"
+    "111221542112216261122212111222532112226161122311111223521112245151123113611231211112316251123212"
+    "111232615112331141124113511241214112421241124311311251134112512131125212311253112112611331126121"
+    "211262122112631111131145211311533113116111131244211312521113134321131351111314421113154161132112"
+    "111321532113216161132211111322521113235151133112111331615113321141134112411342113113511231135211"
+    "211361122113621111141144211411521114124321141251111413421114144161142111111421521114225151143111"
+    "411441113114511111151143211511511115124211151341111521511116114211161241121111462211115432111162"
+    "121112452211125332111261121113442211135212111443221114511211154262112113121121542211216262112212"
+    "121122532211226162112311121123521211245152113113621131211211316252113212121132615211331142114113"
+    "521141214211421242114311321151134211512132115212321153112211611332116121221162122211631121211145"
+    "312111534121116111211236212112443121125211211335212113433121135111211434212114421121153321211541"
+    "112116321212114522121153321211611121214512121244221212521121224421212252221213511121234312121442"
+    "112124421212154111212541621221121212215322122161612131126212221111213153121222526121321111213252"
+    "121223511121335152123112121231615121411252123211112141615121421142124112412151124212421141215211"
+    "321251123121611232125211312162112212611222126211112211362122114431221152112212352122124331221251"
+    "112213342122134211221433212214411122153211221631121311442213115211222144121312432213125111222243"
+    "212222511122234212131441112224416213211112132152612231111122315212132251112232515213311151224111"
+    "421341114122511132135111312261112213611111231135212311433123115111231234212312421123133321231341"
+    "112314321123153112141143221411511123214312141242112322421214134111232341121421511123315111241134"
+    "212411421124123321241241112413321124143112151142112421421215124111242241112511332125114111251232"
+    "112513311216114111252141112611321126123113111145231111533311116113111244231112521311134323111351"
+    "131114421311154163112112131121532311216163112211131122521311235153113112131131615311321143114112"
+    "431142113311511233115211231161122311621112211136222111443221115212211235222112433221125112211334"
+    "222113421221143322211441122115321221163113121144231211521221214413121243231212511221224322212251"
+    "122123421312144112212441631221111312215262213111122131521312225112213251531231115221411143124111"
+    "422151113312511132216111231261112131113531311143413111511131122621311234313112421131132521311333"
+    "313113411131142421311432113115232131153111311622122211352222114332221151113121351222123422221242"
+    "113122342131224222221341113123331222143211312432122215311131253113131143231311511222214313131242"
+    "113131431222224213131341113132421222234111313341131321511222315111314151113211262132113431321142"
+    "113212252132123331321241113213242132133211321423213214311132152211321621122311342223114211322134"
+    "122312332223124111322233213222411132233212231431113224311314114212232142131412411132314212232241"
+    "113232411133112521331133313311411133122421331232113313232133133111331422113315211224113322241141"
+    "113321331224123211332232122413311133233113151141122421411133314111341124213411321134122321341231"
+    "113413221134142112251132113421321225123111342231113511232135113111351222113513211226113111352131"
+    "113611221136122114111144241111521411124324111251141113421411144114112152141122515411311144114111"
+    "341151112411611113211135232111433321115113211234232112421321133323211341132114321321153114121143"
+    "241211511321214314121242132122421412134113212341141221511321315112311126223111343231114212311225"
+    "223112333231124112311324223113321231142322311431123115221231162113221134232211421231213413221233"
+    "232212411231223313221332123123321322143112312431141311421322214214131241123131421322224112313241"
+    "214111253141113341411141114112162141122431411232114113152141132331411331114114142141142211411513"
+    "214115211141161212321125223211333232114111412125123212242232123211412224214122322232133111412323"
+    "123214221141242212321521114125211323113323231141123221331323123211413133123222321323133111413232"
+    "123223311141333114141141132321411232314111414141114211162142112431421132114212152142122331421231"
+    "114213142142132211421413214214211142151211421611123311242233113211422124123312232233123111422223"
+    "214222311142232212331421114224211324113212332132132412311142313212332231114232311143111521431123"
+    "314311311143121421431222114313132143132111431412114315111234112322341131114321231234122211432222"
+    "123413211143232113251131123421311143313111441114214411221144121321441221114413121144141112351122"
+    "114421221235122111442221114511132145112111451212114513111236112111452121151111432511115115111242"
+    "151113411511215114211134242111421421123324211241142113321421143115121142142121421512124114212241"
+    "133111252331113333311141133112242331123213311323233113311331142213311521142211332422114113312133"
+    "142212321331223214221331133123311513114114222141133131411241111622411124324111321241121522411223"
+    "324112311241131422411322124114132241142112411512124116111332112423321132124121241332122323321231"
+    "124122232241223112412322133214211241242114231132133221321423123112413132133222311241323121511115"
+    "315111234151113121511214315112222151131331511321215114122151151112421115224211233242113111512115"
+    "124212142242122211512214215122222242132111512313124214121151241212421511115125111333112323331131"
+    "124221231333122211513123124222221333132111513222124223211151332114241131133321311242313111514131"
+    "215211143152112221521213315212212152131221521411124311142243112211522114124312132243122111522213"
+    "215222211152231212431411115224111334112212432122133412211152312212432221115232212153111331531121"
+    "215312122153131112441113224411211153211312441212115322121244131111532311133511211244212111533121"
+    "215411122154121112451112115421121245121111542211161111421611124115211133252111411521123215211331"
+    "161211411521214114311124243111321431122324311231143113221431142115221132143121321522123114312231"
+    "134111152341112333411131134112142341122213411313234113211341141213411511143211232432113113412123"
+    "234121311341222214321321134123211523113114322131134131312251111432511122225112133251122122511312"
+    "225114111342111423421122125121142251212223421221125122131342131212512312134214111251241114331122"
+    "134221221433122112513122134222211251322131611113416111213161121231611311225211133252112121612113"
+    "225212122161221222521311216123111343111323431121125221131343121211613113125222121343131111613212"
+    "125223111161331114341121134321211252312111614121316211123162121122531112216221122253121121622211"
+    "134411121253211213441211116231121253221111623211316311112254111121632111134511111254211111633111"
+    "162111321621123115311123253111311531122215311321162211311531213114411114244111221441121324411221"
+    "144113121441141115321122144121221532122114412221235111133351112123511212235113111442111324421121"
+    "135121132351212113512212144213111351231115331121144221211351312132611112326112112352111222612112"
+    "235212112261221114431112135221121443121112613112135222111261321132621111235311112262211114441111"
+    "135321111262311116311122163112211541111325411121154112121541131116321121154121212451111224511211"
+    "1542111214512112154212111451221133611111"
+};
+
+// The characters of the text compaction submodes by value; '\x01' marks the latches and shifts.
+const char kPDF417Alpha[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ \x01\x01\x01";
+const char kPDF417Lower[] = "abcdefghijklmnopqrstuvwxyz \x01\x01\x01";
+const char kPDF417MixedSet[] = "0123456789&\r\t,:#-.$/+%*=^\x01 \x01\x01\x01";
+const char kPDF417PunctuationSet[] = ";<>@[\\]_`~!\r\t,:\n-.$/\"|*()?{}'\x01";
+
+// Value of a width string in one cluster, -1 if it is not there.
+int pdf417Value(unsigned cluster, const std::string &widths) {
+    static std::map<std::string, int> values[3];
+    if (values[0].empty()) {
+        for (int k = 0; k < 3; ++k) {
+            for (int v = 0; v < 929; ++v) {
+                values[k][std::string(kPDF417Widths[k] + v * 8, 8)] = v;
+            }
+        }
+    }
+    std::map<std::string, int>::const_iterator found = values[cluster].find(widths);
+    return found == values[cluster].end() ? -1 : found->second;
+}
+
+struct PDF417Reading {
+    unsigned rows, columns, level;
+    std::vector<unsigned> codewords; // row by row, without the row indicators
+};
+
+// Reads the rows of a symbol and checks its start and stop patterns, clusters and row indicators.
+std::string readPDF417(const Symbol &symbol, PDF417Reading *reading) {
+    if (symbol.width < 86 || (symbol.width - 69) % 17 != 0 || symbol.height % 3 != 0) {
+        return "size";
+    }
+    unsigned rows = symbol.height / 3, columns = (symbol.width - 69) / 17;
+    if (rows < 3 || rows > 90 || columns > 30 || rows * columns > 928 || symbol.quietZone != 2) {
+        return "dimensions";
+    }
+    reading->rows = rows;
+    reading->columns = columns;
+    reading->codewords.clear();
+    int level = -1;
+    for (unsigned y = 0; y < symbol.height; ++y) {
+        std::string row;
+        for (unsigned x = 0; x < symbol.width; ++x) {
+            row += symbol.dark(x, y) ? '1' : '0';
+        }
+        if (y % 3 != 0) {
+            // Every row is three modules high.
+            for (unsigned x = 0; x < symbol.width; ++x) {
+                if (symbol.dark(x, y) != symbol.dark(x, y - y % 3)) {
+                    return "row height";
+                }
+            }
+            continue;
+        }
+        std::vector<unsigned> widths = elementWidths(row);
+        if (widths.size() != 8 * (columns + 3) + 9) {
+            return "element count";
+        }
+        std::string elements;
+        for (size_t i = 0; i < widths.size(); ++i) {
+            if (widths[i] > 9) {
+                return "element width";
+            }
+            elements += (char)('0' + widths[i]);
+        }
+        if (elements.compare(0, 8, "81111113") != 0 || elements.compare(elements.size() - 9, 9, "711311121") != 0) {
+            return "start or stop";
+        }
+        unsigned r = y / 3, cluster = r % 3;
+        std::vector<int> values;
+        for (unsigned c = 0; c < columns + 2; ++c) {
+            const char *w = elements.c_str() + 8 + 8 * c;
+            // The cluster follows from the bar widths alone.
+            if ((w[0] - w[2] + w[4] - w[6] + 9) % 9 != (int)cluster * 3) {
+                return "cluster";
+            }
+            values.push_back(pdf417Value(cluster, std::string(w, 8)));
+            if (values.back() < 0) {
+                return "unknown codeword";
+            }
+        }
+        // Left and right indicators: the row group, and per cluster the rows, level and columns.
+        int left = values.front(), right = values.back();
+        if (left / 30 != (int)r / 3 || right / 30 != (int)r / 3) {
+            return "row group";
+        }
+        int rowsInfo = (int)(rows - 1) / 3, columnsInfo = (int)columns - 1;
+        left %= 30;
+        right %= 30;
+        int levelInfo = cluster == 1 ? left : cluster == 2 ? right : -1;
+        if ((cluster == 0 && (left != rowsInfo || right != columnsInfo)) ||
+            (cluster == 1 && right != rowsInfo) || (cluster == 2 && left != columnsInfo)) {
+            return "row indicator";
+        }
+        if (levelInfo >= 0) {
+            if (levelInfo % 3 != (int)(rows - 1) % 3 || levelInfo / 3 > 8 || (level >= 0 && level != levelInfo / 3)) {
+                return "level indicator";
+            }
+            level = levelInfo / 3;
+        }
+        reading->codewords.insert(reading->codewords.end(), values.begin() + 1, values.end() - 1);
+    }
+    reading->level = (unsigned)level;
+    return std::string();
+}
+
+// True if the codewords (highest power first) evaluate to 0 at 3^1 .. 3^count modulo 929.
+bool pdf417SyndromesZero(const std::vector<unsigned> &codewords, unsigned count) {
+    unsigned root = 1;
+    for (unsigned j = 1; j <= count; ++j) {
+        root = root * 3 % 929;
+        unsigned value = 0;
+        for (size_t i = 0; i < codewords.size(); ++i) {
+            value = (value * root + codewords[i]) % 929;
+        }
+        if (value != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool decodePDF417Text(const std::vector<unsigned> &codewords, std::string *out) {
+    const char *const sets[4] = { kPDF417Alpha, kPDF417Lower, kPDF417MixedSet, kPDF417PunctuationSet };
+    enum { Alpha, Lower, Mixed, Punctuation };
+    int mode = Alpha, shift = -1;
+    for (size_t i = 0; i < codewords.size() * 2; ++i) {
+        unsigned value = i % 2 == 0 ? codewords[i / 2] / 30 : codewords[i / 2] % 30;
+        int set = shift >= 0 ? shift : mode;
+        shift = -1;
+        if (sets[set][value] != '\x01') {
+            *out += sets[set][value];
+            continue;
+        }
+        if (set == Punctuation) {
+            mode = Alpha;
+        } else if (value == 29) {
+            shift = Punctuation;
+        } else if (set == Alpha) {
+            mode = value == 27 ? Lower : Mixed;
+        } else if (set == Lower) {
+            if (value == 27) {
+                shift = Alpha;
+            } else {
+                mode = Mixed;
+            }
+        } else {
+            mode = value == 25 ? Punctuation : value == 27 ? Lower : Alpha;
+        }
+    }
+    return true;
+}
+
+bool decodePDF417Bytes(const std::vector<unsigned> &codewords, bool multipleOf6, std::string *out) {
+    // With 901 the last one to five bytes are one per codeword.
+    size_t groups = multipleOf6 ? codewords.size() / 5 : (codewords.empty() ? 0 : (codewords.size() - 1) / 5);
+    if (codewords.empty() || (multipleOf6 && codewords.size() % 5 != 0)) {
+        return false;
+    }
+    for (size_t g = 0; g < groups; ++g) {
+        uint64_t value = 0;
+        for (size_t k = 0; k < 5; ++k) {
+            value = value * 900 + codewords[g * 5 + k];
+        }
+        if (value >> 48 != 0) {
+            return false;
+        }
+        for (int k = 5; k >= 0; --k) {
+            *out += (char)(value >> (8 * k));
+        }
+    }
+    for (size_t i = groups * 5; i < codewords.size(); ++i) {
+        if (codewords[i] > 255) {
+            return false;
+        }
+        *out += (char)codewords[i];
+    }
+    return true;
+}
+
+bool decodePDF417Numeric(const std::vector<unsigned> &codewords, std::string *out) {
+    if (codewords.empty()) {
+        return false;
+    }
+    for (size_t start = 0; start < codewords.size(); start += 15) {
+        // Up to 15 codewords in base 900 are a decimal number with a leading 1.
+        std::vector<unsigned> decimal(1, 0); // least significant first
+        for (size_t i = start; i < codewords.size() && i < start + 15; ++i) {
+            unsigned carry = codewords[i];
+            for (size_t d = 0; d < decimal.size(); ++d) {
+                carry += decimal[d] * 900;
+                decimal[d] = carry % 10;
+                carry /= 10;
+            }
+            for (; carry > 0; carry /= 10) {
+                decimal.push_back(carry % 10);
+            }
+        }
+        if (decimal.back() != 1) {
+            return false;
+        }
+        for (size_t d = decimal.size() - 1; d-- > 0;) {
+            *out += (char)('0' + decimal[d]);
+        }
+    }
+    return true;
+}
+
+// The data codewords after the length descriptor: segments in the mode of the latch before them,
+// text at the start.
+bool decodePDF417Data(const std::vector<unsigned> &codewords, std::string *out) {
+    out->clear();
+    unsigned mode = 900;
+    for (size_t i = 1; i < codewords.size();) {
+        if (codewords[i] >= 900) {
+            mode = codewords[i++];
+        }
+        std::vector<unsigned> segment;
+        for (; i < codewords.size() && codewords[i] < 900; ++i) {
+            segment.push_back(codewords[i]);
+        }
+        bool ok = mode == 900 ? decodePDF417Text(segment, out)
+                : mode == 901 || mode == 924 ? decodePDF417Bytes(segment, mode == 924, out)
+                : mode == 902 ? decodePDF417Numeric(segment, out) : false;
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Encodes and reads back code; the data codewords (length descriptor included) go to dataCount.
+bool readPDF417Code(const std::string &code, const Options &options, std::string *text,
+                    PDF417Reading *reading, unsigned *dataCount) {
+    Symbol symbol;
+    if (!encodeCode(SymbologyPDF417, code, options, &symbol)) {
+        return false;
+    }
+    std::string error = readPDF417(symbol, reading);
+    if (!error.empty()) {
+        fprintf(stderr, "PDF417 of %lu bytes: %s\n", (unsigned long)code.size(), error.c_str());
+        return false;
+    }
+    unsigned eccCount = 2u << reading->level;
+    std::vector<unsigned> &codewords = reading->codewords;
+    if (codewords[0] + eccCount != codewords.size() || !pdf417SyndromesZero(codewords, eccCount)) {
+        return false;
+    }
+    // Whatever is left after the data is padding.
+    std::vector<unsigned> data(codewords.begin(), codewords.begin() + codewords[0]);
+    *dataCount = (unsigned)data.size();
+    while (*dataCount > 1 && data[*dataCount - 1] == 900) {
+        --*dataCount;
+    }
+    return decodePDF417Data(data, text);
+}
+
+void testPDF417Tables() {
+    for (unsigned k = 0; k < 3; ++k) {
+        CHECK(strlen(kPDF417Widths[k]) == 929 * 8);
+        std::set<std::string> patterns;
+        for (unsigned v = 0; v < 929; ++v) {
+            const char *w = kPDF417Widths[k] + v * 8;
+            unsigned modules = 0;
+            for (int i = 0; i < 8; ++i) {
+                CHECK(w[i] >= '1' && w[i] <= '6');
+                modules += (unsigned)(w[i] - '0');
+            }
+            CHECK(modules == 17);
+            CHECK((w[0] - w[2] + w[4] - w[6] + 9) % 9 == (int)k * 3);
+            patterns.insert(std::string(w, 8));
+        }
+        CHECK(patterns.size() == 929);
+    }
+}
+
+void testPDF417() {
+    testPDF417Tables();
+
+    std::string text;
+    PDF417Reading reading;
+    unsigned dataCount = 0;
+    Options options;
+
+    // Compaction: text in pairs, 6 bytes in 5 codewords, 44 digits in 15.
+    CHECK(readPDF417Code("HELLO WORLD", options, &text, &reading, &dataCount) && text == "HELLO WORLD");
+    CHECK(dataCount == 1 + 6 && reading.level == 2);
+    CHECK(readPDF417Code("Hello, World!", options, &text, &reading, &dataCount) && text == "Hello, World!");
+    CHECK(dataCount == 1 + 9);
+    const std::string bytes("\x80\x81\xfe\xff\x00\x01\x9c\xa0\xb0\xc0\xd0\xe0", 12);
+    CHECK(readPDF417Code(bytes, options, &text, &reading, &dataCount) && text == bytes);
+    CHECK(dataCount == 1 + 1 + 10 && reading.codewords[1] == 924);
+    CHECK(readPDF417Code(bytes.substr(0, 7), options, &text, &reading, &dataCount) && text == bytes.substr(0, 7));
+    CHECK(dataCount == 1 + 1 + 5 + 1 && reading.codewords[1] == 901);
+    const std::string digits = "12345678901234567890123456789012345678901234";
+    CHECK(readPDF417Code(digits, options, &text, &reading, &dataCount) && text == digits);
+    CHECK(dataCount == 1 + 1 + 15 && reading.codewords[1] == 902);
+    // Short digit runs stay in text, where they take the mixed submode.
+    CHECK(readPDF417Code("ROW 42", options, &text, &reading, &dataCount) && text == "ROW 42");
+    CHECK(dataCount == 1 + 4);
+    // Numeric compaction from 13 digits on; text needs 5 characters between bytes to pay for the latches.
+    CHECK(readPDF417Code("1234567890123", options, &text, &reading, &dataCount) && text == "1234567890123");
+    CHECK(dataCount == 1 + 1 + 5 && reading.codewords[1] == 902);
+    CHECK(readPDF417Code("123456789012", options, &text, &reading, &dataCount) && text == "123456789012");
+    CHECK(dataCount == 1 + 7);
+    CHECK(readPDF417Code("\x80" "ABCD" "\x80", options, &text, &reading, &dataCount) && text == "\x80" "ABCD" "\x80");
+    CHECK(dataCount == 1 + 1 + 5 && reading.codewords[1] == 924);
+    CHECK(readPDF417Code("\x80" "ABCDE" "\x80", options, &text, &reading, &dataCount) && text == "\x80" "ABCDE" "\x80");
+    CHECK(dataCount == 1 + 2 + 1 + 3 + 2);
+    // Shorter text at the end stays text, and text stops where a numeric run starts.
+    CHECK(readPDF417Code("AB", options, &text, &reading, &dataCount) && text == "AB" && dataCount == 1 + 1);
+    CHECK(readPDF417Code("ABCDE1234567890123", options, &text, &reading, &dataCount) && text == "ABCDE1234567890123");
+    CHECK(dataCount == 1 + 3 + 1 + 5);
+
+    scanditsdk::test::Random random(7);
+    static const char *const kAlphabets[] = {
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ ", "abcdefghijklmnopqrstuvwxyz ", "0123456789", "aZ09 &\r\t,:#-.$/+%*=^",
+        ";<>@[\\]_`~!\r\t,:\n-.$/\"|*()?{}'aA", NULL
+    };
+    unsigned read = 0;
+    for (size_t length = 0; length < 300; length += length < 40 ? 1 : 37) {
+        for (int kind = 0; kind < 7; ++kind) {
+            std::string code;
+            if (kind < 5) {
+                code = randomString(random, kAlphabets[kind], length);
+            } else {
+                // Any bytes, or printable text with bytes and digit runs in between.
+                for (size_t i = 0; i < length; ++i) {
+                    code += kind == 5 ? (char)random.below(256) : (char)(32 + random.below(95));
+                    if (kind == 6 && random.below(20) == 0) {
+                        code += random.below(2) ? std::string("\xc3\xa9") : randomString(random, kDigits, 14);
+                    }
+                }
+            }
+            options.pdf417Level = (int)random.below(10) - 1;
+            options.pdf417Columns = random.below(3) == 0 ? 1 + random.below(30) : 0;
+            Error error = encodeError(SymbologyPDF417, code, options);
+            if (error == ErrorCapacity) {
+                CHECK(options.pdf417Columns > 0);
+                continue;
+            }
+            CHECK(readPDF417Code(code, options, &text, &reading, &dataCount) && text == code);
+            if (options.pdf417Level >= 0) {
+                CHECK(reading.level == (unsigned)options.pdf417Level);
+            }
+            if (options.pdf417Columns > 0) {
+                CHECK(reading.columns == options.pdf417Columns);
+            }
+            ++read;
+        }
+    }
+    CHECK(read > 200);
+
+    // The recommended level grows with the data.
+    options = Options();
+    static const unsigned kLevels[][2] = { { 40, 2 }, { 41, 3 }, { 160, 3 }, { 161, 4 }, { 320, 4 }, { 321, 5 } };
+    for (size_t i = 0; i < sizeof(kLevels) / sizeof(kLevels[0]); ++i) {
+        // Two letters per codeword after the length descriptor.
+        std::string letters = randomString(random, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", (kLevels[i][0] - 1) * 2);
+        CHECK(readPDF417Code(letters, options, &text, &reading, &dataCount) && text == letters);
+        CHECK(dataCount == kLevels[i][0] && reading.level == kLevels[i][1]);
+    }
+
+    // The largest symbols: 1850 text characters, 1108 bytes or 2710 digits at level 0.
+    options.pdf417Level = 0;
+    std::string letters = randomString(random, "ABCDEFGHIJKLMNOPQRSTUVWXYZ", 1850);
+    CHECK(readPDF417Code(letters, options, &text, &reading, &dataCount) && text == letters);
+    CHECK(reading.rows * reading.columns == 928);
+    CHECK(encodeError(SymbologyPDF417, letters + "A", options) == ErrorCapacity);
+    std::string high;
+    for (int i = 0; i < 1108; ++i) {
+        high += (char)(128 + random.below(128));
+    }
+    CHECK(readPDF417Code(high, options, &text, &reading, &dataCount) && text == high);
+    CHECK(encodeError(SymbologyPDF417, high + "\xff", options) == ErrorCapacity);
+    std::string manyDigits = randomString(random, kDigits, 2710);
+    CHECK(readPDF417Code(manyDigits, options, &text, &reading, &dataCount) && text == manyDigits);
+    CHECK(encodeError(SymbologyPDF417, manyDigits + "1", options) == ErrorCapacity);
+    options.pdf417Level = 8;
+    CHECK(encodeError(SymbologyPDF417, std::string(900, 'A'), options) == ErrorCapacity);
+    CHECK(readPDF417Code(std::string(900, 'A'), Options(), &text, &reading, &dataCount) && reading.level == 5);
+
+    // Too many rows for the requested columns.
+    options = Options();
+    options.pdf417Columns = 1;
+    CHECK(encodeError(SymbologyPDF417, std::string(200, 'A'), options) == ErrorCapacity);
+    // The default layout is about three times as wide as high.
+    Symbol symbol;
+    CHECK(encodeCode(SymbologyPDF417, std::string(500, 'x'), Options(), &symbol));
+    CHECK(symbol.width > 2 * symbol.height && symbol.width < 4 * symbol.height);
+}
+
+} // namespace
+
+int main() {
+    testEANUPC();
+    testCode39();
+    testCode128();
+    testITF();
+    testQR();
+    testDataMatrix();
+    testPDF417();
+    return scanditsdk::test::testResult();
+}
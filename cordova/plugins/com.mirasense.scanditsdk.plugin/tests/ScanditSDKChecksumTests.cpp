@@ -0,0 +1,175 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKChecksum.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace scanditsdk::checksum;
+
+namespace {
+
+struct Vector {
+    Check check;
+    const char *code;
+};
+
+// Valid codes; check digits computed independently of the code under test.
+const Vector kValid[] = {
+    { CheckEAN13, "4006381333931" },
+    { CheckEAN13, "5901234123457" },
+    { CheckUPC12, "036000291452" },
+    { CheckEAN8, "96385074" },
+    { CheckUPCE, "04252614" },
+    { CheckUPCE, "01234543" },
+    { CheckUPCE, "01234565" },
+    { CheckITF, "00012345600012" },
+    { CheckITF, "123457" },
+    { CheckCode39Mod43, "CODE39W" },
+    { CheckMSIMod10, "805234" },
+    { CheckMSIMod10, "9876543217" },
+    { CheckMSIMod11, "805238" },
+    { CheckMSIMod11, "9876543211" },
+    { CheckMSIMod1010, "8052342" },
+    { CheckMSIMod1010, "98765432178" },
+    { CheckMSIMod1110, "8052383" },
+    { CheckMSIMod1110, "98765432111" },
+};
+
+bool valid(Check check, const char *code) {
+    return validate(check, code, strlen(code));
+}
+
+void testVectors() {
+    for (size_t i = 0; i < sizeof(kValid) / sizeof(kValid[0]); ++i) {
+        const Vector &v = kValid[i];
+        CHECK(valid(v.check, v.code));
+        // Every single-digit change of a digit check is caught.
+        std::string changed(v.code);
+        for (size_t pos = 0; pos < changed.size(); ++pos) {
+            char original = changed[pos];
+            if (original < '0' || original > '9' || v.check == CheckCode39Mod43) {
+                continue;
+            }
+            changed[pos] = original == '9' ? '0' : original + 1;
+            if (valid(v.check, changed.c_str())) {
+                fprintf(stderr, "%s passes check %d\n", changed.c_str(), v.check);
+                CHECK(!"changed digit passes");
+            }
+            changed[pos] = original;
+        }
+    }
+}
+
+void testMalformed() {
+    CHECK(!valid(CheckEAN13, "400638133393"));
+    CHECK(!valid(CheckEAN13, "40063813339310"));
+    CHECK(!valid(CheckEAN13, "400638133393A"));
+    CHECK(!valid(CheckEAN8, ""));
+    CHECK(!valid(CheckITF, "1234567"));           // odd length
+    CHECK(!valid(CheckUPCE, "24252614"));         // number system 2
+    CHECK(!valid(CheckCode39Mod43, "CODE39X"));
+    CHECK(!valid(CheckCode39Mod43, "code39W"));   // lower case is not Code 39
+    CHECK(!valid(CheckMSIMod11, "1040"));         // 104 needs the check "10"
+    CHECK(!valid(CheckMSIMod10, "4"));
+    CHECK(!valid(CheckNone, "4006381333931"));
+}
+
+void testHelpers() {
+    CHECK(gs1Mod10CheckDigit("400638133393", 12) == '1');
+    CHECK(gs1Mod10CheckDigit("40063813339X", 12) == 0);
+    CHECK(gs1Mod10Valid("96385074", 8));
+    CHECK(msiMod10Valid("805234", 6));
+    CHECK(msiMod11Valid("805238", 6));
+    CHECK(code39Mod43Valid("CODE39W", 7));
+
+    const char *upce[][2] = {
+        { "04252614", "042100005264" },
+        { "01234543", "012340000053" },
+        { "01234565", "012345000065" },
+    };
+    for (size_t i = 0; i < sizeof(upce) / sizeof(upce[0]); ++i) {
+        char upca[12];
+        CHECK(expandUPCE(upce[i][0], 8, upca));
+        CHECK(memcmp(upca, upce[i][1], 12) == 0);
+    }
+    char upca[12];
+    CHECK(!expandUPCE("0425261", 7, upca));
+}
+
+void testInfer() {
+    CHECK(infer("4006381333931", 13) == CheckEAN13);
+    CHECK(infer("036000291452", 12) == CheckUPC12);
+    CHECK(infer("96385074", 8) == CheckEAN8);
+    CHECK(infer("04252614", 8) == CheckUPCE);
+    CHECK(infer("00012345600012", 14) == CheckITF);
+    CHECK(infer("CODE39W", 7) == CheckCode39Mod43);
+    CHECK(infer("805234", 6) == CheckNone);   // MSI is never inferred
+    CHECK(infer("4006381333932", 13) == CheckNone);
+    CHECK(infer("", 0) == CheckNone);
+}
+
+// The batch and fixed-stride vector kernels agree with the scalar path on random codes,
+// about one in ten of which is valid, including codes with a non-digit in them.
+void testBatchMatchesScalar() {
+    scanditsdk::test::Random random;
+    const Check checks[] = { CheckEAN13, CheckUPC12, CheckEAN8, CheckITF, CheckMSIMod10 };
+    for (size_t c = 0; c < sizeof(checks) / sizeof(checks[0]); ++c) {
+        const size_t count = 20000;
+        const size_t length = checks[c] == CheckEAN13 ? 13 : checks[c] == CheckUPC12 ? 12 : checks[c] == CheckEAN8 ? 8 : 14;
+        const size_t stride = 16;
+        std::vector<char> fixed(count * stride + 16, 0);
+        std::vector<const char *> codes(count);
+        std::vector<size_t> lengths(count, length);
+        for (size_t i = 0; i < count; ++i) {
+            char *code = &fixed[i * stride];
+            for (size_t d = 0; d < length; ++d) {
+                code[d] = (char)('0' + random.below(10));
+            }
+            if (random.below(50) == 0) {
+                code[random.below((uint32_t)length)] = (char)random.below(256);
+            }
+            codes[i] = code;
+        }
+        std::vector<uint8_t> batch(count), vector(count);
+        size_t batchValid = validateBatch(checks[c], &codes[0], &lengths[0], count, &batch[0]);
+        size_t scalarValid = 0;
+        for (size_t i = 0; i < count; ++i) {
+            bool ok = validate(checks[c], codes[i], length);
+            scalarValid += ok;
+            CHECK(batch[i] == (ok ? 1 : 0));
+        }
+        CHECK(batchValid == scalarValid);
+        CHECK(scalarValid > count / 20);
+        if (checks[c] == CheckEAN13 || checks[c] == CheckUPC12 || checks[c] == CheckEAN8) {
+            CHECK(validateGS1Fixed(&fixed[0], length, stride, count, &vector[0]) == scalarValid);
+            CHECK(memcmp(&vector[0], &batch[0], count) == 0);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testVectors();
+    testMalformed();
+    testHelpers();
+    testInfer();
+    testBatchMatchesScalar();
+    return scanditsdk::test::testResult();
+}
@@ -0,0 +1,74 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKFrameStats.hpp"
+#include "ScanditSDKSampleFrames.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <stdio.h>
+#include <vector>
+
+using namespace scanditsdk::framestats;
+
+/**
+ * Frame statistics of 720p and 1080p sample frames: analyze() against analyzeScalar(), and the
+ * luminance-only kernel the auto torch samples with. The scale argument sets the number of rounds.
+ */
+int main(int argc, char **argv) {
+    const int rounds = (int)(40 * scanditsdk::test::benchScale(argc, argv)) + 1;
+    const size_t sizes[][2] = { { 1280, 720 }, { 1920, 1080 } };
+    float sink = 0;
+    int mismatches = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t width = sizes[s][0], height = sizes[s][1];
+        for (int sc = 0; sc < scanditsdk::test::SceneCount; ++sc) {
+            scanditsdk::test::Scene scene = (scanditsdk::test::Scene)sc;
+            std::vector<uint8_t> frame = scanditsdk::test::sampleFrame(scene, width, height, width);
+            const uint8_t *pixels = &frame[0];
+
+            double start = scanditsdk::test::now();
+            Stats vector = { 0, 0, 0 };
+            for (int i = 0; i < rounds; ++i) {
+                vector = analyze(pixels, width, height, width);
+                sink += vector.sharpness;
+            }
+            double vectorSeconds = (scanditsdk::test::now() - start) / rounds;
+
+            start = scanditsdk::test::now();
+            Stats scalar = { 0, 0, 0 };
+            for (int i = 0; i < rounds; ++i) {
+                scalar = analyzeScalar(pixels, width, height, width);
+                sink += scalar.sharpness;
+            }
+            double scalarSeconds = (scanditsdk::test::now() - start) / rounds;
+
+            start = scanditsdk::test::now();
+            for (int i = 0; i < rounds; ++i) {
+                sink += meanLuminance(pixels, width, height, width, 4);
+            }
+            double luminanceSeconds = (scanditsdk::test::now() - start) / rounds;
+
+            mismatches += vector.meanLuminance != scalar.meanLuminance || vector.sharpness != scalar.sharpness ||
+                          vector.glareFraction != scalar.glareFraction;
+            printf("%4lux%-4lu %-8s analyze %6.3f ms  scalar %6.3f ms (%.1fx)  luminance/4 %6.3f ms"
+                   "  [lum %.1f sharp %.0f glare %.3f]\n",
+                   (unsigned long)width, (unsigned long)height, scanditsdk::test::sceneName(scene),
+                   vectorSeconds * 1e3, scalarSeconds * 1e3, scalarSeconds / vectorSeconds, luminanceSeconds * 1e3,
+                   vector.meanLuminance, vector.sharpness, vector.glareFraction);
+        }
+    }
+    printf("checksum %g\n", sink);
+    return mismatches == 0 ? 0 : 1;
+}
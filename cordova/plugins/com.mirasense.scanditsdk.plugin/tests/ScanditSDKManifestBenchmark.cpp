@@ -0,0 +1,80 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKManifest.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace scanditsdk::manifest;
+
+/**
+ * A receiving manifest of 100k lines (times the scale argument) loaded from "code,expected"
+ * text, 1M scans against it of which 10% are not on the manifest, and a full diff. The scan
+ * cost is put against the 20 ms a scanner at 50 scans/s leaves between two scans.
+ */
+int main(int argc, char **argv) {
+    double scale = scanditsdk::test::benchScale(argc, argv);
+    const size_t lineCount = (size_t)(100000 * scale);
+    const size_t scanCount = 10 * lineCount;
+    const double scansPerSecond = 50;
+    scanditsdk::test::Random random;
+
+    std::vector<std::string> codes(lineCount);
+    std::string text;
+    for (size_t i = 0; i < lineCount; ++i) {
+        char row[40];
+        snprintf(row, sizeof(row), "%013u", (unsigned)(random.next() % 1000000000u) * 7u + (unsigned)i);
+        codes[i] = row;
+        snprintf(row + strlen(row), sizeof(row) - strlen(row), ",%u\n", 1 + random.below(24));
+        text += row;
+    }
+    std::vector<std::string> scans(scanCount);
+    for (size_t i = 0; i < scanCount; ++i) {
+        scans[i] = random.below(10) == 0 ? "X" + codes[random.below((uint32_t)lineCount)] : codes[random.below((uint32_t)lineCount)];
+    }
+
+    double start = scanditsdk::test::now();
+    Manifest manifest;
+    manifest.reserve(lineCount, text.size());
+    size_t rows = manifest.addRows(text.data(), text.size());
+    double loadSeconds = scanditsdk::test::now() - start;
+
+    start = scanditsdk::test::now();
+    uint64_t sink = 0;
+    for (size_t i = 0; i < scanCount; ++i) {
+        sink += manifest.receive(scans[i].data(), scans[i].size()).status;
+    }
+    double scanSeconds = scanditsdk::test::now() - start;
+
+    start = scanditsdk::test::now();
+    std::vector<Delta> lines;
+    lines.reserve(manifest.lineCount());
+    manifest.diff(lines, true);
+    double diffSeconds = scanditsdk::test::now() - start;
+
+    double perScan = scanSeconds / scanCount;
+    printf("%lu lines (%lu bytes), %lu scans, %lu lines after scanning (checksum %llu)\n", (unsigned long)rows,
+           (unsigned long)text.size(), (unsigned long)scanCount, (unsigned long)manifest.lineCount(),
+           (unsigned long long)sink);
+    printf("load          %8.2f ms\n", loadSeconds * 1e3);
+    printf("receive       %8.3f us/scan, %.5f%% of a core at %.0f scans/s\n", perScan * 1e6,
+           perScan * scansPerSecond * 100, scansPerSecond);
+    printf("full diff     %8.2f ms\n", diffSeconds * 1e3);
+    return rows == lineCount ? 0 : 1;
+}
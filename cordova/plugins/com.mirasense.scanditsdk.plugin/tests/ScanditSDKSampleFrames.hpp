@@ -0,0 +1,108 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_SAMPLE_FRAMES_HPP
+#define SCANDITSDK_SAMPLE_FRAMES_HPP
+
+#include "ScanditSDKTest.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Synthetic luminance planes that stand in for sampled camera frames: a barcode under uneven
+ * light with sensor noise, the same out of focus, a dark shelf and a barcode with a specular
+ * highlight. Shared by the frame statistics tests and benchmark.
+ */
+namespace scanditsdk {
+namespace test {
+
+enum Scene {
+    SceneBarcode = 0,
+    SceneBlurred,
+    SceneDark,
+    SceneGlare,
+    SceneCount
+};
+
+inline const char *sceneName(Scene scene) {
+    static const char *const names[SceneCount] = { "barcode", "blurred", "dark", "glare" };
+    return names[scene];
+}
+
+inline uint8_t clampPixel(int value) {
+    return (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+/** A width x height plane of scene, rows stride bytes apart (stride >= width). */
+inline std::vector<uint8_t> sampleFrame(Scene scene, size_t width, size_t height, size_t stride,
+                                        uint32_t seed = 1) {
+    Random random(seed);
+    std::vector<uint8_t> frame(stride * height + 16);
+    // Bars of one to four modules, so that edges are irregular as in a real code.
+    std::vector<uint8_t> bars(width);
+    size_t module = width / 120 + 1;
+    for (size_t x = 0, bar = 0; x < width; ++bar) {
+        size_t runLength = module * (1 + random.below(4));
+        for (size_t i = 0; i < runLength && x < width; ++i, ++x) {
+            bars[x] = bar & 1;
+        }
+    }
+    for (size_t y = 0; y < height; ++y) {
+        uint8_t *row = &frame[y * stride];
+        for (size_t x = 0; x < width; ++x) {
+            int light = 110 + (int)(60 * x / (width ? width : 1)) - (int)(30 * y / (height ? height : 1));
+            int value = bars[x] ? light / 5 : light + 40;
+            if (scene == SceneDark) {
+                value /= 6;
+            }
+            if (scene == SceneGlare) {
+                long dx = (long)x - (long)(width * 2 / 3), dy = (long)y - (long)(height / 3);
+                long radius = (long)(height / 5) + 1;
+                if (dx * dx + dy * dy < radius * radius) {
+                    value = 255;
+                }
+            }
+            row[x] = clampPixel(value + (int)random.below(17) - 8);
+        }
+        // Padding between rows must not be read.
+        for (size_t x = width; x < stride; ++x) {
+            row[x] = (uint8_t)random.next();
+        }
+    }
+    if (scene == SceneBlurred) {
+        // Horizontal box blur over 2 modules each side, the bars run vertically.
+        std::vector<uint8_t> blurred(frame);
+        size_t radius = 2 * module;
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                size_t from = x < radius ? 0 : x - radius, to = x + radius < width ? x + radius : width - 1;
+                unsigned sum = 0;
+                for (size_t i = from; i <= to; ++i) {
+                    sum += frame[y * stride + i];
+                }
+                blurred[y * stride + x] = (uint8_t)(sum / (to - from + 1));
+            }
+        }
+        frame.swap(blurred);
+    }
+    return frame;
+}
+
+} // namespace test
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_SAMPLE_FRAMES_HPP
@@ -0,0 +1,203 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKScanResultEncoder.h"
+#include "ScanditSDKTest.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint16_t> Text;
+
+Text text(const char *ascii) {
+    Text out;
+    while (*ascii) {
+        out.push_back((uint8_t)*ascii++);
+    }
+    return out;
+}
+
+struct Sample {
+    Sample(const char *code, const char *symbology, double timestamp, bool manual, const char *gtin)
+        : code(text(code)), symbology(text(symbology)), timestamp(timestamp), manual(manual), hasGtin(gtin != NULL),
+          gtin(text(gtin ? gtin : "")) {}
+
+    Text code;
+    Text symbology;
+    double timestamp;
+    bool manual;
+    bool hasGtin;
+    Text gtin;
+};
+
+/**
+ * The generic path the schema encoder replaces: the legacy [barcode, symbology] array plus the
+ * new fields is built as a tree of boxed values (as an NSArray of NSStrings and NSNumbers would
+ * be) and written by a serializer that knows nothing about the layout.
+ */
+struct Value {
+    enum Type { Null, Bool, Number, String, Array } type;
+    bool boolean;
+    double number;
+    Text string;
+    std::vector<Value> items;
+
+    explicit Value(Type t = Null) : type(t), boolean(false), number(0) {}
+};
+
+void writeString(const Text &value, Text *out) {
+    static const char hex[] = "0123456789abcdef";
+    out->push_back('"');
+    for (size_t i = 0; i < value.size(); ++i) {
+        uint16_t c = value[i];
+        if (c == '"' || c == '\\') {
+            out->push_back('\\');
+            out->push_back(c);
+        } else if (c < 0x20 || c == 0x2028 || c == 0x2029) {
+            const uint16_t escaped[] = { '\\', 'u', (uint16_t)hex[c >> 12], (uint16_t)hex[(c >> 8) & 0xf],
+                                         (uint16_t)hex[(c >> 4) & 0xf], (uint16_t)hex[c & 0xf] };
+            out->insert(out->end(), escaped, escaped + 6);
+        } else {
+            out->push_back(c);
+        }
+    }
+    out->push_back('"');
+}
+
+void writeValue(const Value &value, Text *out) {
+    switch (value.type) {
+        case Value::Null: {
+            Text null = text("null");
+            out->insert(out->end(), null.begin(), null.end());
+            break;
+        }
+        case Value::Bool: {
+            Text word = text(value.boolean ? "true" : "false");
+            out->insert(out->end(), word.begin(), word.end());
+            break;
+        }
+        case Value::Number: {
+            char digits[32];
+            snprintf(digits, sizeof(digits), "%.17g", isfinite(value.number) ? value.number : 0.0);
+            Text number = text(digits);
+            out->insert(out->end(), number.begin(), number.end());
+            break;
+        }
+        case Value::String:
+            writeString(value.string, out);
+            break;
+        case Value::Array:
+            out->push_back('[');
+            for (size_t i = 0; i < value.items.size(); ++i) {
+                if (i > 0) {
+                    out->push_back(',');
+                }
+                writeValue(value.items[i], out);
+            }
+            out->push_back(']');
+            break;
+    }
+}
+
+Text encodeGeneric(const Sample &sample) {
+    Value result(Value::Array);
+    result.items.resize(sample.hasGtin ? 5 : 4);
+    result.items[0].type = Value::String;
+    result.items[0].string = sample.code;
+    result.items[1].type = Value::String;
+    result.items[1].string = sample.symbology;
+    result.items[2].type = Value::Number;
+    result.items[2].number = sample.timestamp;
+    result.items[3].type = Value::Bool;
+    result.items[3].boolean = sample.manual;
+    if (sample.hasGtin) {
+        result.items[4].type = Value::String;
+        result.items[4].string = sample.gtin;
+    }
+    Text out;
+    writeValue(result, &out);
+    return out;
+}
+
+size_t encodeSchema(const Sample &sample, Text *buffer) {
+    size_t bound = scanditsdk_scan_result_bound(sample.code.size(), sample.symbology.size(), sample.gtin.size());
+    if (buffer->size() < bound) {
+        buffer->resize(bound);
+    }
+    return scanditsdk_scan_result_encode(&(*buffer)[0], &sample.code[0], sample.code.size(), &sample.symbology[0],
+                                         sample.symbology.size(), sample.timestamp, sample.manual,
+                                         sample.hasGtin ? &sample.gtin[0] : NULL, sample.gtin.size());
+}
+
+} // namespace
+
+/**
+ * Encoding time per scan result, the schema encoder against generic serialization of the same
+ * array, on 1000 retail and QR results (half of them with a GTIN) repeated 1000 times (times the
+ * scale argument). Both produce the same literal, which is checked first.
+ */
+int main(int argc, char **argv) {
+    const int rounds = (int)ceil(1000 * scanditsdk::test::benchScale(argc, argv));
+    std::vector<Sample> samples;
+    for (int i = 0; i < 1000; ++i) {
+        char code[32], gtin[32];
+        snprintf(code, sizeof(code), "40%d%d", 1000000000 + i * 7919, i % 10);
+        snprintf(gtin, sizeof(gtin), "0040%d", 1000000000 + i);
+        samples.push_back(Sample(code, scanditsdk_symbology_name((ScanditSDKSymbology)(1 + i % (ScanditSDKSymbologyCount - 1))),
+                                 1381000000000.0 + i, i % 5 == 0, i % 2 == 0 ? gtin : NULL));
+    }
+    Sample quoted("line separator \"quoted\" \\", "QR", 1, false, NULL);
+    quoted.code[4] = 0x2028;
+    samples.push_back(quoted);
+
+    Text buffer;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        size_t length = encodeSchema(samples[i], &buffer);
+        if (Text(buffer.begin(), buffer.begin() + length) != encodeGeneric(samples[i])) {
+            fprintf(stderr, "the encoders disagree on sample %lu\n", (unsigned long)i);
+            return 1;
+        }
+    }
+
+    size_t schemaSink = 0;
+    double start = scanditsdk::test::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < samples.size(); ++i) {
+            size_t length = encodeSchema(samples[i], &buffer);
+            schemaSink += length + buffer[length / 2];
+        }
+    }
+    double schemaSeconds = scanditsdk::test::now() - start;
+
+    size_t genericSink = 0;
+    start = scanditsdk::test::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < samples.size(); ++i) {
+            Text literal = encodeGeneric(samples[i]);
+            genericSink += literal.size() + literal[literal.size() / 2];
+        }
+    }
+    double genericSeconds = scanditsdk::test::now() - start;
+
+    double count = (double)rounds * samples.size();
+    printf("%lu results x %d rounds (checksums %lu, %lu)\n", (unsigned long)samples.size(), rounds,
+           (unsigned long)schemaSink, (unsigned long)genericSink);
+    printf("schema encoder      %6.1f ns/result\n", schemaSeconds * 1e9 / count);
+    printf("generic array       %6.1f ns/result\n", genericSeconds * 1e9 / count);
+    return schemaSink == genericSink ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKScanResultEncoder.h"
+#include "ScanditSDKTest.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint16_t> Text;
+
+Text text(const char *ascii) {
+    return Text(ascii, ascii + strlen(ascii));
+}
+
+std::string ascii(const Text &value) {
+    std::string out;
+    for (size_t i = 0; i < value.size(); ++i) {
+        out += (value[i] < 0x80) ? (char)value[i] : '?';
+    }
+    return out;
+}
+
+const uint16_t *chars(const Text &value) {
+    return value.empty() ? NULL : &value[0];
+}
+
+Text escape(const Text &value) {
+    Text out(6 * value.size() + 2);
+    out.resize(scanditsdk_js_string(&out[0], chars(value), value.size()));
+    return out;
+}
+
+/** One decoded array entry: a string, a number, true/false or null. */
+struct Entry {
+    enum Type { String, Number, Bool, Null } type;
+    Text string;
+    double number;
+    bool boolean;
+};
+
+int hexValue(uint16_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * Reads a JS string literal at literal[*pos], written independently of the encoder. Fails on
+ * anything a JS engine would reject in a string literal: raw control characters and line
+ * terminators (including U+2028/U+2029 for engines before ES2019) and unknown escapes.
+ */
+bool parseString(const Text &literal, size_t *pos, Text *out) {
+    if (*pos >= literal.size() || literal[*pos] != '"') {
+        return false;
+    }
+    for (size_t i = *pos + 1; i < literal.size(); ++i) {
+        uint16_t c = literal[i];
+        if (c == '"') {
+            *pos = i + 1;
+            return true;
+        }
+        if (c < 0x20 || c == 0x2028 || c == 0x2029) {
+            return false;
+        }
+        if (c != '\\') {
+            out->push_back(c);
+            continue;
+        }
+        if (++i >= literal.size()) {
+            return false;
+        }
+        switch (literal[i]) {
+            case '"': out->push_back('"'); break;
+            case '\\': out->push_back('\\'); break;
+            case 'u': {
+                if (i + 4 >= literal.size()) {
+                    return false;
+                }
+                int value = 0;
+                for (int d = 1; d <= 4; ++d) {
+                    int digit = hexValue(literal[i + d]);
+                    if (digit < 0) {
+                        return false;
+                    }
+                    value = value * 16 + digit;
+                }
+                out->push_back((uint16_t)value);
+                i += 4;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+/** Reads an array literal of strings, numbers, booleans and nulls, with nothing after it. */
+bool parseArray(const Text &literal, std::vector<Entry> *entries) {
+    size_t pos = 0;
+    if (literal.empty() || literal[pos++] != '[') {
+        return false;
+    }
+    while (pos < literal.size() && literal[pos] != ']') {
+        if (!entries->empty() && literal[pos++] != ',') {
+            return false;
+        }
+        Entry entry;
+        entry.number = 0;
+        entry.boolean = false;
+        std::string word;
+        if (pos < literal.size() && literal[pos] == '"') {
+            entry.type = Entry::String;
+            if (!parseString(literal, &pos, &entry.string)) {
+                return false;
+            }
+        } else {
+            while (pos < literal.size() && literal[pos] != ',' && literal[pos] != ']') {
+                word += (char)literal[pos++];
+            }
+            if (word == "true" || word == "false") {
+                entry.type = Entry::Bool;
+                entry.boolean = word == "true";
+            } else if (word == "null") {
+                entry.type = Entry::Null;
+            } else {
+                char *end = NULL;
+                entry.type = Entry::Number;
+                entry.number = strtod(word.c_str(), &end);
+                if (word.empty() || *end != '\0' || word.find_first_not_of("0123456789+-.e") != std::string::npos) {
+                    return false;
+                }
+            }
+        }
+        entries->push_back(entry);
+    }
+    return pos + 1 == literal.size();
+}
+
+/** Encodes into a buffer with guard characters past the bound, which must stay untouched. */
+Text encode(const Text *code, const Text *symbology, double timestamp, bool manual, const Text *gtin) {
+    const uint16_t kGuard = 0xfffe;
+    size_t codeLength = code ? code->size() : 0;
+    size_t symbologyLength = symbology ? symbology->size() : 0;
+    size_t gtinLength = gtin ? gtin->size() : 0;
+    size_t bound = scanditsdk_scan_result_bound(codeLength, symbologyLength, gtinLength);
+    Text out(bound + 8, kGuard);
+    // An empty string is still a string, not nil.
+    static const uint16_t empty = 0;
+    size_t length = scanditsdk_scan_result_encode(&out[0],
+                                                  code ? (codeLength ? &(*code)[0] : &empty) : NULL, codeLength,
+                                                  symbology ? (symbologyLength ? &(*symbology)[0] : &empty) : NULL,
+                                                  symbologyLength, timestamp, manual,
+                                                  gtin ? (gtinLength ? &(*gtin)[0] : &empty) : NULL, gtinLength);
+    CHECK(length <= bound);
+    for (size_t i = bound; i < out.size(); ++i) {
+        CHECK(out[i] == kGuard);
+    }
+    out.resize(length);
+    return out;
+}
+
+std::string encodeASCII(const char *code, const char *symbology, double timestamp, bool manual, const char *gtin) {
+    Text codeText = code ? text(code) : Text();
+    Text symbologyText = symbology ? text(symbology) : Text();
+    Text gtinText = gtin ? text(gtin) : Text();
+    return ascii(encode(code ? &codeText : NULL, symbology ? &symbologyText : NULL, timestamp, manual,
+                        gtin ? &gtinText : NULL));
+}
+
+void testEscaping() {
+    CHECK(ascii(escape(Text())) == "\"\"");
+    CHECK(ascii(escape(text("4006381333931"))) == "\"4006381333931\"");
+    CHECK(ascii(escape(text("say \"hi\""))) == "\"say \\\"hi\\\"\"");
+    CHECK(ascii(escape(text("C:\\dir"))) == "\"C:\\\\dir\"");
+    // Slashes and markup need no escaping inside a string literal.
+    CHECK(ascii(escape(text("</script>"))) == "\"</script>\"");
+
+    const char *hex = "0123456789abcdef";
+    for (uint16_t c = 0; c < 0x20; ++c) {
+        std::string expected = "\"\\u00";
+        expected += hex[c >> 4];
+        expected += hex[c & 0xf];
+        expected += "\"";
+        CHECK(ascii(escape(Text(1, c))) == expected);
+    }
+
+    // Line and paragraph separators are line terminators in JS source.
+    CHECK(ascii(escape(Text(1, 0x2028))) == "\"\\u2028\"");
+    CHECK(ascii(escape(Text(1, 0x2029))) == "\"\\u2029\"");
+
+    // Everything else, including DEL, non-ASCII and surrogate pairs, is written as is.
+    const uint16_t plain[] = { 0x20, 0x7f, 0xe9, 0x20ac, 0x2027, 0x202a, 0xd83d, 0xde00, 0xfeff };
+    Text plainText(plain, plain + sizeof(plain) / sizeof(plain[0]));
+    Text escaped = escape(plainText);
+    CHECK(escaped.size() == plainText.size() + 2);
+    CHECK(Text(escaped.begin() + 1, escaped.end() - 1) == plainText);
+}
+
+/** Random strings, mostly made of the characters that need escaping, survive a parse. */
+void testStringRoundTrip() {
+    const uint16_t special[] = { '"', '\\', 0, '\n', '\r', '\t', 0x1f, 0x2028, 0x2029, 0xd800, 0xdfff, 'u', 0x7f };
+    scanditsdk::test::Random random(7);
+    for (int round = 0; round < 5000; ++round) {
+        Text value(random.below(40));
+        for (size_t i = 0; i < value.size(); ++i) {
+            value[i] = random.below(2) ? special[random.below(sizeof(special) / sizeof(special[0]))]
+                                       : (uint16_t)random.next();
+        }
+        Text escaped = escape(value);
+        CHECK(escaped.size() <= 6 * value.size() + 2);
+        size_t pos = 0;
+        Text decoded;
+        CHECK(parseString(escaped, &pos, &decoded));
+        CHECK(pos == escaped.size());
+        CHECK(decoded == value);
+    }
+}
+
+void testLayout() {
+    CHECK(encodeASCII("4006381333931", "EAN13", 1381000000000.0, false, "04006381333931") ==
+          "[\"4006381333931\",\"EAN13\",1381000000000,false,\"04006381333931\"]");
+    // A nil trailing optional field is left out, so the legacy [barcode, symbology] prefix is all
+    // an old callback sees.
+    CHECK(encodeASCII("HELLO", "QR", 1381000000123.0, true, NULL) == "[\"HELLO\",\"QR\",1381000000123,true]");
+    CHECK(encodeASCII("", "", 0, false, "") == "[\"\",\"\",0,false,\"\"]");
+    CHECK(encodeASCII(NULL, NULL, 0, false, NULL) == "[\"\",\"UNKNOWN\",0,false]");
+
+    // Names in the schema are written from the table, others are escaped and passed through.
+    CHECK(encodeASCII("x", "UNKNOWN", 0, false, NULL) == "[\"x\",\"UNKNOWN\",0,false]");
+    CHECK(encodeASCII("x", "GS1-DATABAR-EXPANDED", 0, false, NULL) == "[\"x\",\"GS1-DATABAR-EXPANDED\",0,false]");
+    CHECK(encodeASCII("x", "qr", 0, false, NULL) == "[\"x\",\"qr\",0,false]");
+    CHECK(encodeASCII("x", "EAN", 0, false, NULL) == "[\"x\",\"EAN\",0,false]");
+    CHECK(encodeASCII("x", "EAN130", 0, false, NULL) == "[\"x\",\"EAN130\",0,false]");
+    CHECK(encodeASCII("x", "Q\"R\n", 0, false, NULL) == "[\"x\",\"Q\\\"R\\u000a\",0,false]");
+
+    // Numbers keep 17 significant digits; JSON has no literal for NaN and infinities.
+    CHECK(encodeASCII("x", "QR", 0.5, false, NULL) == "[\"x\",\"QR\",0.5,false]");
+    CHECK(encodeASCII("x", "QR", -1, false, NULL) == "[\"x\",\"QR\",-1,false]");
+    CHECK(encodeASCII("x", "QR", 0.1, false, NULL) == "[\"x\",\"QR\",0.10000000000000001,false]");
+    CHECK(encodeASCII("x", "QR", NAN, false, NULL) == "[\"x\",\"QR\",0,false]");
+    CHECK(encodeASCII("x", "QR", INFINITY, false, NULL) == "[\"x\",\"QR\",0,false]");
+    CHECK(encodeASCII("x", "QR", -INFINITY, false, NULL) == "[\"x\",\"QR\",0,false]");
+}
+
+/** Every field at its longest fills the bound exactly. */
+void testBoundIsTight() {
+    Text code(3, 0x2028), symbology(5, '\n'), gtin(14, 0);
+    size_t bound = scanditsdk_scan_result_bound(code.size(), symbology.size(), gtin.size());
+    Text literal = encode(&code, &symbology, -1.2345678901234567e-308, false, &gtin);
+    CHECK(literal.size() == bound);
+}
+
+/** Random results, including the longest numbers and symbology names, parse back to their fields. */
+void testResultRoundTrip() {
+    const uint16_t special[] = { '"', '\\', 0, '\n', 0x1f, 0x2028, 0x2029, ',', ']', '[' };
+    const double timestamps[] = { 0, -0.0, 1381000000000.0, 0.1, -1.2345678901234567e-308, 1.7976931348623157e308, -5e-324 };
+    scanditsdk::test::Random random(11);
+    for (int round = 0; round < 5000; ++round) {
+        Text fields[3];
+        for (int f = 0; f < 3; ++f) {
+            fields[f].resize(random.below(24));
+            for (size_t i = 0; i < fields[f].size(); ++i) {
+                fields[f][i] = random.below(3) ? special[random.below(sizeof(special) / sizeof(special[0]))]
+                                               : (uint16_t)random.next();
+            }
+        }
+        if (random.below(3) == 0) {
+            fields[1] = text(scanditsdk_symbology_name((ScanditSDKSymbology)random.below(ScanditSDKSymbologyCount)));
+        }
+        double timestamp = timestamps[random.below(sizeof(timestamps) / sizeof(timestamps[0]))];
+        bool manual = random.below(2) != 0;
+        bool hasGtin = random.below(2) != 0;
+
+        std::vector<Entry> entries;
+        CHECK(parseArray(encode(&fields[0], &fields[1], timestamp, manual, hasGtin ? &fields[2] : NULL), &entries));
+        CHECK(entries.size() == (hasGtin ? 5u : 4u));
+        if (entries.size() < 4) {
+            continue;
+        }
+        CHECK(entries[0].type == Entry::String && entries[0].string == fields[0]);
+        CHECK(entries[1].type == Entry::String && entries[1].string == fields[1]);
+        CHECK(entries[2].type == Entry::Number && entries[2].number == timestamp);
+        CHECK(entries[3].type == Entry::Bool && entries[3].boolean == manual);
+        if (hasGtin && entries.size() == 5) {
+            CHECK(entries[4].type == Entry::String && entries[4].string == fields[2]);
+        }
+    }
+}
+
+void testSymbologyNames() {
+    for (int i = 0; i < ScanditSDKSymbologyCount; ++i) {
+        Text name = text(scanditsdk_symbology_name((ScanditSDKSymbology)i));
+        CHECK(scanditsdk_symbology_from_utf16(&name[0], name.size()) == (ScanditSDKSymbology)i);
+    }
+    CHECK(strcmp(scanditsdk_symbology_name(ScanditSDKSymbologyQr), "QR") == 0);
+    CHECK(strcmp(scanditsdk_symbology_name(ScanditSDKSymbologyCount), "UNKNOWN") == 0);
+    CHECK(strcmp(scanditsdk_symbology_name((ScanditSDKSymbology)-1), "UNKNOWN") == 0);
+    CHECK(scanditsdk_symbology_from_utf16(NULL, 0) == ScanditSDKSymbologyUnknown);
+    Text prefix = text("EAN1");
+    CHECK(scanditsdk_symbology_from_utf16(&prefix[0], prefix.size()) == ScanditSDKSymbologyUnknown);
+    Text longer = text("QRS");
+    CHECK(scanditsdk_symbology_from_utf16(&longer[0], 2) == ScanditSDKSymbologyQr);
+    CHECK(scanditsdk_symbology_from_utf16(&longer[0], longer.size()) == ScanditSDKSymbologyUnknown);
+    // A UTF-16 character that only matches a name in its low byte.
+    Text wide = text("QR");
+    wide[1] = 0x152;
+    CHECK(scanditsdk_symbology_from_utf16(&wide[0], wide.size()) == ScanditSDKSymbologyUnknown);
+}
+
+} // namespace
+
+int main() {
+    testEscaping();
+    testStringRoundTrip();
+    testLayout();
+    testBoundIsTight();
+    testResultRoundTrip();
+    testSymbologyNames();
+    return scanditsdk::test::testResult();
+}
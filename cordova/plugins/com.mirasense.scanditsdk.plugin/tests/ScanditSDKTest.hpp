@@ -0,0 +1,89 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_TEST_HPP
+#define SCANDITSDK_TEST_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Minimal harness for the Linux tests and benchmarks of the portable C++ cores in src/ios.
+ *
+ * CHECK records a failure and carries on, so one run reports every broken case; a test's main
+ * returns testResult(). Benchmarks take an optional scale factor as their only argument, which
+ * ctest sets low to keep them as smoke tests; run them by hand without it for real numbers.
+ */
+namespace scanditsdk {
+namespace test {
+
+inline int &failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char *file, int line, const char *expression) {
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    failures()++;
+}
+
+inline int testResult() {
+    if (failures() != 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures());
+        return 1;
+    }
+    return 0;
+}
+
+/** Seconds on a monotonic clock. */
+inline double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** The scale argument of a benchmark, 1 without one. */
+inline double benchScale(int argc, char **argv) {
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+    return scale > 0 ? scale : 1;
+}
+
+/** Deterministic xorshift32, so failures reproduce on every machine. */
+class Random {
+public:
+    explicit Random(uint32_t seed = 2463534242u) : state_(seed ? seed : 1) {}
+
+    uint32_t next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+
+    uint32_t below(uint32_t bound) { return next() % bound; }
+
+private:
+    uint32_t state_;
+};
+
+} // namespace test
+} // namespace scanditsdk
+
+#define CHECK(expression) \
+    ((expression) ? (void)0 : scanditsdk::test::fail(__FILE__, __LINE__, #expression))
+
+#endif // SCANDITSDK_TEST_HPP
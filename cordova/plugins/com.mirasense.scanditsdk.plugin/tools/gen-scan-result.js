@@ -0,0 +1,644 @@
+#!/usr/bin/env node
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+/*
+ * Generates the fixed-schema scan result encoder and the matching JS decoder
+ * from schema/scan-result.json:
+ *
+ *   src/ios/<Prefix><Name>Encoder.h/.c  the encoder, plain C on UTF-16 text
+ *   src/ios/<Prefix><Name>.h/.m         its NSString front end
+ *   www/<Name>.js                       the decoder
+ *
+ * The encoder writes the result as a positional JS array literal, escaping
+ * strings itself instead of going through NSJSONSerialization. Enum values
+ * are written from precomputed literals. Trailing optional fields that are
+ * nil are left out. tests/ builds the C encoder on Linux, tests it, and
+ * benchmarks it against generic serialization of the same array.
+ *
+ * Usage (from the plugin root):
+ *   tools/gen-scan-result.js [--check] [--bench]
+ *
+ *   --check  exit with status 1 if the generated files are out of date
+ *   --bench  compare the generated decoder with reading the array directly
+ */
+
+var fs = require('fs'),
+    path = require('path');
+
+var root = path.join(__dirname, '..'),
+    schema = JSON.parse(fs.readFileSync(path.join(root, 'schema', 'scan-result.json'), 'utf8'));
+
+var BANNER = '// Generated by tools/gen-scan-result.js from schema/scan-result.json. Do not edit.\n';
+
+function camel(value) {
+    return value.toLowerCase().split(/[^a-z0-9]+/).map(function(part) {
+        return part.charAt(0).toUpperCase() + part.slice(1);
+    }).join('');
+}
+
+function capitalize(name) {
+    return name.charAt(0).toUpperCase() + name.slice(1);
+}
+
+function enumTypeName(field) {
+    return schema.prefix + capitalize(field.name);
+}
+
+function objcParamType(field) {
+    switch (field.type) {
+        case 'string': return 'NSString*';
+        case 'enum': return 'NSString*';
+        case 'double': return 'double';
+        case 'bool': return 'BOOL';
+    }
+    throw new Error('Unknown field type ' + field.type);
+}
+
+function encoderName() {
+    return schema.prefix + 'Encode' + schema.name;
+}
+
+function encoderSignature() {
+    return 'NSString* ' + encoderName() + '(' + schema.fields.map(function(field) {
+        return objcParamType(field) + ' ' + field.name;
+    }).join(', ') + ')';
+}
+
+function snake(name) {
+    return name.replace(/([a-z0-9])([A-Z])/g, '$1_$2').toLowerCase();
+}
+
+// scanditsdk_scan_result<suffix>, scanditsdk_symbology<suffix>, ...
+function cName(name, suffix) {
+    return schema.prefix.toLowerCase() + '_' + snake(name) + suffix;
+}
+
+function isText(field) {
+    return field.type == 'string' || field.type == 'enum';
+}
+
+function cParams(field) {
+    switch (field.type) {
+        case 'string':
+        case 'enum':
+            return 'const uint16_t* ' + field.name + ', size_t ' + field.name + 'Length';
+        case 'double': return 'double ' + field.name;
+        case 'bool': return 'int ' + field.name;
+    }
+    throw new Error('Unknown field type ' + field.type);
+}
+
+function boundSignature() {
+    return 'size_t ' + cName(schema.name, '_bound') + '(' + schema.fields.filter(isText).map(function(field) {
+        return 'size_t ' + field.name + 'Length';
+    }).join(', ') + ')';
+}
+
+function encodeSignature() {
+    return 'size_t ' + cName(schema.name, '_encode') + '(uint16_t* out, ' + schema.fields.map(cParams).join(', ') + ')';
+}
+
+function encoderBaseName() {
+    return schema.prefix + schema.name + 'Encoder';
+}
+
+// Longest characters of a number written with %.17g, e.g. -1.2345678901234567e-308.
+var NUMBER_MAX = 24;
+
+function fieldComments() {
+    return schema.fields.map(function(field, i) {
+        return ' ' + i + ': ' + field.name + ' (' + field.type + (field.optional ? ', optional, nil to omit' : '') + ')' +
+               (field.comment ? ' - ' + field.comment : '');
+    });
+}
+
+function generateCHeader() {
+    var guard = cName(schema.name, '_encoder_h').toUpperCase(),
+        out = [BANNER];
+
+    out.push('/*');
+    out.push(' The encoder behind ' + encoderName() + ', in plain C on UTF-16 text and with no');
+    out.push(' allocations of its own, so it builds and can be tested and benchmarked outside');
+    out.push(' of iOS; tests/ does that on Linux.');
+    out.push(' */');
+    out.push('');
+    out.push('#ifndef ' + guard);
+    out.push('#define ' + guard);
+    out.push('');
+    out.push('#include <stddef.h>');
+    out.push('#include <stdint.h>');
+    out.push('');
+    out.push('#ifdef __cplusplus');
+    out.push('extern "C" {');
+    out.push('#endif');
+    out.push('');
+
+    schema.fields.forEach(function(field) {
+        if (field.type != 'enum') {
+            return;
+        }
+        var type = enumTypeName(field);
+        out.push('typedef enum {');
+        field.values.forEach(function(value, i) {
+            out.push('    ' + type + camel(value) + (i === 0 ? ' = 0' : '') + ',');
+        });
+        out.push('    ' + type + 'Count');
+        out.push('} ' + type + ';');
+        out.push('');
+        out.push('// The schema name of value, that of ' + type + camel(field.values[0]) + ' if it is out of range.');
+        out.push('const char* ' + cName(field.name, '_name') + '(' + type + ' value);');
+        out.push('// Returns ' + type + camel(field.values[0]) + ' for names outside the schema.');
+        out.push(type + ' ' + cName(field.name, '_from_utf16') + '(const uint16_t* name, size_t length);');
+        out.push('');
+    });
+
+    out.push('// Writes chars as a quoted JS string literal to out, which has room for 6 * length + 2');
+    out.push('// characters, and returns the number of characters written. Besides quotes, backslashes');
+    out.push('// and control characters, U+2028/U+2029 are escaped: they end a line in JS source.');
+    out.push('size_t ' + schema.prefix.toLowerCase() + '_js_string(uint16_t* out, const uint16_t* chars, size_t length);');
+    out.push('');
+    out.push('/*');
+    out.push(' ' + schema.comment);
+    out.push('');
+    Array.prototype.push.apply(out, fieldComments());
+    out.push('');
+    out.push(' Strings are passed as UTF-16 characters and their length. A nil string is');
+    out.push(' written as "", a nil enum as its first value and a nil optional field as null,');
+    out.push(' or not at all when no later field is set. Enum names outside the schema are');
+    out.push(' passed through as strings.');
+    out.push('');
+    out.push(' ' + cName(schema.name, '_encode') + ' writes the JS array literal to out, which has room for');
+    out.push(' ' + cName(schema.name, '_bound') + '() characters, and returns the number of characters written.');
+    out.push(' */');
+    out.push(boundSignature() + ';');
+    out.push(encodeSignature() + ';');
+    out.push('');
+    out.push('#ifdef __cplusplus');
+    out.push('}');
+    out.push('#endif');
+    out.push('');
+    out.push('#endif');
+    out.push('');
+    return out.join('\n');
+}
+
+function cStringLiteral(value) {
+    if (!/^[\x20-\x7e]*$/.test(value) || /["\\]/.test(value)) {
+        throw new Error('Enum value ' + JSON.stringify(value) + ' must be printable ASCII without quotes or backslashes');
+    }
+    return '"' + value + '"';
+}
+
+function generateCImplementation() {
+    var jsString = schema.prefix.toLowerCase() + '_js_string',
+        ascii = schema.prefix.toLowerCase() + '_js_ascii',
+        number = schema.prefix.toLowerCase() + '_js_number',
+        out = [BANNER, '#include <math.h>', '#include <stdio.h>', '#include "' + encoderBaseName() + '.h"', ''];
+
+    schema.fields.forEach(function(field) {
+        if (field.type != 'enum') {
+            return;
+        }
+        var type = enumTypeName(field),
+            names = 'k' + type + 'Names',
+            index = cName(field.name, '_index');
+        out.push('static const char* const ' + names + '[' + type + 'Count] = {');
+        out.push('    ' + field.values.map(cStringLiteral).join(', '));
+        out.push('};');
+        out.push('');
+        out.push('const char* ' + cName(field.name, '_name') + '(' + type + ' value)');
+        out.push('{');
+        out.push('    return ((unsigned)value < ' + type + 'Count) ? ' + names + '[value] : ' + names + '[0];');
+        out.push('}');
+        out.push('');
+        out.push('// The index of name in ' + names + ', or -1.');
+        out.push('static int ' + index + '(const uint16_t* name, size_t length)');
+        out.push('{');
+        out.push('    for (int i = 0; i < ' + type + 'Count; ++i) {');
+        out.push('        const char* candidate = ' + names + '[i];');
+        out.push('        size_t j = 0;');
+        out.push('        while ((j < length) && (candidate[j] != \'\\0\') && (name[j] == (uint8_t)candidate[j])) {');
+        out.push('            ++j;');
+        out.push('        }');
+        out.push('        if ((j == length) && (candidate[j] == \'\\0\')) {');
+        out.push('            return i;');
+        out.push('        }');
+        out.push('    }');
+        out.push('    return -1;');
+        out.push('}');
+        out.push('');
+        out.push(type + ' ' + cName(field.name, '_from_utf16') + '(const uint16_t* name, size_t length)');
+        out.push('{');
+        out.push('    int i = ' + index + '(name, length);');
+        out.push('');
+        out.push('    return (i >= 0) ? (' + type + ')i : ' + type + camel(field.values[0]) + ';');
+        out.push('}');
+        out.push('');
+    });
+
+    out.push('size_t ' + jsString + '(uint16_t* out, const uint16_t* chars, size_t length)');
+    out.push('{');
+    out.push('    static const char hex[] = "0123456789abcdef";');
+    out.push('    size_t n = 0;');
+    out.push('');
+    out.push('    out[n++] = \'"\';');
+    out.push('    for (size_t i = 0; i < length; ++i) {');
+    out.push('        uint16_t c = chars[i];');
+    out.push('        if ((c == \'"\') || (c == \'\\\\\')) {');
+    out.push('            out[n++] = \'\\\\\';');
+    out.push('            out[n++] = c;');
+    out.push('        } else if ((c < 0x20) || (c == 0x2028) || (c == 0x2029)) {');
+    out.push('            out[n++] = \'\\\\\';');
+    out.push('            out[n++] = \'u\';');
+    out.push('            out[n++] = hex[(c >> 12) & 0xf];');
+    out.push('            out[n++] = hex[(c >> 8) & 0xf];');
+    out.push('            out[n++] = hex[(c >> 4) & 0xf];');
+    out.push('            out[n++] = hex[c & 0xf];');
+    out.push('        } else {');
+    out.push('            out[n++] = c;');
+    out.push('        }');
+    out.push('    }');
+    out.push('    out[n++] = \'"\';');
+    out.push('    return n;');
+    out.push('}');
+    out.push('');
+    out.push('// Writes text, which has nothing to escape.');
+    out.push('static size_t ' + ascii + '(uint16_t* out, const char* text)');
+    out.push('{');
+    out.push('    size_t n = 0;');
+    out.push('');
+    out.push('    while (text[n] != \'\\0\') {');
+    out.push('        out[n] = (uint8_t)text[n];');
+    out.push('        ++n;');
+    out.push('    }');
+    out.push('    return n;');
+    out.push('}');
+    out.push('');
+    out.push('// Writes at most ' + NUMBER_MAX + ' characters; 0 for NaN and infinities, which have no literal.');
+    out.push('static size_t ' + number + '(uint16_t* out, double value)');
+    out.push('{');
+    out.push('    char digits[32];');
+    out.push('    int length = snprintf(digits, sizeof(digits), "%.17g", isfinite(value) ? value : 0.0);');
+    out.push('');
+    out.push('    for (int i = 0; i < length; ++i) {');
+    out.push('        // Not even a locale with a decimal comma may break the literal.');
+    out.push('        out[i] = (digits[i] == \',\') ? \'.\' : (uint8_t)digits[i];');
+    out.push('    }');
+    out.push('    return (size_t)length;');
+    out.push('}');
+    out.push('');
+
+    out.push(boundSignature());
+    out.push('{');
+    out.push('    // Brackets and commas, then every field at its longest.');
+    out.push('    size_t bound = ' + (schema.fields.length + 1) + ';');
+    out.push('');
+    schema.fields.forEach(function(field) {
+        switch (field.type) {
+            case 'string':
+                out.push('    bound += 6 * ' + field.name + 'Length + 2;');
+                break;
+            case 'enum':
+                var longest = Math.max.apply(null, field.values.map(function(value) { return value.length + 2; }));
+                out.push('    bound += (6 * ' + field.name + 'Length + 2 > ' + longest + ') ? 6 * ' + field.name + 'Length + 2 : ' + longest + ';');
+                break;
+            case 'double':
+                out.push('    bound += ' + NUMBER_MAX + ';');
+                break;
+            case 'bool':
+                out.push('    bound += 5;');
+                break;
+        }
+    });
+    out.push('    return bound;');
+    out.push('}');
+    out.push('');
+
+    // Trailing optional fields are omitted when nil, so the encoder first
+    // finds the last field it has to write.
+    var lastRequired = -1;
+    schema.fields.forEach(function(field, i) {
+        if (!field.optional) {
+            lastRequired = i;
+        }
+    });
+
+    out.push(encodeSignature());
+    out.push('{');
+    out.push('    size_t n = 0;');
+    out.push('    int last = ' + lastRequired + ';');
+    out.push('');
+    schema.fields.forEach(function(field, i) {
+        if (field.optional) {
+            out.push('    if (' + field.name + ' != NULL) {');
+            out.push('        last = ' + i + ';');
+            out.push('    }');
+        }
+    });
+    out.push('');
+    out.push('    out[n++] = \'[\';');
+    schema.fields.forEach(function(field, i) {
+        var indent = '    ';
+        if (i > lastRequired) {
+            out.push('    if (last >= ' + i + ') {');
+            indent = '        ';
+        }
+        if (i > 0) {
+            out.push(indent + 'out[n++] = \',\';');
+        }
+        switch (field.type) {
+            case 'string':
+                if (field.optional) {
+                    out.push(indent + 'if (' + field.name + ' == NULL) {');
+                    out.push(indent + '    n += ' + ascii + '(out + n, "null");');
+                    out.push(indent + '} else {');
+                    out.push(indent + '    n += ' + jsString + '(out + n, ' + field.name + ', ' + field.name + 'Length);');
+                    out.push(indent + '}');
+                } else {
+                    out.push(indent + 'n += ' + jsString + '(out + n, ' + field.name + ', (' + field.name + ' != NULL) ? ' +
+                             field.name + 'Length : 0);');
+                }
+                break;
+            case 'enum':
+                var names = 'k' + enumTypeName(field) + 'Names',
+                    index = field.name + 'Index';
+                out.push(indent + 'int ' + index + ' = (' + field.name + ' != NULL) ? ' + cName(field.name, '_index') + '(' +
+                         field.name + ', ' + field.name + 'Length) : 0;');
+                out.push(indent + 'if (' + index + ' < 0) {');
+                out.push(indent + '    n += ' + jsString + '(out + n, ' + field.name + ', ' + field.name + 'Length);');
+                out.push(indent + '} else {');
+                out.push(indent + '    out[n++] = \'"\';');
+                out.push(indent + '    n += ' + ascii + '(out + n, ' + names + '[' + index + ']);');
+                out.push(indent + '    out[n++] = \'"\';');
+                out.push(indent + '}');
+                break;
+            case 'double':
+                out.push(indent + 'n += ' + number + '(out + n, ' + field.name + ');');
+                break;
+            case 'bool':
+                out.push(indent + 'n += ' + ascii + '(out + n, ' + field.name + ' ? "true" : "false");');
+                break;
+        }
+        if (i > lastRequired) {
+            out.push('    }');
+        }
+    });
+    out.push('    out[n++] = \']\';');
+    out.push('    return n;');
+    out.push('}');
+    out.push('');
+    return out.join('\n');
+}
+
+function generateHeader() {
+    var out = [BANNER, '#import <Foundation/Foundation.h>', '#include "' + encoderBaseName() + '.h"', ''];
+
+    schema.fields.forEach(function(field) {
+        if (field.type != 'enum') {
+            return;
+        }
+        var type = enumTypeName(field);
+        out.push('// Returns ' + type + camel(field.values[0]) + ' for names outside the schema.');
+        out.push('FOUNDATION_EXPORT ' + type + ' ' + type + 'FromString(NSString* name);');
+        out.push('FOUNDATION_EXPORT NSString* ' + type + 'Name(' + type + ' value);');
+        out.push('');
+    });
+
+    out.push('/*');
+    out.push(' ' + schema.comment);
+    out.push('');
+    Array.prototype.push.apply(out, fieldComments());
+    out.push('');
+    out.push(' Enum names outside the schema are passed through as strings. Returns nil if');
+    out.push(' out of memory. The literal is written by ' + cName(schema.name, '_encode') + '.');
+    out.push(' */');
+    out.push('FOUNDATION_EXPORT ' + encoderSignature() + ';');
+    out.push('');
+    return out.join('\n');
+}
+
+function objcStringLiteral(value) {
+    return '@"' + value.replace(/\\/g, '\\\\').replace(/"/g, '\\"') + '"';
+}
+
+function generateImplementation() {
+    var headerName = schema.prefix + schema.name + '.h',
+        out = [BANNER, '#import "' + headerName + '"', ''];
+
+    schema.fields.forEach(function(field) {
+        if (field.type != 'enum') {
+            return;
+        }
+        var type = enumTypeName(field);
+        out.push('static NSString* const k' + type + 'Names[' + type + 'Count] = {');
+        out.push('    ' + field.values.map(objcStringLiteral).join(', '));
+        out.push('};');
+        out.push('');
+        out.push(type + ' ' + type + 'FromString(NSString* name)');
+        out.push('{');
+        out.push('    for (int i = 0; i < ' + type + 'Count; ++i) {');
+        out.push('        if ([name isEqualToString:k' + type + 'Names[i]]) {');
+        out.push('            return (' + type + ')i;');
+        out.push('        }');
+        out.push('    }');
+        out.push('    return ' + type + camel(field.values[0]) + ';');
+        out.push('}');
+        out.push('');
+        out.push('NSString* ' + type + 'Name(' + type + ' value)');
+        out.push('{');
+        out.push('    return (value < ' + type + 'Count) ? k' + type + 'Names[value] : k' + type + 'Names[0];');
+        out.push('}');
+        out.push('');
+    });
+
+    var texts = schema.fields.filter(isText);
+
+    out.push('// Up to this many characters, the strings and the literal are built on the stack.');
+    out.push('#define ENCODE_STACK_CHARS 1024');
+    out.push('');
+    out.push(encoderSignature());
+    out.push('{');
+    texts.forEach(function(field) {
+        out.push('    NSUInteger ' + field.name + 'Length = [' + field.name + ' length];');
+    });
+    out.push('    // The characters of the strings, then the literal.');
+    out.push('    size_t capacity = ' + texts.map(function(field) { return field.name + 'Length'; }).join(' + ') + ' + ' +
+             cName(schema.name, '_bound') + '(' + texts.map(function(field) { return field.name + 'Length'; }).join(', ') + ');');
+    out.push('    unichar stackBuffer[ENCODE_STACK_CHARS];');
+    out.push('    unichar* buffer = (capacity <= ENCODE_STACK_CHARS) ? stackBuffer : malloc(capacity * sizeof(unichar));');
+    out.push('    unichar* next = buffer;');
+    out.push('');
+    out.push('    if (buffer == NULL) {');
+    out.push('        return nil;');
+    out.push('    }');
+    texts.forEach(function(field) {
+        out.push('    const unichar* ' + field.name + 'Chars = next;');
+        out.push('    [' + field.name + ' getCharacters:next range:NSMakeRange(0, ' + field.name + 'Length)];');
+        out.push('    next += ' + field.name + 'Length;');
+    });
+    out.push('');
+    out.push('    size_t length = ' + cName(schema.name, '_encode') + '(next, ' + schema.fields.map(function(field) {
+        if (isText(field)) {
+            return '(' + field.name + ' != nil) ? ' + field.name + 'Chars : NULL, ' + field.name + 'Length';
+        }
+        return field.name;
+    }).join(', ') + ');');
+    out.push('    NSString* js = [[NSString alloc] initWithCharacters:next length:length];');
+    out.push('');
+    out.push('    if (buffer != stackBuffer) {');
+    out.push('        free(buffer);');
+    out.push('    }');
+    out.push('    return js;');
+    out.push('}');
+    out.push('');
+    return out.join('\n');
+}
+
+function generateDecoder() {
+    var out = [BANNER];
+
+    schema.fields.forEach(function(field) {
+        if (field.type == 'enum') {
+            var constName = field.name.toUpperCase() + '_NAMES';
+            out.push('var ' + constName + ' = ' + JSON.stringify(field.values) + ';');
+            out.push('var ' + field.name.toUpperCase() + '_IDS = {};');
+            out.push(constName + '.forEach(function(name, i) { ' + field.name.toUpperCase() + '_IDS[name] = i; });');
+            out.push('');
+        }
+    });
+
+    out.push('/**');
+    out.push(' * ' + schema.comment);
+    out.push(' */');
+    out.push('function ' + schema.name + '(payload) {');
+    schema.fields.forEach(function(field, i) {
+        var value = 'payload[' + i + ']';
+        switch (field.type) {
+            case 'enum':
+                out.push('    this.' + field.name + ' = ' + value + ';');
+                out.push('    this.' + field.name + 'Id = ' + field.name.toUpperCase() + '_IDS.hasOwnProperty(' + value + ') ? ' +
+                         field.name.toUpperCase() + '_IDS[' + value + '] : 0;');
+                break;
+            case 'bool':
+                out.push('    this.' + field.name + ' = ' + value + ' === true;');
+                break;
+            default:
+                out.push('    this.' + field.name + ' = ' + (field.optional ? '(' + value + ' == null) ? undefined : ' : '') + value + ';');
+        }
+    });
+    out.push('}');
+    out.push('');
+    out.push('/**');
+    out.push(' * Turns the array passed to a scan callback into a ' + schema.name + '.');
+    out.push(' */');
+    out.push(schema.name + '.decode = function(payload) {');
+    out.push('    return new ' + schema.name + '(payload);');
+    out.push('};');
+    out.push('');
+    schema.fields.forEach(function(field) {
+        if (field.type == 'enum') {
+            var enumName = capitalize(field.name);
+            out.push(schema.name + '.' + enumName + ' = {};');
+            out.push(field.name.toUpperCase() + '_NAMES.forEach(function(name, i) { ' + schema.name + '.' + enumName + '[name] = i; });');
+            out.push('');
+        }
+    });
+    out.push('module.exports = ' + schema.name + ';');
+    out.push('');
+    return out.join('\n');
+}
+
+var outputs = {};
+outputs[path.join('src', 'ios', encoderBaseName() + '.h')] = generateCHeader();
+outputs[path.join('src', 'ios', encoderBaseName() + '.c')] = generateCImplementation();
+outputs[path.join('src', 'ios', schema.prefix + schema.name + '.h')] = generateHeader();
+outputs[path.join('src', 'ios', schema.prefix + schema.name + '.m')] = generateImplementation();
+outputs[path.join('www', schema.name + '.js')] = generateDecoder();
+
+function bench() {
+    // The native encoder is benchmarked by tests/ScanditSDKScanResultEncoderBenchmark.cpp.
+    // Here the generated decoder is timed against reading the same payload as a plain array,
+    // the way callbacks read the legacy [barcode, symbology] result. Both evaluate the
+    // literal the way cordova.js does with a nativeCallback.
+    var symbologies = schema.fields[1].values,
+        literals = [],
+        samples = [];
+
+    for (var i = 0; i < 1000; ++i) {
+        samples.push(['40' + (1000000000 + i * 7919) + (i % 10), symbologies[1 + i % (symbologies.length - 1)],
+                      1381000000000 + i, i % 5 === 0, i % 2 ? null : '0040' + (1000000000 + i)]);
+    }
+    samples.push(['line\u2028separator "quoted" \\', 'QR', 1, false, null]);
+
+    // What the native encoder writes: JSON with U+2028/U+2029 escaped and a nil gtin left out.
+    samples.forEach(function(r) {
+        literals.push(JSON.stringify(r[4] == null ? r.slice(0, 4) : r).replace(/[\u2028\u2029]/g, function(c) {
+            return '\\u' + c.charCodeAt(0).toString(16);
+        }));
+    });
+
+    var decoder = { exports: {} };
+    new Function('module', 'exports', outputs[path.join('www', schema.name + '.js')])(decoder, decoder.exports);
+    var ScanResult = decoder.exports;
+
+    samples.forEach(function(r, i) {
+        var decoded = ScanResult.decode(eval(literals[i]));
+        if (decoded.code !== r[0] || decoded.symbology !== r[1] || decoded.timestamp !== r[2] || decoded.manual !== r[3] ||
+            decoded.gtin !== (r[4] == null ? undefined : r[4])) {
+            throw new Error('round trip failed for ' + JSON.stringify(r));
+        }
+    });
+
+    function time(name, fn) {
+        var rounds = 200, sink = 0, start = process.hrtime();
+        for (var round = 0; round < rounds; ++round) {
+            for (var i = 0; i < literals.length; ++i) {
+                sink += fn(literals[i]);
+            }
+        }
+        var elapsed = process.hrtime(start),
+            ns = (elapsed[0] * 1e9 + elapsed[1]) / (rounds * literals.length);
+        // The checksum keeps the work from being optimized away.
+        console.log(name + ': ' + ns.toFixed(0) + ' ns/result (checksum ' + sink + ')');
+    }
+
+    time('decode ScanResult', function(literal) { return ScanResult.decode(eval(literal)).symbologyId; });
+    time('plain array      ', function(literal) { return eval(literal)[1].length; });
+}
+
+var args = process.argv.slice(2),
+    stale = [];
+
+Object.keys(outputs).forEach(function(file) {
+    var fullPath = path.join(root, file),
+        current = fs.existsSync(fullPath) ? fs.readFileSync(fullPath, 'utf8') : null;
+    if (current === outputs[file]) {
+        return;
+    }
+    if (args.indexOf('--check') >= 0) {
+        stale.push(file);
+    } else {
+        fs.writeFileSync(fullPath, outputs[file]);
+        console.log('Wrote ' + file);
+    }
+});
+
+if (stale.length) {
+    console.error('Out of date, rerun tools/gen-scan-result.js: ' + stale.join(', '));
+    process.exit(1);
+}
+if (args.indexOf('--bench') >= 0) {
+    bench();
+}
@@ -24,13 +24,21 @@
 #import "CDVCommandDelegate.h"
 #import "CDVURLProtocol.h"
 #import "CDVInvokedUrlCommand.h"
+#import "CDVCommandBatch.h"
 
 #import "CDVDebug.h"
 #import "CDVPluginResult.h"
+#import "CDVResultThrottle.h"
+#import "CDVCursor.h"
 #import "CDVWhitelist.h"
+#import "CDVWhitelistTable.h"
+#import "CDVWwwArchive.h"
 #import "CDVLocalStorage.h"
 #import "CDVScreenOrientationDelegate.h"
 #import "CDVTimer.h"
+#import "CDVLog.h"
+#import "CDVTempFilePurger.h"
+#import "CDVPluginRegistry.h"
 
 #import "NSArray+Comparisons.h"
 #import "NSData+Base64.h"
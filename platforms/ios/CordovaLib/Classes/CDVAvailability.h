@@ -83,10 +83,8 @@
     #define CDV_DEPRECATED(version, msg) __attribute__((deprecated()))
 #endif
 
-// Enable this to log all exec() calls.
-#define CDV_ENABLE_EXEC_LOGGING 0
-#if CDV_ENABLE_EXEC_LOGGING
-    #define CDV_EXEC_LOG NSLog
-#else
-    #define CDV_EXEC_LOG(...) do {} while (NO)
-#endif
+#import "CDVLog.h"
+
+// exec() calls are logged at verbose level in the "exec" category (see CDVLog.h).
+// Enable them at runtime with CDVLogSetLevel(CDVLogCategoryExec, CDVLogLevelVerbose).
+#define CDV_EXEC_LOG(...) CDVLog(CDVLogCategoryExec, CDVLogLevelVerbose, __VA_ARGS__)
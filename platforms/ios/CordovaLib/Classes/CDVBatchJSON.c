@@ -0,0 +1,533 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#ifndef __APPLE__
+#define _GNU_SOURCE // strtod_l and newlocale
+#endif
+
+#include <errno.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#else
+#include <pthread.h>
+#endif
+#include "CDVBatchJSON.h"
+
+typedef struct {
+    const uint8_t* bytes;
+    size_t length;
+    size_t pos;
+    cdv_batch_node* nodes;
+    uint32_t count;
+    uint32_t capacity;
+} cdv_batch_parser;
+
+static void cdv_batch_skip_space(cdv_batch_parser* p)
+{
+    while (p->pos < p->length) {
+        uint8_t c = p->bytes[p->pos];
+        if ((c != ' ') && (c != '\t') && (c != '\n') && (c != '\r')) {
+            return;
+        }
+        p->pos++;
+    }
+}
+
+static int cdv_batch_is_digit(cdv_batch_parser* p)
+{
+    return (p->pos < p->length) && (p->bytes[p->pos] >= '0') && (p->bytes[p->pos] <= '9');
+}
+
+static int cdv_batch_skip_digits(cdv_batch_parser* p)
+{
+    if (!cdv_batch_is_digit(p)) {
+        return 0;
+    }
+    while (cdv_batch_is_digit(p)) {
+        p->pos++;
+    }
+    return 1;
+}
+
+static uint32_t cdv_batch_hex_digit(uint8_t c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    return 0x10000;
+}
+
+// The value of four hex digits, or 0x10000 if there are not four.
+static uint32_t cdv_batch_read_hex4(const uint8_t* s, const uint8_t* end)
+{
+    if (end - s < 4) {
+        return 0x10000;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint32_t digit = cdv_batch_hex_digit(s[i]);
+        if (digit > 0xf) {
+            return 0x10000;
+        }
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+static int cdv_batch_parse_string(cdv_batch_parser* p, cdv_batch_node* node)
+{
+    node->type = CDV_BATCH_STRING;
+    node->start = (uint32_t)++p->pos;
+    while (p->pos < p->length) {
+        uint8_t c = p->bytes[p->pos];
+        if (c == '"') {
+            node->length = (uint32_t)(p->pos++ - node->start);
+            return 1;
+        }
+        if (c < 0x20) {
+            return 0;
+        }
+        if (c == '\\') {
+            node->escaped = 1;
+            if (++p->pos >= p->length) {
+                return 0;
+            }
+            c = p->bytes[p->pos];
+            if (c == 'u') {
+                if (cdv_batch_read_hex4(p->bytes + p->pos + 1, p->bytes + p->length) > 0xffff) {
+                    return 0;
+                }
+                p->pos += 4;
+            } else if (!strchr("\"\\/bfnrt", c) || (c == '\0')) {
+                return 0;
+            }
+        }
+        p->pos++;
+    }
+    return 0;
+}
+
+static int cdv_batch_parse_literal(cdv_batch_parser* p, const char* literal, cdv_batch_type type, cdv_batch_node* node)
+{
+    size_t length = strlen(literal);
+
+    if ((p->length - p->pos < length) || (memcmp(p->bytes + p->pos, literal, length) != 0)) {
+        return 0;
+    }
+    node->type = type;
+    p->pos += length;
+    return 1;
+}
+
+static int cdv_batch_parse_number(cdv_batch_parser* p, cdv_batch_node* node)
+{
+    node->type = CDV_BATCH_NUMBER;
+    if (p->bytes[p->pos] == '-') {
+        p->pos++;
+    }
+    if (!cdv_batch_skip_digits(p)) {
+        return 0;
+    }
+    if ((p->pos < p->length) && (p->bytes[p->pos] == '.')) {
+        p->pos++;
+        if (!cdv_batch_skip_digits(p)) {
+            return 0;
+        }
+    }
+    if ((p->pos < p->length) && ((p->bytes[p->pos] == 'e') || (p->bytes[p->pos] == 'E'))) {
+        p->pos++;
+        if ((p->pos < p->length) && ((p->bytes[p->pos] == '+') || (p->bytes[p->pos] == '-'))) {
+            p->pos++;
+        }
+        if (!cdv_batch_skip_digits(p)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int cdv_batch_parse_value(cdv_batch_parser* p, int depth)
+{
+    cdv_batch_skip_space(p);
+    if ((p->pos >= p->length) || (p->count >= p->capacity) || (depth > CDV_BATCH_MAX_DEPTH)) {
+        return 0;
+    }
+    uint32_t index = p->count++;
+    cdv_batch_node* node = &p->nodes[index];
+    memset(node, 0, sizeof(*node));
+    node->start = (uint32_t)p->pos;
+
+    int ok;
+    uint8_t c = p->bytes[p->pos];
+    if ((c == '[') || (c == '{')) {
+        int isObject = (c == '{');
+        uint8_t close = isObject ? '}' : ']';
+        node->type = isObject ? CDV_BATCH_OBJECT : CDV_BATCH_ARRAY;
+        p->pos++;
+        cdv_batch_skip_space(p);
+        ok = 1;
+        if ((p->pos < p->length) && (p->bytes[p->pos] == close)) {
+            p->pos++;
+        } else {
+            for (;; ) {
+                if (isObject) {
+                    cdv_batch_skip_space(p);
+                    if ((p->pos >= p->length) || (p->bytes[p->pos] != '"') || !cdv_batch_parse_value(p, depth + 1)) {
+                        return 0;
+                    }
+                    cdv_batch_skip_space(p);
+                    if ((p->pos >= p->length) || (p->bytes[p->pos] != ':')) {
+                        return 0;
+                    }
+                    p->pos++;
+                }
+                if (!cdv_batch_parse_value(p, depth + 1)) {
+                    return 0;
+                }
+                p->nodes[index].count++;
+                cdv_batch_skip_space(p);
+                if (p->pos >= p->length) {
+                    return 0;
+                }
+                c = p->bytes[p->pos];
+                if ((c != close) && (c != ',')) {
+                    return 0;
+                }
+                p->pos++;
+                if (c == close) {
+                    break;
+                }
+            }
+        }
+    } else if (c == '"') {
+        // Keeps the span of the contents, without the quotes.
+        ok = cdv_batch_parse_string(p, node);
+        node->end = p->count;
+        return ok;
+    } else if (c == 't') {
+        ok = cdv_batch_parse_literal(p, "true", CDV_BATCH_TRUE, node);
+    } else if (c == 'f') {
+        ok = cdv_batch_parse_literal(p, "false", CDV_BATCH_FALSE, node);
+    } else if (c == 'n') {
+        ok = cdv_batch_parse_literal(p, "null", CDV_BATCH_NULL, node);
+    } else if ((c == '-') || ((c >= '0') && (c <= '9'))) {
+        ok = cdv_batch_parse_number(p, node);
+    } else {
+        ok = 0;
+    }
+    node->length = (uint32_t)(p->pos - node->start);
+    node->end = p->count;
+    return ok;
+}
+
+// Every value but the outermost follows a '[', '{', ',' or ':', so this bounds the node count.
+uint32_t cdv_batch_node_bound(const uint8_t* bytes, size_t length)
+{
+    size_t bound = 1;
+
+    if (length >= UINT32_MAX) {
+        return 0;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t c = bytes[i];
+        bound += (c == ',') | (c == ':') | (c == '[') | (c == '{');
+    }
+    return (bound > UINT32_MAX / 2) ? 0 : (uint32_t)bound;
+}
+
+uint32_t cdv_batch_parse(const uint8_t* bytes, size_t length, cdv_batch_node* nodes, uint32_t capacity,
+    size_t* error_offset)
+{
+    cdv_batch_parser parser = {bytes, length, 0, nodes, 0, capacity};
+
+    if (length >= UINT32_MAX) {
+        *error_offset = 0;
+        return 0;
+    }
+    int ok = cdv_batch_parse_value(&parser, 0);
+    if (ok) {
+        cdv_batch_skip_space(&parser);
+    }
+    if (!ok || (parser.pos != length)) {
+        *error_offset = parser.pos;
+        return 0;
+    }
+    return parser.count;
+}
+
+uint32_t cdv_batch_child(const cdv_batch_node* nodes, uint32_t value, uint32_t i)
+{
+    uint32_t node = value + 1;
+
+    while (i-- > 0) {
+        node = nodes[node].end;
+    }
+    return node;
+}
+
+uint32_t cdv_batch_member(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t object, const char* key)
+{
+    size_t keyLength = strlen(key);
+    uint32_t found = 0;
+
+    for (uint32_t node = object + 1; node < nodes[object].end; ) {
+        uint32_t value = nodes[node].end;
+        if (!nodes[node].escaped && (nodes[node].length == keyLength) &&
+            (memcmp(bytes + nodes[node].start, key, keyLength) == 0)) {
+            found = value;
+        }
+        node = nodes[value].end;
+    }
+    return found;
+}
+
+int cdv_batch_is_string(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t node, const char* string)
+{
+    size_t length = strlen(string);
+
+    return (nodes[node].type == CDV_BATCH_STRING) && !nodes[node].escaped && (nodes[node].length == length) &&
+           (memcmp(bytes + nodes[node].start, string, length) == 0);
+}
+
+static size_t cdv_batch_put_utf8(uint8_t* out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out[0] = (uint8_t)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (uint8_t)(0xc0 | (cp >> 6));
+        out[1] = (uint8_t)(0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (uint8_t)(0xe0 | (cp >> 12));
+        out[1] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+        out[2] = (uint8_t)(0x80 | (cp & 0x3f));
+        return 3;
+    }
+    out[0] = (uint8_t)(0xf0 | (cp >> 18));
+    out[1] = (uint8_t)(0x80 | ((cp >> 12) & 0x3f));
+    out[2] = (uint8_t)(0x80 | ((cp >> 6) & 0x3f));
+    out[3] = (uint8_t)(0x80 | (cp & 0x3f));
+    return 4;
+}
+
+size_t cdv_batch_unescape(const uint8_t* s, size_t length, uint8_t* out)
+{
+    const uint8_t* end = s + length;
+    size_t n = 0;
+
+    while (s < end) {
+        if ((*s != '\\') || (s + 1 >= end)) {
+            out[n++] = *s++;
+            continue;
+        }
+        uint8_t c = s[1];
+        s += 2;
+        switch (c) {
+            case 'b': out[n++] = '\b'; break;
+            case 'f': out[n++] = '\f'; break;
+            case 'n': out[n++] = '\n'; break;
+            case 'r': out[n++] = '\r'; break;
+            case 't': out[n++] = '\t'; break;
+            case 'u': {
+                uint32_t cp = cdv_batch_read_hex4(s, end);
+                if (cp > 0xffff) {
+                    cp = 0xfffd;
+                } else {
+                    s += 4;
+                    if ((cp >= 0xd800) && (cp < 0xdc00)) {
+                        uint32_t low = ((end - s >= 6) && (s[0] == '\\') && (s[1] == 'u')) ? cdv_batch_read_hex4(s + 2, end) : 0x10000;
+                        if ((low >= 0xdc00) && (low < 0xe000)) {
+                            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                            s += 6;
+                        } else {
+                            cp = 0xfffd;
+                        }
+                    } else if ((cp >= 0xdc00) && (cp < 0xe000)) {
+                        cp = 0xfffd;
+                    }
+                }
+                n += cdv_batch_put_utf8(out + n, cp);
+                break;
+            }
+            default: out[n++] = c; break; // \" \\ \/
+        }
+    }
+    return n;
+}
+
+#ifdef __APPLE__
+// A NULL locale is the C locale.
+static locale_t cdv_batch_c_locale(void)
+{
+    return NULL;
+}
+
+#else
+static locale_t gCLocale;
+static pthread_once_t gCLocaleOnce = PTHREAD_ONCE_INIT;
+
+static void cdv_batch_init_c_locale(void)
+{
+    gCLocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+}
+
+static locale_t cdv_batch_c_locale(void)
+{
+    pthread_once(&gCLocaleOnce, cdv_batch_init_c_locale);
+    return gCLocale;
+}
+
+#endif
+
+int cdv_batch_number(const uint8_t* bytes, size_t length, int64_t* integer, double* real)
+{
+    char stackBuffer[64];
+    char* text = (length < sizeof(stackBuffer)) ? stackBuffer : malloc(length + 1);
+    int integral = 1;
+
+    if (text == NULL) {
+        *real = 0;
+        return 0;
+    }
+    memcpy(text, bytes, length);
+    text[length] = '\0';
+    for (size_t i = 0; i < length; ++i) {
+        integral = integral && (text[i] != '.') && (text[i] != 'e') && (text[i] != 'E');
+    }
+    if (integral) {
+        errno = 0;
+        long long value = strtoll(text, NULL, 10);
+        integral = (errno == 0);
+        *integer = value;
+    }
+    if (!integral) {
+        // In the C locale "." is the decimal point whatever the user's locale.
+        *real = strtod_l(text, NULL, cdv_batch_c_locale());
+    }
+    if (text != stackBuffer) {
+        free(text);
+    }
+    return integral;
+}
+
+uint32_t cdv_batch_array_buffer_data(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t node)
+{
+    if (nodes[node].type != CDV_BATCH_OBJECT) {
+        return 0;
+    }
+    uint32_t type = cdv_batch_member(nodes, bytes, node, "CDVType");
+    uint32_t data = cdv_batch_member(nodes, bytes, node, "data");
+    if ((type == 0) || !cdv_batch_is_string(nodes, bytes, type, "ArrayBuffer") || (data == 0) ||
+        (nodes[data].type != CDV_BATCH_STRING)) {
+        return 0;
+    }
+    return data;
+}
+
+size_t cdv_batch_base64_capacity(size_t length)
+{
+    // Four characters carry three bytes; a last group of two or three, one or two.
+    return length / 4 * 3 + 2;
+}
+
+static const uint8_t kCDVBatchBase64Invalid = 0xff;
+
+static uint8_t cdv_batch_base64_value(uint8_t c)
+{
+    if ((c >= 'A') && (c <= 'Z')) {
+        return c - 'A';
+    }
+    if ((c >= 'a') && (c <= 'z')) {
+        return c - 'a' + 26;
+    }
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0' + 52;
+    }
+    if (c == '+') {
+        return 62;
+    }
+    if (c == '/') {
+        return 63;
+    }
+    return kCDVBatchBase64Invalid;
+}
+
+// Writes never overtake reads (three bytes out for every four characters in),
+// so text and out may be the same buffer.
+size_t cdv_batch_base64_decode(const uint8_t* text, size_t length, uint8_t* out)
+{
+    uint32_t group = 0;
+    int count = 0;
+    size_t n = 0;
+
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t value = cdv_batch_base64_value(text[i]);
+        if (value == kCDVBatchBase64Invalid) {
+            continue;
+        }
+        group = (group << 6) | value;
+        if (++count == 4) {
+            out[n++] = (uint8_t)(group >> 16);
+            out[n++] = (uint8_t)(group >> 8);
+            out[n++] = (uint8_t)group;
+            group = 0;
+            count = 0;
+        }
+    }
+    if (count == 2) {
+        out[n++] = (uint8_t)(group >> 4);
+    } else if (count == 3) {
+        out[n++] = (uint8_t)(group >> 10);
+        out[n++] = (uint8_t)(group >> 2);
+    }
+    return n;
+}
+
+size_t cdv_batch_array_buffer_capacity(const cdv_batch_node* nodes, uint32_t data)
+{
+    size_t capacity = cdv_batch_base64_capacity(nodes[data].length);
+
+    // Escaped text is unescaped into the buffer first.
+    return (nodes[data].escaped && (nodes[data].length > capacity)) ? nodes[data].length : capacity;
+}
+
+size_t cdv_batch_array_buffer_decode(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t data, uint8_t* out)
+{
+    const uint8_t* text = bytes + nodes[data].start;
+    size_t length = nodes[data].length;
+
+    if (nodes[data].escaped) {
+        // A "\n" would otherwise leave an 'n', which is base64.
+        length = cdv_batch_unescape(text, length, out);
+        text = out;
+    }
+    return cdv_batch_base64_decode(text, length, out);
+}
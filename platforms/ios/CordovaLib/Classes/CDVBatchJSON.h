@@ -0,0 +1,116 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ The JSON scanner behind CDVCommandBatch. A payload is parsed into a flat
+ arena of value nodes that point into the UTF-8 text instead of into a tree of
+ allocated values; strings are unescaped and numbers converted only when the
+ caller asks. ArrayBuffer arguments ({"CDVType": "ArrayBuffer", "data": "..."})
+ are decoded straight from their base64 text.
+
+ Plain C with no allocations of its own (the caller provides the arena), so it
+ builds and can be tested and benchmarked outside of iOS; tests/ does that on
+ Linux.
+ */
+
+#ifndef CDV_BATCH_JSON_H
+#define CDV_BATCH_JSON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    CDV_BATCH_NULL = 0,
+    CDV_BATCH_FALSE,
+    CDV_BATCH_TRUE,
+    CDV_BATCH_NUMBER,
+    CDV_BATCH_STRING,
+    CDV_BATCH_ARRAY,
+    CDV_BATCH_OBJECT
+} cdv_batch_type;
+
+// One JSON value. Children follow their container in document order; object
+// members are a key node followed by a value node.
+typedef struct {
+    uint32_t start;   // offset in the payload; for strings just past the opening quote
+    uint32_t length;  // bytes of text; for strings without the quotes
+    uint32_t end;     // index of the first node after this value and its children
+    uint32_t count;   // elements of an array, members of an object
+    uint8_t type;
+    uint8_t escaped;  // a string with backslash escapes
+} cdv_batch_node;
+
+// Deeper nesting than this is rejected rather than risking the stack.
+#define CDV_BATCH_MAX_DEPTH 512
+
+// An upper bound of the nodes a payload can need, 0 if it is too large to parse.
+uint32_t cdv_batch_node_bound(const uint8_t* bytes, size_t length);
+
+// Parses the single JSON value that makes up the payload (surrounding white
+// space allowed) into nodes, which needs cdv_batch_node_bound() entries. Returns
+// the number of nodes, or 0 with the offset of the error in *error_offset.
+uint32_t cdv_batch_parse(const uint8_t* bytes, size_t length, cdv_batch_node* nodes, uint32_t capacity,
+    size_t* error_offset);
+
+// Child i of an array node (the caller checks i < count).
+uint32_t cdv_batch_child(const cdv_batch_node* nodes, uint32_t value, uint32_t i);
+
+// The value of the member with the given key in an object node, 0 if there is
+// none. The last one wins, as in NSJSONSerialization.
+uint32_t cdv_batch_member(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t object, const char* key);
+
+// Whether a node is a string equal to the given one. Escaped strings never are.
+int cdv_batch_is_string(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t node, const char* string);
+
+// Decodes the escapes of a string node's text into out, which needs length
+// bytes: no escape sequence is shorter than its UTF-8. Lone surrogates become
+// U+FFFD. Returns the decoded length.
+size_t cdv_batch_unescape(const uint8_t* text, size_t length, uint8_t* out);
+
+// Converts a number node's text. Returns 1 with *integer set if the number has
+// no fraction or exponent and fits in 64 bits, else 0 with *real set.
+int cdv_batch_number(const uint8_t* text, size_t length, int64_t* integer, double* real);
+
+// The data string node of an ArrayBuffer argument, 0 if the node is not one.
+uint32_t cdv_batch_array_buffer_data(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t node);
+
+// Bytes cdv_batch_array_buffer_decode() may need for a data node.
+size_t cdv_batch_array_buffer_capacity(const cdv_batch_node* nodes, uint32_t data);
+
+// Decodes the base64 text of a data node into out, undoing its escapes first.
+// Returns the length.
+size_t cdv_batch_array_buffer_decode(const cdv_batch_node* nodes, const uint8_t* bytes, uint32_t data, uint8_t* out);
+
+// Bytes the decoded form of length characters of base64 text may need.
+size_t cdv_batch_base64_capacity(size_t length);
+
+// Decodes base64 text into out, skipping anything outside the alphabet (such as
+// "=" padding or line breaks). A last group of a single character carries no
+// whole byte and is ignored. out may be text itself. Returns the length.
+size_t cdv_batch_base64_decode(const uint8_t* text, size_t length, uint8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CDV_BATCH_JSON_H */
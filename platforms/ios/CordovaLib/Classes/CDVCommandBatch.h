@@ -0,0 +1,67 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class CDVInvokedUrlCommand;
+
+/*
+ A batch of exec() messages as fetched from JS, decoded into a single arena of
+ value nodes that point into the UTF-8 payload instead of into a tree of
+ NSArray/NSDictionary/NSString/NSNumber objects. Only the callbackId, service
+ and action of a command are turned into objects when the command is created;
+ an argument becomes a Foundation object when a plugin asks for it, and an
+ ArrayBuffer argument becomes NSData straight from its base64 text.
+
+ The payload and the arena are freed together once the batch and the commands
+ created from it are gone. Commands keep their batch alive, so a plugin that
+ holds on to a command keeps the whole batch.
+ */
+@interface CDVCommandBatch : NSObject
+
+// Number of entries in the batch, including malformed ones.
+@property (nonatomic, readonly) NSUInteger commandCount;
+// JSON values in the batch; decoding with NSJSONSerialization creates about one object for each.
+@property (nonatomic, readonly) NSUInteger valueCount;
+// Heap blocks used for decoding: the payload copy, if one was needed, and the node arena.
+@property (nonatomic, readonly) NSUInteger allocationCount;
+// Foundation objects created so far for commands and the arguments plugins asked for.
+@property (nonatomic, readonly) NSUInteger materializedCount;
+
+// Returns nil if batchJSON is not a JSON array.
++ (CDVCommandBatch*)batchWithJSON:(NSString*)batchJSON;
+
+// Returns nil if the entry is not a [callbackId, service, action, [args]] array.
+- (CDVInvokedUrlCommand*)commandAtIndex:(NSUInteger)index;
+// Whether the entries name the same service and action, with arguments of the same JSON text.
+- (BOOL)commandAtIndex:(NSUInteger)index isSameCallAsCommandAtIndex:(NSUInteger)otherIndex ofBatch:(CDVCommandBatch*)other;
+// Whether the entries name the same service.
+- (BOOL)commandAtIndex:(NSUInteger)index hasSameServiceAsCommandAtIndex:(NSUInteger)otherIndex ofBatch:(CDVCommandBatch*)other;
+// The raw callbackId of an entry: an NSString, or nil if it is missing or not a string.
+- (NSString*)callbackIdOfCommandAtIndex:(NSUInteger)index;
+// The JSON text of an entry, for logging.
+- (NSString*)JSONOfCommandAtIndex:(NSUInteger)index;
+
+// Used by CDVInvokedUrlCommand for the arguments array node of a command.
+- (NSUInteger)countOfArrayValue:(NSUInteger)value;
+// An element of the arguments array with ArrayBuffers decoded. NSNull for null and for
+// an ArrayBuffer that could not be allocated; nil only for an index out of range.
+- (id)argument:(NSUInteger)index ofArrayValue:(NSUInteger)value;
+
+@end
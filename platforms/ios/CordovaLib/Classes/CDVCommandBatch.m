@@ -0,0 +1,302 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CDVCommandBatch.h"
+#import "CDVInvokedUrlCommand.h"
+#import "CDVLog.h"
+#include <libkern/OSAtomic.h>
+#include "CDVBatchJSON.h"
+
+@interface CDVCommandBatch () {
+    NSString* _json;  // owns the payload when it is the string's own buffer
+    NSData* _payload; // or a UTF-8 copy of it
+    const uint8_t* _bytes;
+    size_t _length;
+    // A single block: nodeCapacity nodes, then the node index of every entry.
+    cdv_batch_node* _nodes;
+    uint32_t* _entries;
+    NSUInteger _commandCount;
+    NSUInteger _valueCount;
+    NSUInteger _allocationCount;
+    volatile int32_t _materializedCount;
+}
+@end
+
+@implementation CDVCommandBatch
+
+@synthesize commandCount = _commandCount;
+@synthesize valueCount = _valueCount;
+@synthesize allocationCount = _allocationCount;
+
++ (CDVCommandBatch*)batchWithJSON:(NSString*)batchJSON
+{
+    return [[CDVCommandBatch alloc] initWithJSON:batchJSON];
+}
+
+- (id)initWithJSON:(NSString*)batchJSON
+{
+    self = [super init];
+    if (self == nil) {
+        return nil;
+    }
+    _json = [batchJSON copy];
+    const char* cString = CFStringGetCStringPtr((__bridge CFStringRef)_json, kCFStringEncodingUTF8);
+    if (cString != NULL) {
+        _bytes = (const uint8_t*)cString;
+        _length = strlen(cString);
+    } else {
+        _payload = [_json dataUsingEncoding:NSUTF8StringEncoding];
+        _bytes = [_payload bytes];
+        _length = [_payload length];
+        _allocationCount++;
+    }
+
+    uint32_t capacity = cdv_batch_node_bound(_bytes, _length);
+    _nodes = (capacity > 0) ? malloc((size_t)capacity * (sizeof(cdv_batch_node) + sizeof(uint32_t))) : NULL;
+    if (_nodes == NULL) {
+        return nil;
+    }
+    _allocationCount++;
+    _entries = (uint32_t*)(_nodes + capacity);
+
+    size_t errorOffset = 0;
+    uint32_t count = cdv_batch_parse(_bytes, _length, _nodes, capacity, &errorOffset);
+    if ((count == 0) || (_nodes[0].type != CDV_BATCH_ARRAY)) {
+        CDVLogError(CDVLogCategoryExec, @"ERROR: the exec batch is not a JSON array (at byte %lu).", (unsigned long)errorOffset);
+        return nil;
+    }
+    _valueCount = count;
+    for (uint32_t node = 1; node < _nodes[0].end; node = _nodes[node].end) {
+        _entries[_commandCount++] = node;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_nodes);
+}
+
+- (NSUInteger)materializedCount
+{
+    return (NSUInteger)_materializedCount;
+}
+
+- (uint32_t)child:(NSUInteger)i ofValue:(uint32_t)value
+{
+    return cdv_batch_child(_nodes, value, (uint32_t)i);
+}
+
+// The entry at index if it has the shape [callbackId, service, action, [args]], else 0.
+- (uint32_t)entryAtIndex:(NSUInteger)index
+{
+    if (index >= _commandCount) {
+        return 0;
+    }
+    uint32_t entry = _entries[index];
+    if ((_nodes[entry].type != CDV_BATCH_ARRAY) || (_nodes[entry].count < 4) ||
+        (_nodes[[self child:3 ofValue:entry]].type != CDV_BATCH_ARRAY)) {
+        return 0;
+    }
+    return entry;
+}
+
+- (BOOL)isString:(uint32_t)node
+{
+    return _nodes[node].type == CDV_BATCH_STRING;
+}
+
+- (NSString*)stringForNode:(uint32_t)node
+{
+    const cdv_batch_node* n = &_nodes[node];
+    const uint8_t* text = _bytes + n->start;
+    NSString* string;
+
+    OSAtomicIncrement32(&_materializedCount);
+    if (!n->escaped) {
+        string = [[NSString alloc] initWithBytes:text length:n->length encoding:NSUTF8StringEncoding];
+    } else {
+        uint8_t stackBuffer[256];
+        uint8_t* buffer = (n->length <= sizeof(stackBuffer)) ? stackBuffer : malloc(n->length);
+        if (buffer == NULL) {
+            CDVLogError(CDVLogCategoryExec, @"ERROR: out of memory unescaping a %lu byte exec string.", (unsigned long)n->length);
+            return @"";
+        }
+        size_t length = cdv_batch_unescape(text, n->length, buffer);
+        string = [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+        if (buffer != stackBuffer) {
+            free(buffer);
+        }
+    }
+    return (string != nil) ? string : @"";
+}
+
+- (NSNumber*)numberForNode:(uint32_t)node
+{
+    int64_t integer = 0;
+    double real = 0;
+    NSNumber* number = cdv_batch_number(_bytes + _nodes[node].start, _nodes[node].length, &integer, &real) ?
+        [NSNumber numberWithLongLong:integer] : [NSNumber numberWithDouble:real];
+
+    OSAtomicIncrement32(&_materializedCount);
+    return number;
+}
+
+- (id)objectForNode:(uint32_t)node
+{
+    const cdv_batch_node* n = &_nodes[node];
+
+    switch (n->type) {
+        case CDV_BATCH_NULL:
+            return [NSNull null];
+
+        case CDV_BATCH_FALSE:
+            return [NSNumber numberWithBool:NO];
+
+        case CDV_BATCH_TRUE:
+            return [NSNumber numberWithBool:YES];
+
+        case CDV_BATCH_NUMBER:
+            return [self numberForNode:node];
+
+        case CDV_BATCH_STRING:
+            return [self stringForNode:node];
+
+        case CDV_BATCH_ARRAY: {
+            NSMutableArray* array = [NSMutableArray arrayWithCapacity:n->count];
+            for (uint32_t child = node + 1; child < n->end; child = _nodes[child].end) {
+                [array addObject:[self objectForNode:child]];
+            }
+            OSAtomicIncrement32(&_materializedCount);
+            return array;
+        }
+
+        case CDV_BATCH_OBJECT: {
+            NSMutableDictionary* dict = [NSMutableDictionary dictionaryWithCapacity:n->count];
+            for (uint32_t key = node + 1; key < n->end; ) {
+                uint32_t value = _nodes[key].end;
+                [dict setObject:[self objectForNode:value] forKey:[self stringForNode:key]];
+                key = _nodes[value].end;
+            }
+            OSAtomicIncrement32(&_materializedCount);
+            return dict;
+        }
+    }
+    return [NSNull null];
+}
+
+- (NSUInteger)countOfArrayValue:(NSUInteger)value
+{
+    return _nodes[value].count;
+}
+
+- (id)argument:(NSUInteger)index ofArrayValue:(NSUInteger)value
+{
+    if (index >= _nodes[value].count) {
+        return nil;
+    }
+    uint32_t node = [self child:index ofValue:(uint32_t)value];
+
+    // {"CDVType": "ArrayBuffer", "data": "<base64>"} is decoded straight from the payload.
+    uint32_t data = cdv_batch_array_buffer_data(_nodes, _bytes, node);
+    if (data != 0) {
+        uint8_t* bytes = malloc(cdv_batch_array_buffer_capacity(_nodes, data));
+        if (bytes == NULL) {
+            CDVLogError(CDVLogCategoryExec, @"ERROR: out of memory decoding a %lu byte ArrayBuffer argument.", (unsigned long)_nodes[data].length);
+            return [NSNull null];
+        }
+        size_t length = cdv_batch_array_buffer_decode(_nodes, _bytes, data, bytes);
+        OSAtomicIncrement32(&_materializedCount);
+        return [NSData dataWithBytesNoCopy:bytes length:length freeWhenDone:YES];
+    }
+    return [self objectForNode:node];
+}
+
+- (CDVInvokedUrlCommand*)commandAtIndex:(NSUInteger)index
+{
+    uint32_t entry = [self entryAtIndex:index];
+
+    if (entry == 0) {
+        return nil;
+    }
+    uint32_t callbackId = entry + 1;
+    uint32_t service = _nodes[callbackId].end;
+    uint32_t action = _nodes[service].end;
+    uint32_t arguments = _nodes[action].end;
+
+    return [[CDVInvokedUrlCommand alloc] initWithBatch:self
+                                             arguments:arguments
+                                            callbackId:[self isString:callbackId] ? [self stringForNode:callbackId] : nil
+                                             className:[self isString:service] ? [self stringForNode:service] : nil
+                                            methodName:[self isString:action] ? [self stringForNode:action] : nil];
+}
+
+- (NSString*)callbackIdOfCommandAtIndex:(NSUInteger)index
+{
+    uint32_t entry = [self entryAtIndex:index];
+
+    return ((entry != 0) && [self isString:entry + 1]) ? [self stringForNode:entry + 1] : nil;
+}
+
+// Whether two nodes have the same JSON text.
+- (BOOL)node:(uint32_t)node isSameTextAs:(uint32_t)otherNode ofBatch:(CDVCommandBatch*)other
+{
+    const cdv_batch_node* a = &_nodes[node];
+    const cdv_batch_node* b = &other->_nodes[otherNode];
+
+    return (a->type == b->type) && (a->length == b->length) &&
+           (memcmp(_bytes + a->start, other->_bytes + b->start, a->length) == 0);
+}
+
+- (BOOL)commandAtIndex:(NSUInteger)index isSameCallAsCommandAtIndex:(NSUInteger)otherIndex ofBatch:(CDVCommandBatch*)other
+{
+    uint32_t entry = [self entryAtIndex:index];
+    uint32_t otherEntry = [other entryAtIndex:otherIndex];
+
+    if ((entry == 0) || (otherEntry == 0)) {
+        return NO;
+    }
+    // service, action and arguments
+    for (NSUInteger i = 1; i < 4; ++i) {
+        if (![self node:[self child:i ofValue:entry] isSameTextAs:[other child:i ofValue:otherEntry] ofBatch:other]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (BOOL)commandAtIndex:(NSUInteger)index hasSameServiceAsCommandAtIndex:(NSUInteger)otherIndex ofBatch:(CDVCommandBatch*)other
+{
+    uint32_t entry = [self entryAtIndex:index];
+    uint32_t otherEntry = [other entryAtIndex:otherIndex];
+
+    return (entry != 0) && (otherEntry != 0) &&
+           [self node:[self child:1 ofValue:entry] isSameTextAs:[other child:1 ofValue:otherEntry] ofBatch:other];
+}
+
+- (NSString*)JSONOfCommandAtIndex:(NSUInteger)index
+{
+    if (index >= _commandCount) {
+        return nil;
+    }
+    const cdv_batch_node* n = &_nodes[_entries[index]];
+    return [[NSString alloc] initWithBytes:_bytes + n->start length:n->length encoding:NSUTF8StringEncoding];
+}
+
+@end
@@ -19,6 +19,8 @@
 
 #import "CDVAvailability.h"
 #import "CDVInvokedUrlCommand.h"
+#import "CDVResultThrottle.h"
+#import "CDVCursor.h"
 
 @class CDVPlugin;
 @class CDVPluginResult;
@@ -37,6 +39,17 @@
 
 // Sends a plugin result to the JS. This is thread-safe.
 - (void)sendPluginResult:(CDVPluginResult*)result callbackId:(NSString*)callbackId;
+// Limits how fast keep-alive results of a callback reach JS (see CDVResultThrottle.h).
+// interval is in seconds, capacity only matters for CDVResultThrottleBatch. Error results
+// and the final result (keepCallback NO) are never held back; they first flush what is held
+// and the final one ends the throttle. This is thread-safe.
+- (void)setResultThrottle:(CDVResultThrottleMode)mode interval:(NSTimeInterval)interval capacity:(NSUInteger)capacity forCallbackId:(NSString*)callbackId;
+// Delivered and dropped counts of the throttle of a callback, nil if it has none.
+- (NSDictionary*)resultThrottleStatsForCallbackId:(NSString*)callbackId;
+// Hands a cursor to JS. Returns the message to send as (part of) a result; the
+// callback receives an object that reads the cursor page by page (see CDVCursor.h).
+// This is thread-safe.
+- (NSDictionary*)openCursor:(CDVCursor*)cursor;
 // Evaluates the given JS. This is thread-safe.
 - (void)evalJs:(NSString*)js;
 // Can be used to evaluate JS right away instead of scheduling it on the run-loop.
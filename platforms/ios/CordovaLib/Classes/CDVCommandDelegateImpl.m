@@ -22,6 +22,39 @@
 #import "CDVCommandQueue.h"
 #import "CDVPluginResult.h"
 #import "CDVViewController.h"
+#import "CDVPlugin.h"
+#import "CDVLog.h"
+
+@interface CDVCommandDelegateImpl () {
+    // callbackId -> CDVResultThrottle, guarded by self. Each throttle is locked while it
+    // holds, flushes or sends results, which keeps the results of a callback in order.
+    NSMutableDictionary* _throttles;
+}
+@end
+
+// Callback ids from exec() are "<service>:<handle>" with an integer handle into the
+// JS callback table. The bare handle is passed to nativeCallback so that JS can go
+// straight to the slot; any other id is passed as a string.
+static NSString* CDVCallbackIdLiteral(NSString* callbackId)
+{
+    NSRange separator = [callbackId rangeOfString:@":" options:NSBackwardsSearch];
+    NSUInteger length = [callbackId length];
+
+    if ((separator.location != NSNotFound) && (separator.location + 1 < length) && (length - separator.location <= 17)) {
+        NSUInteger i = separator.location + 1;
+        for (; i < length; ++i) {
+            unichar c = [callbackId characterAtIndex:i];
+            if ((c < '0') || (c > '9')) {
+                break;
+            }
+        }
+
+        if (i == length) {
+            return [callbackId substringFromIndex:separator.location + 1];
+        }
+    }
+    return [NSString stringWithFormat:@"'%@'", callbackId];
+}
 
 @implementation CDVCommandDelegateImpl
 
@@ -31,10 +64,27 @@
     if (self != nil) {
         _viewController = viewController;
         _commandQueue = _viewController.commandQueue;
+        _throttles = [[NSMutableDictionary alloc] init];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(onReset:) name:CDVPluginResetNotification object:nil];
     }
     return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+// The callbacks of the previous page are gone, and so are their throttles.
+- (void)onReset:(NSNotification*)notification
+{
+    if (notification.object == _viewController.webView) {
+        @synchronized(self) {
+            [_throttles removeAllObjects];
+        }
+    }
+}
+
 - (NSString*)pathForResource:(NSString*)resourcepath
 {
     NSBundle* mainBundle = [NSBundle mainBundle];
@@ -80,6 +130,53 @@
     }
 }
 
+- (void)evalResult:(CDVPluginResult*)result callbackId:(NSString*)callbackId
+{
+    int status = [result.status intValue];
+    BOOL keepCallback = [result.keepCallback boolValue];
+    NSString* argumentsAsJSON = [result argumentsAsJSON];
+
+    NSString* js = [NSString stringWithFormat:@"cordova.require('cordova/exec').nativeCallback(%@,%d,%@,%d)", CDVCallbackIdLiteral(callbackId), status, argumentsAsJSON, keepCallback];
+
+    [self evalJsHelper:js];
+
+    // Deliver the same result to calls that were coalesced into this one.
+    // Each is evaluated on its own so that the exec messages nativeCallback
+    // returns are not dropped. Staged data is served once per id, so each
+    // alias stages the bytes under an id of its own.
+    NSArray* coalesced = [_commandQueue coalescedCallbackIdsForCallbackId:callbackId keepCallback:keepCallback];
+    for (NSString* aliasId in coalesced) {
+        NSString* aliasArguments = [result hasStagedData] ? [result argumentsAsJSON] : argumentsAsJSON;
+        js = [NSString stringWithFormat:@"cordova.require('cordova/exec').nativeCallback(%@,%d,%@,%d)", CDVCallbackIdLiteral(aliasId), status, aliasArguments, keepCallback];
+        [self evalJsHelper:js];
+    }
+}
+
+// Several results go out in a single nativeCallbackBatch eval, which also fetches the exec
+// messages of all their callbacks at once.
+- (void)evalResults:(NSArray*)results callbackId:(NSString*)callbackId
+{
+    if ([results count] <= 1) {
+        if ([results count] == 1) {
+            [self evalResult:[results objectAtIndex:0] callbackId:callbackId];
+        }
+        return;
+    }
+
+    NSMutableArray* entries = [NSMutableArray arrayWithCapacity:[results count]];
+    for (CDVPluginResult* result in results) {
+        int status = [result.status intValue];
+        BOOL keepCallback = [result.keepCallback boolValue];
+        NSString* argumentsAsJSON = [result argumentsAsJSON];
+        [entries addObject:[NSString stringWithFormat:@"[%@,%d,%@,%d]", CDVCallbackIdLiteral(callbackId), status, argumentsAsJSON, keepCallback]];
+        for (NSString* aliasId in [_commandQueue coalescedCallbackIdsForCallbackId:callbackId keepCallback:keepCallback]) {
+            NSString* aliasArguments = [result hasStagedData] ? [result argumentsAsJSON] : argumentsAsJSON;
+            [entries addObject:[NSString stringWithFormat:@"[%@,%d,%@,%d]", CDVCallbackIdLiteral(aliasId), status, aliasArguments, keepCallback]];
+        }
+    }
+    [self evalJsHelper:[NSString stringWithFormat:@"cordova.require('cordova/exec').nativeCallbackBatch([%@])", [entries componentsJoinedByString:@","]]];
+}
+
 - (void)sendPluginResult:(CDVPluginResult*)result callbackId:(NSString*)callbackId
 {
     CDV_EXEC_LOG(@"Exec(%@): Sending result. Status=%@", callbackId, result.status);
@@ -87,13 +184,92 @@
     if ([@"INVALID" isEqualToString : callbackId]) {
         return;
     }
-    int status = [result.status intValue];
+    if ([_commandQueue consumeResult:result forCallbackId:callbackId]) {
+        return;
+    }
     BOOL keepCallback = [result.keepCallback boolValue];
-    NSString* argumentsAsJSON = [result argumentsAsJSON];
+    CDVResultThrottle* throttle = nil;
+    @synchronized(self) {
+        throttle = [_throttles objectForKey:callbackId];
+        if ((throttle != nil) && !keepCallback) {
+            [_throttles removeObjectForKey:callbackId];
+        }
+    }
+    if (throttle == nil) {
+        [self evalResult:result callbackId:callbackId];
+        return;
+    }
+
+    @synchronized(throttle) {
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        if (keepCallback && ([result.status intValue] == CDVCommandStatus_OK)) {
+            NSTimeInterval flushDelay = -1;
+            if (![throttle holdResult:result now:now flushDelay:&flushDelay]) {
+                [self evalResult:result callbackId:callbackId];
+            } else if (flushDelay >= 0) {
+                [self flushThrottle:throttle callbackId:callbackId after:flushDelay];
+            }
+            return;
+        }
+        // Whatever is held goes first, so that JS sees the results in order.
+        [self evalResults:[[throttle takeResultsAt:now] arrayByAddingObject:result] callbackId:callbackId];
+        if (!keepCallback && (throttle.droppedCount > 0)) {
+            CDVLogInfo(CDVLogCategoryExec, @"Throttled callback %@ ended: %@", callbackId, [throttle stats]);
+        }
+    }
+}
 
-    NSString* js = [NSString stringWithFormat:@"cordova.require('cordova/exec').nativeCallback('%@',%d,%@,%d)", callbackId, status, argumentsAsJSON, keepCallback];
+- (void)flushThrottle:(CDVResultThrottle*)throttle callbackId:(NSString*)callbackId after:(NSTimeInterval)delay
+{
+    __weak CDVCommandDelegateImpl* weakSelf = self;
 
-    [self evalJsHelper:js];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        CDVCommandDelegateImpl* strongSelf = weakSelf;
+        @synchronized(throttle) {
+            [strongSelf evalResults:[throttle takeResultsAt:[NSDate timeIntervalSinceReferenceDate]] callbackId:callbackId];
+        }
+    });
+}
+
+- (void)setResultThrottle:(CDVResultThrottleMode)mode interval:(NSTimeInterval)interval capacity:(NSUInteger)capacity forCallbackId:(NSString*)callbackId
+{
+    if ((callbackId == nil) || [@"INVALID" isEqualToString : callbackId]) {
+        return;
+    }
+    CDVResultThrottle* previous = nil;
+    @synchronized(self) {
+        previous = [_throttles objectForKey:callbackId];
+        if (mode == CDVResultThrottleNone) {
+            [_throttles removeObjectForKey:callbackId];
+        } else {
+            [_throttles setObject:[[CDVResultThrottle alloc] initWithMode:mode interval:interval capacity:capacity] forKey:callbackId];
+        }
+    }
+    // Results held under the previous settings are not lost.
+    if (previous != nil) {
+        @synchronized(previous) {
+            [self evalResults:[previous takeResultsAt:[NSDate timeIntervalSinceReferenceDate]] callbackId:callbackId];
+        }
+    }
+}
+
+- (NSDictionary*)openCursor:(CDVCursor*)cursor
+{
+    return [_commandQueue openCursor:cursor];
+}
+
+- (NSDictionary*)resultThrottleStatsForCallbackId:(NSString*)callbackId
+{
+    CDVResultThrottle* throttle = nil;
+    @synchronized(self) {
+        throttle = [_throttles objectForKey:callbackId];
+    }
+    if (throttle == nil) {
+        return nil;
+    }
+    @synchronized(throttle) {
+        return [throttle stats];
+    }
 }
 
 - (void)evalJs:(NSString*)js
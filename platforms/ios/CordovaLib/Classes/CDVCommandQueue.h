@@ -19,12 +19,27 @@
 
 #import <Foundation/Foundation.h>
 
+@class CDVCursor;
 @class CDVInvokedUrlCommand;
+@class CDVPlugin;
+@class CDVPluginResult;
 @class CDVViewController;
 
 @interface CDVCommandQueue : NSObject
 
 @property (nonatomic, readonly) BOOL currentlyExecuting;
+// Number of queued commands that were folded into an identical earlier one
+// because their action is listed under "idempotent-actions" in config.xml.
+@property (nonatomic, readonly) NSUInteger coalescedCommandCount;
+// Number of cordova.exec.batch() calls run so far, and how many of the calls in
+// them ran in the same native turn as the call before them.
+@property (nonatomic, readonly) NSUInteger execBatchCount;
+@property (nonatomic, readonly) NSUInteger chainedCallCount;
+// Number of cordova.exec.sync() calls answered synchronously.
+@property (nonatomic, readonly) NSUInteger syncCallCount;
+// Number of cursors handed to JS, and how many of them are open.
+@property (nonatomic, readonly) NSUInteger cursorCount;
+@property (nonatomic, readonly) NSUInteger openCursorCount;
 
 - (id)initWithViewController:(CDVViewController*)viewController;
 - (void)dispose;
@@ -37,4 +52,30 @@
 - (void)executePending;
 - (BOOL)execute:(CDVInvokedUrlCommand*)command;
 
+// Callback IDs whose commands were folded into the command with the given
+// callbackId. The mapping is dropped unless keepCallback is YES.
+- (NSArray*)coalescedCallbackIdsForCallbackId:(NSString*)callbackId keepCallback:(BOOL)keepCallback;
+// "Service.action" -> NSNumber count of coalesced calls.
+- (NSDictionary*)coalescedCommandCounts;
+
+// Results for the calls of a cordova.exec.batch() or cordova.exec.sync() are
+// collected here instead of being sent to JS. Returns YES if the result was taken.
+- (BOOL)consumeResult:(CDVPluginResult*)result forCallbackId:(NSString*)callbackId;
+
+// Makes a plugin reachable by cordova.exec.sync() if service has sync-actions.
+// Called by CDVViewController for every plugin it creates.
+- (void)rememberSyncPlugin:(CDVPlugin*)plugin forService:(NSString*)service;
+
+// Runs a [service, action, args] call of cordova.exec.sync() on the calling
+// thread and returns its result as [status, message] JSON. Returns nil if the
+// call has to go through exec() instead: the action is not listed under
+// sync-actions, its plugin does not mark it non-blocking or is not loaded yet,
+// or it was demoted for not answering synchronously or running over budget.
+// Called by CDVURLProtocol on the URL loading thread.
+- (NSString*)executeSynchronously:(NSString*)commandJSON;
+
+// Keeps the cursor until JS is done with it and returns the message that stands
+// for it in a result: {CDVType: "Cursor", id, count}. See CDVCursor.h.
+- (NSDictionary*)openCursor:(CDVCursor*)cursor;
+
 @end
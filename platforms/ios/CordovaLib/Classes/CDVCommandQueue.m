@@ -22,18 +22,103 @@
 #import "CDVCommandQueue.h"
 #import "CDVViewController.h"
 #import "CDVCommandDelegateImpl.h"
+#import "CDVCommandBatch.h"
+
+// cordova.exec.batch() is sent as a call of this pseudo-service, which the queue runs itself.
+static NSString* const kCDVExecBatchService = @"CDVCommandQueue";
+static NSString* const kCDVExecBatchAction = @"batch";
+// Prefix of the callbackIds given to the calls of a batch; never a JS callback.
+static NSString* const kCDVExecBatchCallbackIdPrefix = @"CDVCommandQueue:batch";
+// Pages of a cursor are read and cursors closed through these actions of the same pseudo-service.
+static NSString* const kCDVCursorNextAction = @"cursorNext";
+static NSString* const kCDVCursorCloseAction = @"cursorClose";
+// Prefix of the callbackIds given to synchronous calls.
+static NSString* const kCDVSyncCallbackIdPrefix = @"CDVCommandQueue:sync";
+
+// The web view is blocked while a synchronous call runs. A call over this budget
+// is logged, and an action that goes over it this many times is demoted to exec().
+#define CDV_SYNC_EXEC_BUDGET_MS 4.0
+#define CDV_SYNC_EXEC_MAX_OVERRUNS 3
+
+// A cordova.exec.batch() in progress. Its calls run in order, each once the one
+// before it sent its first result, so a call can depend on the previous ones.
+// Results may arrive on any thread; the mutable state is guarded by the object.
+@interface CDVExecBatch : NSObject
+
+@property (nonatomic, copy) NSString* callbackId;
+@property (nonatomic, assign) NSUInteger serial;
+@property (nonatomic, strong) NSArray* calls;
+@property (nonatomic, assign) BOOL stopOnError;
+@property (nonatomic, assign) NSTimeInterval timeout;
+@property (nonatomic, assign) NSTimeInterval startedAt;
+// The first result of each call that ran, in order.
+@property (nonatomic, strong) NSMutableArray* results;
+// callbackId of the call waiting for its first result.
+@property (nonatomic, copy) NSString* pendingCallbackId;
+// Set while runExecBatch: is on the stack, or about to be; a result then needs no new run.
+@property (nonatomic, assign) BOOL running;
+@property (nonatomic, assign) BOOL cancelled;
+
+@end
+
+@implementation CDVExecBatch
+
+@synthesize callbackId, serial, calls, stopOnError, timeout, startedAt, results, pendingCallbackId, running, cancelled;
+
+- (BOOL)isFinished
+{
+    NSUInteger count = [self.results count];
+
+    if (count == [self.calls count]) {
+        return YES;
+    }
+    if (!self.stopOnError || (count == 0)) {
+        return NO;
+    }
+    int status = [[[self.results lastObject] status] intValue];
+    return (status != CDVCommandStatus_OK) && (status != CDVCommandStatus_NO_RESULT);
+}
+
+@end
 
 @interface CDVCommandQueue () {
     NSInteger _lastCommandQueueFlushRequestId;
     __weak CDVViewController* _viewController;
     NSMutableArray* _queue;
     BOOL _currentlyExecuting;
+    // callbackId of an executed command -> callbackIds of the duplicates folded into it.
+    NSMutableDictionary* _coalescedCallbackIds;
+    NSMutableDictionary* _coalescedCounts;
+    NSUInteger _coalescedCommandCount;
+    // callbackId of a batch call -> its CDVExecBatch. Calls that keep their
+    // callback stay here until their final result, which is swallowed.
+    NSMutableDictionary* _execBatchCalls;
+    NSUInteger _execBatchCount;
+    NSUInteger _chainedCallCount;
+    // Guarded by _syncLock: the loaded plugins that have sync-actions (lowercase
+    // service -> CDVPlugin), the results sent by the synchronous calls in progress
+    // (callbackId -> NSMutableArray), over-budget counts and the demoted actions
+    // ("Service.action").
+    NSObject* _syncLock;
+    NSMutableDictionary* _syncPlugins;
+    NSMutableDictionary* _syncResults;
+    NSMutableDictionary* _syncOverruns;
+    NSMutableSet* _demotedSyncActions;
+    NSUInteger _syncCallCount;
+    // Cursor id -> CDVCursor of the cursors JS may still read, guarded by itself.
+    NSMutableDictionary* _cursors;
+    NSUInteger _cursorCount;
 }
 @end
 
 @implementation CDVCommandQueue
 
 @synthesize currentlyExecuting = _currentlyExecuting;
+@synthesize coalescedCommandCount = _coalescedCommandCount;
+@synthesize execBatchCount = _execBatchCount;
+@synthesize chainedCallCount = _chainedCallCount;
+@synthesize syncCallCount = _syncCallCount;
+@synthesize cursorCount = _cursorCount;
 
 - (id)initWithViewController:(CDVViewController*)viewController
 {
@@ -41,10 +126,43 @@
     if (self != nil) {
         _viewController = viewController;
         _queue = [[NSMutableArray alloc] init];
+        _coalescedCallbackIds = [[NSMutableDictionary alloc] init];
+        _coalescedCounts = [[NSMutableDictionary alloc] init];
+        _execBatchCalls = [[NSMutableDictionary alloc] init];
+        _syncLock = [[NSObject alloc] init];
+        _syncPlugins = [[NSMutableDictionary alloc] init];
+        _syncResults = [[NSMutableDictionary alloc] init];
+        _syncOverruns = [[NSMutableDictionary alloc] init];
+        _demotedSyncActions = [[NSMutableSet alloc] init];
+        _cursors = [[NSMutableDictionary alloc] init];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(onReset:) name:CDVPluginResetNotification object:nil];
     }
     return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+// Batches of the previous page are abandoned; the calls not run yet never will be.
+// Its cursors can no longer be read.
+- (void)onReset:(NSNotification*)notification
+{
+    if (notification.object != _viewController.webView) {
+        return;
+    }
+    [self closeCursorsIdleSince:DBL_MAX];
+    @synchronized(_execBatchCalls) {
+        for (CDVExecBatch* batch in [_execBatchCalls allValues]) {
+            @synchronized(batch) {
+                batch.cancelled = YES;
+            }
+        }
+        [_execBatchCalls removeAllObjects];
+    }
+}
+
 - (void)dispose
 {
     // TODO(agrieve): Make this a zeroing weak ref once we drop support for 4.3.
@@ -96,52 +214,196 @@
     @try {
         _currentlyExecuting = YES;
 
-        for (NSUInteger i = 0; i < [_queue count]; ++i) {
-            // Parse the returned JSON array.
-            NSArray* commandBatch = [[_queue objectAtIndex:i] JSONObject];
+        // Batches may be enqueued while executing (by chaining), so keep
+        // draining until nothing is left.
+        while ([_queue count] > 0) {
+            // Decode every queued batch up front so that repeated idempotent
+            // commands can be collapsed across batch boundaries. Each batch is
+            // a single arena; arguments become objects only when plugins ask.
+            NSMutableArray* batches = [NSMutableArray arrayWithCapacity:[_queue count]];
+            for (NSString* batchJSON in _queue) {
+                CDVCommandBatch* batch = [CDVCommandBatch batchWithJSON:batchJSON];
+                if (batch != nil) {
+                    CDV_EXEC_LOG(@"Exec: Decoded %u command(s), %u value(s) in %u allocation(s).",
+                        (unsigned)batch.commandCount, (unsigned)batch.valueCount, (unsigned)batch.allocationCount);
+                    [batches addObject:batch];
+                }
+            }
+
+            [_queue removeAllObjects];
+
+            // Positions (counted across all batches) of commands folded into an earlier identical one.
+            NSMutableIndexSet* folded = [NSMutableIndexSet indexSet];
+            NSUInteger position = 0;
 
             // Iterate over and execute all of the commands.
-            for (NSArray* jsonEntry in commandBatch) {
-                @autoreleasepool {
-                    CDVInvokedUrlCommand* command = [CDVInvokedUrlCommand commandFromJson:jsonEntry];
-                    CDV_EXEC_LOG(@"Exec(%@): Calling %@.%@", command.callbackId, command.className, command.methodName);
+            for (NSUInteger b = 0; b < [batches count]; ++b) {
+                CDVCommandBatch* batch = [batches objectAtIndex:b];
+                for (NSUInteger i = 0; i < batch.commandCount; ++i, ++position) {
+                    if ([folded containsIndex:position]) {
+                        continue;
+                    }
+                    @autoreleasepool {
+                        CDVInvokedUrlCommand* command = [batch commandAtIndex:i];
+                        if (command != nil) {
+                            CDV_EXEC_LOG(@"Exec(%@): Calling %@.%@", command.callbackId, command.className, command.methodName);
+
+                            [self coalesceDuplicatesOfCommand:command atIndex:i ofBatch:b position:position inBatches:batches folded:folded];
+                        }
 
-                    if (![self execute:command]) {
+                        if ((command == nil) || ![self execute:command]) {
 #ifdef DEBUG
-                            NSString* commandJson = [jsonEntry JSONString];
-                            static NSUInteger maxLogLength = 1024;
-                            NSString* commandString = ([commandJson length] > maxLogLength) ?
-                                [NSString stringWithFormat:@"%@[...]", [commandJson substringToIndex:maxLogLength]] :
-                                commandJson;
+                                NSString* commandJson = [batch JSONOfCommandAtIndex:i];
+                                static NSUInteger maxLogLength = 1024;
+                                NSString* commandString = ([commandJson length] > maxLogLength) ?
+                                    [NSString stringWithFormat:@"%@[...]", [commandJson substringToIndex:maxLogLength]] :
+                                    commandJson;
 
-                            DLog(@"FAILED pluginJSON = %@", commandString);
+                                DLog(@"FAILED pluginJSON = %@", commandString);
 #endif
+                        }
                     }
                 }
             }
+            CDV_EXEC_LOG(@"Exec: Materialized %u object(s) for the decoded batches.",
+                (unsigned)[[batches valueForKeyPath:@"@sum.materializedCount"] unsignedIntegerValue]);
         }
-
-        [_queue removeAllObjects];
     } @finally
     {
         _currentlyExecuting = NO;
     }
 }
 
+static BOOL CDVIsRealCallbackId(id callbackId)
+{
+    return [callbackId isKindOfClass:[NSString class]] && ![@"INVALID" isEqualToString:callbackId];
+}
+
+// Folds later commands identical to command (same service, action and
+// argument JSON) into it when the action is declared idempotent in config.xml.
+// Their callbackIds are remembered so that the single result can be fanned out.
+// Only duplicates that no other call to the same service separates are folded:
+// with [state, start, state] the second state has to see what start did.
+- (void)coalesceDuplicatesOfCommand:(CDVInvokedUrlCommand*)command atIndex:(NSUInteger)index ofBatch:(NSUInteger)batchIndex position:(NSUInteger)position
+                          inBatches:(NSArray*)batches folded:(NSMutableIndexSet*)foldedPositions
+{
+    if ((command.className == nil) || (command.methodName == nil)) {
+        return;
+    }
+    NSSet* actions = [_viewController.idempotentActions objectForKey:[command.className lowercaseString]];
+    if (![actions containsObject:command.methodName]) {
+        return;
+    }
+
+    CDVCommandBatch* batch = [batches objectAtIndex:batchIndex];
+    BOOL hasCallback = CDVIsRealCallbackId(command.callbackId);
+    NSMutableArray* aliases = nil;
+    NSUInteger folded = 0;
+    NSUInteger otherPosition = position - index;
+    BOOL separated = NO;
+
+    for (NSUInteger b = batchIndex; b < [batches count] && !separated; ++b) {
+        CDVCommandBatch* other = [batches objectAtIndex:b];
+        for (NSUInteger j = 0; j < other.commandCount; ++j, ++otherPosition) {
+            if ((otherPosition <= position) || [foldedPositions containsIndex:otherPosition]) {
+                continue;
+            }
+            if (![batch commandAtIndex:index isSameCallAsCommandAtIndex:j ofBatch:other]) {
+                separated = [batch commandAtIndex:index hasSameServiceAsCommandAtIndex:j ofBatch:other];
+                if (separated) {
+                    break;
+                }
+                continue;
+            }
+            id otherCallbackId = [other callbackIdOfCommandAtIndex:j];
+            if (CDVIsRealCallbackId(otherCallbackId)) {
+                // Without a callbackId of our own there is nothing to fan out from.
+                if (!hasCallback) {
+                    continue;
+                }
+                if (aliases == nil) {
+                    aliases = [NSMutableArray array];
+                }
+                [aliases addObject:otherCallbackId];
+            }
+            [foldedPositions addIndex:otherPosition];
+            ++folded;
+        }
+    }
+
+    if (folded == 0) {
+        return;
+    }
+
+    NSString* key = [NSString stringWithFormat:@"%@.%@", command.className, command.methodName];
+    @synchronized(_coalescedCallbackIds) {
+        if (aliases != nil) {
+            NSMutableArray* existing = [_coalescedCallbackIds objectForKey:command.callbackId];
+            if (existing != nil) {
+                [existing addObjectsFromArray:aliases];
+            } else {
+                [_coalescedCallbackIds setObject:aliases forKey:command.callbackId];
+            }
+        }
+        _coalescedCommandCount += folded;
+        NSUInteger count = [[_coalescedCounts objectForKey:key] unsignedIntegerValue] + folded;
+        [_coalescedCounts setObject:[NSNumber numberWithUnsignedInteger:count] forKey:key];
+    }
+    CDV_EXEC_LOG(@"Exec(%@): Coalesced %u duplicate %@ call(s).", command.callbackId, (unsigned)folded, key);
+}
+
+- (NSArray*)coalescedCallbackIdsForCallbackId:(NSString*)callbackId keepCallback:(BOOL)keepCallback
+{
+    if (callbackId == nil) {
+        return nil;
+    }
+    @synchronized(_coalescedCallbackIds) {
+        NSArray* aliases = [_coalescedCallbackIds objectForKey:callbackId];
+        if (aliases == nil) {
+            return nil;
+        }
+        aliases = [aliases copy];
+        if (!keepCallback) {
+            [_coalescedCallbackIds removeObjectForKey:callbackId];
+        }
+        return aliases;
+    }
+}
+
+- (NSDictionary*)coalescedCommandCounts
+{
+    @synchronized(_coalescedCallbackIds) {
+        return [_coalescedCounts copy];
+    }
+}
+
 - (BOOL)execute:(CDVInvokedUrlCommand*)command
 {
     if ((command.className == nil) || (command.methodName == nil)) {
-        NSLog(@"ERROR: Classname and/or methodName not found for command.");
+        CDVLogError(CDVLogCategoryExec, @"ERROR: Classname and/or methodName not found for command.");
         return NO;
     }
+    if ([command.className isEqualToString:kCDVExecBatchService]) {
+        if ([command.methodName isEqualToString:kCDVExecBatchAction]) {
+            [self executeBatchCommand:command];
+            return YES;
+        } else if ([command.methodName isEqualToString:kCDVCursorNextAction]) {
+            [self executeCursorNextCommand:command];
+            return YES;
+        } else if ([command.methodName isEqualToString:kCDVCursorCloseAction]) {
+            [self executeCursorCloseCommand:command];
+            return YES;
+        }
+    }
 
     // Fetch an instance of this class
     CDVPlugin* obj = [_viewController.commandDelegate getCommandInstance:command.className];
 
     if (!([obj isKindOfClass:[CDVPlugin class]])) {
-        NSLog(@"ERROR: Plugin '%@' not found, or is not a CDVPlugin. Check your plugin mapping in config.xml.", command.className);
+        CDVLogError(CDVLogCategoryExec, @"ERROR: Plugin '%@' not found, or is not a CDVPlugin. Check your plugin mapping in config.xml.", command.className);
         return NO;
     }
+    [self rememberSyncPlugin:obj forService:command.className];
     BOOL retVal = YES;
     double started = [[NSDate date] timeIntervalSince1970] * 1000.0;
     // Find the proper selector to call.
@@ -152,14 +414,394 @@
         objc_msgSend(obj, normalSelector, command);
     } else {
         // There's no method to call, so throw an error.
-        NSLog(@"ERROR: Method '%@' not defined in Plugin '%@'", methodName, command.className);
+        CDVLogError(CDVLogCategoryExec, @"ERROR: Method '%@' not defined in Plugin '%@'", methodName, command.className);
         retVal = NO;
     }
     double elapsed = [[NSDate date] timeIntervalSince1970] * 1000.0 - started;
     if (elapsed > 10) {
-        NSLog(@"THREAD WARNING: ['%@'] took '%f' ms. Plugin should use a background thread.", command.className, elapsed);
+        CDVLogWarning(CDVLogCategoryExec, @"THREAD WARNING: ['%@'] took '%f' ms. Plugin should use a background thread.", command.className, elapsed);
     }
     return retVal;
 }
 
+#pragma mark Exec batches
+
+// args: [[[service, action, args], ...], {stopOnError: bool, timeout: ms}]
+- (void)executeBatchCommand:(CDVInvokedUrlCommand*)command
+{
+    NSArray* calls = [command argumentAtIndex:0 withDefault:nil andClass:[NSArray class]];
+
+    if (calls == nil) {
+        CDVPluginResult* result = [CDVPluginResult resultWithStatus:CDVCommandStatus_JSON_EXCEPTION messageAsString:@"Invalid batch"];
+        [_viewController.commandDelegate sendPluginResult:result callbackId:command.callbackId];
+        return;
+    }
+    NSDictionary* options = [command argumentAtIndex:1 withDefault:nil andClass:[NSDictionary class]];
+
+    CDVExecBatch* batch = [[CDVExecBatch alloc] init];
+    batch.callbackId = command.callbackId;
+    batch.serial = ++_execBatchCount;
+    batch.calls = calls;
+    batch.stopOnError = [[options objectForKey:@"stopOnError"] boolValue];
+    batch.timeout = [[options objectForKey:@"timeout"] doubleValue] / 1000.0;
+    batch.startedAt = [NSDate timeIntervalSinceReferenceDate];
+    batch.results = [NSMutableArray arrayWithCapacity:[calls count]];
+    batch.running = YES;
+    [self runExecBatch:batch];
+}
+
+// Runs the calls of a batch for as long as they answer synchronously, on the main
+// thread. A call that answers later resumes the batch from consumeResult:.
+- (void)runExecBatch:(CDVExecBatch*)batch
+{
+    BOOL chained = NO;
+
+    for (;; chained = YES) {
+        NSUInteger index = 0;
+        BOOL finished = NO;
+        @synchronized(batch) {
+            if (batch.cancelled || (batch.pendingCallbackId != nil)) {
+                batch.running = NO;
+                return;
+            }
+            index = [batch.results count];
+            finished = [batch isFinished];
+        }
+        if (finished) {
+            [self finishExecBatch:batch];
+            return;
+        }
+        if (chained) {
+            ++_chainedCallCount;
+        }
+
+        NSString* callbackId = [NSString stringWithFormat:@"%@%lu.%lu", kCDVExecBatchCallbackIdPrefix, (unsigned long)batch.serial, (unsigned long)index];
+        id call = [batch.calls objectAtIndex:index];
+        CDVInvokedUrlCommand* callCommand = nil;
+        if ([call isKindOfClass:[NSArray class]] && ([call count] >= 2) &&
+            [[call objectAtIndex:0] isKindOfClass:[NSString class]] && [[call objectAtIndex:1] isKindOfClass:[NSString class]] &&
+            ![[call objectAtIndex:0] isEqualToString:kCDVExecBatchService]) {
+            id arguments = ([call count] > 2) ? [call objectAtIndex:2] : nil;
+            callCommand = [[CDVInvokedUrlCommand alloc] initWithArguments:([arguments isKindOfClass:[NSArray class]] ? arguments : [NSArray array])
+                                                               callbackId:callbackId
+                                                                className:[call objectAtIndex:0]
+                                                               methodName:[call objectAtIndex:1]];
+        }
+
+        @synchronized(batch) {
+            batch.pendingCallbackId = callbackId;
+        }
+        @synchronized(_execBatchCalls) {
+            [_execBatchCalls setObject:batch forKey:callbackId];
+        }
+        CDV_EXEC_LOG(@"Exec(%@): Calling %@.%@ in batch %@", callbackId, callCommand.className, callCommand.methodName, batch.callbackId);
+
+        if ((callCommand == nil) || ![self execute:callCommand]) {
+            CDVPluginResult* result = [CDVPluginResult resultWithStatus:CDVCommandStatus_INVALID_ACTION messageAsString:@"Invalid call"];
+            [self consumeResult:result forCallbackId:callbackId];
+        } else if (batch.timeout > 0) {
+            [self expireBatchCall:callbackId after:batch.timeout];
+        }
+    }
+}
+
+- (void)expireBatchCall:(NSString*)callbackId after:(NSTimeInterval)timeout
+{
+    __weak CDVCommandQueue* weakSelf = self;
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        CDVPluginResult* result = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR messageAsString:@"Timed out"];
+        [weakSelf consumeResult:result forCallbackId:callbackId];
+    });
+}
+
+- (BOOL)consumeResult:(CDVPluginResult*)result forCallbackId:(NSString*)callbackId
+{
+    if ([callbackId hasPrefix:kCDVSyncCallbackIdPrefix]) {
+        // Results sent after the call returned have nowhere to go; JS got an error.
+        @synchronized(_syncLock) {
+            [[_syncResults objectForKey:callbackId] addObject:result];
+        }
+        return YES;
+    }
+    if (![callbackId hasPrefix:kCDVExecBatchCallbackIdPrefix]) {
+        return NO;
+    }
+    CDVExecBatch* batch = nil;
+    @synchronized(_execBatchCalls) {
+        batch = [_execBatchCalls objectForKey:callbackId];
+        if ((batch != nil) && ![result.keepCallback boolValue]) {
+            [_execBatchCalls removeObjectForKey:callbackId];
+        }
+    }
+    // Late results of a finished, expired or abandoned batch have nowhere to go.
+    if (batch == nil) {
+        return YES;
+    }
+
+    BOOL resume = NO;
+    @synchronized(batch) {
+        // Only the first result of a call that keeps its callback makes it into the batch.
+        if (![callbackId isEqualToString:batch.pendingCallbackId]) {
+            return YES;
+        }
+        [batch.results addObject:result];
+        batch.pendingCallbackId = nil;
+        resume = !batch.running;
+        batch.running = YES;
+    }
+    if (resume) {
+        __weak CDVCommandQueue* weakSelf = self;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf runExecBatch:batch];
+        });
+    }
+    return YES;
+}
+
+// Sends [{status, message}, ...] for the calls that ran in a single result, an
+// error if any of them failed.
+- (void)finishExecBatch:(CDVExecBatch*)batch
+{
+    NSMutableArray* entries = [NSMutableArray arrayWithCapacity:[batch.results count]];
+    BOOL failed = NO;
+
+    for (CDVPluginResult* result in batch.results) {
+        int status = [result.status intValue];
+        failed |= (status != CDVCommandStatus_OK) && (status != CDVCommandStatus_NO_RESULT);
+        [entries addObject:[NSString stringWithFormat:@"{\"status\":%d,\"message\":%@}", status, [result argumentsAsJSON]]];
+    }
+    CDV_EXEC_LOG(@"Exec(%@): Batch ran %u of %u call(s) in %.1f ms.", batch.callbackId,
+        (unsigned)[entries count], (unsigned)[batch.calls count], ([NSDate timeIntervalSinceReferenceDate] - batch.startedAt) * 1000.0);
+
+    NSString* json = [NSString stringWithFormat:@"[%@]", [entries componentsJoinedByString:@","]];
+    CDVPluginResult* result = [CDVPluginResult resultWithStatus:(failed ? CDVCommandStatus_ERROR : CDVCommandStatus_OK) messageAsEncodedJSON:json];
+    [_viewController.commandDelegate sendPluginResult:result callbackId:batch.callbackId];
+}
+
+#pragma mark Cursors
+
+- (NSUInteger)openCursorCount
+{
+    @synchronized(_cursors) {
+        return [_cursors count];
+    }
+}
+
+// Closes the cursors not read since the given time. Cursors are only looked at when
+// one is opened or read, so an idle one can outlive its timeout; there are never
+// more than CDV_MAX_OPEN_CURSORS of them.
+- (void)closeCursorsIdleSince:(NSTimeInterval)time
+{
+    NSMutableArray* closed = [NSMutableArray array];
+
+    @synchronized(_cursors) {
+        for (NSString* cursorId in [_cursors allKeys]) {
+            CDVCursor* cursor = [_cursors objectForKey:cursorId];
+            if (cursor.lastRead < time) {
+                [closed addObject:cursor];
+                [_cursors removeObjectForKey:cursorId];
+            }
+        }
+    }
+    if ([closed count] > 0) {
+        // The iterators may hold plugin state, which is only touched on the main thread.
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [closed makeObjectsPerformSelector:@selector(close)];
+        });
+    }
+}
+
+- (NSDictionary*)openCursor:(CDVCursor*)cursor
+{
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    NSString* cursorId = nil;
+    CDVCursor* evicted = nil;
+
+    [self closeCursorsIdleSince:now - CDV_CURSOR_IDLE_TIMEOUT];
+    @synchronized(_cursors) {
+        cursorId = [NSString stringWithFormat:@"%lu", (unsigned long)++_cursorCount];
+        if ([_cursors count] >= CDV_MAX_OPEN_CURSORS) {
+            NSString* oldestId = nil;
+            for (NSString* key in _cursors) {
+                if ((oldestId == nil) || ([[_cursors objectForKey:key] lastRead] < [[_cursors objectForKey:oldestId] lastRead])) {
+                    oldestId = key;
+                }
+            }
+            evicted = [_cursors objectForKey:oldestId];
+            [_cursors removeObjectForKey:oldestId];
+            CDVLogWarning(CDVLogCategoryExec, @"More than %d cursors open, closing cursor %@ at %lu elements. Close cursors that are no longer read.",
+                CDV_MAX_OPEN_CURSORS, oldestId, (unsigned long)evicted.position);
+        }
+        if (!cursor.exhausted) {
+            [_cursors setObject:cursor forKey:cursorId];
+        }
+    }
+    if (evicted != nil) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [evicted close];
+        });
+    }
+    return @{
+               @"CDVType" : @"Cursor",
+               @"id" : cursorId,
+               @"count" :[NSNumber numberWithInteger:cursor.count]
+    };
+}
+
+// args: [cursorId, pageSize]. Sends {elements, position, done}; the cursor is gone once done.
+- (void)executeCursorNextCommand:(CDVInvokedUrlCommand*)command
+{
+    NSString* cursorId = [command argumentAtIndex:0 withDefault:nil andClass:[NSString class]];
+    NSUInteger pageSize = [[command argumentAtIndex:1 withDefault:nil andClass:[NSNumber class]] unsignedIntegerValue];
+    CDVCursor* cursor = nil;
+
+    [self closeCursorsIdleSince:[NSDate timeIntervalSinceReferenceDate] - CDV_CURSOR_IDLE_TIMEOUT];
+    @synchronized(_cursors) {
+        cursor = (cursorId != nil) ? [_cursors objectForKey:cursorId] : nil;
+    }
+    if (cursor == nil) {
+        CDVPluginResult* result = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR messageAsString:@"Cursor closed"];
+        [_viewController.commandDelegate sendPluginResult:result callbackId:command.callbackId];
+        return;
+    }
+
+    NSArray* elements = [cursor nextPage:pageSize];
+    if (cursor.exhausted) {
+        @synchronized(_cursors) {
+            [_cursors removeObjectForKey:cursorId];
+        }
+    }
+    NSDictionary* page = @{
+                              @"elements" : elements,
+                              @"position" :[NSNumber numberWithUnsignedInteger:cursor.position],
+                              @"done" :[NSNumber numberWithBool:cursor.exhausted]
+    };
+    CDVPluginResult* result = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK messageAsDictionary:page];
+    [_viewController.commandDelegate sendPluginResult:result callbackId:command.callbackId];
+}
+
+// args: [cursorId]
+- (void)executeCursorCloseCommand:(CDVInvokedUrlCommand*)command
+{
+    NSString* cursorId = [command argumentAtIndex:0 withDefault:nil andClass:[NSString class]];
+    CDVCursor* cursor = nil;
+
+    @synchronized(_cursors) {
+        if (cursorId != nil) {
+            cursor = [_cursors objectForKey:cursorId];
+            [_cursors removeObjectForKey:cursorId];
+        }
+    }
+    [cursor close];
+    CDVPluginResult* result = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK];
+    [_viewController.commandDelegate sendPluginResult:result callbackId:command.callbackId];
+}
+
+#pragma mark Synchronous calls
+
+// Plugins are created on the main thread, so synchronous calls only reach the
+// ones CDVViewController has already created: onload plugins at startup, the
+// others on their first asynchronous exec().
+- (void)rememberSyncPlugin:(CDVPlugin*)plugin forService:(NSString*)service
+{
+    if ([_viewController.syncActions count] == 0) {
+        return;
+    }
+    NSString* key = [service lowercaseString];
+    if ([_viewController.syncActions objectForKey:key] == nil) {
+        return;
+    }
+    @synchronized(_syncLock) {
+        if ([_syncPlugins objectForKey:key] == nil) {
+            [_syncPlugins setObject:plugin forKey:key];
+        }
+    }
+}
+
+- (void)demoteSyncAction:(NSString*)name
+{
+    @synchronized(_syncLock) {
+        [_demotedSyncActions addObject:name];
+    }
+}
+
+- (NSString*)executeSynchronously:(NSString*)commandJSON
+{
+    NSData* data = [commandJSON dataUsingEncoding:NSUTF8StringEncoding];
+    NSArray* entry = (data != nil) ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+
+    if (![entry isKindOfClass:[NSArray class]] || ([entry count] < 2) ||
+        ![[entry objectAtIndex:0] isKindOfClass:[NSString class]] || ![[entry objectAtIndex:1] isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    NSString* service = [entry objectAtIndex:0];
+    NSString* action = [entry objectAtIndex:1];
+    id arguments = ([entry count] > 2) ? [entry objectAtIndex:2] : nil;
+    NSString* key = [service lowercaseString];
+    if (![[_viewController.syncActions objectForKey:key] containsObject:action]) {
+        return nil;
+    }
+
+    NSString* name = [NSString stringWithFormat:@"%@.%@", service, action];
+    NSString* callbackId = nil;
+    CDVPlugin* plugin = nil;
+    @synchronized(_syncLock) {
+        if ([_demotedSyncActions containsObject:name]) {
+            return nil;
+        }
+        plugin = [_syncPlugins objectForKey:key];
+        if (plugin == nil) {
+            return nil;
+        }
+        callbackId = [NSString stringWithFormat:@"%@%lu", kCDVSyncCallbackIdPrefix, (unsigned long)++_syncCallCount];
+        [_syncResults setObject:[NSMutableArray arrayWithCapacity:1] forKey:callbackId];
+    }
+
+    SEL selector = NSSelectorFromString([action stringByAppendingString:@":"]);
+    if (![[[plugin class] nonBlockingActions] containsObject:action] || ![plugin respondsToSelector:selector]) {
+        CDVLogError(CDVLogCategoryExec, @"ERROR: %@ is listed under sync-actions, but the plugin does not implement it or does not mark it non-blocking.", name);
+        @synchronized(_syncLock) {
+            [_syncResults removeObjectForKey:callbackId];
+        }
+        [self demoteSyncAction:name];
+        return nil;
+    }
+
+    CDVInvokedUrlCommand* command = [[CDVInvokedUrlCommand alloc] initWithArguments:([arguments isKindOfClass:[NSArray class]] ? arguments : [NSArray array])
+                                                                         callbackId:callbackId
+                                                                          className:service
+                                                                         methodName:action];
+    CFAbsoluteTime started = CFAbsoluteTimeGetCurrent();
+    objc_msgSend(plugin, selector, command);
+    double elapsed = (CFAbsoluteTimeGetCurrent() - started) * 1000.0;
+
+    NSArray* results = nil;
+    NSUInteger overruns = 0;
+    @synchronized(_syncLock) {
+        results = [_syncResults objectForKey:callbackId];
+        [_syncResults removeObjectForKey:callbackId];
+        if (elapsed > CDV_SYNC_EXEC_BUDGET_MS) {
+            overruns = [[_syncOverruns objectForKey:name] unsignedIntegerValue] + 1;
+            [_syncOverruns setObject:[NSNumber numberWithUnsignedInteger:overruns] forKey:name];
+        }
+    }
+
+    CDVPluginResult* result = ([results count] == 1) ? [results objectAtIndex:0] : nil;
+    if ((result == nil) || [result.keepCallback boolValue]) {
+        CDVLogError(CDVLogCategoryExec, @"ERROR: %@ sent %u result(s) instead of a single final one during a synchronous call. It goes through exec() from now on.",
+            name, (unsigned)[results count]);
+        [self demoteSyncAction:name];
+        result = [CDVPluginResult resultWithStatus:CDVCommandStatus_ILLEGAL_ACCESS_EXCEPTION messageAsString:@"Not a synchronous action"];
+    } else if (overruns > 0) {
+        CDVLogWarning(CDVLogCategoryExec, @"THREAD WARNING: synchronous %@ took %.2f ms, over the budget of %.0f ms.", name, elapsed, CDV_SYNC_EXEC_BUDGET_MS);
+        if (overruns >= CDV_SYNC_EXEC_MAX_OVERRUNS) {
+            CDVLogWarning(CDVLogCategoryExec, @"%@ went over budget %u times. It goes through exec() from now on.", name, (unsigned)overruns);
+            [self demoteSyncAction:name];
+        }
+    }
+    CDV_EXEC_LOG(@"Exec(%@): Synchronous %@ in %.2f ms.", callbackId, name, elapsed);
+    return [NSString stringWithFormat:@"[%d,%@]", [result.status intValue], [result argumentsAsJSON]];
+}
+
 @end
@@ -26,6 +26,8 @@
 @property (nonatomic, readonly, strong) NSMutableDictionary* settings;
 @property (nonatomic, readonly, strong) NSMutableArray* whitelistHosts;
 @property (nonatomic, readonly, strong) NSMutableArray* startupPluginNames;
+@property (nonatomic, readonly, strong) NSMutableDictionary* idempotentActions;
+@property (nonatomic, readonly, strong) NSMutableDictionary* syncActions;
 @property (nonatomic, readonly, strong) NSString* startPage;
 
 @end
@@ -25,13 +25,29 @@
 @property (nonatomic, readwrite, strong) NSMutableDictionary* settings;
 @property (nonatomic, readwrite, strong) NSMutableArray* whitelistHosts;
 @property (nonatomic, readwrite, strong) NSMutableArray* startupPluginNames;
+@property (nonatomic, readwrite, strong) NSMutableDictionary* idempotentActions;
+@property (nonatomic, readwrite, strong) NSMutableDictionary* syncActions;
 @property (nonatomic, readwrite, strong) NSString* startPage;
 
 @end
 
+// The action names of a comma-separated list such as "getStatus, getSettings".
+static NSSet* CDVActionSetFromList(NSString* list)
+{
+    NSMutableSet* actions = [NSMutableSet set];
+
+    for (NSString* action in [list componentsSeparatedByString:@","]) {
+        NSString* trimmed = [action stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        if ([trimmed length] > 0) {
+            [actions addObject:trimmed];
+        }
+    }
+    return actions;
+}
+
 @implementation CDVConfigParser
 
-@synthesize pluginsDict, settings, whitelistHosts, startPage, startupPluginNames;
+@synthesize pluginsDict, settings, whitelistHosts, startPage, startupPluginNames, idempotentActions, syncActions;
 
 - (id)init
 {
@@ -44,6 +60,8 @@
         [self.whitelistHosts addObject:@"content:///*"];
         [self.whitelistHosts addObject:@"data:///*"];
         self.startupPluginNames = [[NSMutableArray alloc] initWithCapacity:8];
+        self.idempotentActions = [[NSMutableDictionary alloc] initWithCapacity:8];
+        self.syncActions = [[NSMutableDictionary alloc] initWithCapacity:8];
         featureName = nil;
     }
     return self;
@@ -66,6 +84,14 @@
         if (paramIsOnload || attribIsOnload) {
             [self.startupPluginNames addObject:featureName];
         }
+        // e.g. <param name="idempotent-actions" value="getStatus,getSettings" />
+        if ([paramName isEqualToString:@"idempotent-actions"]) {
+            idempotentActions[featureName] = CDVActionSetFromList(value);
+        }
+        // e.g. <param name="sync-actions" value="getStatus" />, see cordova.exec.sync()
+        if ([paramName isEqualToString:@"sync-actions"]) {
+            syncActions[featureName] = CDVActionSetFromList(value);
+        }
     } else if ([elementName isEqualToString:@"access"]) {
         [whitelistHosts addObject:attributeDict[@"origin"]];
     } else if ([elementName isEqualToString:@"content"]) {
@@ -0,0 +1,62 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+// Returns the next element of a collection, or nil at its end. Elements must be
+// JSON-compatible (NSString, NSNumber, NSNull, NSArray, NSDictionary).
+typedef id (^CDVCursorIterator)(void);
+
+/*
+ A large collection that JS reads page by page instead of receiving it in one
+ result. A plugin creates the cursor over its data and hands it to JS with
+ -[CDVCommandDelegate openCursor:]; the iterator is called on the main thread
+ while a page is filled, so it may read plugin state directly. Only the page
+ being sent exists as Foundation objects, unless the cursor wraps an array.
+
+ A cursor is released when JS closes it or reads its last page, after
+ CDV_CURSOR_IDLE_TIMEOUT seconds without a read, when the page is reloaded, or
+ when more than CDV_MAX_OPEN_CURSORS are open (the least recently read goes).
+ Releasing it releases the iterator and what its block captured.
+ */
+#define CDV_CURSOR_IDLE_TIMEOUT 60.0
+#define CDV_MAX_OPEN_CURSORS 16
+// Larger page requests are cut to this many elements.
+#define CDV_MAX_CURSOR_PAGE_SIZE 500
+
+@interface CDVCursor : NSObject
+
+// Number of elements, or -1 if the iterator does not know it up front.
+@property (nonatomic, readonly) NSInteger count;
+// Elements read so far.
+@property (nonatomic, readonly) NSUInteger position;
+// Whether the iterator returned nil or the cursor was closed.
+@property (nonatomic, readonly) BOOL exhausted;
+@property (nonatomic, readonly) NSTimeInterval lastRead;
+
++ (CDVCursor*)cursorWithIterator:(CDVCursorIterator)iterator count:(NSInteger)count;
+// Pages through an array the plugin already has; saves serializing it in one go.
++ (CDVCursor*)cursorWithArray:(NSArray*)array;
+
+// The next elements, at most maxCount (clamped to 1...CDV_MAX_CURSOR_PAGE_SIZE).
+- (NSArray*)nextPage:(NSUInteger)maxCount;
+// Releases the iterator; later pages are empty.
+- (void)close;
+
+@end
@@ -0,0 +1,89 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CDVCursor.h"
+
+@interface CDVCursor () {
+    CDVCursorIterator _iterator;
+}
+@end
+
+@implementation CDVCursor
+
+@synthesize count = _count, position = _position, exhausted = _exhausted, lastRead = _lastRead;
+
+- (id)initWithIterator:(CDVCursorIterator)iterator count:(NSInteger)count
+{
+    self = [super init];
+    if (self != nil) {
+        _iterator = [iterator copy];
+        _count = (count >= 0) ? count : -1;
+        _exhausted = (iterator == nil) || (count == 0);
+        _lastRead = [NSDate timeIntervalSinceReferenceDate];
+    }
+    return self;
+}
+
++ (CDVCursor*)cursorWithIterator:(CDVCursorIterator)iterator count:(NSInteger)count
+{
+    return [[CDVCursor alloc] initWithIterator:iterator count:count];
+}
+
++ (CDVCursor*)cursorWithArray:(NSArray*)array
+{
+    __block NSUInteger index = 0;
+    NSUInteger count = [array count];
+
+    return [[CDVCursor alloc] initWithIterator:^id (void) {
+        return (index < count) ? [array objectAtIndex:index++] : nil;
+    } count:count];
+}
+
+- (NSArray*)nextPage:(NSUInteger)maxCount
+{
+    maxCount = MIN(MAX(maxCount, 1), CDV_MAX_CURSOR_PAGE_SIZE);
+    _lastRead = [NSDate timeIntervalSinceReferenceDate];
+    if (_exhausted) {
+        return [NSArray array];
+    }
+
+    NSMutableArray* page = [NSMutableArray arrayWithCapacity:maxCount];
+    while ([page count] < maxCount) {
+        id element = _iterator();
+        if (element == nil) {
+            [self close];
+            break;
+        }
+        [page addObject:element];
+    }
+    _position += [page count];
+    // Known counts end the cursor with the last page instead of with an empty one.
+    if ((_count >= 0) && (_position >= (NSUInteger)_count)) {
+        [self close];
+    }
+    return page;
+}
+
+- (void)close
+{
+    _exhausted = YES;
+    _iterator = nil;
+}
+
+@end
@@ -19,11 +19,18 @@
 
 #import <Foundation/Foundation.h>
 
+@class CDVCommandBatch;
+
 @interface CDVInvokedUrlCommand : NSObject {
     NSString* _callbackId;
     NSString* _className;
     NSString* _methodName;
     NSArray* _arguments;
+    // Set for commands created by a CDVCommandBatch: the arguments stay in its
+    // arena until they are asked for.
+    CDVCommandBatch* _batch;
+    NSUInteger _argumentsValue;
+    NSMutableArray* _materializedArguments;
 }
 
 @property (nonatomic, readonly) NSArray* arguments;
@@ -40,6 +47,13 @@
 
 - (id)initFromJson:(NSArray*)jsonEntry;
 
+// Used by CDVCommandBatch; arguments is the node of the arguments array in the batch.
+- (id)initWithBatch:(CDVCommandBatch*)batch
+          arguments:(NSUInteger)arguments
+         callbackId:(NSString*)callbackId
+          className:(NSString*)className
+         methodName:(NSString*)methodName;
+
 // Returns the argument at the given index.
 // If index >= the number of arguments, returns nil.
 // If the argument at the given index is NSNull, returns nil.
@@ -18,12 +18,12 @@
  */
 
 #import "CDVInvokedUrlCommand.h"
+#import "CDVCommandBatch.h"
 #import "CDVJSON.h"
 #import "NSData+Base64.h"
 
 @implementation CDVInvokedUrlCommand
 
-@synthesize arguments = _arguments;
 @synthesize callbackId = _callbackId;
 @synthesize className = _className;
 @synthesize methodName = _methodName;
@@ -63,6 +63,85 @@
     return self;
 }
 
+- (id)initWithBatch:(CDVCommandBatch*)batch
+          arguments:(NSUInteger)arguments
+         callbackId:(NSString*)callbackId
+          className:(NSString*)className
+         methodName:(NSString*)methodName
+{
+    self = [super init];
+    if (self != nil) {
+        _batch = batch;
+        _argumentsValue = arguments;
+        _callbackId = callbackId;
+        _className = className;
+        _methodName = methodName;
+    }
+    return self;
+}
+
+// Placeholder for arguments of a batch command that were not asked for yet.
+static id CDVUnmaterializedArgument(void)
+{
+    static id placeholder = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        placeholder = [[NSObject alloc] init];
+    });
+    return placeholder;
+}
+
+- (NSUInteger)argumentCount
+{
+    return (_batch != nil) ? [_batch countOfArrayValue:_argumentsValue] : [_arguments count];
+}
+
+// The argument at index, which is < argumentCount. A batch argument is turned into
+// an object the first time it is asked for and the same object is returned after that.
+- (id)rawArgumentAtIndex:(NSUInteger)index
+{
+    if (_batch == nil) {
+        return [_arguments objectAtIndex:index];
+    }
+    @synchronized(self) {
+        if (_materializedArguments == nil) {
+            NSUInteger count = [self argumentCount];
+            _materializedArguments = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger i = 0; i < count; ++i) {
+                [_materializedArguments addObject:CDVUnmaterializedArgument()];
+            }
+        }
+        id arg = [_materializedArguments objectAtIndex:index];
+        if (arg == CDVUnmaterializedArgument()) {
+            arg = [_batch argument:index ofArrayValue:_argumentsValue];
+            if (arg == nil) {
+                arg = [NSNull null];
+            }
+            [_materializedArguments replaceObjectAtIndex:index withObject:arg];
+        }
+        return arg;
+    }
+}
+
+- (NSArray*)arguments
+{
+    if (_batch == nil) {
+        return _arguments;
+    }
+    @synchronized(self) {
+        if (_arguments == nil) {
+            NSUInteger count = [self argumentCount];
+            NSMutableArray* arguments = [NSMutableArray arrayWithCapacity:count];
+            for (NSUInteger i = 0; i < count; ++i) {
+                [arguments addObject:[self rawArgumentAtIndex:i]];
+            }
+            _arguments = arguments;
+        }
+        return _arguments;
+    }
+}
+
 - (void)massageArguments
 {
     NSMutableArray* newArgs = nil;
@@ -101,10 +180,10 @@
 
 - (id)argumentAtIndex:(NSUInteger)index withDefault:(id)defaultValue andClass:(Class)aClass
 {
-    if (index >= [_arguments count]) {
+    if (index >= [self argumentCount]) {
         return defaultValue;
     }
-    id ret = [_arguments objectAtIndex:index];
+    id ret = [self rawArgumentAtIndex:index];
     if (ret == [NSNull null]) {
         ret = defaultValue;
     }
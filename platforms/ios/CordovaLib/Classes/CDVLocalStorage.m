@@ -159,6 +159,10 @@
     if (destExists && ![fileManager copyItemAtPath:dest toPath:tempBackup error:error]) {
         return NO;
     }
+    // the backup is removed below, unless the app dies first
+    if (destExists) {
+        [[CDVTempFilePurger sharedPurger] registerTemporaryFile:tempBackup];
+    }
 
     // remove the dest
     if (destExists && ![fileManager removeItemAtPath:dest error:error]) {
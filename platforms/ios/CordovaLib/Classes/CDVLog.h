@@ -0,0 +1,91 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*
+ Leveled, per-category logging. Records go into an in-memory ring buffer
+ (CDVLogRing) that can be dumped after the fact; only records at or above the
+ console level are also echoed to NSLog, asynchronously.
+
+ The arguments of a disabled log statement are never evaluated or formatted.
+ Statements above CDV_LOG_MAX_LEVEL are compiled out entirely.
+ */
+
+typedef enum {
+    CDVLogLevelOff = 0,
+    CDVLogLevelError,
+    CDVLogLevelWarning,
+    CDVLogLevelInfo,
+    CDVLogLevelDebug,
+    CDVLogLevelVerbose
+} CDVLogLevel;
+
+typedef enum {
+    CDVLogCategoryGeneral = 0,
+    CDVLogCategoryExec,
+    CDVLogCategoryURLProtocol,
+    CDVLogCategoryTimer,
+    CDVLogCategoryPluginResult,
+    CDVLogCategoryPlugin,
+    CDVLogCategoryCount
+} CDVLogCategory;
+
+#ifndef CDV_LOG_MAX_LEVEL
+    #ifdef DEBUG
+        #define CDV_LOG_MAX_LEVEL CDVLogLevelVerbose
+    #else
+        #define CDV_LOG_MAX_LEVEL CDVLogLevelInfo
+    #endif
+#endif
+
+// Runtime level per category; read without locking by the macros below.
+FOUNDATION_EXPORT volatile CDVLogLevel gCDVLogLevels[CDVLogCategoryCount];
+
+#define CDVLogEnabled(category, level) \
+    (((level) <= CDV_LOG_MAX_LEVEL) && ((level) <= gCDVLogLevels[(category)]))
+
+#define CDVLog(category, level, fmt, ...) \
+    do { \
+        if (CDVLogEnabled(category, level)) { \
+            CDVLogWrite((category), (level), (fmt), ##__VA_ARGS__); \
+        } \
+    } while (NO)
+
+#define CDVLogError(category, fmt, ...) CDVLog(category, CDVLogLevelError, fmt, ##__VA_ARGS__)
+#define CDVLogWarning(category, fmt, ...) CDVLog(category, CDVLogLevelWarning, fmt, ##__VA_ARGS__)
+#define CDVLogInfo(category, fmt, ...) CDVLog(category, CDVLogLevelInfo, fmt, ##__VA_ARGS__)
+#define CDVLogDebug(category, fmt, ...) CDVLog(category, CDVLogLevelDebug, fmt, ##__VA_ARGS__)
+#define CDVLogVerbose(category, fmt, ...) CDVLog(category, CDVLogLevelVerbose, fmt, ##__VA_ARGS__)
+
+// Use the macros above; this formats unconditionally.
+FOUNDATION_EXPORT void CDVLogWrite(CDVLogCategory category, CDVLogLevel level, NSString* format, ...) NS_FORMAT_FUNCTION(3, 4);
+
+// Sets the runtime level of one category, or of all of them.
+FOUNDATION_EXPORT void CDVLogSetLevel(CDVLogCategory category, CDVLogLevel level);
+FOUNDATION_EXPORT void CDVLogSetAllLevels(CDVLogLevel level);
+
+// Records at or above this severity are also sent to NSLog.
+FOUNDATION_EXPORT void CDVLogSetConsoleLevel(CDVLogLevel level);
+
+// Parses "error", "warning", "info", "debug", "verbose" or "off".
+FOUNDATION_EXPORT CDVLogLevel CDVLogLevelFromString(NSString* name, CDVLogLevel defaultLevel);
+
+// The records still in the ring buffer, oldest first, one per line.
+FOUNDATION_EXPORT NSString* CDVLogDump(void);
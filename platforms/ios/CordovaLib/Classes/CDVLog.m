@@ -0,0 +1,132 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CDVLog.h"
+#import "CDVLogRing.h"
+
+#ifdef DEBUG
+    #define CDV_LOG_DEFAULT_LEVEL CDVLogLevelDebug
+    #define CDV_LOG_DEFAULT_CONSOLE_LEVEL CDVLogLevelInfo
+#else
+    #define CDV_LOG_DEFAULT_LEVEL CDVLogLevelInfo
+    #define CDV_LOG_DEFAULT_CONSOLE_LEVEL CDVLogLevelWarning
+#endif
+
+volatile CDVLogLevel gCDVLogLevels[CDVLogCategoryCount] = {
+    CDV_LOG_DEFAULT_LEVEL, CDV_LOG_DEFAULT_LEVEL, CDV_LOG_DEFAULT_LEVEL,
+    CDV_LOG_DEFAULT_LEVEL, CDV_LOG_DEFAULT_LEVEL, CDV_LOG_DEFAULT_LEVEL
+};
+
+static volatile CDVLogLevel gCDVLogConsoleLevel = CDV_LOG_DEFAULT_CONSOLE_LEVEL;
+static cdv_log_ring gCDVLogRing; // static storage is zero-filled, i.e. initialized
+
+static const char* const kCDVLogCategoryNames[CDVLogCategoryCount] = {
+    "general", "exec", "urlprotocol", "timer", "pluginresult", "plugin"
+};
+
+static const char* const kCDVLogLevelNames[] = {
+    "off", "error", "warning", "info", "debug", "verbose"
+};
+
+static dispatch_queue_t CDVLogConsoleQueue(void)
+{
+    static dispatch_queue_t queue = NULL;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("org.apache.cordova.log", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+void CDVLogWrite(CDVLogCategory category, CDVLogLevel level, NSString* format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    NSString* message = [[NSString alloc] initWithFormat:format arguments:args];
+    va_end(args);
+
+    char buffer[CDV_LOG_RING_MESSAGE_MAX];
+    NSUInteger length = 0;
+    [message getBytes:buffer maxLength:sizeof(buffer) - 1 usedLength:&length encoding:NSUTF8StringEncoding
+              options:NSStringEncodingConversionAllowLossy range:NSMakeRange(0, [message length]) remainingRange:NULL];
+    cdv_log_ring_write(&gCDVLogRing, (uint8_t)level, (uint8_t)category, CFAbsoluteTimeGetCurrent(), buffer, length);
+
+    if (level <= gCDVLogConsoleLevel) {
+        dispatch_async(CDVLogConsoleQueue(), ^{
+            NSLog(@"[%s] %@", kCDVLogCategoryNames[category], message);
+        });
+    }
+}
+
+void CDVLogSetLevel(CDVLogCategory category, CDVLogLevel level)
+{
+    if (category < CDVLogCategoryCount) {
+        gCDVLogLevels[category] = level;
+    }
+}
+
+void CDVLogSetAllLevels(CDVLogLevel level)
+{
+    for (int i = 0; i < CDVLogCategoryCount; ++i) {
+        gCDVLogLevels[i] = level;
+    }
+}
+
+void CDVLogSetConsoleLevel(CDVLogLevel level)
+{
+    gCDVLogConsoleLevel = level;
+}
+
+CDVLogLevel CDVLogLevelFromString(NSString* name, CDVLogLevel defaultLevel)
+{
+    const char* cName = [[name lowercaseString] UTF8String];
+
+    if (cName != NULL) {
+        for (int i = CDVLogLevelOff; i <= CDVLogLevelVerbose; ++i) {
+            if (strcmp(cName, kCDVLogLevelNames[i]) == 0) {
+                return (CDVLogLevel)i;
+            }
+        }
+    }
+    return defaultLevel;
+}
+
+static void CDVLogAppendRecord(const cdv_log_record* record, void* context)
+{
+    NSMutableString* dump = (__bridge NSMutableString*)context;
+    NSDate* date = [NSDate dateWithTimeIntervalSinceReferenceDate:record->timestamp];
+    const char* levelName = (record->level <= CDVLogLevelVerbose) ? kCDVLogLevelNames[record->level] : "?";
+    const char* categoryName = (record->category < CDVLogCategoryCount) ? kCDVLogCategoryNames[record->category] : "?";
+
+    [dump appendFormat:@"%@ [%s] %s: %s\n", date, categoryName, levelName, record->message];
+}
+
+NSString* CDVLogDump(void)
+{
+    NSMutableString* dump = [NSMutableString string];
+
+    cdv_log_ring_snapshot(&gCDVLogRing, CDVLogAppendRecord, (__bridge void*)dump);
+    uint64_t dropped = cdv_log_ring_dropped(&gCDVLogRing);
+    if (dropped > 0) {
+        [dump appendFormat:@"(%llu records dropped under contention)\n", (unsigned long long)dropped];
+    }
+    return dump;
+}
@@ -0,0 +1,124 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#include <string.h>
+#include "CDVLogRing.h"
+
+// Tickets a write tries before dropping its record.
+#define CDV_LOG_RING_CLAIM_ATTEMPTS 4
+
+void cdv_log_ring_init(cdv_log_ring* ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Marks the ticket's slot as being written, which only one writer may do at a
+// time: two writing at once (a lap apart) would let the later one publish a
+// record the earlier one is still writing over. Fails if the slot is still held
+// by a writer a lap behind, or was taken by one a lap ahead.
+static cdv_log_record* cdv_log_ring_claim(cdv_log_ring* ring, uint64_t ticket)
+{
+    cdv_log_record* record = &ring->records[ticket & (CDV_LOG_RING_CAPACITY - 1)];
+    uint64_t claimed = 2 * ticket + 1;
+    uint64_t current = __atomic_load_n(&record->sequence, __ATOMIC_RELAXED);
+
+    do {
+        if (((current & 1) != 0) || (current >= claimed)) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&record->sequence, &current, claimed, 1, __ATOMIC_RELAXED,
+        __ATOMIC_RELAXED));
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return record;
+}
+
+void cdv_log_ring_write(cdv_log_ring* ring, uint8_t level, uint8_t category, double timestamp,
+    const char* message, size_t length)
+{
+    uint64_t ticket = 0;
+    cdv_log_record* record = NULL;
+
+    if (length >= CDV_LOG_RING_MESSAGE_MAX) {
+        length = CDV_LOG_RING_MESSAGE_MAX - 1;
+    }
+
+    // A busy slot (its writer preempted, typically) costs a ticket, not the
+    // record: the next ticket's slot is tried instead.
+    for (int attempt = 0; (record == NULL) && (attempt < CDV_LOG_RING_CLAIM_ATTEMPTS); ++attempt) {
+        if (attempt > 0) {
+            __atomic_fetch_add(&ring->skipped, 1, __ATOMIC_RELAXED);
+        }
+        ticket = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+        record = cdv_log_ring_claim(ring, ticket);
+    }
+    if (record == NULL) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    record->timestamp = timestamp;
+    record->level = level;
+    record->category = category;
+    record->length = (uint16_t)length;
+    memcpy(record->message, message, length);
+    record->message[length] = '\0';
+
+    __atomic_store_n(&record->sequence, 2 * ticket + 2, __ATOMIC_RELEASE);
+}
+
+size_t cdv_log_ring_snapshot(cdv_log_ring* ring, cdv_log_record_fn fn, void* context)
+{
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t ticket = (head > CDV_LOG_RING_CAPACITY) ? head - CDV_LOG_RING_CAPACITY : 0;
+    size_t visited = 0;
+    cdv_log_record copy;
+
+    for (; ticket < head; ++ticket) {
+        const cdv_log_record* record = &ring->records[ticket & (CDV_LOG_RING_CAPACITY - 1)];
+        uint64_t expected = 2 * ticket + 2;
+
+        if (__atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE) != expected) {
+            continue; // still being written, or already overwritten
+        }
+        memcpy(&copy, record, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&record->sequence, __ATOMIC_RELAXED) != expected) {
+            continue; // overwritten while we were copying it
+        }
+        if (copy.length >= CDV_LOG_RING_MESSAGE_MAX) {
+            continue;
+        }
+        copy.message[copy.length] = '\0';
+        fn(&copy, context);
+        ++visited;
+    }
+    return visited;
+}
+
+uint64_t cdv_log_ring_count(cdv_log_ring* ring)
+{
+    uint64_t skipped = __atomic_load_n(&ring->skipped, __ATOMIC_RELAXED);
+
+    return __atomic_load_n(&ring->head, __ATOMIC_RELAXED) - skipped;
+}
+
+uint64_t cdv_log_ring_dropped(cdv_log_ring* ring)
+{
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
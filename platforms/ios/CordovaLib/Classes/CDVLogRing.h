@@ -0,0 +1,88 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ Fixed-size, lock-free ring of log records. Any number of threads may write;
+ each write takes a ticket with one atomic increment, claims the ticket's slot
+ with a compare-and-swap on the slot's sequence number and publishes it through
+ the same number, so readers can take a consistent snapshot at any time without
+ stopping writers. The oldest records are overwritten. A writer that finds its
+ slot still held by a writer a lap behind (or already taken by one a lap ahead)
+ moves on to a new ticket rather than wait, and after a few such tickets drops
+ its record; see cdv_log_ring_dropped.
+
+ Plain C with GCC/clang __atomic builtins so it builds and can be benchmarked
+ outside of iOS; tests/ does that on Linux.
+ */
+
+#ifndef CDV_LOG_RING_H
+#define CDV_LOG_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CDV_LOG_RING_CAPACITY
+#define CDV_LOG_RING_CAPACITY 512 // must be a power of two
+#endif
+#define CDV_LOG_RING_MESSAGE_MAX 232
+
+typedef struct {
+    uint64_t sequence; // 2 * ticket + 1 while being written, 2 * ticket + 2 once complete
+    double timestamp;
+    uint8_t level;
+    uint8_t category;
+    uint16_t length;
+    char message[CDV_LOG_RING_MESSAGE_MAX];
+} cdv_log_record;
+
+typedef struct {
+    uint64_t head;    // next ticket
+    uint64_t skipped; // tickets given up because their slot was busy
+    uint64_t dropped;
+    cdv_log_record records[CDV_LOG_RING_CAPACITY];
+} cdv_log_ring;
+
+typedef void (*cdv_log_record_fn)(const cdv_log_record* record, void* context);
+
+// A zero-filled ring is ready for use.
+void cdv_log_ring_init(cdv_log_ring* ring);
+
+// Copies at most CDV_LOG_RING_MESSAGE_MAX - 1 bytes of message.
+void cdv_log_ring_write(cdv_log_ring* ring, uint8_t level, uint8_t category, double timestamp,
+    const char* message, size_t length);
+
+// Calls fn for every complete record still in the ring, oldest first. Records
+// overwritten while being copied are skipped. Returns the number visited.
+size_t cdv_log_ring_snapshot(cdv_log_ring* ring, cdv_log_record_fn fn, void* context);
+
+// Total number of records ever written, including dropped ones.
+uint64_t cdv_log_ring_count(cdv_log_ring* ring);
+
+// Number of records dropped because every slot they tried was busy.
+uint64_t cdv_log_ring_dropped(cdv_log_ring* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CDV_LOG_RING_H */
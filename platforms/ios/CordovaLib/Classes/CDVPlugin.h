@@ -45,6 +45,12 @@ extern NSString* const CDVLocalNotification;
 - (void)onReset;
 - (void)dispose;
 
+// Actions that send their result before they return, never wait (for locks, I/O
+// or the main thread) and are safe to run on any thread. cordova.exec.sync() runs
+// an action on the URL loading thread only if it is listed here and under
+// sync-actions in config.xml. Returns nil by default.
++ (NSSet*)nonBlockingActions;
+
 /*
  // see initWithWebView implementation
  - (void) onPause {}
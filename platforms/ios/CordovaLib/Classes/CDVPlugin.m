@@ -116,6 +116,11 @@ NSString* const CDVLocalNotification = @"CDVLocalNotification";
     // Override to cancel any long-running requests when the WebView navigates or refreshes.
 }
 
++ (NSSet*)nonBlockingActions
+{
+    return nil;
+}
+
 - (void)dealloc
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self];   // this will remove all notification unless added using addObserverForName:object:queue:usingBlock:
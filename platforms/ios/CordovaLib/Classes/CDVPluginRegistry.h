@@ -0,0 +1,52 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <UIKit/UIKit.h>
+
+@class CDVPlugin;
+
+typedef CDVPlugin* (*CDVPluginFactory)(UIWebView* webView);
+
+typedef struct {
+    const char* serviceName; // <feature name>, lowercased
+    const char* className;   // its ios-package
+    CDVPluginFactory factory;
+} CDVPluginRegistryEntry;
+
+/*
+ Table of plugin factories generated from config.xml at build time by
+ cordova/lib/gen-plugin-registry.js. The generated file refers to every plugin
+ class directly, so a mapping to a class that does not exist fails to link
+ instead of failing on the first exec() call. Services that are not in the
+ table are still resolved with NSClassFromString().
+ */
+@interface CDVPluginRegistry : NSObject
+
+// Called from the generated file's +load; entries must stay valid forever.
++ (void)registerEntries:(const CDVPluginRegistryEntry*)entries count:(NSUInteger)count;
+
+// Returns NULL when the (lowercased) service has no generated entry.
++ (const CDVPluginRegistryEntry*)entryForService:(NSString*)serviceName;
+
+// Lists config.xml mappings (lowercased service -> class name) that disagree
+// with the generated table, e.g. because config.xml changed after generation.
+// Empty when no table was registered.
++ (NSArray*)mismatchesWithPluginsMap:(NSDictionary*)pluginsMap;
+
+@end
@@ -0,0 +1,70 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CDVPluginRegistry.h"
+
+// lowercased service name -> const CDVPluginRegistryEntry*
+static CFMutableDictionaryRef gRegistryEntries = NULL;
+
+@implementation CDVPluginRegistry
+
++ (void)registerEntries:(const CDVPluginRegistryEntry*)entries count:(NSUInteger)count
+{
+    @synchronized(self) {
+        if (gRegistryEntries == NULL) {
+            gRegistryEntries = CFDictionaryCreateMutable(NULL, (CFIndex)count, &kCFTypeDictionaryKeyCallBacks, NULL);
+        }
+        for (NSUInteger i = 0; i < count; ++i) {
+            NSString* key = [[NSString stringWithUTF8String:entries[i].serviceName] lowercaseString];
+            CFDictionarySetValue(gRegistryEntries, (__bridge const void*)key, &entries[i]);
+        }
+    }
+}
+
++ (const CDVPluginRegistryEntry*)entryForService:(NSString*)serviceName
+{
+    if ((serviceName == nil) || (gRegistryEntries == NULL)) {
+        return NULL;
+    }
+    @synchronized(self) {
+        return (const CDVPluginRegistryEntry*)CFDictionaryGetValue(gRegistryEntries, (__bridge const void*)serviceName);
+    }
+}
+
++ (NSArray*)mismatchesWithPluginsMap:(NSDictionary*)pluginsMap
+{
+    NSMutableArray* mismatches = [NSMutableArray array];
+
+    // Apps that don't generate a table use NSClassFromString() for everything.
+    if (gRegistryEntries == NULL) {
+        return mismatches;
+    }
+    for (NSString* serviceName in pluginsMap) {
+        const CDVPluginRegistryEntry* entry = [self entryForService:serviceName];
+        NSString* className = [pluginsMap objectForKey:serviceName];
+        if (entry == NULL) {
+            [mismatches addObject:[NSString stringWithFormat:@"'%@' (%@) is not in the generated plugin registry", serviceName, className]];
+        } else if (![className isEqualToString:[NSString stringWithUTF8String:entry->className]]) {
+            [mismatches addObject:[NSString stringWithFormat:@"'%@' maps to %@ in config.xml but to %s in the generated plugin registry", serviceName, className, entry->className]];
+        }
+    }
+    return mismatches;
+}
+
+@end
@@ -50,14 +50,26 @@ typedef enum {
 + (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsBool:(BOOL)theMessage;
 + (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsDictionary:(NSDictionary*)theMessage;
 + (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsArrayBuffer:(NSData*)theMessage;
+// Like messageAsArrayBuffer:, but the bytes are not Base64 encoded into the result. They are
+// staged in CDVURLProtocol and fetched by cordova.js as an ArrayBuffer before the callback is
+// called, which saves several copies for large data (frame captures, exports). The callback
+// sees the same ArrayBuffer argument; later results of the same callback wait for the fetch.
+// The bytes are staged when the result is serialized, once per argumentsAsJSON call.
++ (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsStagedArrayBuffer:(NSData*)theMessage;
 + (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsMultipart:(NSArray*)theMessages;
 + (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageToErrorObject:(int)errorCode;
+// The message is a complete JSON value produced by a specialized encoder; it is
+// passed to JS as is, without going through NSJSONSerialization.
++ (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsEncodedJSON:(NSString*)theJSON;
 
 + (void)setVerbose:(BOOL)verbose;
 + (BOOL)isVerbose;
 
 - (void)setKeepCallbackAsBool:(BOOL)bKeepCallback;
 
+// Whether the message is a staged ArrayBuffer (see messageAsStagedArrayBuffer:).
+- (BOOL)hasStagedData;
+
 - (NSString*)argumentsAsJSON;
 
 // These methods are used by the legacy plugin return result method
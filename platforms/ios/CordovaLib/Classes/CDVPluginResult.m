@@ -20,16 +20,22 @@
 #import "CDVPluginResult.h"
 #import "CDVJSON.h"
 #import "CDVDebug.h"
+#import "CDVLog.h"
 #import "NSData+Base64.h"
+#import "CDVURLProtocol.h"
 
 @interface CDVPluginResult ()
 
+@property (nonatomic, copy) NSString* encodedMessage;
+// The bytes of a staged ArrayBuffer message; staged each time the result is serialized.
+@property (nonatomic, strong) NSData* stagedData;
+
 - (CDVPluginResult*)initWithStatus:(CDVCommandStatus)statusOrdinal message:(id)theMessage;
 
 @end
 
 @implementation CDVPluginResult
-@synthesize status, message, keepCallback, associatedObject;
+@synthesize status, message, keepCallback, associatedObject, encodedMessage, stagedData;
 
 static NSArray* org_apache_cordova_CommandStatusMsgs;
 
@@ -41,6 +47,22 @@ id messageFromArrayBuffer(NSData* data)
     };
 }
 
+// Without an id the message is only a placeholder; see serializedMessage.
+id messageFromStagedArrayBuffer(NSData* data, NSString* stagedId)
+{
+    if (stagedId == nil) {
+        return @{
+                   @"CDVType" : @"StagedArrayBuffer",
+                   @"length" :[NSNumber numberWithUnsignedInteger:[data length]]
+        };
+    }
+    return @{
+               @"CDVType" : @"StagedArrayBuffer",
+               @"id" : stagedId,
+               @"length" :[NSNumber numberWithUnsignedInteger:[data length]]
+    };
+}
+
 id massageMessage(id message)
 {
     if ([message isKindOfClass:[NSData class]]) {
@@ -134,6 +156,14 @@ id messageFromMultipart(NSArray* theMessages)
     return [[self alloc] initWithStatus:statusOrdinal message:messageFromArrayBuffer(theMessage)];
 }
 
++ (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsStagedArrayBuffer:(NSData*)theMessage
+{
+    CDVPluginResult* result = [[self alloc] initWithStatus:statusOrdinal message:messageFromStagedArrayBuffer(theMessage, nil)];
+
+    result.stagedData = (theMessage != nil) ? theMessage : [NSData data];
+    return result;
+}
+
 + (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsMultipart:(NSArray*)theMessages
 {
     return [[self alloc] initWithStatus:statusOrdinal message:messageFromMultipart(theMessages)];
@@ -146,14 +176,43 @@ id messageFromMultipart(NSArray* theMessages)
     return [[self alloc] initWithStatus:statusOrdinal message:errDict];
 }
 
++ (CDVPluginResult*)resultWithStatus:(CDVCommandStatus)statusOrdinal messageAsEncodedJSON:(NSString*)theJSON
+{
+    CDVPluginResult* result = [[self alloc] initWithStatus:statusOrdinal message:nil];
+
+    result.encodedMessage = theJSON;
+    return result;
+}
+
 - (void)setKeepCallbackAsBool:(BOOL)bKeepCallback
 {
     [self setKeepCallback:[NSNumber numberWithBool:bKeepCallback]];
 }
 
+- (BOOL)hasStagedData
+{
+    return self.stagedData != nil;
+}
+
+// The message as sent to JS. Staged data is staged only here, so a result that is
+// never sent (e.g. dropped by a throttle) never holds bytes in CDVURLProtocol, and
+// every serialization gets an id of its own, since each id can be fetched only once.
+- (id)serializedMessage
+{
+    if (self.stagedData != nil) {
+        return messageFromStagedArrayBuffer(self.stagedData, [CDVURLProtocol stageData:self.stagedData]);
+    }
+    return self.message;
+}
+
 - (NSString*)argumentsAsJSON
 {
-    id arguments = (self.message == nil ? [NSNull null] : self.message);
+    if (self.encodedMessage != nil) {
+        return self.encodedMessage;
+    }
+
+    id serializedMessage = [self serializedMessage];
+    id arguments = (serializedMessage == nil ? [NSNull null] : serializedMessage);
     NSArray* argumentsWrappedInArray = [NSArray arrayWithObject:arguments];
 
     NSString* argumentsJSON = [argumentsWrappedInArray JSONString];
@@ -166,9 +225,15 @@ id messageFromMultipart(NSArray* theMessages)
 // These methods are used by the legacy plugin return result method
 - (NSString*)toJSONString
 {
+    if (self.encodedMessage != nil) {
+        return [NSString stringWithFormat:@"{\"status\":%@,\"message\":%@,\"keepCallback\":%@}",
+            self.status, self.encodedMessage, [self.keepCallback boolValue] ? @"true" : @"false"];
+    }
+
+    id serializedMessage = [self serializedMessage];
     NSDictionary* dict = [NSDictionary dictionaryWithObjectsAndKeys:
         self.status, @"status",
-        self.message ? self.                                message:[NSNull null], @"message",
+        serializedMessage ? serializedMessage:[NSNull null], @"message",
         self.keepCallback, @"keepCallback",
         nil];
 
@@ -179,14 +244,12 @@ id messageFromMultipart(NSArray* theMessages)
     NSString* resultString = nil;
 
     if (error != nil) {
-        NSLog(@"toJSONString error: %@", [error localizedDescription]);
+        CDVLogError(CDVLogCategoryPluginResult, @"toJSONString error: %@", [error localizedDescription]);
     } else {
         resultString = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
     }
 
-    if ([[self class] isVerbose]) {
-        NSLog(@"PluginResult:toJSONString - %@", resultString);
-    }
+    CDVLogVerbose(CDVLogCategoryPluginResult, @"PluginResult:toJSONString - %@", resultString);
     return resultString;
 }
 
@@ -194,9 +257,7 @@ id messageFromMultipart(NSArray* theMessages)
 {
     NSString* successCB = [NSString stringWithFormat:@"cordova.callbackSuccess('%@',%@);", callbackId, [self toJSONString]];
 
-    if ([[self class] isVerbose]) {
-        NSLog(@"PluginResult toSuccessCallbackString: %@", successCB);
-    }
+    CDVLogVerbose(CDVLogCategoryPluginResult, @"PluginResult toSuccessCallbackString: %@", successCB);
     return successCB;
 }
 
@@ -204,21 +265,19 @@ id messageFromMultipart(NSArray* theMessages)
 {
     NSString* errorCB = [NSString stringWithFormat:@"cordova.callbackError('%@',%@);", callbackId, [self toJSONString]];
 
-    if ([[self class] isVerbose]) {
-        NSLog(@"PluginResult toErrorCallbackString: %@", errorCB);
-    }
+    CDVLogVerbose(CDVLogCategoryPluginResult, @"PluginResult toErrorCallbackString: %@", errorCB);
     return errorCB;
 }
 
-static BOOL gIsVerbose = NO;
+// Kept for compatibility; verbosity is the level of the "pluginresult" log category.
 + (void)setVerbose:(BOOL)verbose
 {
-    gIsVerbose = verbose;
+    CDVLogSetLevel(CDVLogCategoryPluginResult, verbose ? CDVLogLevelVerbose : CDVLogLevelInfo);
 }
 
 + (BOOL)isVerbose
 {
-    return gIsVerbose;
+    return CDVLogEnabled(CDVLogCategoryPluginResult, CDVLogLevelVerbose);
 }
 
 @end
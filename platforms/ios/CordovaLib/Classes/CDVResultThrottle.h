@@ -0,0 +1,61 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class CDVPluginResult;
+
+typedef enum {
+    // Every result is sent right away (the default).
+    CDVResultThrottleNone = 0,
+    // At most one result per interval; a newer result replaces one that is still waiting.
+    CDVResultThrottleLatest,
+    // Results are collected and sent together once per interval; only the last `capacity`
+    // results are kept, older ones are dropped.
+    CDVResultThrottleBatch
+} CDVResultThrottleMode;
+
+/**
+ Holds back the keep-alive results of one callback according to its mode. Results
+ that are dropped are never serialized, and since staged ArrayBuffers are staged
+ only on serialization, their bytes are released with the result. Not thread safe;
+ CDVCommandDelegateImpl serializes access.
+ */
+@interface CDVResultThrottle : NSObject
+
+@property (nonatomic, readonly) CDVResultThrottleMode mode;
+@property (nonatomic, readonly) NSTimeInterval interval;
+@property (nonatomic, readonly) NSUInteger capacity;
+@property (nonatomic, readonly) NSUInteger deliveredCount;
+@property (nonatomic, readonly) NSUInteger droppedCount;
+@property (nonatomic, readonly) NSUInteger flushCount;
+// Whether a flush has been asked for through holdResult:now:flushDelay: and not done yet.
+@property (nonatomic, readonly) BOOL flushScheduled;
+
+- (id)initWithMode:(CDVResultThrottleMode)mode interval:(NSTimeInterval)interval capacity:(NSUInteger)capacity;
+
+// Returns NO if the result is to be sent now. Otherwise the result is held, and if
+// *flushDelay is set to a value >= 0 the caller has to call takeResultsAt: after that delay.
+- (BOOL)holdResult:(CDVPluginResult*)result now:(NSTimeInterval)now flushDelay:(NSTimeInterval*)flushDelay;
+// Returns the held results in order and empties the throttle.
+- (NSArray*)takeResultsAt:(NSTimeInterval)now;
+// {mode, interval, delivered, dropped, flushes, pending}
+- (NSDictionary*)stats;
+
+@end
@@ -0,0 +1,101 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CDVResultThrottle.h"
+
+static NSString* const kCDVResultThrottleModeNames[] = {@"none", @"latest", @"batch"};
+
+@interface CDVResultThrottle () {
+    NSMutableArray* _pending;
+    NSTimeInterval _lastSent;
+}
+@end
+
+@implementation CDVResultThrottle
+
+@synthesize mode = _mode, interval = _interval, capacity = _capacity;
+@synthesize deliveredCount = _deliveredCount, droppedCount = _droppedCount, flushCount = _flushCount;
+@synthesize flushScheduled = _flushScheduled;
+
+- (id)initWithMode:(CDVResultThrottleMode)mode interval:(NSTimeInterval)interval capacity:(NSUInteger)capacity
+{
+    self = [super init];
+    if (self != nil) {
+        _mode = mode;
+        _interval = MAX(interval, 0);
+        _capacity = (mode == CDVResultThrottleLatest) ? 1 : MAX(capacity, 1);
+        _pending = [[NSMutableArray alloc] initWithCapacity:_capacity];
+        _lastSent = -DBL_MAX;
+    }
+    return self;
+}
+
+- (BOOL)holdResult:(CDVPluginResult*)result now:(NSTimeInterval)now flushDelay:(NSTimeInterval*)flushDelay
+{
+    *flushDelay = -1;
+    if (_mode == CDVResultThrottleNone) {
+        _deliveredCount++;
+        return NO;
+    }
+    // Latest-value results go out right away when the previous one is old enough.
+    if ((_mode == CDVResultThrottleLatest) && ([_pending count] == 0) && (now - _lastSent >= _interval)) {
+        _lastSent = now;
+        _deliveredCount++;
+        return NO;
+    }
+
+    if ([_pending count] == _capacity) {
+        [_pending removeObjectAtIndex:0];
+        _droppedCount++;
+    }
+    [_pending addObject:result];
+    if (!_flushScheduled) {
+        _flushScheduled = YES;
+        *flushDelay = MAX(0, _lastSent + _interval - now);
+    }
+    return YES;
+}
+
+- (NSArray*)takeResultsAt:(NSTimeInterval)now
+{
+    NSArray* results = [_pending copy];
+
+    [_pending removeAllObjects];
+    _flushScheduled = NO;
+    if ([results count] > 0) {
+        _lastSent = now;
+        _deliveredCount += [results count];
+        _flushCount++;
+    }
+    return results;
+}
+
+- (NSDictionary*)stats
+{
+    return @{
+               @"mode" : kCDVResultThrottleModeNames[_mode],
+               @"interval" :[NSNumber numberWithDouble:_interval * 1000.0],
+               @"delivered" :[NSNumber numberWithUnsignedInteger:_deliveredCount],
+               @"dropped" :[NSNumber numberWithUnsignedInteger:_droppedCount],
+               @"flushes" :[NSNumber numberWithUnsignedInteger:_flushCount],
+               @"pending" :[NSNumber numberWithUnsignedInteger:[_pending count]]
+    };
+}
+
+@end
@@ -0,0 +1,48 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*
+ Removes files from NSTemporaryDirectory() in parallel batches, stopping when
+ a time budget runs out. Plugins register the temp files they create so that
+ a purge does not have to enumerate the directory; whatever is left when the
+ budget expires is kept in an on-disk manifest and picked up by the next purge.
+ CDVLocalStorage registers the backups it copies to the temp directory, and the
+ purge on termination registers the files it had no time left for, so the
+ purge on entering the background removes those.
+ */
+@interface CDVTempFilePurger : NSObject
+
+@property (nonatomic, readonly, getter = isPurging) BOOL purging;
+
++ (CDVTempFilePurger*)sharedPurger;
+
+// Adds a file (absolute, or relative to NSTemporaryDirectory()) to the manifest.
+- (void)registerTemporaryFile:(NSString*)path;
+
+// Deletes the registered files on a background queue. Calls completion on the
+// main thread with YES when nothing is left to delete.
+- (void)purgeRegisteredFilesWithTimeBudget:(NSTimeInterval)budget completion:(void (^)(BOOL finished))completion;
+
+// Deletes the registered files and then the rest of NSTemporaryDirectory(),
+// blocking the caller for at most the given budget.
+- (BOOL)purgeAllWithTimeBudget:(NSTimeInterval)budget;
+
+@end
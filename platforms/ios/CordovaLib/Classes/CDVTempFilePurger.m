@@ -0,0 +1,246 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#include <errno.h>
+#include <unistd.h>
+#import "CDVTempFilePurger.h"
+#import "CDVAvailability.h"
+
+#define CDV_TEMP_PURGE_BATCH_SIZE 64
+
+static NSString* const kCDVTempManifestFileName = @"CDVTempFileManifest.plist";
+
+@interface CDVTempFilePurger () {
+    NSMutableOrderedSet* _pending; // paths relative to NSTemporaryDirectory()
+    NSString* _tempDirectoryPath;
+    NSString* _manifestPath;
+    BOOL _purging;
+    BOOL _dirty;
+}
+@end
+
+@implementation CDVTempFilePurger
+
+@synthesize purging = _purging;
+
++ (CDVTempFilePurger*)sharedPurger
+{
+    static CDVTempFilePurger* sharedPurger = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        sharedPurger = [[CDVTempFilePurger alloc] init];
+    });
+    return sharedPurger;
+}
+
+- (id)init
+{
+    self = [super init];
+    if (self != nil) {
+        _tempDirectoryPath = [NSTemporaryDirectory() stringByStandardizingPath];
+        // The manifest must outlive a purge of the temp directory itself.
+        NSString* cachesPath = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+        _manifestPath = [cachesPath stringByAppendingPathComponent:kCDVTempManifestFileName];
+        NSArray* saved = [NSArray arrayWithContentsOfFile:_manifestPath];
+        _pending = saved ? [NSMutableOrderedSet orderedSetWithArray:saved] : [NSMutableOrderedSet orderedSet];
+    }
+    return self;
+}
+
+- (NSString*)relativePathForPath:(NSString*)path
+{
+    path = [path stringByStandardizingPath];
+    NSString* prefix = [_tempDirectoryPath stringByAppendingString:@"/"];
+    if ([path hasPrefix:prefix]) {
+        return [path substringFromIndex:[prefix length]];
+    }
+    // Anything outside the temp directory is not ours to delete.
+    return [path isAbsolutePath] ? nil : path;
+}
+
+- (void)registerTemporaryFile:(NSString*)path
+{
+    NSString* relativePath = [self relativePathForPath:path];
+
+    if (([relativePath length] == 0) || [relativePath hasPrefix:@".."]) {
+        CDVLogWarning(CDVLogCategoryGeneral, @"CDVTempFilePurger: ignoring '%@', which is not inside the temp directory.", path);
+        return;
+    }
+    @synchronized(self) {
+        [_pending addObject:relativePath];
+        _dirty = YES;
+    }
+}
+
+- (void)saveManifest
+{
+    NSArray* snapshot = nil;
+
+    @synchronized(self) {
+        if (!_dirty) {
+            return;
+        }
+        snapshot = [_pending array];
+        _dirty = NO;
+    }
+    if ([snapshot count] == 0) {
+        [[NSFileManager defaultManager] removeItemAtPath:_manifestPath error:nil];
+    } else if (![snapshot writeToFile:_manifestPath atomically:YES]) {
+        CDVLogError(CDVLogCategoryGeneral, @"CDVTempFilePurger: failed to write manifest to %@", _manifestPath);
+    }
+}
+
+// Deletes the given relative paths in parallel batches until the deadline.
+// Returns the paths that were removed (or were already gone).
+- (NSArray*)removePaths:(NSArray*)paths deadline:(CFAbsoluteTime)deadline
+{
+    NSUInteger count = [paths count];
+    size_t batches = (count + CDV_TEMP_PURGE_BATCH_SIZE - 1) / CDV_TEMP_PURGE_BATCH_SIZE;
+    NSMutableArray* removed = [NSMutableArray arrayWithCapacity:count];
+    NSString* tempDirectoryPath = _tempDirectoryPath;
+
+    dispatch_apply(batches, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t batch) {
+        NSFileManager* fileMgr = [[NSFileManager alloc] init];
+        NSUInteger end = MIN((batch + 1) * CDV_TEMP_PURGE_BATCH_SIZE, count);
+        NSMutableArray* batchRemoved = [NSMutableArray arrayWithCapacity:CDV_TEMP_PURGE_BATCH_SIZE];
+
+        for (NSUInteger i = batch * CDV_TEMP_PURGE_BATCH_SIZE; i < end; ++i) {
+            if (CFAbsoluteTimeGetCurrent() >= deadline) {
+                break;
+            }
+            @autoreleasepool {
+                NSString* relativePath = [paths objectAtIndex:i];
+                NSString* filePath = [tempDirectoryPath stringByAppendingPathComponent:relativePath];
+                // unlink() covers plain files without NSFileManager's overhead;
+                // directories fall back to a recursive remove.
+                if ((unlink([filePath fileSystemRepresentation]) == 0) || (errno == ENOENT)) {
+                    [batchRemoved addObject:relativePath];
+                    continue;
+                }
+                NSError* __autoreleasing err = nil;
+                if ([fileMgr removeItemAtPath:filePath error:&err]) {
+                    [batchRemoved addObject:relativePath];
+                } else {
+                    CDVLogWarning(CDVLogCategoryGeneral, @"Failed to delete: %@ (error: %@)", filePath, err);
+                }
+            }
+        }
+        @synchronized(removed) {
+            [removed addObjectsFromArray:batchRemoved];
+        }
+    });
+    return removed;
+}
+
+- (BOOL)purgeRegisteredFilesUntil:(CFAbsoluteTime)deadline
+{
+    NSArray* paths = nil;
+
+    @synchronized(self) {
+        paths = [_pending array];
+    }
+    if ([paths count] == 0) {
+        return YES;
+    }
+
+    NSArray* removed = [self removePaths:paths deadline:deadline];
+    BOOL finished;
+    @synchronized(self) {
+        [_pending removeObjectsInArray:removed];
+        _dirty = YES;
+        finished = [_pending count] == 0;
+    }
+    CDVLogInfo(CDVLogCategoryGeneral, @"CDVTempFilePurger: removed %u of %u registered files.", (unsigned)[removed count], (unsigned)[paths count]);
+    [self saveManifest];
+    return finished;
+}
+
+- (BOOL)beginPurge
+{
+    @synchronized(self) {
+        if (_purging) {
+            return NO;
+        }
+        _purging = YES;
+        return YES;
+    }
+}
+
+- (void)endPurge
+{
+    @synchronized(self) {
+        _purging = NO;
+    }
+}
+
+- (void)purgeRegisteredFilesWithTimeBudget:(NSTimeInterval)budget completion:(void (^)(BOOL finished))completion
+{
+    if (![self beginPurge]) {
+        if (completion) {
+            completion(NO);
+        }
+        return;
+    }
+    CFAbsoluteTime deadline = CFAbsoluteTimeGetCurrent() + budget;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+        BOOL finished = [self purgeRegisteredFilesUntil:deadline];
+        [self endPurge];
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(finished);
+            });
+        }
+    });
+}
+
+- (BOOL)purgeAllWithTimeBudget:(NSTimeInterval)budget
+{
+    CFAbsoluteTime deadline = CFAbsoluteTimeGetCurrent() + budget;
+
+    // A background purge may still be running; it holds its own deadline, so
+    // just sweep what is left.
+    BOOL ownsPurge = [self beginPurge];
+    BOOL finished = [self purgeRegisteredFilesUntil:deadline];
+
+    if (CFAbsoluteTimeGetCurrent() < deadline) {
+        // Only the top level is listed; directories are removed recursively.
+        NSMutableArray* contents = [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:_tempDirectoryPath error:nil] mutableCopy];
+        NSArray* removed = [self removePaths:contents deadline:deadline];
+        if ([removed count] < [contents count]) {
+            // Remember the leftovers so the next launch can finish the job.
+            [contents removeObjectsInArray:removed];
+            @synchronized(self) {
+                [_pending addObjectsFromArray:contents];
+                _dirty = YES;
+            }
+            [self saveManifest];
+            finished = NO;
+        }
+    } else {
+        finished = NO;
+    }
+
+    if (ownsPurge) {
+        [self endPurge];
+    }
+    return finished;
+}
+
+@end
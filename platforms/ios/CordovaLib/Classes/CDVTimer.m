@@ -18,6 +18,7 @@
  */
 
 #import "CDVTimer.h"
+#import "CDVLog.h"
 
 #pragma mark CDVTimerItem
 
@@ -35,7 +36,7 @@
 
 - (void)log
 {
-    NSLog(@"[CDVTimer][%@] %fms", self.name, [self.ended timeIntervalSinceDate:self.started] * 1000.0);
+    CDVLogInfo(CDVLogCategoryTimer, @"[CDVTimer][%@] %fms", self.name, [self.ended timeIntervalSinceDate:self.started] * 1000.0);
 }
 
 @end
@@ -69,7 +70,7 @@
         item.started = [NSDate new];
         [self.items setObject:item forKey:[name lowercaseString]];
     } else {
-        NSLog(@"Timer called '%@' already exists.", name);
+        CDVLogWarning(CDVLogCategoryTimer, @"Timer called '%@' already exists.", name);
     }
 }
 
@@ -82,7 +83,7 @@
         [item log];
         [self.items removeObjectForKey:[name lowercaseString]];
     } else {
-        NSLog(@"Timer called '%@' does not exist.", name);
+        CDVLogWarning(CDVLogCategoryTimer, @"Timer called '%@' does not exist.", name);
     }
 }
 
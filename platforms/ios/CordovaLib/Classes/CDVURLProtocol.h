@@ -22,8 +22,25 @@
 
 @class CDVViewController;
 
+// Produces the response to a request for /!gap_res/<name>/..., or nil for a 404.
+// Called on a URL loading thread, possibly on several at once.
+typedef NSData* (^CDVURLResourceHandler)(NSURL* url, NSString** mimeType);
+
 @interface CDVURLProtocol : NSURLProtocol {}
 
 + (void)registerViewController:(CDVViewController*)viewController;
 + (void)unregisterViewController:(CDVViewController*)viewController;
+// The token identifying a registered controller in its User-Agent and in the
+// 'vc' header of the exec bridge, 0 if the controller is not registered.
++ (uint32_t)tokenForViewController:(CDVViewController*)viewController;
+
+// Keeps data for a single fetch by a registered web view from /!gap_blob/<id> and returns the id.
+// Data that is not fetched within a minute is dropped on a timer. Safe to call from any thread.
++ (NSString*)stageData:(NSData*)data;
+
+// Serves /!gap_res/<name>/... from the handler, e.g. images a plugin renders for
+// <img> tags. These requests carry neither the 'vc' header nor, for file: pages,
+// the User-Agent, so they are answered for any page; only register handlers
+// whose responses are fine for any page to read. Safe to call from any thread.
++ (void)registerResourceHandler:(CDVURLResourceHandler)handler forName:(NSString*)name;
 @end
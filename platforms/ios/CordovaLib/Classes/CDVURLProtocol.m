@@ -21,51 +21,135 @@
 #import <AssetsLibrary/ALAssetRepresentation.h>
 #import <AssetsLibrary/ALAssetsLibrary.h>
 #import <MobileCoreServices/MobileCoreServices.h>
+#import <libkern/OSAtomic.h>
 #import "CDVURLProtocol.h"
 #import "CDVCommandQueue.h"
 #import "CDVWhitelist.h"
 #import "CDVViewController.h"
+#import "CDVWwwArchive.h"
+#import "CDVLog.h"
 
 @interface CDVHTTPURLResponse : NSHTTPURLResponse
 @property (nonatomic) NSInteger statusCode;
 @end
 
-static CDVWhitelist* gWhitelist = nil;
-// Contains a set of NSNumbers of addresses of controllers. It doesn't store
-// the actual pointer to avoid retaining.
-static NSMutableSet* gRegisteredControllers = nil;
+// Registered controllers live in a fixed table indexed by the low bits of their
+// token; the remaining bits are a per-slot generation so a stale token from a
+// released controller never matches a later one. Only register/unregister take
+// a lock (they run on the main thread). Lookups from the URL loading threads
+// read the slot without locking: the token is published after the controller
+// pointer and cleared before it, and is re-checked after reading the pointer.
+// The table does not retain the controllers.
+#define CDV_CONTROLLER_SLOT_BITS 6
+#define CDV_MAX_REGISTERED_CONTROLLERS (1 << CDV_CONTROLLER_SLOT_BITS)
+
+typedef struct {
+    __unsafe_unretained CDVViewController* controller;
+    volatile uint32_t token;
+} CDVControllerSlot;
+
+static CDVControllerSlot gControllerSlots[CDV_MAX_REGISTERED_CONTROLLERS];
+static uint32_t gControllerGenerations[CDV_MAX_REGISTERED_CONTROLLERS];
+static NSObject* gControllerRegistryLock = nil;
+// The packed www folder of the first view controller, if the app was built with one.
+static CDVWwwArchive* gWwwArchive = nil;
+static NSString* gWwwArchivePathPrefix = nil;
 
 NSString* const kCDVAssetsLibraryPrefixs = @"assets-library://";
+static NSString* const kCDVStagedDataPathPrefix = @"/!gap_blob/";
+static NSString* const kCDVSyncExecPath = @"/!gap_exec_sync";
+static NSString* const kCDVResourcePathPrefix = @"/!gap_res/";
+
+// Staged data by id, with the time after which it is dropped. Guarded by gStagedDataLock.
+#define CDV_STAGED_DATA_LIFETIME 60.0
+static NSMutableDictionary* gStagedData = nil;
+static NSMutableDictionary* gStagedDataExpiry = nil;
+static NSObject* gStagedDataLock = nil;
+static BOOL gStagedDataSweepScheduled = NO;
+
+// Resource handlers by name, guarded by itself once created.
+static NSMutableDictionary* gResourceHandlers = nil;
+
+// Parses the decimal token at the end of the string: either the whole string
+// (vc header) or the trailing "(token)" of the User-Agent. Does not allocate.
+static uint32_t parseControllerToken(NSString* value, BOOL inParentheses)
+{
+    NSUInteger length = [value length];
+    NSUInteger end = length;
+
+    if (inParentheses) {
+        if ((length < 3) || ([value characterAtIndex:length - 1] != ')')) {
+            return 0;
+        }
+        end = length - 1;
+    }
+
+    NSUInteger begin = end;
+    while ((begin > 0) && (end - begin < 10)) {
+        unichar c = [value characterAtIndex:begin - 1];
+        if ((c < '0') || (c > '9')) {
+            break;
+        }
+        --begin;
+    }
+    if ((begin == end) || (inParentheses ? (begin == 0 || [value characterAtIndex:begin - 1] != '(') : (begin != 0))) {
+        return 0;
+    }
+
+    uint64_t token = 0;
+    for (NSUInteger i = begin; i < end; ++i) {
+        token = token * 10 + ([value characterAtIndex:i] - '0');
+    }
+    return (token > UINT32_MAX) ? 0 : (uint32_t)token;
+}
+
+static CDVViewController* viewControllerForToken(uint32_t token)
+{
+    if (token == 0) {
+        return nil;
+    }
+    CDVControllerSlot* slot = &gControllerSlots[token & (CDV_MAX_REGISTERED_CONTROLLERS - 1)];
+    if (slot->token != token) {
+        return nil;
+    }
+    OSMemoryBarrier();
+    CDVViewController* controller = slot->controller;
+    OSMemoryBarrier();
+    return (slot->token == token) ? controller : nil;
+}
 
 // Returns the registered view controller that sent the given request.
 // If the user-agent is not from a UIWebView, or if it's from an unregistered one,
 // then nil is returned.
 static CDVViewController *viewControllerForRequest(NSURLRequest* request)
 {
-    // The exec bridge explicitly sets the VC address in a header.
+    // The exec bridge explicitly sets the VC token in a header.
     // This works around the User-Agent not being set for file: URLs.
-    NSString* addrString = [request valueForHTTPHeaderField:@"vc"];
+    NSString* tokenString = [request valueForHTTPHeaderField:@"vc"];
 
-    if (addrString == nil) {
-        NSString* userAgent = [request valueForHTTPHeaderField:@"User-Agent"];
-        if (userAgent == nil) {
-            return nil;
-        }
-        NSUInteger bracketLocation = [userAgent rangeOfString:@"(" options:NSBackwardsSearch].location;
-        if (bracketLocation == NSNotFound) {
-            return nil;
-        }
-        addrString = [userAgent substringFromIndex:bracketLocation + 1];
+    if (tokenString != nil) {
+        return viewControllerForToken(parseControllerToken(tokenString, NO));
     }
 
-    long long viewControllerAddress = [addrString longLongValue];
-    @synchronized(gRegisteredControllers) {
-        if (![gRegisteredControllers containsObject:[NSNumber numberWithLongLong:viewControllerAddress]]) {
-            return nil;
-        }
+    NSString* userAgent = [request valueForHTTPHeaderField:@"User-Agent"];
+    if (userAgent == nil) {
+        return nil;
     }
+    return viewControllerForToken(parseControllerToken(userAgent, YES));
+}
 
-    return (__bridge CDVViewController*)(void*)viewControllerAddress;
+// Returns the path of a file: URL relative to the packed www folder, or nil if
+// the URL does not point into it.
+static NSString* wwwArchivePathForURL(NSURL* url)
+{
+    if ((gWwwArchive == nil) || ![url isFileURL]) {
+        return nil;
+    }
+    NSString* path = [url path];
+    if (![path hasPrefix:gWwwArchivePathPrefix]) {
+        return nil;
+    }
+    return [path substringFromIndex:[gWwwArchivePathPrefix length]];
 }
 
 @implementation CDVURLProtocol
@@ -75,34 +159,179 @@ static CDVViewController *viewControllerForRequest(NSURLRequest* request)
 + (void)registerURLProtocol {}
 
 // Called to register the URLProtocol, and to make it away of an instance of
-// a ViewController.
+// a ViewController. Registering an already registered controller is a no-op.
 + (void)registerViewController:(CDVViewController*)viewController
 {
-    if (gRegisteredControllers == nil) {
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
         [NSURLProtocol registerClass:[CDVURLProtocol class]];
-        gRegisteredControllers = [[NSMutableSet alloc] initWithCapacity:8];
-        // The whitelist doesn't change, so grab the first one and store it.
-        gWhitelist = viewController.whitelist;
-
-        // Note that we grab the whitelist from the first viewcontroller for now - but this will change
-        // when we allow a registered viewcontroller to have its own whitelist (e.g InAppBrowser)
-        // Differentiating the requests will be through the 'vc' http header below as used for the js->objc bridge.
-        //  The 'vc' value is generated by casting the viewcontroller object to a (long long) value (see CDVViewController::webViewDidFinishLoad)
-        if (gWhitelist == nil) {
-            NSLog(@"WARNING: NO whitelist has been set in CDVURLProtocol.");
+        gControllerRegistryLock = [[NSObject alloc] init];
+
+        gWwwArchive = viewController.wwwArchive;
+        if (gWwwArchive != nil) {
+            gWwwArchivePathPrefix = [NSString stringWithFormat:@"%@/%@/", [[NSBundle mainBundle] bundlePath], viewController.wwwFolderName];
+            CDVLogInfo(CDVLogCategoryURLProtocol, @"Serving %lu files of %@ from the packed www archive.", (unsigned long)gWwwArchive.count, viewController.wwwFolderName);
         }
+    });
+
+    // Each controller is checked against its own whitelist (see canInitWithRequest:),
+    // differentiated through the token in its User-Agent and the 'vc' header of the exec bridge.
+    if (viewController.whitelist == nil) {
+        CDVLogWarning(CDVLogCategoryURLProtocol, @"WARNING: NO whitelist has been set for %@ in CDVURLProtocol.", viewController);
     }
 
-    @synchronized(gRegisteredControllers) {
-        [gRegisteredControllers addObject:[NSNumber numberWithLongLong:(long long)viewController]];
+    @synchronized(gControllerRegistryLock) {
+        if ([self tokenForViewController:viewController] != 0) {
+            return;
+        }
+        for (uint32_t i = 0; i < CDV_MAX_REGISTERED_CONTROLLERS; ++i) {
+            CDVControllerSlot* slot = &gControllerSlots[i];
+            if (slot->token != 0) {
+                continue;
+            }
+            // Generations start at 1 so that no token is ever 0.
+            uint32_t generation = ++gControllerGenerations[i];
+            if (generation >= (UINT32_MAX >> CDV_CONTROLLER_SLOT_BITS)) {
+                gControllerGenerations[i] = generation = 1;
+            }
+            slot->controller = viewController;
+            OSMemoryBarrier();
+            slot->token = (generation << CDV_CONTROLLER_SLOT_BITS) | i;
+            return;
+        }
+        CDVLogError(CDVLogCategoryURLProtocol, @"ERROR: More than %d view controllers registered with CDVURLProtocol, %@ is ignored.", CDV_MAX_REGISTERED_CONTROLLERS, viewController);
     }
 }
 
 + (void)unregisterViewController:(CDVViewController*)viewController
 {
-    @synchronized(gRegisteredControllers) {
-        [gRegisteredControllers removeObject:[NSNumber numberWithLongLong:(long long)viewController]];
+    @synchronized(gControllerRegistryLock) {
+        for (uint32_t i = 0; i < CDV_MAX_REGISTERED_CONTROLLERS; ++i) {
+            CDVControllerSlot* slot = &gControllerSlots[i];
+            if ((slot->token != 0) && (slot->controller == viewController)) {
+                slot->token = 0;
+                OSMemoryBarrier();
+                slot->controller = nil;
+            }
+        }
+    }
+}
+
++ (uint32_t)tokenForViewController:(CDVViewController*)viewController
+{
+    for (uint32_t i = 0; i < CDV_MAX_REGISTERED_CONTROLLERS; ++i) {
+        CDVControllerSlot* slot = &gControllerSlots[i];
+        uint32_t token = slot->token;
+        if ((token != 0) && (slot->controller == viewController)) {
+            return token;
+        }
+    }
+    return 0;
+}
+
+// Drops what the page never fetched, e.g. because it was reloaded in between, and
+// sweeps again while anything is left. Call with gStagedDataLock held.
+static void sweepStagedData(void)
+{
+    NSDate* now = [NSDate date];
+    NSDate* nextExpiry = nil;
+
+    for (NSString* key in [gStagedDataExpiry allKeys]) {
+        NSDate* expiry = [gStagedDataExpiry objectForKey:key];
+        if ([expiry compare:now] != NSOrderedDescending) {
+            CDVLogWarning(CDVLogCategoryURLProtocol, @"Dropping %lu staged bytes that were not fetched.", (unsigned long)[[gStagedData objectForKey:key] length]);
+            [gStagedData removeObjectForKey:key];
+            [gStagedDataExpiry removeObjectForKey:key];
+        } else if ((nextExpiry == nil) || ([expiry compare:nextExpiry] == NSOrderedAscending)) {
+            nextExpiry = expiry;
+        }
+    }
+    gStagedDataSweepScheduled = (nextExpiry != nil);
+    if (gStagedDataSweepScheduled) {
+        NSTimeInterval delay = [nextExpiry timeIntervalSinceDate:now];
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+            @synchronized(gStagedDataLock) {
+                sweepStagedData();
+            }
+        });
+    }
+}
+
++ (NSString*)stageData:(NSData*)data
+{
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        gStagedData = [[NSMutableDictionary alloc] init];
+        gStagedDataExpiry = [[NSMutableDictionary alloc] init];
+        gStagedDataLock = [[NSObject alloc] init];
+    });
+
+    // The id is the only thing protecting the data, so it is random rather than a counter.
+    CFUUIDRef uuid = CFUUIDCreate(kCFAllocatorDefault);
+    NSString* stagedId = (__bridge_transfer NSString*)CFUUIDCreateString(kCFAllocatorDefault, uuid);
+    CFRelease(uuid);
+    NSDate* now = [NSDate date];
+
+    @synchronized(gStagedDataLock) {
+        [gStagedData setObject:(data ? data : [NSData data]) forKey:stagedId];
+        [gStagedDataExpiry setObject:[now dateByAddingTimeInterval:CDV_STAGED_DATA_LIFETIME] forKey:stagedId];
+        // Expiry runs on a timer, so unfetched data goes even if nothing else is staged.
+        if (!gStagedDataSweepScheduled) {
+            sweepStagedData();
+        }
+    }
+    return stagedId;
+}
+
++ (void)registerResourceHandler:(CDVURLResourceHandler)handler forName:(NSString*)name
+{
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        gResourceHandlers = [[NSMutableDictionary alloc] init];
+    });
+
+    @synchronized(gResourceHandlers) {
+        [gResourceHandlers setObject:[handler copy] forKey:name];
+    }
+}
+
+// The handler for a /!gap_res/<name>/... URL, nil if the URL is not one or no handler is registered.
+static CDVURLResourceHandler resourceHandlerForURL(NSURL* url)
+{
+    if (gResourceHandlers == nil) {
+        return nil;
+    }
+    NSString* path = [url path];
+    if (![path hasPrefix:kCDVResourcePathPrefix]) {
+        return nil;
+    }
+    NSRange nameRange = NSMakeRange([kCDVResourcePathPrefix length], [path length] - [kCDVResourcePathPrefix length]);
+    NSRange slash = [path rangeOfString:@"/" options:0 range:nameRange];
+    if (slash.location != NSNotFound) {
+        nameRange.length = slash.location - nameRange.location;
+    }
+    @synchronized(gResourceHandlers) {
+        return [gResourceHandlers objectForKey:[path substringWithRange:nameRange]];
+    }
+}
+
+// Removes and returns the staged data for a /!gap_blob/<id> URL, nil if there is none.
+static NSData* takeStagedDataForURL(NSURL* url)
+{
+    NSString* stagedId = [[url path] substringFromIndex:[kCDVStagedDataPathPrefix length]];
+    NSData* data = nil;
+
+    @synchronized(gStagedDataLock) {
+        data = [gStagedData objectForKey:stagedId];
+        if (data != nil) {
+            [gStagedData removeObjectForKey:stagedId];
+            [gStagedDataExpiry removeObjectForKey:stagedId];
+        }
     }
+    return data;
 }
 
 + (BOOL)canInitWithRequest:(NSURLRequest*)theRequest
@@ -112,12 +341,18 @@ static CDVViewController *viewControllerForRequest(NSURLRequest* request)
 
     if ([[theUrl absoluteString] hasPrefix:kCDVAssetsLibraryPrefixs]) {
         return YES;
+    } else if ([gWwwArchive containsPath:wwwArchivePathForURL(theUrl)]) {
+        // file: requests do not carry the User-Agent, so this does not depend on the view controller.
+        return YES;
+    } else if (resourceHandlerForURL(theUrl) != nil) {
+        // Neither does this: <img> requests have no 'vc' header.
+        return YES;
     } else if (viewController != nil) {
         if ([[theUrl path] isEqualToString:@"/!gap_exec"]) {
             NSString* queuedCommandsJSON = [theRequest valueForHTTPHeaderField:@"cmds"];
             NSString* requestId = [theRequest valueForHTTPHeaderField:@"rc"];
             if (requestId == nil) {
-                NSLog(@"!cordova request missing rc header");
+                CDVLogWarning(CDVLogCategoryURLProtocol, @"!cordova request missing rc header");
                 return NO;
             }
             BOOL hasCmds = [queuedCommandsJSON length] > 0;
@@ -134,11 +369,18 @@ static CDVViewController *viewControllerForRequest(NSURLRequest* request)
             // For this reason, we return NO when cmds exist.
             return !hasCmds;
         }
+        if ([[theUrl path] hasPrefix:kCDVStagedDataPathPrefix]) {
+            return gStagedDataLock != nil;
+        }
+        if ([[theUrl path] isEqualToString:kCDVSyncExecPath]) {
+            return YES;
+        }
         // we only care about http and https connections.
         // CORS takes care of http: trying to access file: URLs.
-        if ([gWhitelist schemeIsAllowed:[theUrl scheme]]) {
+        CDVWhitelist* whitelist = viewController.whitelist;
+        if ([whitelist schemeIsAllowed:[theUrl scheme]]) {
             // if it FAILS the whitelist, we return TRUE, so we can fail the connection later
-            return ![gWhitelist URLIsAllowed:theUrl];
+            return ![whitelist URLIsAllowed:theUrl];
         }
     }
 
@@ -159,6 +401,17 @@ static CDVViewController *viewControllerForRequest(NSURLRequest* request)
     if ([[url path] isEqualToString:@"/!gap_exec"]) {
         [self sendResponseWithResponseCode:200 data:nil mimeType:nil];
         return;
+    } else if ([[url path] isEqualToString:kCDVSyncExecPath]) {
+        // cordova.exec.sync(): the web view waits for this response, so the call
+        // runs right here. An empty body tells JS to fall back to exec().
+        NSString* command = [[[self request] valueForHTTPHeaderField:@"cmd"] stringByReplacingPercentEscapesUsingEncoding:NSUTF8StringEncoding];
+        NSString* result = [viewControllerForRequest([self request]).commandQueue executeSynchronously:command];
+        [self sendResponseWithResponseCode:200 data:[result dataUsingEncoding:NSUTF8StringEncoding] mimeType:@"application/json"];
+        return;
+    } else if ([[url path] hasPrefix:kCDVStagedDataPathPrefix]) {
+        NSData* data = takeStagedDataForURL(url);
+        [self sendResponseWithResponseCode:(data ? 200 : 404) data:data mimeType:@"application/octet-stream"];
+        return;
     } else if ([[url absoluteString] hasPrefix:kCDVAssetsLibraryPrefixs]) {
         ALAssetsLibraryAssetForURLResultBlock resultBlock = ^(ALAsset* asset) {
             if (asset) {
@@ -184,7 +437,28 @@ static CDVViewController *viewControllerForRequest(NSURLRequest* request)
         return;
     }
 
-    NSString* body = [gWhitelist errorStringForURL:url];
+    CDVURLResourceHandler resourceHandler = resourceHandlerForURL(url);
+    if (resourceHandler != nil) {
+        NSString* mimeType = nil;
+        NSData* data = resourceHandler(url, &mimeType);
+        [self sendResponseWithResponseCode:(data ? 200 : 404) data:data mimeType:mimeType];
+        return;
+    }
+
+    NSString* archivePath = wwwArchivePathForURL(url);
+    if (archivePath != nil) {
+        NSString* mimeType = nil;
+        NSData* data = [gWwwArchive dataForPath:archivePath mimeType:&mimeType];
+        if (data != nil) {
+            [self sendResponseWithResponseCode:200 data:data mimeType:mimeType];
+        } else {
+            [self sendResponseWithResponseCode:404 data:nil mimeType:nil];
+        }
+        return;
+    }
+
+    CDVWhitelist* whitelist = viewControllerForRequest([self request]).whitelist;
+    NSString* body = (whitelist != nil) ? [whitelist errorStringForURL:url] : [NSString stringWithFormat:kCDVDefaultWhitelistRejectionString, [url absoluteString]];
     [self sendResponseWithResponseCode:401 data:[body dataUsingEncoding:NSASCIIStringEncoding] mimeType:nil];
 }
 
@@ -203,7 +477,8 @@ static CDVViewController *viewControllerForRequest(NSURLRequest* request)
     if (mimeType == nil) {
         mimeType = @"text/plain";
     }
-    NSString* encodingName = [@"text/plain" isEqualToString : mimeType] ? @"UTF-8" : nil;
+    BOOL isText = [mimeType hasPrefix:@"text/"] || [@"application/javascript" isEqualToString : mimeType] || [@"application/json" isEqualToString : mimeType];
+    NSString* encodingName = isText ? @"UTF-8" : nil;
     CDVHTTPURLResponse* response =
         [[CDVHTTPURLResponse alloc] initWithURL:[[self request] URL]
                                        MIMEType:mimeType
@@ -24,6 +24,7 @@
 #import "CDVCommandDelegate.h"
 #import "CDVCommandQueue.h"
 #import "CDVWhitelist.h"
+#import "CDVWwwArchive.h"
 #import "CDVScreenOrientationDelegate.h"
 #import "CDVPlugin.h"
 
@@ -39,9 +40,12 @@
 
 @property (nonatomic, readonly, strong) NSMutableDictionary* pluginObjects;
 @property (nonatomic, readonly, strong) NSDictionary* pluginsMap;
+@property (nonatomic, readonly, strong) NSDictionary* idempotentActions; // lowercase plugin name -> NSSet of action names
+@property (nonatomic, readonly, strong) NSDictionary* syncActions; // lowercase plugin name -> NSSet of action names
 @property (nonatomic, readonly, strong) NSMutableDictionary* settings;
 @property (nonatomic, readonly, strong) NSXMLParser* configParser;
 @property (nonatomic, readonly, strong) CDVWhitelist* whitelist; // readonly for public
+@property (nonatomic, readonly, strong) CDVWwwArchive* wwwArchive; // nil unless www was packed at build time
 @property (nonatomic, readonly, assign) BOOL loadFromString;
 
 @property (nonatomic, readwrite, copy) NSString* wwwFolderName;
@@ -27,6 +27,10 @@
 
 #define degreesToRadian(x) (M_PI * (x) / 180.0)
 
+// Seconds spent deleting temp files when the app is terminated / backgrounded.
+#define kCDVTerminatePurgeBudget 2.0
+#define kCDVBackgroundPurgeBudget 8.0
+
 @interface CDVViewController () {
     NSInteger _userAgentLockToken;
     CDVWebViewDelegate* _webViewDelegate;
@@ -35,9 +39,12 @@
 @property (nonatomic, readwrite, strong) NSXMLParser* configParser;
 @property (nonatomic, readwrite, strong) NSMutableDictionary* settings;
 @property (nonatomic, readwrite, strong) CDVWhitelist* whitelist;
+@property (nonatomic, readwrite, strong) CDVWwwArchive* wwwArchive;
 @property (nonatomic, readwrite, strong) NSMutableDictionary* pluginObjects;
 @property (nonatomic, readwrite, strong) NSArray* startupPluginNames;
 @property (nonatomic, readwrite, strong) NSDictionary* pluginsMap;
+@property (nonatomic, readwrite, strong) NSDictionary* idempotentActions;
+@property (nonatomic, readwrite, strong) NSDictionary* syncActions;
 @property (nonatomic, readwrite, strong) NSArray* supportedOrientations;
 @property (nonatomic, readwrite, assign) BOOL loadFromString;
 
@@ -50,7 +57,7 @@
 @implementation CDVViewController
 
 @synthesize webView, supportedOrientations;
-@synthesize pluginObjects, pluginsMap, whitelist, startupPluginNames;
+@synthesize pluginObjects, pluginsMap, idempotentActions, syncActions, whitelist, wwwArchive, startupPluginNames;
 @synthesize configParser, settings, loadFromString;
 @synthesize wwwFolderName, startPage, initialized, openURL;
 @synthesize commandDelegate = _commandDelegate;
@@ -265,10 +272,23 @@ CGFloat gAccessoryBarHeight = 0.0;
 
     // Get the plugin dictionary, whitelist and settings from the delegate.
     self.pluginsMap = delegate.pluginsDict;
+#ifdef DEBUG
+    for (NSString* mismatch in [CDVPluginRegistry mismatchesWithPluginsMap:self.pluginsMap]) {
+        CDVLogWarning(CDVLogCategoryPlugin, @"WARNING: %@. Rebuild to regenerate it.", mismatch);
+    }
+#endif
     self.startupPluginNames = delegate.startupPluginNames;
+    self.idempotentActions = delegate.idempotentActions;
+    self.syncActions = delegate.syncActions;
     self.whitelist = [[CDVWhitelist alloc] initWithArray:delegate.whitelistHosts];
     self.settings = delegate.settings;
 
+    // e.g. <preference name="LogLevel" value="debug" />, see CDVLog.h
+    NSString* logLevel = [self.settings objectForKey:@"loglevel"];
+    if (logLevel != nil) {
+        CDVLogSetAllLevels(CDVLogLevelFromString(logLevel, CDVLogLevelInfo));
+    }
+
     // And the start folder/page.
     self.wwwFolderName = @"www";
     self.startPage = delegate.startPage;
@@ -276,6 +296,10 @@ CGFloat gAccessoryBarHeight = 0.0;
         self.startPage = @"index.html";
     }
 
+    // A www folder packed by copy-www-build-step.sh replaces the loose files.
+    NSString* archivePath = [[NSBundle mainBundle] pathForResource:self.wwwFolderName ofType:kCDVWwwArchiveExtension];
+    self.wwwArchive = [CDVWwwArchive archiveAtPath:archivePath];
+
     // Initialize the plugin objects dict.
     self.pluginObjects = [[NSMutableDictionary alloc] initWithCapacity:20];
 }
@@ -297,13 +321,13 @@ CGFloat gAccessoryBarHeight = 0.0;
         NSURL* startURL = [NSURL URLWithString:self.startPage];
         NSString* startFilePath = [self.commandDelegate pathForResource:[startURL path]];
 
-        if (startFilePath == nil) {
+        if ((startFilePath == nil) && ![self.wwwArchive containsPath:[startURL path]]) {
             loadErr = [NSString stringWithFormat:@"ERROR: Start Page at '%@/%@' was not found.", self.wwwFolderName, self.startPage];
             NSLog(@"%@", loadErr);
             self.loadFromString = YES;
             appURL = nil;
         } else {
-            // CB-3005 we know that the page exists : reconstruct full path from bundle
+            // CB-3005 we know that the page exists (loose or packed) : reconstruct full path from bundle
             NSURL* relativeURL = [NSURL fileURLWithPath:[[NSBundle mainBundle] bundlePath]];
             NSString* localURL = [NSString stringWithFormat:@"%@/%@", self.wwwFolderName, self.startPage];
             appURL = [NSURL URLWithString:localURL relativeToURL:relativeURL];
@@ -665,8 +689,9 @@ CGFloat gAccessoryBarHeight = 0.0;
 {
     if (_userAgent == nil) {
         NSString* originalUserAgent = [CDVUserAgentUtil originalUserAgent];
-        // Use our address as a unique number to append to the User-Agent.
-        _userAgent = [NSString stringWithFormat:@"%@ (%lld)", originalUserAgent, (long long)self];
+        // Append our CDVURLProtocol token so requests can be mapped back to this controller.
+        [CDVURLProtocol registerViewController:self];
+        _userAgent = [NSString stringWithFormat:@"%@ (%u)", originalUserAgent, [CDVURLProtocol tokenForViewController:self]];
     }
     return _userAgent;
 }
@@ -912,6 +937,7 @@ CGFloat gAccessoryBarHeight = 0.0;
     [self.pluginObjects setObject:plugin forKey:className];
     [self.pluginsMap setValue:className forKey:[pluginName lowercaseString]];
     [plugin pluginInitialize];
+    [_commandQueue rememberSyncPlugin:plugin forService:pluginName];
 }
 
 /**
@@ -932,10 +958,18 @@ CGFloat gAccessoryBarHeight = 0.0;
 
     id obj = [self.pluginObjects objectForKey:className];
     if (!obj) {
-        obj = [[NSClassFromString(className)alloc] initWithWebView:webView];
+        // prefer the factory generated at build time, if it agrees with config.xml
+        const CDVPluginRegistryEntry* entry = [CDVPluginRegistry entryForService:[pluginName lowercaseString]];
+        if ((entry != NULL) && (strcmp(entry->className, [className UTF8String]) == 0)) {
+            obj = entry->factory(webView);
+        } else {
+            obj = [[NSClassFromString(className)alloc] initWithWebView:webView];
+        }
 
         if (obj != nil) {
             [self registerPlugin:obj withClassName:className];
+            // Onload plugins are created here at startup, before any exec().
+            [_commandQueue rememberSyncPlugin:obj forService:pluginName];
         } else {
             NSLog(@"CDVPlugin class %@ (pluginName: %@) does not exist.", className, pluginName);
         }
@@ -989,23 +1023,9 @@ CGFloat gAccessoryBarHeight = 0.0;
  */
 - (void)onAppWillTerminate:(NSNotification*)notification
 {
-    // empty the tmp directory
-    NSFileManager* fileMgr = [[NSFileManager alloc] init];
-    NSError* __autoreleasing err = nil;
-
-    // clear contents of NSTemporaryDirectory
-    NSString* tempDirectoryPath = NSTemporaryDirectory();
-    NSDirectoryEnumerator* directoryEnumerator = [fileMgr enumeratorAtPath:tempDirectoryPath];
-    NSString* fileName = nil;
-    BOOL result;
-
-    while ((fileName = [directoryEnumerator nextObject])) {
-        NSString* filePath = [tempDirectoryPath stringByAppendingPathComponent:fileName];
-        result = [fileMgr removeItemAtPath:filePath error:&err];
-        if (!result && err) {
-            NSLog(@"Failed to delete: %@ (error: %@)", filePath, err);
-        }
-    }
+    // empty the tmp directory; the OS only allows a few seconds here, so files
+    // that don't fit in the budget are left for the next purge
+    [[CDVTempFilePurger sharedPurger] purgeAllWithTimeBudget:kCDVTerminatePurgeBudget];
 }
 
 /*
@@ -1044,6 +1064,22 @@ CGFloat gAccessoryBarHeight = 0.0;
 {
     // NSLog(@"%@",@"applicationDidEnterBackground");
     [self.commandDelegate evalJs:@"cordova.fireDocumentEvent('pause', null, true);" scheduledOnRunLoop:NO];
+
+    // remove the temp files plugins registered while we were in the foreground
+    CDVTempFilePurger* purger = [CDVTempFilePurger sharedPurger];
+    if (!purger.purging) {
+        UIApplication* app = [UIApplication sharedApplication];
+        __block UIBackgroundTaskIdentifier taskId = [app beginBackgroundTaskWithExpirationHandler:^{
+            [app endBackgroundTask:taskId];
+            taskId = UIBackgroundTaskInvalid;
+        }];
+        [purger purgeRegisteredFilesWithTimeBudget:kCDVBackgroundPurgeBudget completion:^(BOOL finished) {
+            if (taskId != UIBackgroundTaskInvalid) {
+                [app endBackgroundTask:taskId];
+                taskId = UIBackgroundTaskInvalid;
+            }
+        }];
+    }
 }
 
 // ///////////////////////
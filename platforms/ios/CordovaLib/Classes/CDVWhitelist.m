@@ -18,6 +18,7 @@
  */
 
 #import "CDVWhitelist.h"
+#import "CDVWhitelistTable.h"
 
 NSString* const kCDVDefaultWhitelistRejectionString = @"ERROR whitelist rejection: url='%@'";
 NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
@@ -89,7 +90,12 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
 
 @end
 
-@interface CDVWhitelist ()
+@interface CDVWhitelist () {
+    // Compiled from the same origins at build time (see CDVWhitelistLookup.h), or NULL.
+    const cdv_whitelist_table* _table;
+    NSArray* _origins;
+    BOOL _patternsLoaded;
+}
 
 @property (nonatomic, readwrite, strong) NSMutableArray* whitelist;
 @property (nonatomic, readwrite, strong) NSMutableSet* permittedSchemes;
@@ -98,6 +104,18 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
 
 @end
 
+// Copies a URL component into buffer for the table lookup, without allocating.
+// Returns NO if it does not fit; *component is NULL when string is nil.
+static BOOL CDVCopyComponent(NSString* string, char* buffer, CFIndex size, const char** component)
+{
+    if (string == nil) {
+        *component = NULL;
+        return YES;
+    }
+    *component = buffer;
+    return CFStringGetCString((__bridge CFStringRef)string, buffer, size, kCFStringEncodingUTF8);
+}
+
 @implementation CDVWhitelist
 
 @synthesize whitelist, permittedSchemes, whitelistRejectionFormatString;
@@ -106,15 +124,31 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
 {
     self = [super init];
     if (self) {
-        self.whitelist = [[NSMutableArray alloc] init];
-        self.permittedSchemes = [[NSMutableSet alloc] init];
         self.whitelistRejectionFormatString = kCDVDefaultWhitelistRejectionString;
+        _origins = [array copy];
+        _table = [CDVWhitelistTable tableForOrigins:_origins];
+        // Without a table (or with one generated from other origins) the patterns are built
+        // right away; otherwise only for URLs too long for the table lookup.
+        if (_table == NULL) {
+            [self loadPatterns];
+        }
+    }
+    return self;
+}
 
-        for (NSString* pattern in array) {
+- (void)loadPatterns
+{
+    @synchronized(self) {
+        if (_patternsLoaded) {
+            return;
+        }
+        self.whitelist = [[NSMutableArray alloc] init];
+        self.permittedSchemes = [[NSMutableSet alloc] init];
+        for (NSString* pattern in _origins) {
             [self addWhiteListEntry:pattern];
         }
+        _patternsLoaded = YES;
     }
-    return self;
 }
 
 - (BOOL)isIPv4Address:(NSString*)externalHost
@@ -215,6 +249,19 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
 }
 
 - (BOOL)schemeIsAllowed:(NSString*)scheme
+{
+    if (_table != NULL) {
+        char buffer[64];
+        const char* cScheme;
+        if (CDVCopyComponent(scheme, buffer, sizeof(buffer), &cScheme)) {
+            return cdv_whitelist_scheme_is_allowed(_table, cScheme) != 0;
+        }
+        [self loadPatterns];
+    }
+    return [self patternsAllowScheme:scheme];
+}
+
+- (BOOL)patternsAllowScheme:(NSString*)scheme
 {
     if ([scheme isEqualToString:@"http"] ||
         [scheme isEqualToString:@"https"] ||
@@ -232,6 +279,29 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
 }
 
 - (BOOL)URLIsAllowed:(NSURL*)url logFailure:(BOOL)logFailure
+{
+    BOOL allowed;
+    char scheme[64], host[256], path[1024];
+    const char *cScheme, *cHost, *cPath;
+
+    if ((_table != NULL) &&
+        CDVCopyComponent([url scheme], scheme, sizeof(scheme), &cScheme) &&
+        CDVCopyComponent([url host], host, sizeof(host), &cHost) &&
+        CDVCopyComponent([url path], path, sizeof(path), &cPath)) {
+        NSNumber* port = [url port];
+        allowed = cdv_whitelist_url_is_allowed(_table, cScheme, cHost, (port != nil) ? [port longValue] : -1, cPath) != 0;
+    } else {
+        [self loadPatterns];
+        allowed = [self patternsAllowURL:url];
+    }
+
+    if (!allowed && logFailure) {
+        NSLog(@"%@", [self errorStringForURL:url]);
+    }
+    return allowed;
+}
+
+- (BOOL)patternsAllowURL:(NSURL*)url
 {
     // Shortcut acceptance: Are all urls whitelisted ("*" in whitelist)?
     if (whitelist == nil) {
@@ -240,10 +310,7 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
 
     // Shortcut rejection: Check that the scheme is supported
     NSString* scheme = [url scheme];
-    if (![self schemeIsAllowed:scheme]) {
-        if (logFailure) {
-            NSLog(@"%@", [self errorStringForURL:url]);
-        }
+    if (![self patternsAllowScheme:scheme]) {
         return NO;
     }
 
@@ -251,7 +318,7 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
     if ([scheme isEqualToString:@"http"] || [scheme isEqualToString:@"https"] || [scheme isEqualToString:@"ftp"] || [scheme isEqualToString:@"ftps"]) {
         NSURL* newUrl = [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@%@", kCDVDefaultSchemeName, [url host], [url path]]];
         // If it is allowed, we are done.  If not, continue to check for the actual scheme-specific list
-        if ([self URLIsAllowed:newUrl logFailure:NO]) {
+        if ([self patternsAllowURL:newUrl]) {
             return YES;
         }
     }
@@ -263,9 +330,6 @@ NSString* const kCDVDefaultSchemeName = @"cdv-default-scheme";
         }
     }
 
-    if (logFailure) {
-        NSLog(@"%@", [self errorStringForURL:url]);
-    }
     // if we got here, the url host is not in the white-list, do nothing
     return NO;
 }
@@ -0,0 +1,197 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#include <string.h>
+#include "CDVWhitelistLookup.h"
+
+// Matches -[CDVWhitelist URLIsAllowed:], which also checks http[s] and ftp[s] URLs
+// against the origins given for this scheme.
+static const char* const kDefaultScheme = "cdv-default-scheme";
+
+static int cdv_whitelist_is_always_allowed_scheme(const char* scheme)
+{
+    return (scheme != NULL) && ((strcmp(scheme, "http") == 0) || (strcmp(scheme, "https") == 0) ||
+           (strcmp(scheme, "ftp") == 0) || (strcmp(scheme, "ftps") == 0));
+}
+
+static uint32_t cdv_whitelist_hash(const char* s)
+{
+    uint32_t hash = 0x811c9dc5u;
+
+    for (; *s != '\0'; ++s) {
+        hash = (hash ^ (uint8_t)*s) * 0x01000193u;
+    }
+    return hash;
+}
+
+// Length of the line terminator at s (ICU's: \n \r U+0085 U+2028 U+2029), 0 if there is none.
+static size_t cdv_whitelist_terminator_length(const char* s)
+{
+    if ((s[0] == '\n') || (s[0] == '\r')) {
+        return 1;
+    }
+    if (((uint8_t)s[0] == 0xc2) && ((uint8_t)s[1] == 0x85)) {
+        return 2;
+    }
+    if (((uint8_t)s[0] == 0xe2) && ((uint8_t)s[1] == 0x80) && (((uint8_t)s[2] == 0xa8) || ((uint8_t)s[2] == 0xa9))) {
+        return 3;
+    }
+    return 0;
+}
+
+// The regular expression for a path turns "*" into ".*", which does not match line
+// terminators, and ends in "$", which also matches before a terminator at the very end.
+static int cdv_whitelist_glob_matches(const char* glob, const char* text)
+{
+    size_t n = strlen(text);
+
+    if ((n >= 2) && (text[n - 2] == '\r') && (text[n - 1] == '\n')) {
+        n -= 2;
+    } else {
+        for (size_t len = 1; len <= 3 && len <= n; ++len) {
+            if (cdv_whitelist_terminator_length(text + n - len) == len) {
+                n -= len;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (cdv_whitelist_terminator_length(text + i) > 0) {
+            return 0;
+        }
+    }
+
+    size_t t = 0, g = 0, starT = 0;
+    const char* star = NULL;
+    while (t < n) {
+        if (glob[g] == '*') {
+            star = glob + g++;
+            starT = t;
+        } else if ((glob[g] != '\0') && (glob[g] == text[t])) {
+            ++g;
+            ++t;
+        } else if (star != NULL) {
+            g = star - glob + 1;
+            t = ++starT;
+        } else {
+            return 0;
+        }
+    }
+    while (glob[g] == '*') {
+        ++g;
+    }
+    return glob[g] == '\0';
+}
+
+static int cdv_whitelist_rules_match(const cdv_whitelist_table* table, size_t first, size_t count, const char* scheme,
+    long port, const char* path)
+{
+    for (size_t i = first; i < first + count; ++i) {
+        const cdv_whitelist_rule* rule = &table->rules[i];
+        if (((rule->scheme == NULL) || ((scheme != NULL) && (strcmp(rule->scheme, scheme) == 0))) &&
+            ((rule->port == -1) || (port == rule->port)) &&
+            ((rule->path == NULL) || cdv_whitelist_glob_matches(rule->path, (path != NULL) ? path : ""))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static const cdv_whitelist_host_slot* cdv_whitelist_lookup_host(const cdv_whitelist_host_slot* slots, size_t slotCount,
+    const char* host)
+{
+    if (slotCount == 0) {
+        return NULL;
+    }
+    uint32_t hash = cdv_whitelist_hash(host);
+    for (size_t i = hash & (slotCount - 1); slots[i].host != NULL; i = (i + 1) & (slotCount - 1)) {
+        if ((slots[i].hash == hash) && (strcmp(slots[i].host, host) == 0)) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+static int cdv_whitelist_table_matches(const cdv_whitelist_table* table, const char* scheme, const char* host, long port,
+    const char* path)
+{
+    if (cdv_whitelist_rules_match(table, 0, table->any_host_rule_count, scheme, port, path)) {
+        return 1;
+    }
+    if (host == NULL) {
+        return 0;
+    }
+
+    const cdv_whitelist_host_slot* slot = cdv_whitelist_lookup_host(table->exact_hosts, table->exact_host_slot_count, host);
+    if ((slot != NULL) && cdv_whitelist_rules_match(table, slot->first_rule, slot->rule_count, scheme, port, path)) {
+        return 1;
+    }
+
+    // "*.x" matches x itself and p.x where p only has [a-z0-9.-], so x is tried after every
+    // dot up to the first other character.
+    size_t plain = strspn(host, "abcdefghijklmnopqrstuvwxyz0123456789.-");
+    for (const char* x = host; x != NULL; ) {
+        slot = cdv_whitelist_lookup_host(table->suffix_hosts, table->suffix_host_slot_count, x);
+        if ((slot != NULL) && cdv_whitelist_rules_match(table, slot->first_rule, slot->rule_count, scheme, port, path)) {
+            return 1;
+        }
+        const char* dot = strchr(x, '.');
+        x = ((dot != NULL) && ((size_t)(dot - host) <= plain)) ? dot + 1 : NULL;
+    }
+    return 0;
+}
+
+int cdv_whitelist_scheme_is_allowed(const cdv_whitelist_table* table, const char* scheme)
+{
+    if (cdv_whitelist_is_always_allowed_scheme(scheme) || table->allow_all || table->any_scheme) {
+        return 1;
+    }
+    if (scheme == NULL) {
+        return 0;
+    }
+    size_t low = 0, high = table->scheme_count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int order = strcmp(table->schemes[mid], scheme);
+        if (order == 0) {
+            return 1;
+        } else if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return 0;
+}
+
+int cdv_whitelist_url_is_allowed(const cdv_whitelist_table* table, const char* scheme, const char* host, long port,
+    const char* path)
+{
+    if (table->allow_all) {
+        return 1;
+    }
+    if (!cdv_whitelist_scheme_is_allowed(table, scheme)) {
+        return 0;
+    }
+    if (cdv_whitelist_is_always_allowed_scheme(scheme) && cdv_whitelist_scheme_is_allowed(table, kDefaultScheme) &&
+        cdv_whitelist_table_matches(table, kDefaultScheme, host, -1, path)) {
+        return 1;
+    }
+    return cdv_whitelist_table_matches(table, scheme, host, port, path);
+}
@@ -0,0 +1,79 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ The decision table for the <access> origins of config.xml and its lookups.
+ cordova/lib/gen-whitelist-table.js generates the table at build time; it makes
+ the same decisions as the regular expressions CDVWhitelist otherwise builds at
+ startup, and lookups take C strings and do not allocate.
+
+ Plain C, so tests/ builds the lookups on Linux and runs them against the
+ generator's corpus of URLs and the decisions of its port of the regular
+ expression matcher.
+ */
+
+#ifndef CDV_WHITELIST_LOOKUP_H
+#define CDV_WHITELIST_LOOKUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char* scheme; // NULL matches any scheme
+    long port;          // -1 matches any port, otherwise the URL must have this port
+    const char* path;   // "*" matches any run of characters; NULL matches any path
+} cdv_whitelist_rule;
+
+typedef struct {
+    uint32_t hash;       // FNV-1a of host
+    const char* host;    // NULL for an empty slot
+    uint16_t first_rule; // the rules for this host are rules[first_rule, first_rule + rule_count)
+    uint16_t rule_count;
+} cdv_whitelist_host_slot;
+
+typedef struct {
+    const char* const* origins; // the whitelist the table was compiled from
+    size_t origin_count;
+    int allow_all;              // "*" was whitelisted
+    int any_scheme;             // an origin has the scheme "*"
+    const char* const* schemes; // permitted schemes, sorted by strcmp
+    size_t scheme_count;
+    const cdv_whitelist_rule* rules;
+    size_t any_host_rule_count; // rules[0, any_host_rule_count) apply to every host
+    const cdv_whitelist_host_slot* exact_hosts; // open addressing, slot count is a power of 2
+    size_t exact_host_slot_count;
+    const cdv_whitelist_host_slot* suffix_hosts; // "*.example.com" is filed as "example.com"
+    size_t suffix_host_slot_count;
+} cdv_whitelist_table;
+
+int cdv_whitelist_scheme_is_allowed(const cdv_whitelist_table* table, const char* scheme);
+
+// scheme, host and path may be NULL when the URL has none; port is -1 when it has none.
+int cdv_whitelist_url_is_allowed(const cdv_whitelist_table* table, const char* scheme, const char* host, long port,
+    const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CDV_WHITELIST_LOOKUP_H */
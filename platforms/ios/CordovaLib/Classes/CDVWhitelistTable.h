@@ -0,0 +1,35 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#include "CDVWhitelistLookup.h"
+
+/*
+ Registry of the decision table generated at build time from the <access> origins
+ of config.xml (see CDVWhitelistLookup.h for the table and its lookups).
+ */
+@interface CDVWhitelistTable : NSObject
+
+// Called from the generated file's +load; the table must stay valid forever.
++ (void)registerTable:(const cdv_whitelist_table*)table;
+
+// The registered table if it was compiled from exactly these origins, NULL otherwise.
++ (const cdv_whitelist_table*)tableForOrigins:(NSArray*)origins;
+
+@end
@@ -0,0 +1,54 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CDVWhitelistTable.h"
+#import "CDVLog.h"
+
+static const cdv_whitelist_table* gRegisteredTable = NULL;
+
+@implementation CDVWhitelistTable
+
++ (void)registerTable:(const cdv_whitelist_table*)table
+{
+    @synchronized(self) {
+        gRegisteredTable = table;
+    }
+}
+
++ (const cdv_whitelist_table*)tableForOrigins:(NSArray*)origins
+{
+    const cdv_whitelist_table* table;
+
+    @synchronized(self) {
+        table = gRegisteredTable;
+    }
+    if (table == NULL) {
+        return NULL;
+    }
+    BOOL matches = (table->origin_count == [origins count]);
+    for (NSUInteger i = 0; matches && i < table->origin_count; ++i) {
+        matches = [[origins objectAtIndex:i] isEqualToString:[NSString stringWithUTF8String:table->origins[i]]];
+    }
+    if (!matches) {
+        CDVLogWarning(CDVLogCategoryURLProtocol, @"WARNING: the generated whitelist table was compiled from other <access> origins than config.xml has. Rebuild to regenerate it.");
+    }
+    return matches ? table : NULL;
+}
+
+@end
@@ -0,0 +1,41 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+extern NSString* const kCDVWwwArchiveExtension;
+
+/**
+ Read-only view of a packed www archive as written by cordova/lib/pack-www.js.
+ The file is memory-mapped and looked up through the hash index stored in the
+ archive itself, so no per-file stat or bundle lookup happens at load time.
+ */
+@interface CDVWwwArchive : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;
+
++ (CDVWwwArchive*)archiveAtPath:(NSString*)path;
+
+- (id)initWithPath:(NSString*)path;
+- (BOOL)containsPath:(NSString*)path;
+// Returns the contents for a path relative to the www folder, or nil if the
+// archive has no such entry. Compressed entries are inflated on the fly.
+- (NSData*)dataForPath:(NSString*)path mimeType:(NSString**)mimeType;
+
+@end
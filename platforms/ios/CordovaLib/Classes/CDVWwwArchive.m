@@ -0,0 +1,237 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <zlib.h>
+#import "CDVWwwArchive.h"
+#import "CDVLog.h"
+
+NSString* const kCDVWwwArchiveExtension = @"cdvpak";
+
+// On-disk layout, all integers little-endian:
+//   header   (CDVWwwArchiveHeader)
+//   buckets  bucketCount x uint32, entry index + 1 or 0 when empty (linear probing)
+//   entries  entryCount x CDVWwwArchiveEntry
+//   mimes    mimeCount x (uint32 offset, uint32 length) into the string table
+//   strings  paths and mime types, not terminated
+//   data     file contents, raw or zlib-deflated
+static const char kCDVWwwArchiveMagic[8] = {'C', 'D', 'V', 'P', 'A', 'K', '0', '1'};
+static const uint32_t kCDVWwwArchiveFlagDeflated = 1;
+
+typedef struct {
+    char magic[8];
+    uint32_t entryCount;
+    uint32_t bucketCount;
+    uint32_t mimeCount;
+    uint32_t bucketsOffset;
+    uint32_t entriesOffset;
+    uint32_t mimesOffset;
+    uint32_t stringsOffset;
+    uint32_t reserved;
+} CDVWwwArchiveHeader;
+
+typedef struct {
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint32_t dataOffset;
+    uint32_t dataLength;
+    uint32_t rawLength;
+    uint16_t mimeIndex;
+    uint16_t flags;
+} CDVWwwArchiveEntry;
+
+// FNV-1a, must match hashPath() in pack-www.js.
+static uint32_t CDVWwwArchiveHash(const char* bytes, size_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+@interface CDVWwwArchive () {
+    NSData* _mapped;
+    const uint8_t* _base;
+    const CDVWwwArchiveHeader* _header;
+    const uint32_t* _buckets;
+    const CDVWwwArchiveEntry* _entries;
+    const uint32_t* _mimes;
+    NSMutableDictionary* _mimeStrings;
+}
+@end
+
+@implementation CDVWwwArchive
+
++ (CDVWwwArchive*)archiveAtPath:(NSString*)path
+{
+    if (path == nil) {
+        return nil;
+    }
+    return [[CDVWwwArchive alloc] initWithPath:path];
+}
+
+- (id)initWithPath:(NSString*)path
+{
+    self = [super init];
+    if (self) {
+        NSError* __autoreleasing err = nil;
+        _mapped = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:&err];
+        if (_mapped == nil) {
+            CDVLogError(CDVLogCategoryURLProtocol, @"ERROR: failed to map www archive %@ (error: %@)", path, err);
+            return nil;
+        }
+        if (![self validate]) {
+            CDVLogError(CDVLogCategoryURLProtocol, @"ERROR: ignoring malformed www archive %@", path);
+            return nil;
+        }
+        _mimeStrings = [[NSMutableDictionary alloc] initWithCapacity:_header->mimeCount];
+    }
+    return self;
+}
+
+- (BOOL)validate
+{
+    NSUInteger length = [_mapped length];
+
+    if (length < sizeof(CDVWwwArchiveHeader)) {
+        return NO;
+    }
+    _base = (const uint8_t*)[_mapped bytes];
+    _header = (const CDVWwwArchiveHeader*)_base;
+    if (memcmp(_header->magic, kCDVWwwArchiveMagic, sizeof(kCDVWwwArchiveMagic)) != 0) {
+        return NO;
+    }
+    // The bucket count is a power of two so lookups can mask instead of divide.
+    if ((_header->bucketCount == 0) || ((_header->bucketCount & (_header->bucketCount - 1)) != 0) ||
+        (_header->entryCount >= _header->bucketCount)) {
+        return NO;
+    }
+    if (((uint64_t)_header->bucketsOffset + (uint64_t)_header->bucketCount * sizeof(uint32_t) > length) ||
+        ((uint64_t)_header->entriesOffset + (uint64_t)_header->entryCount * sizeof(CDVWwwArchiveEntry) > length) ||
+        ((uint64_t)_header->mimesOffset + (uint64_t)_header->mimeCount * 2 * sizeof(uint32_t) > length) ||
+        (_header->stringsOffset > length)) {
+        return NO;
+    }
+    _buckets = (const uint32_t*)(_base + _header->bucketsOffset);
+    _entries = (const CDVWwwArchiveEntry*)(_base + _header->entriesOffset);
+    _mimes = (const uint32_t*)(_base + _header->mimesOffset);
+
+    for (uint32_t i = 0; i < _header->mimeCount; ++i) {
+        if ((uint64_t)_header->stringsOffset + _mimes[i * 2] + _mimes[i * 2 + 1] > length) {
+            return NO;
+        }
+    }
+    for (uint32_t i = 0; i < _header->entryCount; ++i) {
+        const CDVWwwArchiveEntry* entry = &_entries[i];
+        if (((uint64_t)_header->stringsOffset + entry->pathOffset + entry->pathLength > length) ||
+            ((uint64_t)entry->dataOffset + entry->dataLength > length) ||
+            (entry->mimeIndex >= _header->mimeCount)) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (NSUInteger)count
+{
+    return _header->entryCount;
+}
+
+- (const CDVWwwArchiveEntry*)entryForPath:(NSString*)path
+{
+    if ([path hasPrefix:@"/"]) {
+        path = [path substringFromIndex:1];
+    }
+    const char* key = [path UTF8String];
+    if (key == NULL) {
+        return NULL;
+    }
+    size_t keyLength = strlen(key);
+    uint32_t mask = _header->bucketCount - 1;
+    const uint8_t* strings = _base + _header->stringsOffset;
+
+    uint32_t slot = CDVWwwArchiveHash(key, keyLength) & mask;
+
+    // A well-formed archive always has an empty bucket; a malformed one must not loop forever.
+    for (uint32_t probes = 0; probes < _header->bucketCount; ++probes, slot = (slot + 1) & mask) {
+        uint32_t index = _buckets[slot];
+        if ((index == 0) || (index > _header->entryCount)) {
+            return NULL;
+        }
+        const CDVWwwArchiveEntry* entry = &_entries[index - 1];
+        if ((entry->pathLength == keyLength) && (memcmp(strings + entry->pathOffset, key, keyLength) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+- (NSString*)mimeTypeAtIndex:(uint16_t)mimeIndex
+{
+    NSNumber* key = [NSNumber numberWithUnsignedShort:mimeIndex];
+    NSString* mimeType = [_mimeStrings objectForKey:key];
+
+    if (mimeType == nil) {
+        const uint8_t* strings = _base + _header->stringsOffset;
+        mimeType = [[NSString alloc] initWithBytes:strings + _mimes[mimeIndex * 2]
+                                            length:_mimes[mimeIndex * 2 + 1]
+                                          encoding:NSASCIIStringEncoding];
+        [_mimeStrings setObject:mimeType forKey:key];
+    }
+    return mimeType;
+}
+
+- (BOOL)containsPath:(NSString*)path
+{
+    return [self entryForPath:path] != NULL;
+}
+
+- (NSData*)dataForPath:(NSString*)path mimeType:(NSString**)mimeType
+{
+    const CDVWwwArchiveEntry* entry = [self entryForPath:path];
+
+    if (entry == NULL) {
+        return nil;
+    }
+    if (mimeType != NULL) {
+        @synchronized(_mimeStrings) {
+            *mimeType = [self mimeTypeAtIndex:entry->mimeIndex];
+        }
+    }
+
+    if ((entry->flags & kCDVWwwArchiveFlagDeflated) == 0) {
+        // A view into the mapping, the pages are only faulted in when WebKit reads them.
+        // The archive is kept for the lifetime of the app, which outlives any response.
+        return [NSData dataWithBytesNoCopy:(void*)(_base + entry->dataOffset) length:entry->dataLength freeWhenDone:NO];
+    }
+
+    NSMutableData* inflated = [NSMutableData dataWithLength:entry->rawLength];
+    uLongf inflatedLength = entry->rawLength;
+    int status = uncompress((Bytef*)[inflated mutableBytes], &inflatedLength, _base + entry->dataOffset, entry->dataLength);
+    if ((status != Z_OK) || (inflatedLength != entry->rawLength)) {
+        CDVLogError(CDVLogCategoryURLProtocol, @"ERROR: failed to inflate www archive entry %@ (zlib status: %d)", path, status);
+        return nil;
+    }
+    return inflated;
+}
+
+@end
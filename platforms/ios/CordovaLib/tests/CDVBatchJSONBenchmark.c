@@ -0,0 +1,243 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ Decoding an exec batch into the node arena against decoding it into a tree
+ with one allocation per value, which is what NSJSONSerialization does (an
+ NSArray, NSDictionary, NSString or NSNumber for every value). Foundation is not
+ available here, so the tree decoder below stands in for it: a plain recursive
+ descent into malloc'd values with growing arrays, sharing only the string
+ unescaping with the arena decoder. Reported per command, for batches of 1 and
+ 64 commands (1M commands per row, times the scale argument).
+
+ The arena rows are the two ways CDVCommandBatch is used: parsing alone (the
+ queue only needs callback ids to coalesce), and parsing plus copying out the
+ callback id, service and action strings of every command.
+ */
+
+#include <string.h>
+#include "CDVBatchJSON.h"
+#include "CDVTest.h"
+
+static uint64_t gAllocations;
+static volatile uint64_t gChecksum; // keeps the work from being optimized away
+
+static void* countedMalloc(size_t size)
+{
+    gAllocations++;
+    return malloc(size);
+}
+
+static void* countedRealloc(void* pointer, size_t size)
+{
+    gAllocations++;
+    return realloc(pointer, size);
+}
+
+typedef struct TreeValue {
+    cdv_batch_type type;
+    double number;
+    char* string;
+    struct TreeValue** items; // array elements, or object keys and values in turn
+    size_t count;
+} TreeValue;
+
+typedef struct {
+    const uint8_t* bytes;
+    size_t length;
+    size_t pos;
+} TreeParser;
+
+static void treeSkipSpace(TreeParser* p)
+{
+    while ((p->pos < p->length) && strchr(" \t\n\r", p->bytes[p->pos]) && (p->bytes[p->pos] != '\0')) {
+        p->pos++;
+    }
+}
+
+static TreeValue* treeParse(TreeParser* p);
+
+static char* treeString(TreeParser* p)
+{
+    size_t start = ++p->pos;
+
+    while (p->bytes[p->pos] != '"') {
+        p->pos += (p->bytes[p->pos] == '\\') ? 2 : 1;
+    }
+    size_t length = p->pos++ - start;
+    char* string = countedMalloc(length + 1);
+    string[cdv_batch_unescape(p->bytes + start, length, (uint8_t*)string)] = '\0';
+    return string;
+}
+
+static void treeAppend(TreeValue* value, TreeValue* item, size_t* capacity)
+{
+    if (value->count == *capacity) {
+        *capacity = *capacity ? 2 * *capacity : 4;
+        value->items = countedRealloc(value->items, *capacity * sizeof(*value->items));
+    }
+    value->items[value->count++] = item;
+}
+
+static TreeValue* treeParse(TreeParser* p)
+{
+    TreeValue* value = countedMalloc(sizeof(*value));
+    memset(value, 0, sizeof(*value));
+    treeSkipSpace(p);
+    uint8_t c = p->bytes[p->pos];
+
+    if ((c == '[') || (c == '{')) {
+        size_t capacity = 0;
+        value->type = (c == '{') ? CDV_BATCH_OBJECT : CDV_BATCH_ARRAY;
+        p->pos++;
+        treeSkipSpace(p);
+        while (p->bytes[p->pos] != ((c == '{') ? '}' : ']')) {
+            if (c == '{') {
+                treeSkipSpace(p);
+                TreeValue* key = countedMalloc(sizeof(*key));
+                memset(key, 0, sizeof(*key));
+                key->type = CDV_BATCH_STRING;
+                key->string = treeString(p);
+                treeAppend(value, key, &capacity);
+                treeSkipSpace(p);
+                p->pos++; // ':'
+            }
+            treeAppend(value, treeParse(p), &capacity);
+            treeSkipSpace(p);
+            if (p->bytes[p->pos] == ',') {
+                p->pos++;
+            }
+        }
+        p->pos++;
+    } else if (c == '"') {
+        value->type = CDV_BATCH_STRING;
+        value->string = treeString(p);
+    } else if (c == 't') {
+        value->type = CDV_BATCH_TRUE;
+        p->pos += 4;
+    } else if (c == 'f') {
+        value->type = CDV_BATCH_FALSE;
+        p->pos += 5;
+    } else if (c == 'n') {
+        value->type = CDV_BATCH_NULL;
+        p->pos += 4;
+    } else {
+        char* end = NULL;
+        value->type = CDV_BATCH_NUMBER;
+        value->number = strtod((const char*)p->bytes + p->pos, &end);
+        p->pos = end - (const char*)p->bytes;
+    }
+    return value;
+}
+
+static void treeFree(TreeValue* value)
+{
+    for (size_t i = 0; i < value->count; ++i) {
+        treeFree(value->items[i]);
+    }
+    free(value->items);
+    free(value->string);
+    free(value);
+}
+
+static const char kCommand[] =
+    "[\"ScanditSDK%u\",\"ScanditSDK\",\"scan\",[\"appKey-0123456789abcdef\",{\"beep\":true,\"vibrate\":true,"
+    "\"code128\":false,\"dataMatrix\":true,\"searchBar\":false,\"orientation\":\"portrait\",\"scanningHotspot\":"
+    "\"0.5/0.5\",\"titleBar\":\"Scan a barcode \\u2014 hold steady\"},1.5,{\"CDVType\":\"ArrayBuffer\","
+    "\"data\":\"aGVsbG8gd29ybGQsIHRoaXMgaXMgYSBiYXJjb2RlIGZyYW1l\"}]]";
+
+// A batch of the given number of commands, as cordova.js sends them.
+static char* makeBatch(unsigned commands, size_t* length)
+{
+    char* batch = malloc(commands * (sizeof(kCommand) + 16) + 2);
+    size_t n = 0;
+
+    batch[n++] = '[';
+    for (unsigned i = 0; i < commands; ++i) {
+        if (i > 0) {
+            batch[n++] = ',';
+        }
+        n += sprintf(batch + n, kCommand, i);
+    }
+    batch[n++] = ']';
+    batch[n] = '\0';
+    *length = n;
+    return batch;
+}
+
+static void report(const char* name, unsigned commands, uint64_t total, double elapsed, uint64_t allocations)
+{
+    printf("%-32s %3u commands: %8.1f ns/command, %6.2f allocations/command\n", name, commands,
+        elapsed * 1e9 / total, (double)allocations / total);
+}
+
+static void run(unsigned commands, uint64_t total)
+{
+    size_t length = 0;
+    char* batch = makeBatch(commands, &length);
+    const uint8_t* bytes = (const uint8_t*)batch;
+    uint64_t rounds = total / commands;
+    uint64_t checksum = 0;
+
+    total = rounds * commands;
+    for (int mode = 0; mode < 3; ++mode) {
+        gAllocations = 0;
+        double start = cdv_test_now();
+        for (uint64_t round = 0; round < rounds; ++round) {
+            if (mode == 2) {
+                TreeParser parser = {bytes, length, 0};
+                TreeValue* root = treeParse(&parser);
+                checksum += root->count;
+                treeFree(root);
+                continue;
+            }
+            // One block for the nodes and the entry index, as CDVCommandBatch allocates it.
+            uint32_t capacity = cdv_batch_node_bound(bytes, length);
+            cdv_batch_node* nodes = countedMalloc((size_t)capacity * (sizeof(cdv_batch_node) + sizeof(uint32_t)));
+            size_t errorOffset = 0;
+            uint32_t count = cdv_batch_parse(bytes, length, nodes, capacity, &errorOffset);
+            checksum += count;
+            if ((mode == 1) && (count > 0)) {
+                for (uint32_t entry = 1; entry < nodes[0].end; entry = nodes[entry].end) {
+                    for (uint32_t field = entry + 1; field < entry + 4; field = nodes[field].end) {
+                        char* string = countedMalloc(nodes[field].length + 1);
+                        string[cdv_batch_unescape(bytes + nodes[field].start, nodes[field].length,
+                            (uint8_t*)string)] = '\0';
+                        checksum += (uint8_t)string[0];
+                        free(string);
+                    }
+                }
+            }
+            free(nodes);
+        }
+        static const char* names[] = {"arena, parse only", "arena, callback/service/action", "tree (one malloc per value)"};
+        report(names[mode], commands, total, cdv_test_now() - start, gAllocations);
+    }
+    free(batch);
+    gChecksum += checksum;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t total = (uint64_t)(1000000 * cdv_bench_scale(argc, argv));
+
+    run(1, total);
+    run(64, total);
+    return 0;
+}
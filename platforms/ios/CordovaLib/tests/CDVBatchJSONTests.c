@@ -0,0 +1,410 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ The batch decoder behind CDVCommandBatch: node layout, string escapes and
+ surrogates, number conversion, ArrayBuffer arguments and their base64, and
+ malformed payloads, which must fail cleanly at the right offset and never need
+ more nodes than cdv_batch_node_bound() promised.
+ */
+
+#include <locale.h>
+#include <math.h>
+#include <string.h>
+#include "CDVBatchJSON.h"
+#include "CDVTest.h"
+
+enum { kMaxNodes = 4096 };
+
+static cdv_batch_node gNodes[kMaxNodes];
+static const uint8_t* gBytes;
+
+// Parses a payload into gNodes, checking the bound; returns the node count.
+static uint32_t parse(const char* json, size_t length, size_t* errorOffset)
+{
+    uint32_t bound = cdv_batch_node_bound((const uint8_t*)json, length);
+    size_t offset = (size_t)-1;
+
+    CHECK(bound > 0 && bound <= kMaxNodes);
+    gBytes = (const uint8_t*)json;
+    uint32_t count = cdv_batch_parse(gBytes, length, gNodes, bound, &offset);
+    CHECK(count <= bound);
+    if (count == 0) {
+        CHECK(offset <= length);
+    }
+    if (errorOffset != NULL) {
+        *errorOffset = offset;
+    }
+    return count;
+}
+
+static uint32_t parseString(const char* json)
+{
+    return parse(json, strlen(json), NULL);
+}
+
+// Whether a string node unescapes to the given bytes.
+static int unescapesTo(uint32_t node, const char* expected)
+{
+    uint8_t out[256];
+
+    if ((gNodes[node].type != CDV_BATCH_STRING) || (gNodes[node].length > sizeof(out))) {
+        return 0;
+    }
+    size_t length = cdv_batch_unescape(gBytes + gNodes[node].start, gNodes[node].length, out);
+    return (length <= gNodes[node].length) && (length == strlen(expected)) && (memcmp(out, expected, length) == 0);
+}
+
+static void testStructure(void)
+{
+    CHECK(parseString(" [1, \"two\", [true, false, null], {\"k\": 2, \"j\": [], \"k\": \"last\"}, []] ") == 15);
+    CHECK(gNodes[0].type == CDV_BATCH_ARRAY && gNodes[0].count == 5 && gNodes[0].end == 15);
+    CHECK(gNodes[1].type == CDV_BATCH_NUMBER && gNodes[1].length == 1);
+    CHECK(gNodes[2].type == CDV_BATCH_STRING && !gNodes[2].escaped && gNodes[2].length == 3);
+    CHECK(cdv_batch_is_string(gNodes, gBytes, 2, "two") && !cdv_batch_is_string(gNodes, gBytes, 2, "tw"));
+    CHECK(!cdv_batch_is_string(gNodes, gBytes, 1, "1"));
+
+    uint32_t inner = cdv_batch_child(gNodes, 0, 2);
+    CHECK(inner == 3 && gNodes[inner].count == 3 && gNodes[inner].end == 7);
+    CHECK(gNodes[cdv_batch_child(gNodes, inner, 0)].type == CDV_BATCH_TRUE);
+    CHECK(gNodes[cdv_batch_child(gNodes, inner, 1)].type == CDV_BATCH_FALSE);
+    CHECK(gNodes[cdv_batch_child(gNodes, inner, 2)].type == CDV_BATCH_NULL);
+    CHECK(memcmp(gBytes + gNodes[inner].start, "[true, false, null]", gNodes[inner].length) == 0);
+
+    uint32_t object = cdv_batch_child(gNodes, 0, 3);
+    CHECK(gNodes[object].type == CDV_BATCH_OBJECT && gNodes[object].count == 3);
+    uint32_t k = cdv_batch_member(gNodes, gBytes, object, "k");
+    CHECK(cdv_batch_is_string(gNodes, gBytes, k, "last")); // the last one wins
+    uint32_t j = cdv_batch_member(gNodes, gBytes, object, "j");
+    CHECK(gNodes[j].type == CDV_BATCH_ARRAY && gNodes[j].count == 0 && gNodes[j].end == j + 1);
+    CHECK(cdv_batch_member(gNodes, gBytes, object, "missing") == 0);
+    CHECK(cdv_batch_member(gNodes, gBytes, object, "") == 0);
+
+    uint32_t last = cdv_batch_child(gNodes, 0, 4);
+    CHECK(gNodes[last].type == CDV_BATCH_ARRAY && gNodes[last].end == 15);
+
+    // Any value may be the root; CDVCommandBatch rejects all but arrays itself.
+    CHECK(parseString("{\"a\": 1}") == 3 && gNodes[0].type == CDV_BATCH_OBJECT);
+    CHECK(parseString("\"s\"") == 1 && gNodes[0].type == CDV_BATCH_STRING);
+    CHECK(parseString("-0.5e+3") == 1 && gNodes[0].type == CDV_BATCH_NUMBER && gNodes[0].length == 7);
+
+    // Escaped keys never match, as CDVCommandBatch only looks up plain ones.
+    CHECK(parseString("{\"CDV\\u0054ype\": 1}") == 3);
+    CHECK(cdv_batch_member(gNodes, gBytes, 0, "CDVType") == 0);
+}
+
+static void testEscapes(void)
+{
+    CHECK(parseString("[\"plain\", \"q\\\"b\\\\s\\/b\\bf\\fn\\nr\\rt\\t\", \"caf\xc3\xa9\"]") == 4);
+    CHECK(!gNodes[1].escaped && unescapesTo(1, "plain"));
+    CHECK(gNodes[2].escaped && unescapesTo(2, "q\"b\\s/b\bf\fn\nr\rt\t"));
+    CHECK(unescapesTo(3, "caf\xc3\xa9")); // UTF-8 passes through
+
+    CHECK(parseString("[\"\\u0041\\u00e9\\u20AC\\u0000\"]") == 2);
+    uint8_t out[16];
+    CHECK(cdv_batch_unescape(gBytes + gNodes[1].start, gNodes[1].length, out) == 7);
+    CHECK(memcmp(out, "A\xc3\xa9\xe2\x82\xac\0", 7) == 0);
+
+    // A surrogate pair is one four-byte character.
+    CHECK(parseString("[\"\\ud83d\\ude00\", \"\\uD834\\uDD1E!\"]") == 3);
+    CHECK(unescapesTo(1, "\xf0\x9f\x98\x80"));
+    CHECK(unescapesTo(2, "\xf0\x9d\x84\x9e!"));
+
+    // Lone surrogates become U+FFFD, without swallowing what follows.
+    CHECK(parseString("[\"\\ud83d\", \"\\ud83dx\", \"\\ude00\", \"\\ud83d\\u0041\", \"\\ud83d\\ud83d\\ude00\", "
+        "\"\\ude00\\ud83d\"]") == 7);
+    CHECK(unescapesTo(1, "\xef\xbf\xbd"));
+    CHECK(unescapesTo(2, "\xef\xbf\xbdx"));
+    CHECK(unescapesTo(3, "\xef\xbf\xbd"));
+    CHECK(unescapesTo(4, "\xef\xbf\xbd" "A"));
+    CHECK(unescapesTo(5, "\xef\xbf\xbd\xf0\x9f\x98\x80"));
+    CHECK(unescapesTo(6, "\xef\xbf\xbd\xef\xbf\xbd"));
+
+    // The escape sequences with the least room: six bytes for three of UTF-8.
+    CHECK(parseString("[\"\\uffff\\u0800\"]") == 2);
+    CHECK(unescapesTo(1, "\xef\xbf\xbf\xe0\xa0\x80"));
+}
+
+static int isInteger(const char* text, int64_t expected)
+{
+    int64_t integer = 0;
+    double real = 0;
+
+    return cdv_batch_number((const uint8_t*)text, strlen(text), &integer, &real) && (integer == expected);
+}
+
+static int isReal(const char* text, double expected)
+{
+    int64_t integer = 0;
+    double real = 0;
+
+    return !cdv_batch_number((const uint8_t*)text, strlen(text), &integer, &real) && (real == expected);
+}
+
+static void testNumbers(void)
+{
+    CHECK(isInteger("0", 0));
+    CHECK(isInteger("-0", 0));
+    CHECK(isInteger("42", 42));
+    CHECK(isInteger("-17", -17));
+    CHECK(isInteger("9223372036854775807", INT64_MAX));
+    CHECK(isInteger("-9223372036854775808", INT64_MIN));
+    // Out of 64 bits becomes a double instead of clamping.
+    CHECK(isReal("9223372036854775808", 9223372036854775808.0));
+    CHECK(isReal("-9223372036854775809", -9223372036854775808.0));
+    CHECK(isReal("100000000000000000000000000000", 1e29));
+    CHECK(isReal("1.5", 1.5));
+    CHECK(isReal("-0.25", -0.25));
+    CHECK(isReal("1e3", 1000));
+    CHECK(isReal("1E+3", 1000));
+    CHECK(isReal("-2.5e-2", -0.025));
+    CHECK(isReal("1.0", 1));
+    CHECK(isReal("1e400", HUGE_VAL));
+    // Longer than the stack buffer.
+    CHECK(isReal("0.000000000000000000000000000000000000000000000000000000000000000000000001", 1e-72));
+
+    // The decimal point does not follow the user's locale.
+    const char* locales[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "ru_RU.UTF-8"};
+    const char* locale = NULL;
+    for (size_t i = 0; (i < sizeof(locales) / sizeof(locales[0])) && (locale == NULL); ++i) {
+        locale = setlocale(LC_NUMERIC, locales[i]);
+    }
+    if (locale != NULL) {
+        CHECK(isReal("1.5", 1.5));
+        CHECK(isReal("-2.5e-2", -0.025));
+        setlocale(LC_NUMERIC, "C");
+    } else {
+        printf("no locale with a decimal comma installed, skipping the locale check\n");
+    }
+}
+
+// Decodes the ArrayBuffer argument at the root of a payload; -1 if it is not one.
+static long arrayBuffer(const char* json, uint8_t* out, size_t size)
+{
+    CHECK(parseString(json) > 0);
+    uint32_t data = cdv_batch_array_buffer_data(gNodes, gBytes, 0);
+    if (data == 0) {
+        return -1;
+    }
+    CHECK(cdv_batch_array_buffer_capacity(gNodes, data) <= size);
+    return (long)cdv_batch_array_buffer_decode(gNodes, gBytes, data, out);
+}
+
+static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t encode(const uint8_t* bytes, size_t length, char* out, int padded)
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t group = (uint32_t)bytes[i] << 16;
+        size_t left = length - i;
+        group |= (left > 1) ? (uint32_t)bytes[i + 1] << 8 : 0;
+        group |= (left > 2) ? bytes[i + 2] : 0;
+        out[n++] = kAlphabet[(group >> 18) & 63];
+        out[n++] = kAlphabet[(group >> 12) & 63];
+        if ((left > 1) || padded) {
+            out[n++] = (left > 1) ? kAlphabet[(group >> 6) & 63] : '=';
+        }
+        if ((left > 2) || padded) {
+            out[n++] = (left > 2) ? kAlphabet[group & 63] : '=';
+        }
+    }
+    return n;
+}
+
+static void testArrayBuffer(void)
+{
+    uint8_t out[512];
+
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"aGVsbG8=\"}", out, sizeof(out)) == 5);
+    CHECK(memcmp(out, "hello", 5) == 0);
+    CHECK(arrayBuffer("{\"data\": \"aGVsbG8\", \"CDVType\": \"ArrayBuffer\"}", out, sizeof(out)) == 5);
+    CHECK(memcmp(out, "hello", 5) == 0);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"\"}", out, sizeof(out)) == 0);
+    // "\/" is how JSON.stringify may write a slash; the backslash is skipped.
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"\\/\\/\\/\\/+A==\"}", out, sizeof(out)) == 4);
+    CHECK(memcmp(out, "\xff\xff\xff\xf8", 4) == 0);
+    // Escaped line breaks (not an 'n' to decode), trailing junk and a dangling
+    // character carry no bytes; other escapes are undone first.
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"aGVs\\r\\nbG8=\\n\\n\\t\\n\"}", out, sizeof(out)) == 5);
+    CHECK(memcmp(out, "hello", 5) == 0);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"\\u0061GVsbG8\\u003d\"}", out, sizeof(out)) == 5);
+    CHECK(memcmp(out, "hello", 5) == 0);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"aGVsbG8hQ\"}", out, sizeof(out)) == 6);
+    CHECK(memcmp(out, "hello!", 6) == 0);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"\\/\"}", out, sizeof(out)) == 0);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": \"====!!!!\"}", out, sizeof(out)) == 0);
+
+    CHECK(arrayBuffer("{\"CDVType\": \"Arraybuffer\", \"data\": \"aGVsbG8=\"}", out, sizeof(out)) == -1);
+    CHECK(arrayBuffer("{\"CDVType\": \"Array\\u0042uffer\", \"data\": \"aGVsbG8=\"}", out, sizeof(out)) == -1);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\", \"data\": 5}", out, sizeof(out)) == -1);
+    CHECK(arrayBuffer("{\"CDVType\": \"ArrayBuffer\"}", out, sizeof(out)) == -1);
+    CHECK(arrayBuffer("{\"data\": \"aGVsbG8=\"}", out, sizeof(out)) == -1);
+    CHECK(arrayBuffer("[\"ArrayBuffer\", \"aGVsbG8=\"]", out, sizeof(out)) == -1);
+
+    // Random data, padded or not, with random junk in between, decoded into a
+    // buffer of exactly the promised capacity followed by a guard.
+    uint32_t state = 1;
+    for (int round = 0; round < 2000; ++round) {
+        uint8_t data[96];
+        char text[384];
+        char noisy[768];
+        size_t length = cdv_test_random(&state) % sizeof(data);
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = (uint8_t)cdv_test_random(&state);
+        }
+        size_t textLength = encode(data, length, text, round & 1);
+        size_t noisyLength = 0;
+        for (size_t i = 0; i <= textLength; ++i) {
+            while (cdv_test_random(&state) % 4 == 0) {
+                noisy[noisyLength++] = "=\n\r \\!-_."[cdv_test_random(&state) % 9];
+            }
+            if (i < textLength) {
+                noisy[noisyLength++] = text[i];
+            }
+        }
+        size_t capacity = cdv_batch_base64_capacity(noisyLength);
+        memset(out, 0xa5, sizeof(out));
+        size_t decoded = cdv_batch_base64_decode((const uint8_t*)noisy, noisyLength, out);
+        CHECK(decoded == length && memcmp(out, data, length) == 0);
+        CHECK(decoded <= capacity);
+        for (size_t i = capacity; i < capacity + 8; ++i) {
+            CHECK(out[i] == 0xa5);
+        }
+    }
+    // The capacity is tight for every length of pure base64.
+    memset(out, 'A', 64);
+    for (size_t length = 0; length < 64; ++length) {
+        size_t decoded = cdv_batch_base64_decode(out, length, out + 64);
+        CHECK(decoded == length * 3 / 4 && decoded <= cdv_batch_base64_capacity(length));
+    }
+}
+
+static void expectError(const char* json, size_t offset)
+{
+    size_t errorOffset = 0;
+    uint32_t count = parse(json, strlen(json), &errorOffset);
+
+    CHECK(count == 0);
+    if ((count != 0) || (errorOffset != offset)) {
+        fprintf(stderr, "  '%s': %u nodes, error at %lu, expected %lu\n", json, count, (unsigned long)errorOffset,
+            (unsigned long)offset);
+    }
+}
+
+static void testMalformed(void)
+{
+    expectError("", 0);
+    expectError("   ", 3);
+    expectError("[", 1);
+    expectError("[1,", 3);
+    expectError("[1,]", 3);
+    expectError("[,1]", 1);
+    expectError("[1 2]", 3);
+    expectError("[1]]", 3);
+    expectError("[1] x", 4);
+    expectError("[1, x]", 4);
+    expectError("{\"a\"}", 4);
+    expectError("{\"a\":}", 5);
+    expectError("{a:1}", 1);
+    expectError("{\"a\":1,}", 7);
+    expectError("[tru]", 1);
+    expectError("[nul]", 1);
+    expectError("[1,nulL]", 3);
+    expectError("[truex]", 5);
+    expectError("[-]", 2);
+    expectError("[1.]", 3);
+    expectError("[.5]", 1);
+    expectError("[1e]", 3);
+    expectError("[1e+]", 4);
+    expectError("[+1]", 1);
+    // Strings: unterminated, raw control characters, bad escapes.
+    expectError("[\"abc", 5);
+    expectError("[\"abc\\\"]", 8);
+    expectError("[\"a\tb\"]", 3);
+    expectError("[\"a\nb\"]", 3);
+    expectError("[\"\\x\"]", 3);
+    expectError("[\"\\U0041\"]", 3);
+    expectError("[\"\\u12\"]", 3);
+    expectError("[\"\\u12G4\"]", 3);
+    expectError("[\"\\u", 3);
+    expectError("[\"\\", 3);
+    // A NUL byte is neither white space nor a value.
+    size_t errorOffset = 0;
+    CHECK(parse("[1]\0", 4, &errorOffset) == 0 && errorOffset == 3);
+    CHECK(parse("[\"a\0\"]", 6, &errorOffset) == 0 && errorOffset == 3);
+
+    // Nesting: 513 levels are fine, 514 are not.
+    char deep[2 * 600 + 1];
+    for (int levels = 512; levels <= 514; ++levels) {
+        memset(deep, '[', levels);
+        memset(deep + levels, ']', levels);
+        deep[2 * levels] = '\0';
+        uint32_t count = parse(deep, 2 * levels, &errorOffset);
+        CHECK((levels <= CDV_BATCH_MAX_DEPTH + 1) ? (count == (uint32_t)levels) : (count == 0));
+    }
+
+    // Too small an arena fails instead of overrunning it.
+    cdv_batch_node small[3];
+    CHECK(cdv_batch_parse((const uint8_t*)"[1,2,3]", 7, small, 3, &errorOffset) == 0);
+    CHECK(cdv_batch_parse((const uint8_t*)"[1,2]", 5, small, 3, &errorOffset) == 3);
+}
+
+// Random single-byte corruptions of a realistic batch: whatever parses must
+// stay within the bound and describe consistent spans.
+static void testMutations(void)
+{
+    static const char kBatch[] = "[[\"Scandit1\",\"ScanditSDK\",\"scan\",[\"key\",{\"beep\":true,\"code128\":false,"
+        "\"text\":\"caf\\u00e9 \\ud83d\\ude00\"},-1.5e3,{\"CDVType\":\"ArrayBuffer\",\"data\":\"aGVsbG8=\"}]],"
+        "[\"Device2\",\"Device\",\"getDeviceInfo\",[]]]";
+    static const char kBytes[] = "[]{},:\"\\0123456789.eE+-tfnu \t\nxA\x01\xff";
+    char json[sizeof(kBatch)];
+    uint32_t state = 7;
+
+    CHECK(parseString(kBatch) > 0);
+    for (int round = 0; round < 20000; ++round) {
+        memcpy(json, kBatch, sizeof(kBatch));
+        for (int edits = 1 + cdv_test_random(&state) % 3; edits > 0; --edits) {
+            json[cdv_test_random(&state) % (sizeof(kBatch) - 1)] = kBytes[cdv_test_random(&state) % (sizeof(kBytes) - 1)];
+        }
+        size_t length = sizeof(kBatch) - 1;
+        size_t errorOffset = 0;
+        uint32_t count = parse(json, length, &errorOffset);
+        for (uint32_t i = 0; i < count; ++i) {
+            CHECK(gNodes[i].end > i && gNodes[i].end <= count);
+            CHECK((size_t)gNodes[i].start + gNodes[i].length <= length);
+            if (gNodes[i].type == CDV_BATCH_STRING) {
+                uint8_t out[sizeof(kBatch)];
+                CHECK(cdv_batch_unescape(gBytes + gNodes[i].start, gNodes[i].length, out) <= gNodes[i].length);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    testStructure();
+    testEscapes();
+    testNumbers();
+    testArrayBuffer();
+    testMalformed();
+    testMutations();
+    return cdv_test_result();
+}
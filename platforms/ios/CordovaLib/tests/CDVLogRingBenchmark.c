@@ -0,0 +1,119 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ Cost of a log ring write with 1 to 8 writer threads, against the same copy
+ into a ring guarded by a mutex, and the cost of a full snapshot. 2M writes in
+ total per row (times the scale argument).
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include "CDVLogRing.h"
+#include "CDVTest.h"
+
+static cdv_log_ring gRing;
+static pthread_mutex_t gMutex = PTHREAD_MUTEX_INITIALIZER;
+static const char kMessage[] = "exec: CDVCommandQueue executed Scandit.scan in 2.4 ms";
+
+typedef struct {
+    uint64_t count;
+    int locked;
+} Writer;
+
+static void* writerThread(void* argument)
+{
+    Writer* writer = argument;
+    size_t length = sizeof(kMessage) - 1;
+
+    for (uint64_t n = 0; n < writer->count; ++n) {
+        if (writer->locked) {
+            // The same slot copy, serialized by a lock instead of the sequence numbers.
+            pthread_mutex_lock(&gMutex);
+            cdv_log_record* record = &gRing.records[gRing.head++ & (CDV_LOG_RING_CAPACITY - 1)];
+            record->timestamp = (double)n;
+            record->level = 3;
+            record->category = 1;
+            record->length = (uint16_t)length;
+            memcpy(record->message, kMessage, length);
+            record->message[length] = '\0';
+            pthread_mutex_unlock(&gMutex);
+        } else {
+            cdv_log_ring_write(&gRing, 3, 1, (double)n, kMessage, length);
+        }
+    }
+    return NULL;
+}
+
+static double run(unsigned threads, uint64_t total, int locked)
+{
+    pthread_t ids[8];
+    Writer writers[8];
+
+    cdv_log_ring_init(&gRing);
+    double start = cdv_test_now();
+    for (unsigned i = 0; i < threads; ++i) {
+        writers[i].count = total / threads;
+        writers[i].locked = locked;
+        pthread_create(&ids[i], NULL, writerThread, &writers[i]);
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        pthread_join(ids[i], NULL);
+    }
+    return cdv_test_now() - start;
+}
+
+static void countRecord(const cdv_log_record* record, void* context)
+{
+    *(size_t*)context += record->length;
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t total = (uint64_t)(2000000 * cdv_bench_scale(argc, argv));
+    static const unsigned kThreads[] = { 1, 2, 4, 8 };
+    int result = 0;
+
+    printf("writers  lock-free ns/write  mutex ns/write  dropped\n");
+    for (size_t i = 0; i < sizeof(kThreads) / sizeof(kThreads[0]); ++i) {
+        uint64_t writes = total / kThreads[i] * kThreads[i];
+        double lockFree = run(kThreads[i], writes, 0);
+        uint64_t dropped = cdv_log_ring_dropped(&gRing);
+        if (cdv_log_ring_count(&gRing) != writes) {
+            result = 1;
+        }
+        double locked = run(kThreads[i], writes, 1);
+        printf("%7u  %18.1f  %14.1f  %7lu\n", kThreads[i], lockFree * 1e9 / writes, locked * 1e9 / writes,
+            (unsigned long)dropped);
+    }
+
+    cdv_log_ring_init(&gRing);
+    for (int n = 0; n < CDV_LOG_RING_CAPACITY; ++n) {
+        cdv_log_ring_write(&gRing, 3, 1, n, kMessage, sizeof(kMessage) - 1);
+    }
+    unsigned snapshots = (unsigned)(total / 1000) + 1;
+    size_t bytes = 0, visited = 0;
+    double start = cdv_test_now();
+    for (unsigned i = 0; i < snapshots; ++i) {
+        visited += cdv_log_ring_snapshot(&gRing, countRecord, &bytes);
+    }
+    double elapsed = cdv_test_now() - start;
+    printf("snapshot of %d records: %.1f us\n", CDV_LOG_RING_CAPACITY, elapsed * 1e6 / snapshots);
+    return (result == 0 && visited == (size_t)snapshots * CDV_LOG_RING_CAPACITY) ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ Single-threaded behaviour of the log ring, then several writers racing a
+ reader that snapshots continuously. Every record carries its writer and
+ per-writer number and a payload derived from them, so a torn copy (a payload
+ from one write under the header of another) is detected, as is a record seen
+ out of order. Built twice: with the real capacity and with a tiny one, where
+ writers lap each other all the time.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include "CDVLogRing.h"
+#include "CDVTest.h"
+
+enum { kWriters = 8 };
+
+static cdv_log_ring gRing;
+
+// Message length and fill byte of a writer's n-th record.
+static size_t messageLength(unsigned writer, uint64_t n)
+{
+    return (size_t)((writer * 31 + n * 7) % (CDV_LOG_RING_MESSAGE_MAX - 1)) + 1;
+}
+
+static char messageByte(unsigned writer, uint64_t n)
+{
+    return (char)('A' + (writer * 7 + n) % 26);
+}
+
+static void writeRecord(unsigned writer, uint64_t n)
+{
+    char message[CDV_LOG_RING_MESSAGE_MAX];
+    size_t length = messageLength(writer, n);
+
+    memset(message, messageByte(writer, n), length);
+    cdv_log_ring_write(&gRing, (uint8_t)writer, (uint8_t)n, (double)n, message, length);
+}
+
+typedef struct {
+    uint64_t last[kWriters]; // 1 + number of the last record seen per writer, 0 for none
+    size_t records;
+    size_t torn;
+    size_t unordered;
+} Check;
+
+static void checkRecord(const cdv_log_record* record, void* context)
+{
+    Check* check = context;
+    unsigned writer = record->level;
+    uint64_t n = (uint64_t)record->timestamp;
+    int intact = writer < kWriters && record->category == (uint8_t)n &&
+        record->length == messageLength(writer, n) && record->message[record->length] == '\0';
+
+    for (size_t i = 0; intact && i < record->length; ++i) {
+        intact = record->message[i] == messageByte(writer, n);
+    }
+    ++check->records;
+    if (!intact) {
+        ++check->torn;
+        return;
+    }
+    // Records come oldest first, so one writer's numbers increase.
+    if (n + 1 <= check->last[writer]) {
+        ++check->unordered;
+    }
+    check->last[writer] = n + 1;
+}
+
+static void testSingleWriter(void)
+{
+    Check check;
+
+    cdv_log_ring_init(&gRing);
+    memset(&check, 0, sizeof(check));
+    CHECK(cdv_log_ring_snapshot(&gRing, checkRecord, &check) == 0 && cdv_log_ring_count(&gRing) == 0);
+
+    // Overwrites the oldest and keeps the newest in order.
+    for (uint64_t n = 0; n < CDV_LOG_RING_CAPACITY + 10; ++n) {
+        writeRecord(0, n);
+    }
+    CHECK(cdv_log_ring_count(&gRing) == CDV_LOG_RING_CAPACITY + 10);
+    CHECK(cdv_log_ring_snapshot(&gRing, checkRecord, &check) == CDV_LOG_RING_CAPACITY);
+    CHECK(check.torn == 0 && check.unordered == 0 && check.last[0] == CDV_LOG_RING_CAPACITY + 10);
+    CHECK(cdv_log_ring_dropped(&gRing) == 0 && gRing.skipped == 0);
+
+    // Long messages are cut to fit and stay terminated.
+    char message[2 * CDV_LOG_RING_MESSAGE_MAX];
+    memset(message, 'x', sizeof(message));
+    cdv_log_ring_init(&gRing);
+    cdv_log_ring_write(&gRing, 1, 2, 3.0, message, sizeof(message));
+    const cdv_log_record* record = &gRing.records[0];
+    CHECK(record->length == CDV_LOG_RING_MESSAGE_MAX - 1 && record->message[record->length] == '\0');
+    CHECK(record->level == 1 && record->category == 2 && record->timestamp == 3.0);
+}
+
+typedef struct {
+    unsigned writer;
+    uint64_t count;
+} Writer;
+
+static void* writerThread(void* argument)
+{
+    Writer* writer = argument;
+
+    for (uint64_t n = 0; n < writer->count; ++n) {
+        writeRecord(writer->writer, n);
+    }
+    return NULL;
+}
+
+static void testConcurrentWriters(uint64_t perWriter)
+{
+    pthread_t threads[kWriters];
+    Writer writers[kWriters];
+    Check total;
+    size_t snapshots = 0;
+
+    cdv_log_ring_init(&gRing);
+    memset(&total, 0, sizeof(total));
+    for (unsigned i = 0; i < kWriters; ++i) {
+        writers[i].writer = i;
+        writers[i].count = perWriter;
+        pthread_create(&threads[i], NULL, writerThread, &writers[i]);
+    }
+    while (cdv_log_ring_count(&gRing) < kWriters * perWriter) {
+        Check check;
+        memset(&check, 0, sizeof(check));
+        cdv_log_ring_snapshot(&gRing, checkRecord, &check);
+        total.records += check.records;
+        total.torn += check.torn;
+        total.unordered += check.unordered;
+        ++snapshots;
+    }
+    for (unsigned i = 0; i < kWriters; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    Check check;
+    memset(&check, 0, sizeof(check));
+    size_t visited = cdv_log_ring_snapshot(&gRing, checkRecord, &check);
+    uint64_t dropped = cdv_log_ring_dropped(&gRing);
+    printf("capacity %d: %lu snapshots, %lu records checked, %lu torn, %lu out of order, %lu dropped, "
+        "%lu in the final one\n", CDV_LOG_RING_CAPACITY, (unsigned long)snapshots, (unsigned long)total.records,
+        (unsigned long)total.torn, (unsigned long)total.unordered, (unsigned long)dropped, (unsigned long)visited);
+    CHECK(total.torn == 0 && total.unordered == 0);
+    CHECK(check.torn == 0 && check.unordered == 0);
+    CHECK(cdv_log_ring_count(&gRing) == kWriters * perWriter);
+    // Once the writers are done every slot holds a complete record, unless its
+    // last ticket was skipped (or the record dropped) because the slot was busy.
+    CHECK(visited <= CDV_LOG_RING_CAPACITY && visited + gRing.skipped + dropped >= CDV_LOG_RING_CAPACITY);
+}
+
+int main(void)
+{
+    testSingleWriter();
+    testConcurrentWriters(200000);
+    return cdv_test_result();
+}
@@ -0,0 +1,86 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ Minimal harness for the Linux tests and benchmarks of the portable C cores in
+ Classes (see CMakeLists.txt).
+
+ CHECK records a failure and carries on, so one run reports every broken case;
+ a test's main returns cdv_test_result(). Benchmarks take an optional scale
+ factor as their only argument, which ctest sets low to keep them as smoke
+ tests; run them by hand without it for real numbers.
+ */
+
+#ifndef CDV_TEST_H
+#define CDV_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static int cdv_test_failures = 0;
+
+#define CHECK(expression) \
+    ((expression) ? (void)0 : cdv_test_fail(__FILE__, __LINE__, #expression))
+
+static inline void cdv_test_fail(const char* file, int line, const char* expression)
+{
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    __atomic_fetch_add(&cdv_test_failures, 1, __ATOMIC_RELAXED);
+}
+
+static inline int cdv_test_result(void)
+{
+    if (cdv_test_failures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", cdv_test_failures);
+        return 1;
+    }
+    return 0;
+}
+
+// Seconds on a monotonic clock.
+static inline double cdv_test_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// The scale argument of a benchmark, 1 without one.
+static inline double cdv_bench_scale(int argc, char** argv)
+{
+    double scale = argc > 1 ? atof(argv[1]) : 1;
+
+    return scale > 0 ? scale : 1;
+}
+
+// Deterministic xorshift32, so failures reproduce on every machine.
+static inline uint32_t cdv_test_random(uint32_t* state)
+{
+    uint32_t x = *state ? *state : 2463534242u;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+#endif /* CDV_TEST_H */
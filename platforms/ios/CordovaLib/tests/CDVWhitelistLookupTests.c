@@ -0,0 +1,125 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ The C whitelist lookups against the regular expression matcher of CDVWhitelist.m.
+ CMakeLists.txt runs cordova/lib/gen-whitelist-table.js on each config in
+ whitelist/, which writes the table this is linked with and a corpus of URLs
+ derived from the origins, each with the decisions of the generator's port of
+ the regular expressions (see its corpus()). Every URL must get the same
+ decisions from the table.
+
+ Usage: CDVWhitelistLookupTests <corpus>
+ */
+
+#include <string.h>
+#include "CDVWhitelistLookup.h"
+#include "CDVTest.h"
+
+extern const cdv_whitelist_table cdv_generated_whitelist_table;
+
+enum { kMaxField = 4096, kMaxMismatchesShown = 20 };
+
+// Decodes a corpus string ("-" for none, "=" and hex bytes otherwise) into buffer.
+// Returns 0 if the field is malformed.
+static int decodeField(const char* field, char* buffer, const char** value)
+{
+    if (strcmp(field, "-") == 0) {
+        *value = NULL;
+        return 1;
+    }
+    size_t length = strlen(field);
+    if ((field[0] != '=') || (length % 2 != 1) || (length / 2 >= kMaxField)) {
+        return 0;
+    }
+    for (size_t i = 0; i < length / 2; ++i) {
+        unsigned byte;
+        if (sscanf(field + 1 + 2 * i, "%2x", &byte) != 1) {
+            return 0;
+        }
+        buffer[i] = (char)byte;
+    }
+    buffer[length / 2] = '\0';
+    *value = buffer;
+    return 1;
+}
+
+// A printable form of a URL part for failure messages.
+static const char* show(const char* value, char* buffer)
+{
+    size_t n = 0;
+
+    if (value == NULL) {
+        return "(none)";
+    }
+    for (; (*value != '\0') && (n < 200); ++value) {
+        n += (*value >= 0x20 && *value < 0x7f) ? (size_t)sprintf(buffer + n, "%c", *value)
+                                               : (size_t)sprintf(buffer + n, "\\x%02x", (uint8_t)*value);
+    }
+    buffer[n] = '\0';
+    return buffer;
+}
+
+int main(int argc, char** argv)
+{
+    const cdv_whitelist_table* table = &cdv_generated_whitelist_table;
+    static char line[4 * kMaxField], schemeField[2 * kMaxField + 2], hostField[2 * kMaxField + 2],
+        pathField[2 * kMaxField + 2];
+    static char scheme[kMaxField], host[kMaxField], path[kMaxField];
+    unsigned long urls = 0, mismatches = 0;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <corpus>\n", argv[0]);
+        return 2;
+    }
+    FILE* corpus = fopen(argv[1], "r");
+    if (corpus == NULL) {
+        perror(argv[1]);
+        return 2;
+    }
+    while (fgets(line, sizeof(line), corpus) != NULL) {
+        int urlAllowed, schemeAllowed;
+        long port;
+        const char *cScheme, *cHost, *cPath;
+        if ((sscanf(line, "%d %d %8193s %8193s %ld %8193s", &urlAllowed, &schemeAllowed, schemeField, hostField, &port,
+                 pathField) != 6) ||
+            !decodeField(schemeField, scheme, &cScheme) || !decodeField(hostField, host, &cHost) ||
+            !decodeField(pathField, path, &cPath)) {
+            fprintf(stderr, "malformed corpus line %lu: %s", urls + 1, line);
+            CHECK(!"malformed corpus");
+            break;
+        }
+        urls++;
+        int urlResult = cdv_whitelist_url_is_allowed(table, cScheme, cHost, port, cPath);
+        int schemeResult = cdv_whitelist_scheme_is_allowed(table, cScheme);
+        if (((urlResult != 0) != urlAllowed) || ((schemeResult != 0) != schemeAllowed)) {
+            if (mismatches++ < kMaxMismatchesShown) {
+                char a[1024], b[1024], c[1024];
+                fprintf(stderr, "mismatch for %s://%s:%ld path %s: regex %d/%d, table %d/%d\n", show(cScheme, a),
+                    show(cHost, b), port, show(cPath, c), urlAllowed, schemeAllowed, urlResult != 0, schemeResult != 0);
+            }
+        }
+    }
+    fclose(corpus);
+
+    printf("%lu URL(s) against %lu origin(s): %lu mismatch(es)\n", urls, (unsigned long)table->origin_count, mismatches);
+    CHECK(urls > 0);
+    CHECK(mismatches == 0);
+    return cdv_test_result();
+}
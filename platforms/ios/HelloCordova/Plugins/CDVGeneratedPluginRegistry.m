@@ -0,0 +1,34 @@
+// Generated by cordova/lib/gen-plugin-registry.js from config.xml. Do not edit.
+
+#import <Cordova/CDVPluginRegistry.h>
+#import <Cordova/CDVPlugin.h>
+#import <Cordova/CDVLocalStorage.h>
+#import "com.mirasense.scanditsdk.plugin/ScanditSDK.h"
+
+static CDVPlugin* CDVCreateCDVLocalStorage(UIWebView* webView)
+{
+    return [[CDVLocalStorage alloc] initWithWebView:webView];
+}
+
+static CDVPlugin* CDVCreateScanditSDK(UIWebView* webView)
+{
+    return [[ScanditSDK alloc] initWithWebView:webView];
+}
+
+static const CDVPluginRegistryEntry kGeneratedPluginEntries[] = {
+    {"localstorage", "CDVLocalStorage", CDVCreateCDVLocalStorage},
+    {"scanditsdk", "ScanditSDK", CDVCreateScanditSDK},
+};
+
+@interface CDVGeneratedPluginRegistry : NSObject
+@end
+
+@implementation CDVGeneratedPluginRegistry
+
++ (void)load
+{
+    [CDVPluginRegistry registerEntries:kGeneratedPluginEntries
+                                 count:sizeof(kGeneratedPluginEntries) / sizeof(kGeneratedPluginEntries[0])];
+}
+
+@end
@@ -0,0 +1,37 @@
+// Generated by cordova/lib/gen-whitelist-table.js from config.xml. Do not edit.
+
+#import <Cordova/CDVWhitelistTable.h>
+
+static const char* const kOrigins[] = {
+    "file:///*",
+    "content:///*",
+    "data:///*",
+    "*",
+};
+
+static const char* const kSchemes[] = {
+    "content",
+    "data",
+    "file",
+};
+
+static const cdv_whitelist_table kGeneratedWhitelistTable = {
+    kOrigins, 4,
+    1, 0,
+    kSchemes, 3,
+    NULL, 0,
+    NULL, 0,
+    NULL, 0
+};
+
+@interface CDVGeneratedWhitelistTable : NSObject
+@end
+
+@implementation CDVGeneratedWhitelistTable
+
++ (void)load
+{
+    [CDVWhitelistTable registerTable:&kGeneratedWhitelistTable];
+}
+
+@end
@@ -17,31 +17,124 @@
 
 #import "ScanditSDK.h"
 #import "ScanditSDKRotatingBarcodePicker.h"
+#import "ScanditSDKScanResult.h"
+#import "ScanditSDKSession.h"
+#import "ScanditSDKChecksum.hpp"
+#import "ScanditSDKManifest.hpp"
+#import "ScanditSDKFrameStats.hpp"
+#import "ScanditSDKTorch.hpp"
+#import "ScanditSDKDutyCycle.hpp"
+#import "ScanditSDKBarcodeEncoder.hpp"
+#import "ScanditSDKBarcodeImage.hpp"
+#import <Cordova/CDVLog.h>
+#import <Cordova/CDVURLProtocol.h>
+
+#include <string>
+#include <vector>
+
+using namespace scanditsdk;
+
+// Seconds a picker is kept for a reloaded page to attach to, unless the reattachTimeout option says otherwise.
+#define kScanditSDKDefaultReattachTimeout 10.0
+
+@interface ScanditSDK () {
+    // State of the running scan or show call. Survives page reloads (see onReset).
+    ScanditSDKSession *session;
+    NSUInteger reattachCount;
+    // Owned; replaced as a whole by loadManifest and only touched on the main thread. The
+    // generation changes with every replacement, which ends the cursors over the previous one.
+    manifest::Manifest *receivingManifest;
+    NSUInteger manifestGeneration;
+    NSString *reconcileCallbackId;
+    // Frame sampling (see metrics), main thread only. frameWindow is owned.
+    NSString *metricsCallbackId;
+    NSTimeInterval metricsInterval;
+    NSDate *frameRequestedAt;
+    BOOL frameSampleScheduled;
+    NSUInteger sampledFrames;
+    framestats::Window *frameWindow;
+    // Time to decode, from the start of scanning or the previous decode.
+    NSDate *scanStartedAt;
+    NSUInteger decodeCount;
+    NSTimeInterval lastTimeToDecode;
+    NSTimeInterval totalTimeToDecode;
+    // Owned; only set while the autoTorch option of the current picker is on.
+    torch::Controller *torchController;
+    // Owned; only set while the dutyCycle option of the current picker is on. Ticks of an older
+    // schedule see a different dutyCycleGeneration and do nothing.
+    dutycycle::Controller *dutyCycle;
+    NSUInteger dutyCycleGeneration;
+    NSArray *dutyCycleTouchRecognizers;
+}
+@end
 
 
 @implementation ScanditSDK
 
-@synthesize callbackId;
 @synthesize hasPendingOperation;
 @synthesize bufferedResult;
 @synthesize scanditSDKBarcodePicker;
+@synthesize embedded;
+
+- (void)pluginInitialize {
+    [super pluginInitialize];
+    
+    [ScanditSDK registerBarcodeRenderer];
+
+    lastResumeToDecode = -1;
+    lastTimeToDecode = -1;
+    frameWindow = new framestats::Window();
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(onPause)
+                                                 name:UIApplicationDidEnterBackgroundNotification object:nil];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(onResume)
+                                                 name:UIApplicationWillEnterForegroundNotification object:nil];
+}
+
+- (void)dealloc {
+    delete receivingManifest;
+    delete frameWindow;
+    delete torchController;
+    delete dutyCycle;
+}
+
+- (void)setScanditSDKBarcodePicker:(ScanditSDKBarcodePicker *)picker {
+    if (picker == nil) {
+        [self stopDutyCycle];
+    }
+    scanditSDKBarcodePicker = picker;
+}
+
+- (NSString *)callbackId {
+    return session.callbackId;
+}
+
+- (void)setCallbackId:(NSString *)aCallbackId {
+    [session attachCallbackId:aCallbackId];
+}
 
 - (void)scan:(CDVInvokedUrlCommand *)command {
-    NSLog(@"scanning");
+    CDVLogDebug(CDVLogCategoryPlugin, @"[ScanditSDK] scan");
+    // A page that was reloaded while the picker was up, or before it got the result, takes the
+    // session over instead of being ignored.
+    if (session != nil && session.callbackId == nil && session.mode != ScanditSDKSessionModeEmbedded) {
+        [self attachSessionToCallbackId:command.callbackId];
+        return;
+    }
     if (self.hasPendingOperation) {
         return;
     }
-    self.hasPendingOperation = YES;
     
     NSUInteger argc = [command.arguments count];
     if (argc < 2) {
-        NSLog(@"The scan call received too few arguments and has to return without starting.");
+        CDVLogWarning(CDVLogCategoryPlugin, @"[ScanditSDK] The scan call received too few arguments and has to return without starting.");
         return;
     }
-    self.callbackId = command.callbackId;
+    self.hasPendingOperation = YES;
     
     NSString *appKey = [command.arguments objectAtIndex:0];
 	NSDictionary *options = [command.arguments objectAtIndex:1];
+    session = [[ScanditSDKSession alloc] initWithMode:ScanditSDKSessionModeModal appKey:appKey options:options
+                                           callbackId:command.callbackId];
     
     // Hide the status bar to get a bigger area of the video feed. We have to set this before we add
     // GUI elements to the overview, such that the views are aware of the fact that there is no
@@ -53,6 +146,1266 @@
         [[UIApplication sharedApplication] setStatusBarHidden:YES withAnimation:UIStatusBarAnimationNone];
     }
 	
+    [self createPickerWithAppKey:appKey options:options];
+    
+    // Show the toolbar that contains a cancel button.
+    [scanditSDKBarcodePicker.overlayController showToolBar:YES];
+	
+    // Set this class as the delegate for the overlay controller. It will now receive events when
+    // a barcode was successfully scanned, manually entered or the cancel button was pressed.
+	scanditSDKBarcodePicker.overlayController.delegate = self;
+    
+	startAnimationDone = NO;
+	self.bufferedResult = nil;
+	
+	// Present the barcode picker modally and start scanning.
+	if ([self.viewController respondsToSelector:@selector(presentViewController:animated:completion:)]) {
+		[self.viewController presentViewController:scanditSDKBarcodePicker animated:YES completion:^{
+			startAnimationDone = YES;
+			if (self.bufferedResult != nil) {
+				[self scanditSDKOverlayController:scanditSDKBarcodePicker.overlayController
+								   didScanBarcode:self.bufferedResult];
+				self.bufferedResult = nil;
+			}
+		}];
+	} else {
+		[self.viewController presentModalViewController:scanditSDKBarcodePicker animated:NO];
+		startAnimationDone = YES;
+	}
+	
+	[scanditSDKBarcodePicker performSelector:@selector(startScanning) withObject:nil afterDelay:0.1];
+}
+
+#pragma mark -
+#pragma mark Embedded picker
+
+- (void)show:(CDVInvokedUrlCommand *)command {
+    // A page that was reloaded while the embedded picker was up takes it over, at its own frame.
+    if (self.embedded && session.callbackId == nil && [command.arguments count] > 2) {
+        CGRect frame;
+        if ([self parseFrame:[command.arguments objectAtIndex:2] into:&frame]) {
+            session.frame = [command.arguments objectAtIndex:2];
+            scanditSDKBarcodePicker.size = frame.size;
+            scanditSDKBarcodePicker.view.frame = frame;
+        }
+        [self attachSessionToCallbackId:command.callbackId];
+        return;
+    }
+    if (self.hasPendingOperation) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"Busy"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    NSUInteger argc = [command.arguments count];
+    if (argc < 3) {
+        CDVLogWarning(CDVLogCategoryPlugin, @"[ScanditSDK] The show call received too few arguments and has to return without starting.");
+        return;
+    }
+    
+    CGRect frame;
+    if (![self parseFrame:[command.arguments objectAtIndex:2] into:&frame]) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"Invalid frame"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    self.hasPendingOperation = YES;
+    self.embedded = YES;
+    
+    NSString *appKey = [command.arguments objectAtIndex:0];
+	NSDictionary *options = [command.arguments objectAtIndex:1];
+    session = [[ScanditSDKSession alloc] initWithMode:ScanditSDKSessionModeEmbedded appKey:appKey options:options
+                                           callbackId:command.callbackId];
+    session.frame = [command.arguments objectAtIndex:2];
+    
+    [self createPickerWithAppKey:appKey options:options];
+    
+    // The page keeps its own controls around the embedded picker, so there is no toolbar and the
+    // status bar is left alone.
+    [scanditSDKBarcodePicker.overlayController showToolBar:NO];
+	scanditSDKBarcodePicker.overlayController.delegate = self;
+    
+	startAnimationDone = YES;
+	self.bufferedResult = nil;
+    
+    // Attach the picker as a child view controller directly above the web view. No transition is
+    // involved, so the web view stays visible and responsive while the camera is running.
+    scanditSDKBarcodePicker.size = frame.size;
+    if ([self.viewController respondsToSelector:@selector(addChildViewController:)]) {
+        [self.viewController addChildViewController:scanditSDKBarcodePicker];
+    }
+    scanditSDKBarcodePicker.view.frame = frame;
+    [self.viewController.view insertSubview:scanditSDKBarcodePicker.view aboveSubview:self.webView];
+    if ([scanditSDKBarcodePicker respondsToSelector:@selector(didMoveToParentViewController:)]) {
+        [scanditSDKBarcodePicker didMoveToParentViewController:self.viewController];
+    }
+    
+    [scanditSDKBarcodePicker startScanning];
+}
+
+- (void)resize:(CDVInvokedUrlCommand *)command {
+    CGRect frame;
+    if (!self.embedded || [command.arguments count] < 1
+            || ![self parseFrame:[command.arguments objectAtIndex:0] into:&frame]) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"Invalid frame"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    session.frame = [command.arguments objectAtIndex:0];
+    scanditSDKBarcodePicker.size = frame.size;
+    scanditSDKBarcodePicker.view.frame = frame;
+    
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)start:(CDVInvokedUrlCommand *)command {
+    if (self.embedded) {
+        if (![scanditSDKBarcodePicker isScanning]) {
+            [scanditSDKBarcodePicker startScanning];
+        }
+        [self resumeDutyCycle];
+    }
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                        messageAsBool:self.embedded];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)stop:(CDVInvokedUrlCommand *)command {
+    if (self.embedded) {
+        if ([scanditSDKBarcodePicker isScanning]) {
+            [scanditSDKBarcodePicker stopScanning];
+        }
+        if (dutyCycle != NULL) {
+            dutyCycle->pause([NSDate timeIntervalSinceReferenceDate]);
+        }
+    }
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                        messageAsBool:self.embedded];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)hide:(CDVInvokedUrlCommand *)command {
+    if (self.embedded) {
+        [self removeEmbeddedPicker];
+        
+        // Release the keep-alive callback of the show call without invoking it.
+        if (self.callbackId != nil) {
+            CDVPluginResult *closeResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_NO_RESULT];
+            [self.commandDelegate sendPluginResult:closeResult callbackId:self.callbackId];
+        }
+        session = nil;
+        self.hasPendingOperation = NO;
+    }
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)removeEmbeddedPicker {
+    [scanditSDKBarcodePicker stopScanning];
+    if ([scanditSDKBarcodePicker respondsToSelector:@selector(willMoveToParentViewController:)]) {
+        [scanditSDKBarcodePicker willMoveToParentViewController:nil];
+    }
+    [scanditSDKBarcodePicker.view removeFromSuperview];
+    if ([scanditSDKBarcodePicker respondsToSelector:@selector(removeFromParentViewController)]) {
+        [scanditSDKBarcodePicker removeFromParentViewController];
+    }
+	self.scanditSDKBarcodePicker = nil;
+    self.embedded = NO;
+}
+
+- (void)sendEmbeddedResult:(CDVPluginResult *)pluginResult {
+    [pluginResult setKeepCallbackAsBool:YES];
+    [self sendSessionResult:pluginResult asError:NO];
+}
+
+/**
+ * Parses a frame given as "x/y/width/height" in points relative to the Cordova view.
+ */
+- (BOOL)parseFrame:(NSObject *)frameObject into:(CGRect *)frame {
+    if (!frameObject || ![frameObject isKindOfClass:[NSString class]]) {
+        return NO;
+    }
+    NSArray *split = [((NSString *) frameObject) componentsSeparatedByString:@"/"];
+    if ([split count] != 4) {
+        return NO;
+    }
+    *frame = CGRectMake([[split objectAtIndex:0] floatValue],
+                        [[split objectAtIndex:1] floatValue],
+                        [[split objectAtIndex:2] floatValue],
+                        [[split objectAtIndex:3] floatValue]);
+    return frame->size.width > 0 && frame->size.height > 0;
+}
+
+- (void)onReset {
+    // Callbacks of the old page are gone.
+    reconcileCallbackId = nil;
+    metricsCallbackId = nil;
+    if (session == nil) {
+        return;
+    }
+    
+    // The picker and the results scanned from now on are kept for a while, so that the reloaded
+    // page can take them over with attach (or by calling scan or show again) instead of starting
+    // the camera from scratch. Without an attach the picker is taken down as before.
+    [session detach];
+    NSTimeInterval timeout = kScanditSDKDefaultReattachTimeout;
+    id timeoutOption = [session.options objectForKey:@"reattachTimeout"];
+    if ([timeoutOption respondsToSelector:@selector(doubleValue)]) {
+        timeout = [timeoutOption doubleValue];
+    }
+    if (timeout <= 0) {
+        [self endDetachedSession];
+        return;
+    }
+    
+    ScanditSDKSession *detached = session;
+    __weak ScanditSDK *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        ScanditSDK *strongSelf = weakSelf;
+        if (strongSelf != nil && strongSelf->session == detached && detached.callbackId == nil) {
+            CDVLogInfo(CDVLogCategoryPlugin, @"[ScanditSDK] no page attached to session %@, ending it", detached.sessionId);
+            [strongSelf endDetachedSession];
+        }
+    });
+}
+
+/**
+ * Takes down the picker of a session nobody attached to and drops its queued results.
+ */
+- (void)endDetachedSession {
+    if (self.embedded) {
+        [self removeEmbeddedPicker];
+    } else if (session.mode == ScanditSDKSessionModeModal && scanditSDKBarcodePicker != nil) {
+        if (!wasStatusBarHidden) {
+            [[UIApplication sharedApplication] setStatusBarHidden:NO withAnimation:UIStatusBarAnimationNone];
+        }
+        [self.viewController dismissModalViewControllerAnimated:NO];
+        self.scanditSDKBarcodePicker = nil;
+    }
+    session = nil;
+    self.hasPendingOperation = NO;
+}
+
+/**
+ * Delivers a result to the attached page, or queues it until a page attaches.
+ */
+- (void)sendSessionResult:(CDVPluginResult *)pluginResult asError:(BOOL)asError {
+    NSString *target = session.callbackId;
+    if (target == nil) {
+        [session enqueueResult:pluginResult asError:asError];
+        return;
+    }
+    if (asError) {
+        [self writeJavascript:[pluginResult toErrorCallbackString:target]];
+    } else {
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:target];
+    }
+}
+
+/**
+ * Marks the end of a modal scan. A detached session is kept until its queued result is drained.
+ */
+- (void)finishSession {
+    self.hasPendingOperation = NO;
+    if (session.callbackId != nil || session.pendingCount == 0) {
+        session = nil;
+    } else {
+        session.mode = ScanditSDKSessionModeFinished;
+    }
+}
+
+- (void)attachSessionToCallbackId:(NSString *)newCallbackId {
+    NSString *previous = session.callbackId;
+    if (previous != nil && ![previous isEqualToString:newCallbackId]) {
+        // Another live page had the session; release its callback.
+        CDVPluginResult *closeResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_NO_RESULT];
+        [self.commandDelegate sendPluginResult:closeResult callbackId:previous];
+    }
+    [session attachCallbackId:newCallbackId];
+    reattachCount++;
+    CDVLogInfo(CDVLogCategoryPlugin, @"[ScanditSDK] attached to session %@ with %lu queued results",
+               session.sessionId, (unsigned long)session.pendingCount);
+    
+    [session drainResultsWithBlock:^(CDVPluginResult *result, BOOL asError) {
+        [self sendSessionResult:result asError:asError];
+    }];
+    if (session.mode == ScanditSDKSessionModeFinished) {
+        session = nil;
+    }
+}
+
+- (void)session:(CDVInvokedUrlCommand *)command {
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                  messageAsDictionary:(session ? [session descriptor] : [NSDictionary dictionaryWithObject:@"none" forKey:@"mode"])];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)attach:(CDVInvokedUrlCommand *)command {
+    if (session == nil) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"No session"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    [self attachSessionToCallbackId:command.callbackId];
+}
+
+#pragma mark -
+#pragma mark Background handling
+
+/**
+ * Parks a running picker when the app goes to the background. The camera is released but the
+ * picker with its configured engine and overlay is kept, so resuming needs neither the options
+ * nor a new picker.
+ */
+- (void)onPause {
+    // A probing picker counts as running even while its camera is stopped between probes.
+    BOOL probing = dutyCycle != NULL && dutyCycle->isProbing();
+    if (scanditSDKBarcodePicker != nil && ([scanditSDKBarcodePicker isScanning] || probing)) {
+        [scanditSDKBarcodePicker stopScanningAndKeepTorchState];
+        parkedInBackground = YES;
+        if (dutyCycle != NULL) {
+            dutyCycle->pause([NSDate timeIntervalSinceReferenceDate]);
+        }
+    }
+}
+
+- (void)onResume {
+    if (!parkedInBackground) {
+        return;
+    }
+    parkedInBackground = NO;
+    if (scanditSDKBarcodePicker != nil) {
+        resumedAt = [NSDate date];
+        scanStartedAt = resumedAt;
+        resumeCount++;
+        [scanditSDKBarcodePicker startScanning];
+        [self resumeDutyCycle];
+    }
+}
+
+/**
+ * Measures the time from the last resume to the first decode after it.
+ */
+- (void)noteDecode {
+    if (resumedAt != nil) {
+        lastResumeToDecode = [[NSDate date] timeIntervalSinceDate:resumedAt];
+        resumedAt = nil;
+        CDVLogInfo(CDVLogCategoryPlugin, @"[ScanditSDK] resume to first decode: %fms", lastResumeToDecode * 1000.0);
+    }
+}
+
+- (void)stats:(CDVInvokedUrlCommand *)command {
+    NSMutableDictionary *stats = [NSMutableDictionary dictionaryWithCapacity:4];
+    [stats setObject:[NSNumber numberWithUnsignedInteger:resumeCount] forKey:@"resumeCount"];
+    [stats setObject:[NSNumber numberWithUnsignedInteger:reattachCount] forKey:@"reattachCount"];
+    [stats setObject:[NSNumber numberWithDouble:(lastResumeToDecode < 0 ? -1 : lastResumeToDecode * 1000.0)]
+              forKey:@"lastResumeToDecodeMs"];
+    if (torchController != NULL) {
+        [stats addEntriesFromDictionary:[self torchStats]];
+    }
+    if (dutyCycle != NULL) {
+        [stats addEntriesFromDictionary:[self dutyCycleStats]];
+    }
+    
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                  messageAsDictionary:stats];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+#pragma mark -
+#pragma mark Frame metrics
+
+// Width sampled frames are scaled down to before they are analyzed. Sharpness depends on it.
+#define kScanditSDKFrameAnalysisWidth 320
+#define kScanditSDKDefaultMetricsInterval 1.0
+// A requested frame that did not arrive within this time (e.g. the picker went away) is given up.
+#define kScanditSDKFrameRequestTimeout 2.0
+// Sampling interval for the auto torch when metrics are not sampled faster anyway.
+#define kScanditSDKAutoTorchInterval 0.5
+// Sampling interval for presence detection while probing; a probe lasts only a second or two.
+#define kScanditSDKDutyCycleProbeInterval 0.25
+
+/**
+ * Decodes a JPEG frame of the picker into an 8-bit luminance plane, scaled to at most
+ * kScanditSDKFrameAnalysisWidth pixels wide. Safe to call off the main thread.
+ */
+static BOOL ScanditSDKLuminancePlane(NSData *jpeg, std::vector<uint8_t> &plane, size_t *width, size_t *height) {
+    CGImageRef image = [UIImage imageWithData:jpeg].CGImage;
+    if (image == NULL || CGImageGetWidth(image) == 0 || CGImageGetHeight(image) == 0) {
+        return NO;
+    }
+    size_t w = MIN(CGImageGetWidth(image), (size_t)kScanditSDKFrameAnalysisWidth);
+    size_t h = MAX((size_t)1, CGImageGetHeight(image) * w / CGImageGetWidth(image));
+    plane.resize(w * h);
+    
+    CGColorSpaceRef gray = CGColorSpaceCreateDeviceGray();
+    CGContextRef context = CGBitmapContextCreate(&plane[0], w, h, 8, w, gray, kCGImageAlphaNone);
+    CGColorSpaceRelease(gray);
+    if (context == NULL) {
+        return NO;
+    }
+    CGContextSetInterpolationQuality(context, kCGInterpolationLow);
+    CGContextDrawImage(context, CGRectMake(0, 0, w, h), image);
+    CGContextRelease(context);
+    *width = w;
+    *height = h;
+    return YES;
+}
+
+static NSDictionary *ScanditSDKFrameStatsDictionary(const framestats::Stats &stats) {
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [NSNumber numberWithFloat:stats.meanLuminance], @"luminance",
+            [NSNumber numberWithFloat:stats.sharpness], @"sharpness",
+            [NSNumber numberWithFloat:stats.glareFraction], @"glare",
+            nil];
+}
+
+- (void)metrics:(CDVInvokedUrlCommand *)command {
+    id intervalArgument = [command.arguments count] > 0 ? [command.arguments objectAtIndex:0] : nil;
+    NSTimeInterval interval = [intervalArgument isKindOfClass:[NSNumber class]]
+            ? [intervalArgument doubleValue] / 1000.0 : kScanditSDKDefaultMetricsInterval;
+    
+    if (metricsCallbackId != nil) {
+        CDVPluginResult *closeResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_NO_RESULT];
+        [self.commandDelegate sendPluginResult:closeResult callbackId:metricsCallbackId];
+        metricsCallbackId = nil;
+    }
+    if (interval <= 0) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    // Every sample costs a JPEG encode in the SDK and a decode here, so sampling stays slow.
+    metricsCallbackId = command.callbackId;
+    metricsInterval = MAX(interval, 0.1);
+    frameWindow->clear();
+    sampledFrames = 0;
+    [self requestFrameSample];
+}
+
+- (BOOL)wantsFrameSamples {
+    if (metricsCallbackId != nil) {
+        return YES;
+    }
+    return scanditSDKBarcodePicker != nil && (torchController != NULL || (dutyCycle != NULL && dutyCycle->isProbing()));
+}
+
+- (NSTimeInterval)frameSampleInterval {
+    NSTimeInterval interval = metricsCallbackId != nil ? metricsInterval : kScanditSDKAutoTorchInterval;
+    if (torchController != NULL) {
+        interval = MIN(interval, kScanditSDKAutoTorchInterval);
+    }
+    if (dutyCycle != NULL && dutyCycle->isProbing()) {
+        interval = MIN(interval, kScanditSDKDutyCycleProbeInterval);
+    }
+    return interval;
+}
+
+/**
+ * Asks the running picker for a frame unless one is still on its way, and polls again after the
+ * sampling interval. The poll ends when nobody wants samples any more.
+ */
+- (void)requestFrameSample {
+    if (![self wantsFrameSamples]) {
+        return;
+    }
+    BOOL outstanding = frameRequestedAt != nil
+            && -[frameRequestedAt timeIntervalSinceNow] < kScanditSDKFrameRequestTimeout;
+    if (!outstanding && scanditSDKBarcodePicker != nil && [scanditSDKBarcodePicker isScanning]) {
+        frameRequestedAt = [NSDate date];
+        [scanditSDKBarcodePicker sendNextFrameToDelegate:self];
+    }
+    [self scheduleFrameSample];
+}
+
+- (void)scheduleFrameSample {
+    if (frameSampleScheduled) {
+        return;
+    }
+    frameSampleScheduled = YES;
+    __weak ScanditSDK *weakSelf = self;
+    NSTimeInterval interval = [self frameSampleInterval];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        ScanditSDK *strongSelf = weakSelf;
+        if (strongSelf != nil) {
+            strongSelf->frameSampleScheduled = NO;
+            [strongSelf requestFrameSample];
+        }
+    });
+}
+
+- (void)scanditSDKBarcodePicker:(ScanditSDKBarcodePicker *)picker
+                didCaptureImage:(NSData *)image
+                     withHeight:(int)height
+                      withWidth:(int)width {
+    // The auto torch alone only needs the luminance, which is a fraction of the full analysis.
+    BOOL fullAnalysis = metricsCallbackId != nil;
+    [self.commandDelegate runInBackground:^{
+        NSDate *start = [NSDate date];
+        std::vector<uint8_t> plane;
+        size_t planeWidth = 0, planeHeight = 0;
+        BOOL decoded = ScanditSDKLuminancePlane(image, plane, &planeWidth, &planeHeight);
+        framestats::Stats stats = { 0, 0, 0 };
+        if (decoded && fullAnalysis) {
+            stats = framestats::analyze(&plane[0], planeWidth, planeHeight, planeWidth);
+        } else if (decoded) {
+            stats.meanLuminance = framestats::meanLuminance(&plane[0], planeWidth, planeHeight, planeWidth, 2);
+        }
+        NSTimeInterval analysisTime = -[start timeIntervalSinceNow];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            frameRequestedAt = nil;
+            if (decoded) {
+                [self frameSampled:stats analysisTime:analysisTime];
+            }
+        });
+    }];
+}
+
+- (void)frameSampled:(framestats::Stats)stats analysisTime:(NSTimeInterval)analysisTime {
+    [self updateTorchWithLuminance:stats.meanLuminance];
+    if (dutyCycle != NULL && scanditSDKBarcodePicker != nil) {
+        [self applyDutyCycleAction:dutyCycle->sample([NSDate timeIntervalSinceReferenceDate], stats.meanLuminance)];
+    }
+    if (metricsCallbackId == nil) {
+        return;
+    }
+    sampledFrames++;
+    frameWindow->push(stats);
+    
+    NSMutableDictionary *metrics = [NSMutableDictionary dictionaryWithDictionary:ScanditSDKFrameStatsDictionary(stats)];
+    [metrics setObject:ScanditSDKFrameStatsDictionary(frameWindow->mean()) forKey:@"rolling"];
+    [metrics setObject:[NSNumber numberWithUnsignedInteger:sampledFrames] forKey:@"frames"];
+    [metrics setObject:[NSNumber numberWithUnsignedInteger:decodeCount] forKey:@"decodes"];
+    [metrics setObject:[NSNumber numberWithDouble:(lastTimeToDecode < 0 ? -1 : lastTimeToDecode * 1000.0)]
+                forKey:@"lastTimeToDecodeMs"];
+    [metrics setObject:[NSNumber numberWithDouble:(decodeCount == 0 ? -1 : totalTimeToDecode / decodeCount * 1000.0)]
+                forKey:@"meanTimeToDecodeMs"];
+    [metrics setObject:[NSNumber numberWithDouble:analysisTime * 1000.0] forKey:@"analysisMs"];
+    if (torchController != NULL) {
+        [metrics addEntriesFromDictionary:[self torchStats]];
+    }
+    if (dutyCycle != NULL) {
+        [metrics addEntriesFromDictionary:[self dutyCycleStats]];
+    }
+    
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                  messageAsDictionary:metrics];
+    [pluginResult setKeepCallbackAsBool:YES];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:metricsCallbackId];
+}
+
+/**
+ * Records the time since scanning started or since the previous decode.
+ */
+- (void)countDecode {
+    NSDate *now = [NSDate date];
+    if (scanStartedAt != nil) {
+        lastTimeToDecode = [now timeIntervalSinceDate:scanStartedAt];
+        totalTimeToDecode += lastTimeToDecode;
+        decodeCount++;
+    }
+    scanStartedAt = now;
+    if (torchController != NULL) {
+        torchController->decoded([now timeIntervalSinceReferenceDate]);
+    }
+    if (dutyCycle != NULL) {
+        [self applyDutyCycleAction:dutyCycle->wake([now timeIntervalSinceReferenceDate], dutycycle::WakeDecode)];
+    }
+}
+
+#pragma mark -
+#pragma mark Auto torch
+
+/**
+ * Sets up the auto torch for a new picker from the autoTorch options, or turns it off.
+ */
+- (void)configureAutoTorchWithOptions:(NSDictionary *)options {
+    delete torchController;
+    torchController = NULL;
+    NSObject *autoTorch = [options objectForKey:@"autoTorch"];
+    if (!autoTorch || ![autoTorch isKindOfClass:[NSNumber class]] || ![((NSNumber *)autoTorch) boolValue]) {
+        return;
+    }
+    
+    torch::Config config;
+    NSObject *darkLevel = [options objectForKey:@"autoTorchDarkLevel"];
+    if (darkLevel && [darkLevel isKindOfClass:[NSNumber class]]) {
+        config.darkLevel = [((NSNumber *)darkLevel) floatValue];
+    }
+    NSObject *dimLevel = [options objectForKey:@"autoTorchDimLevel"];
+    if (dimLevel && [dimLevel isKindOfClass:[NSNumber class]]) {
+        config.dimLevel = [((NSNumber *)dimLevel) floatValue];
+    }
+    NSObject *noDecodeSeconds = [options objectForKey:@"autoTorchNoDecodeSeconds"];
+    if (noDecodeSeconds && [noDecodeSeconds isKindOfClass:[NSNumber class]]) {
+        config.noDecodeSeconds = [((NSNumber *)noDecodeSeconds) doubleValue];
+    }
+    NSObject *holdSeconds = [options objectForKey:@"autoTorchHoldSeconds"];
+    if (holdSeconds && [holdSeconds isKindOfClass:[NSNumber class]]) {
+        config.holdSeconds = [((NSNumber *)holdSeconds) doubleValue];
+    }
+    torchController = new torch::Controller(config);
+    torchController->start([NSDate timeIntervalSinceReferenceDate]);
+    [self requestFrameSample];
+}
+
+- (void)updateTorchWithLuminance:(float)luminance {
+    if (torchController == NULL || scanditSDKBarcodePicker == nil) {
+        return;
+    }
+    torch::Reason reason = torchController->sample([NSDate timeIntervalSinceReferenceDate], luminance);
+    if (reason == torch::ReasonNone) {
+        return;
+    }
+    static NSString *const reasons[] = { @"", @"dark", @"no decode", @"idle" };
+    CDVLogDebug(CDVLogCategoryPlugin, @"[ScanditSDK] auto torch %@ (%@, luminance %.0f)",
+                torchController->isOn() ? @"on" : @"off", reasons[reason], luminance);
+    [scanditSDKBarcodePicker switchTorchOn:torchController->isOn()];
+}
+
+- (NSDictionary *)torchStats {
+    double now = [NSDate timeIntervalSinceReferenceDate];
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [NSNumber numberWithBool:torchController->isOn()], @"torchOn",
+            [NSNumber numberWithDouble:torchController->onSeconds(now) * 1000.0], @"torchOnMs",
+            [NSNumber numberWithUnsignedInt:torchController->switchCount()], @"torchSwitches",
+            nil];
+}
+
+#pragma mark -
+#pragma mark Duty cycling
+
+/**
+ * Sets up duty cycling for a new picker from the dutyCycle options, or turns it off.
+ */
+- (void)configureDutyCycleWithOptions:(NSDictionary *)options {
+    [self removeDutyCycleTouchRecognizers];
+    delete dutyCycle;
+    dutyCycle = NULL;
+    dutyCycleGeneration++;
+    NSObject *enabled = [options objectForKey:@"dutyCycle"];
+    if (!enabled || ![enabled isKindOfClass:[NSNumber class]] || ![((NSNumber *)enabled) boolValue]) {
+        return;
+    }
+    
+    dutycycle::Config config;
+    NSObject *idleSeconds = [options objectForKey:@"dutyCycleIdleSeconds"];
+    if (idleSeconds && [idleSeconds isKindOfClass:[NSNumber class]]) {
+        config.idleSeconds = [((NSNumber *)idleSeconds) doubleValue];
+    }
+    NSObject *probeOnSeconds = [options objectForKey:@"dutyCycleProbeOnSeconds"];
+    if (probeOnSeconds && [probeOnSeconds isKindOfClass:[NSNumber class]]) {
+        config.probeOnSeconds = [((NSNumber *)probeOnSeconds) doubleValue];
+    }
+    NSObject *probePeriodSeconds = [options objectForKey:@"dutyCycleProbePeriodSeconds"];
+    if (probePeriodSeconds && [probePeriodSeconds isKindOfClass:[NSNumber class]]) {
+        config.probePeriodSeconds = [((NSNumber *)probePeriodSeconds) doubleValue];
+    }
+    NSObject *presenceDelta = [options objectForKey:@"dutyCyclePresenceDelta"];
+    if (presenceDelta && [presenceDelta isKindOfClass:[NSNumber class]]) {
+        config.presenceDelta = [((NSNumber *)presenceDelta) floatValue];
+    }
+    dutyCycle = new dutycycle::Controller(config);
+    dutyCycle->start([NSDate timeIntervalSinceReferenceDate]);
+    
+    // Any touch on the picker, or on the page around an embedded one, wakes a probing picker. The
+    // recognizers only watch; the touches still reach the picker and the web view.
+    NSMutableArray *recognizers = [NSMutableArray arrayWithCapacity:2];
+    NSMutableArray *views = [NSMutableArray arrayWithObject:scanditSDKBarcodePicker.view];
+    if (self.embedded && self.webView != nil) {
+        [views addObject:self.webView];
+    }
+    for (UIView *view in views) {
+        UILongPressGestureRecognizer *recognizer = [[UILongPressGestureRecognizer alloc]
+                                                    initWithTarget:self action:@selector(dutyCycleTouched:)];
+        recognizer.minimumPressDuration = 0;
+        recognizer.cancelsTouchesInView = NO;
+        recognizer.delegate = self;
+        [view addGestureRecognizer:recognizer];
+        [recognizers addObject:recognizer];
+    }
+    dutyCycleTouchRecognizers = recognizers;
+    [self scheduleDutyCycleTick];
+}
+
+- (void)removeDutyCycleTouchRecognizers {
+    for (UIGestureRecognizer *recognizer in dutyCycleTouchRecognizers) {
+        [recognizer.view removeGestureRecognizer:recognizer];
+    }
+    dutyCycleTouchRecognizers = nil;
+}
+
+/**
+ * Ends duty cycling when the picker goes away. The totals are kept for stats until the next picker.
+ */
+- (void)stopDutyCycle {
+    [self removeDutyCycleTouchRecognizers];
+    if (dutyCycle != NULL) {
+        dutyCycle->pause([NSDate timeIntervalSinceReferenceDate]);
+        dutyCycleGeneration++;
+    }
+}
+
+/**
+ * Called after the picker was started again by the page or on returning to the foreground.
+ */
+- (void)resumeDutyCycle {
+    if (dutyCycle == NULL || scanditSDKBarcodePicker == nil) {
+        return;
+    }
+    dutyCycle->resume([NSDate timeIntervalSinceReferenceDate]);
+    [self scheduleDutyCycleTick];
+}
+
+- (void)scheduleDutyCycleTick {
+    double deadline = dutyCycle->nextDeadline();
+    if (deadline < 0) {
+        return;
+    }
+    NSUInteger generation = ++dutyCycleGeneration;
+    NSTimeInterval delay = MAX(0, deadline - [NSDate timeIntervalSinceReferenceDate]);
+    __weak ScanditSDK *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        ScanditSDK *strongSelf = weakSelf;
+        if (strongSelf != nil && strongSelf->dutyCycleGeneration == generation && strongSelf->dutyCycle != NULL
+                && strongSelf.scanditSDKBarcodePicker != nil) {
+            dutycycle::Action action = strongSelf->dutyCycle->tick([NSDate timeIntervalSinceReferenceDate]);
+            if (action == dutycycle::ActionNone) {
+                [strongSelf scheduleDutyCycleTick];
+            } else {
+                [strongSelf applyDutyCycleAction:action];
+            }
+        }
+    });
+}
+
+/**
+ * Starts or stops the picker as the duty cycle decided. A decode or touch that only keeps an active
+ * picker awake needs no new tick: the pending one finds the idle time not up yet and reschedules.
+ */
+- (void)applyDutyCycleAction:(dutycycle::Action)action {
+    if (action == dutycycle::ActionNone) {
+        return;
+    }
+    if (action == dutycycle::ActionStartScanning) {
+        [scanditSDKBarcodePicker startScanning];
+        if (torchController != NULL && torchController->isOn()) {
+            [scanditSDKBarcodePicker switchTorchOn:YES];
+        }
+    } else {
+        // The torch goes off with the camera; it burns as much as the camera between probes.
+        [scanditSDKBarcodePicker stopScanning];
+    }
+    static NSString *const states[] = { @"active", @"probe on", @"probe off", @"paused" };
+    CDVLogDebug(CDVLogCategoryPlugin, @"[ScanditSDK] duty cycle %@", states[dutyCycle->state()]);
+    if (dutyCycle->isProbing()) {
+        [self requestFrameSample];
+    }
+    [self scheduleDutyCycleTick];
+}
+
+- (void)dutyCycleTouched:(UIGestureRecognizer *)recognizer {
+    if (recognizer.state == UIGestureRecognizerStateBegan && dutyCycle != NULL && scanditSDKBarcodePicker != nil) {
+        [self applyDutyCycleAction:dutyCycle->wake([NSDate timeIntervalSinceReferenceDate], dutycycle::WakeTouch)];
+    }
+}
+
+- (BOOL)gestureRecognizer:(UIGestureRecognizer *)gestureRecognizer
+        shouldRecognizeSimultaneouslyWithGestureRecognizer:(UIGestureRecognizer *)otherGestureRecognizer {
+    return YES;
+}
+
+- (NSDictionary *)dutyCycleStats {
+    double now = [NSDate timeIntervalSinceReferenceDate];
+    static NSString *const states[] = { @"active", @"probing", @"probing", @"paused" };
+    double probeOn = dutyCycle->seconds(dutycycle::StateProbeOn, now);
+    double probeOff = dutyCycle->seconds(dutycycle::StateProbeOff, now);
+    NSDictionary *wakes = [NSDictionary dictionaryWithObjectsAndKeys:
+                           [NSNumber numberWithUnsignedInt:dutyCycle->wakeCount(dutycycle::WakeDecode)], @"decode",
+                           [NSNumber numberWithUnsignedInt:dutyCycle->wakeCount(dutycycle::WakePresence)], @"presence",
+                           [NSNumber numberWithUnsignedInt:dutyCycle->wakeCount(dutycycle::WakeTouch)], @"touch",
+                           nil];
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            states[dutyCycle->state()], @"dutyState",
+            [NSNumber numberWithDouble:dutyCycle->seconds(dutycycle::StateActive, now) * 1000.0], @"dutyActiveMs",
+            [NSNumber numberWithDouble:(probeOn + probeOff) * 1000.0], @"dutyProbeMs",
+            [NSNumber numberWithDouble:probeOn * 1000.0], @"dutyProbeScanningMs",
+            [NSNumber numberWithUnsignedInt:dutyCycle->probeCount()], @"dutyProbes",
+            wakes, @"dutyWakes",
+            nil];
+}
+
+#pragma mark -
+#pragma mark Checksum validation
+
+/**
+ * Maps the check names accepted by validate to checks, CheckNone for "auto" and unknown names.
+ */
+static checksum::Check ScanditSDKCheckFromString(NSString *name) {
+    static NSDictionary *checks = nil;
+    if (checks == nil) {
+        checks = [NSDictionary dictionaryWithObjectsAndKeys:
+                  [NSNumber numberWithInt:checksum::CheckEAN13], @"ean13",
+                  [NSNumber numberWithInt:checksum::CheckUPC12], @"upc12",
+                  [NSNumber numberWithInt:checksum::CheckEAN8], @"ean8",
+                  [NSNumber numberWithInt:checksum::CheckUPCE], @"upce",
+                  [NSNumber numberWithInt:checksum::CheckITF], @"itf",
+                  [NSNumber numberWithInt:checksum::CheckCode39Mod43], @"code39",
+                  [NSNumber numberWithInt:checksum::CheckMSIMod10], @"mod10",
+                  [NSNumber numberWithInt:checksum::CheckMSIMod11], @"mod11",
+                  [NSNumber numberWithInt:checksum::CheckMSIMod1010], @"mod1010",
+                  [NSNumber numberWithInt:checksum::CheckMSIMod1110], @"mod1110",
+                  nil];
+    }
+    NSNumber *check = [checks objectForKey:[name lowercaseString]];
+    return check ? (checksum::Check)[check intValue] : checksum::CheckNone;
+}
+
+static ScanditSDKSymbology ScanditSDKSymbologyForCheck(checksum::Check check) {
+    switch (check) {
+        case checksum::CheckEAN13: return ScanditSDKSymbologyEan13;
+        case checksum::CheckUPC12: return ScanditSDKSymbologyUpc12;
+        case checksum::CheckEAN8: return ScanditSDKSymbologyEan8;
+        case checksum::CheckUPCE: return ScanditSDKSymbologyUpce;
+        case checksum::CheckITF: return ScanditSDKSymbologyItf;
+        case checksum::CheckCode39Mod43: return ScanditSDKSymbologyCode39;
+        case checksum::CheckMSIMod10:
+        case checksum::CheckMSIMod11:
+        case checksum::CheckMSIMod1010:
+        case checksum::CheckMSIMod1110: return ScanditSDKSymbologyMsi;
+        case checksum::CheckNone: break;
+    }
+    return ScanditSDKSymbologyUnknown;
+}
+
+/**
+ * Returns the schema name of the symbology a manually entered code most likely belongs to.
+ */
+- (NSString *)symbologyForManualEntry:(NSString *)input {
+    NSData *bytes = [input dataUsingEncoding:NSUTF8StringEncoding];
+    checksum::Check check = checksum::infer((const char *)[bytes bytes], [bytes length]);
+    return ScanditSDKSymbologyName(ScanditSDKSymbologyForCheck(check));
+}
+
+/**
+ * Actions that send their result before returning and touch no state of the plugin, so
+ * cordova.exec.sync() may call them on the URL loading thread.
+ */
++ (NSSet *)nonBlockingActions {
+    return [NSSet setWithObject:@"symbology"];
+}
+
+- (void)symbology:(CDVInvokedUrlCommand *)command {
+    id input = [command.arguments count] > 0 ? [command.arguments objectAtIndex:0] : nil;
+    CDVPluginResult *pluginResult;
+    if ([input isKindOfClass:[NSString class]]) {
+        pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                         messageAsString:[self symbologyForManualEntry:input]];
+    } else {
+        pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                         messageAsString:@"Expected a code"];
+    }
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)validate:(CDVInvokedUrlCommand *)command {
+    id codesArgument = [command.arguments count] > 0 ? [command.arguments objectAtIndex:0] : nil;
+    NSString *checkName = [command.arguments count] > 1 ? [command.arguments objectAtIndex:1] : @"auto";
+    
+    if (![codesArgument isKindOfClass:[NSString class]] && ![codesArgument isKindOfClass:[NSArray class]]) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"Expected an array or a string of codes"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    BOOL inferring = ![checkName isKindOfClass:[NSString class]] ||
+                     [checkName caseInsensitiveCompare:@"auto"] == NSOrderedSame;
+    checksum::Check check = inferring ? checksum::CheckNone : ScanditSDKCheckFromString(checkName);
+    if (!inferring && check == checksum::CheckNone) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:[NSString stringWithFormat:@"Unknown check %@", checkName]];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    [self.commandDelegate runInBackground:^{
+        // Both forms are flattened into one UTF-8 buffer split at newlines, so a large manifest
+        // costs a single conversion instead of one NSString per line. A trailing newline does not
+        // start another code.
+        BOOL isArray = [codesArgument isKindOfClass:[NSArray class]];
+        NSData *buffer = [(isArray ? [codesArgument componentsJoinedByString:@"\n"] : codesArgument)
+                          dataUsingEncoding:NSUTF8StringEncoding];
+        const char *line = (const char *)[buffer bytes];
+        const char *end = line + [buffer length];
+        
+        std::vector<const char *> codes;
+        std::vector<size_t> lengths;
+        BOOL hasCodes = isArray ? [codesArgument count] > 0 : [buffer length] > 0;
+        while (hasCodes) {
+            const char *newline = (line < end) ? (const char *)memchr(line, '\n', end - line) : NULL;
+            size_t length = (newline ? newline : end) - line;
+            if (length > 0 && line[length - 1] == '\r') {
+                length--;
+            }
+            codes.push_back(line);
+            lengths.push_back(length);
+            if (newline == NULL || (!isArray && newline + 1 == end)) {
+                break;
+            }
+            line = newline + 1;
+        }
+        
+        // One character per code: '1' or '0' for an explicit check, the base 36 ScanditSDKSymbology
+        // value when inferring ('0' is UNKNOWN).
+        size_t count = codes.size();
+        std::vector<char> summary(count);
+        if (inferring) {
+            static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+            for (size_t i = 0; i < count; i++) {
+                summary[i] = digits[ScanditSDKSymbologyForCheck(checksum::infer(codes[i], lengths[i]))];
+            }
+        } else if (count > 0) {
+            std::vector<uint8_t> results(count);
+            checksum::validateBatch(check, &codes[0], &lengths[0], count, &results[0]);
+            for (size_t i = 0; i < count; i++) {
+                summary[i] = results[i] ? '1' : '0';
+            }
+        }
+        
+        NSString *message = [[NSString alloc] initWithBytes:(count > 0 ? &summary[0] : "") length:count
+                                                   encoding:NSASCIIStringEncoding];
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                          messageAsString:message];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+    }];
+}
+
+#pragma mark -
+#pragma mark Manifest reconciliation
+
+static NSString *const kScanditSDKManifestStatusNames[manifest::StatusCount] = {
+    @"short", @"complete", @"over", @"unexpected"
+};
+
+- (NSDictionary *)manifestTotals {
+    const manifest::Totals &totals = receivingManifest->totals();
+    return [NSDictionary dictionaryWithObjectsAndKeys:
+            [NSNumber numberWithUnsignedInteger:receivingManifest->lineCount()], @"lines",
+            [NSNumber numberWithUnsignedLongLong:totals.expectedUnits], @"expected",
+            [NSNumber numberWithUnsignedLongLong:totals.receivedUnits], @"received",
+            [NSNumber numberWithUnsignedInt:totals.lines[manifest::StatusShort]], @"short",
+            [NSNumber numberWithUnsignedInt:totals.lines[manifest::StatusComplete]], @"complete",
+            [NSNumber numberWithUnsignedInt:totals.lines[manifest::StatusOver]], @"over",
+            [NSNumber numberWithUnsignedInt:totals.lines[manifest::StatusUnexpected]], @"unexpected",
+            nil];
+}
+
+- (void)loadManifest:(CDVInvokedUrlCommand *)command {
+    id rows = [command.arguments count] > 0 ? [command.arguments objectAtIndex:0] : nil;
+    if (![rows isKindOfClass:[NSString class]] && ![rows isKindOfClass:[NSArray class]]) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"Expected a string or an array of rows"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    // The manifest is built off the main thread and swapped in afterwards, so scans keep being
+    // matched against the previous manifest until the new one is complete.
+    [self.commandDelegate runInBackground:^{
+        manifest::Manifest *loaded = new manifest::Manifest();
+        NSString *error = nil;
+        if ([rows isKindOfClass:[NSString class]]) {
+            NSData *text = [rows dataUsingEncoding:NSUTF8StringEncoding];
+            size_t invalidRow = 0;
+            loaded->addRows((const char *)[text bytes], [text length], &invalidRow);
+            if (invalidRow != 0) {
+                error = [NSString stringWithFormat:@"Expected a positive count in row %lu", (unsigned long)invalidRow];
+            }
+        } else {
+            loaded->reserve([rows count], [rows count] * 16);
+            for (id row in rows) {
+                id code = row;
+                id expected = nil;
+                if ([row isKindOfClass:[NSArray class]] && [row count] > 0) {
+                    code = [row objectAtIndex:0];
+                    expected = [row count] > 1 ? [row objectAtIndex:1] : nil;
+                }
+                if (![code isKindOfClass:[NSString class]]) {
+                    continue;
+                }
+                uint32_t count = 1;
+                if ([expected isKindOfClass:[NSNumber class]]) {
+                    // unsignedIntValue would turn -1 into 4294967295.
+                    double value = [expected doubleValue];
+                    if (!(value >= 1 && value <= UINT32_MAX && value == floor(value))) {
+                        error = [NSString stringWithFormat:@"Expected a positive count for %@", code];
+                        break;
+                    }
+                    count = (uint32_t)value;
+                }
+                const char *bytes = [code UTF8String];
+                loaded->add(bytes, strlen(bytes), count);
+            }
+        }
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (error != nil) {
+                // The previous manifest stays loaded.
+                delete loaded;
+                CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                                  messageAsString:error];
+                [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+                return;
+            }
+            delete self->receivingManifest;
+            self->receivingManifest = loaded;
+            self->manifestGeneration++;
+            CDVLogInfo(CDVLogCategoryPlugin, @"[ScanditSDK] loaded manifest with %lu lines",
+                       (unsigned long)loaded->lineCount());
+            CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                          messageAsDictionary:[self manifestTotals]];
+            [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        });
+    }];
+}
+
+- (void)reconcile:(CDVInvokedUrlCommand *)command {
+    reconcileCallbackId = command.callbackId;
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_NO_RESULT];
+    [pluginResult setKeepCallbackAsBool:YES];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+- (void)manifestDiff:(CDVInvokedUrlCommand *)command {
+    if (receivingManifest == NULL) {
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_ERROR
+                                                          messageAsString:@"No manifest loaded"];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    id includeArgument = [command.arguments count] > 0 ? [command.arguments objectAtIndex:0] : nil;
+    BOOL includeComplete = [includeArgument isKindOfClass:[NSNumber class]] && [includeArgument boolValue];
+    NSDictionary *options = [command.arguments count] > 1 ? [command.arguments objectAtIndex:1] : nil;
+    BOOL paged = [options isKindOfClass:[NSDictionary class]] && [[options objectForKey:@"cursor"] boolValue];
+    
+    std::vector<manifest::Delta> deltas;
+    receivingManifest->diff(deltas, includeComplete);
+    if (paged) {
+        // Only the deltas are kept; a page builds its lines from them and the manifest.
+        __weak ScanditSDK *weakSelf = self;
+        NSUInteger generation = manifestGeneration;
+        __block size_t next = 0;
+        CDVCursor *cursor = [CDVCursor cursorWithIterator:^id {
+            ScanditSDK *strongSelf = weakSelf;
+            if (strongSelf == nil || strongSelf->manifestGeneration != generation || next >= deltas.size()) {
+                return nil;
+            }
+            return [strongSelf manifestLineForDelta:deltas[next++]];
+        } count:deltas.size()];
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                       messageAsMultipart:[NSArray arrayWithObjects:
+                                                                           [self manifestTotals],
+                                                                           [self.commandDelegate openCursor:cursor], nil]];
+        [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+        return;
+    }
+    
+    NSMutableArray *lines = [NSMutableArray arrayWithCapacity:deltas.size()];
+    for (size_t i = 0; i < deltas.size(); i++) {
+        [lines addObject:[self manifestLineForDelta:deltas[i]]];
+    }
+    
+    NSDictionary *diff = [NSDictionary dictionaryWithObjectsAndKeys:
+                          [self manifestTotals], @"totals", lines, @"lines", nil];
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                  messageAsDictionary:diff];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+/**
+ * [line, code, expected, received, status] of a line of the loaded manifest, the order of both
+ * manifestDiff lines and reconcile events.
+ */
+- (NSArray *)manifestLineForDelta:(const manifest::Delta &)delta {
+    size_t length;
+    const char *code = receivingManifest->code(delta.line, &length);
+    return [NSArray arrayWithObjects:
+            [NSNumber numberWithUnsignedInt:delta.line],
+            [[NSString alloc] initWithBytes:code length:length encoding:NSUTF8StringEncoding] ?: @"",
+            [NSNumber numberWithUnsignedInt:delta.expected],
+            [NSNumber numberWithUnsignedInt:delta.received],
+            kScanditSDKManifestStatusNames[delta.status],
+            nil];
+}
+
+- (void)clearManifest:(CDVInvokedUrlCommand *)command {
+    delete receivingManifest;
+    receivingManifest = NULL;
+    manifestGeneration++;
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:command.callbackId];
+}
+
+/**
+ * Counts a scanned or entered code against the loaded manifest and reports the changed line
+ * to the reconcile callback.
+ */
+- (void)reconcileCode:(NSString *)code {
+    if (receivingManifest == NULL || code == nil) {
+        return;
+    }
+    const char *bytes = [code UTF8String];
+    manifest::Delta delta = receivingManifest->receive(bytes, strlen(bytes));
+    if (reconcileCallbackId == nil) {
+        return;
+    }
+    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                       messageAsArray:[self manifestLineForDelta:delta]];
+    [pluginResult setKeepCallbackAsBool:YES];
+    [self.commandDelegate sendPluginResult:pluginResult callbackId:reconcileCallbackId];
+}
+
+#pragma mark -
+#pragma mark Barcode rendering
+
+// Budget of the rendered image cache, shared by all web views.
+#define kScanditSDKBarcodeCacheBytes (2 * 1024 * 1024)
+#define kScanditSDKBarcodeCacheEntries 256
+
+static image::Cache *gBarcodeCache = NULL;
+static NSObject *gBarcodeCacheLock = nil;
+
+static BOOL ScanditSDKEncoderSymbology(ScanditSDKSymbology symbology, encoder::Symbology *out) {
+    switch (symbology) {
+        case ScanditSDKSymbologyEan13: *out = encoder::SymbologyEAN13; return YES;
+        case ScanditSDKSymbologyUpc12: *out = encoder::SymbologyUPCA; return YES;
+        case ScanditSDKSymbologyEan8: *out = encoder::SymbologyEAN8; return YES;
+        case ScanditSDKSymbologyUpce: *out = encoder::SymbologyUPCE; return YES;
+        case ScanditSDKSymbologyCode39: *out = encoder::SymbologyCode39; return YES;
+        case ScanditSDKSymbologyCode128: *out = encoder::SymbologyCode128; return YES;
+        case ScanditSDKSymbologyItf: *out = encoder::SymbologyITF; return YES;
+        case ScanditSDKSymbologyQr: *out = encoder::SymbologyQR; return YES;
+        case ScanditSDKSymbologyDatamatrix: *out = encoder::SymbologyDataMatrix; return YES;
+        case ScanditSDKSymbologyPdf417: *out = encoder::SymbologyPDF417; return YES;
+        default: return NO;
+    }
+}
+
+static NSDictionary *ScanditSDKQueryParameters(NSURL *url) {
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionary];
+    for (NSString *pair in [[url query] componentsSeparatedByString:@"&"]) {
+        NSRange equals = [pair rangeOfString:@"="];
+        if (equals.location == NSNotFound) {
+            continue;
+        }
+        NSString *value = [[pair substringFromIndex:equals.location + 1]
+                           stringByReplacingOccurrencesOfString:@"+" withString:@" "];
+        value = [value stringByReplacingPercentEscapesUsingEncoding:NSUTF8StringEncoding];
+        if (value != nil) {
+            [parameters setObject:value forKey:[pair substringToIndex:equals.location]];
+        }
+    }
+    return parameters;
+}
+
+/**
+ * Renders /!gap_res/barcode/<SYMBOLOGY>.png?d=<code>, see ScanditSDK.h for the parameters.
+ * Returns nil for a symbology or code that cannot be rendered. Runs on URL loading threads.
+ */
+static NSData *ScanditSDKRenderBarcode(NSURL *url, NSString **mimeType) {
+    NSString *name = [[[url lastPathComponent] stringByDeletingPathExtension] uppercaseString];
+    ScanditSDKSymbology symbology = ScanditSDKSymbologyFromString(name);
+    NSDictionary *parameters = ScanditSDKQueryParameters(url);
+    NSData *code = [[parameters objectForKey:@"d"] dataUsingEncoding:NSUTF8StringEncoding];
+    if (code == nil || ![[[url pathExtension] lowercaseString] isEqualToString:@"png"]) {
+        return nil;
+    }
+
+    // Requests differ in the host part only between pages; the result does not.
+    std::string key([[NSString stringWithFormat:@"%@?%@", [url path], [url query]] UTF8String]);
+    std::vector<uint8_t> bytes;
+    @synchronized(gBarcodeCacheLock) {
+        if (gBarcodeCache->get(key, &bytes)) {
+            *mimeType = @"image/png";
+            return [NSData dataWithBytes:&bytes[0] length:bytes.size()];
+        }
+    }
+
+    image::RenderOptions renderOptions;
+    NSString *scale = [parameters objectForKey:@"scale"];
+    if (scale != nil) {
+        renderOptions.scale = (unsigned)MAX([scale intValue], 1);
+    }
+    renderOptions.barHeight = (unsigned)MAX([[parameters objectForKey:@"height"] intValue], 0);
+    NSString *quiet = [parameters objectForKey:@"quiet"];
+    if (quiet != nil) {
+        renderOptions.quietZone = MAX([quiet intValue], 0);
+    }
+
+    encoder::Symbology encoderSymbology;
+    if (!ScanditSDKEncoderSymbology(symbology, &encoderSymbology)) {
+        return nil;
+    }
+    encoder::Options options;
+    NSString *level = [[parameters objectForKey:@"ec"] uppercaseString];
+    NSRange levelIndex = [level length] == 1 ? [@"LMQH" rangeOfString:level] : NSMakeRange(NSNotFound, 0);
+    if (levelIndex.location != NSNotFound) {
+        options.qrLevel = (encoder::QRLevel)levelIndex.location;
+    }
+    levelIndex = [level length] == 1 ? [@"012345678" rangeOfString:level] : NSMakeRange(NSNotFound, 0);
+    if (levelIndex.location != NSNotFound) {
+        options.pdf417Level = (int)levelIndex.location;
+    }
+    options.code39CheckCharacter = [[parameters objectForKey:@"check"] boolValue];
+    encoder::Symbol symbol;
+    encoder::Error error = encoder::encode(encoderSymbology, (const char *)[code bytes], [code length], options,
+                                           &symbol);
+    if (error != encoder::ErrorNone) {
+        CDVLogWarning(CDVLogCategoryPlugin, @"[ScanditSDK] Cannot render a code of %lu bytes as %@ (error %d).",
+                      (unsigned long)[code length], name, (int)error);
+        return nil;
+    }
+    if (!image::renderPNG(symbol, renderOptions, &bytes)) {
+        return nil;
+    }
+    @synchronized(gBarcodeCacheLock) {
+        gBarcodeCache->put(key, bytes);
+    }
+    *mimeType = @"image/png";
+    return [NSData dataWithBytes:&bytes[0] length:bytes.size()];
+}
+
++ (void)registerBarcodeRenderer {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        gBarcodeCache = new image::Cache(kScanditSDKBarcodeCacheBytes, kScanditSDKBarcodeCacheEntries);
+        gBarcodeCacheLock = [[NSObject alloc] init];
+        [CDVURLProtocol registerResourceHandler:^NSData *(NSURL *url, NSString **mimeType) {
+            return ScanditSDKRenderBarcode(url, mimeType);
+        } forName:@"barcode"];
+    });
+}
+
+#pragma mark -
+#pragma mark Picker configuration
+
+/**
+ * Creates the picker and applies all options shared by the modal and the embedded mode.
+ */
+- (void)createPickerWithAppKey:(NSString *)appKey options:(NSDictionary *)options {
+    parkedInBackground = NO;
+    resumedAt = nil;
+    scanStartedAt = [NSDate date];
+    
 	CameraFacingDirection facing = CAMERA_FACING_BACK;
     NSObject *preferFrontCamera = [options objectForKey:@"preferFrontCamera"];
     if (preferFrontCamera && [preferFrontCamera isKindOfClass:[NSNumber class]]) {
@@ -200,6 +1553,8 @@
     if (torch && [torch isKindOfClass:[NSNumber class]]) {
         [scanditSDKBarcodePicker.overlayController setTorchEnabled:[((NSNumber *)torch) boolValue]];
     }
+    [self configureAutoTorchWithOptions:options];
+    [self configureDutyCycleWithOptions:options];
     NSObject *torchButtonPositionAndSize = [options objectForKey:@"torchButtonPositionAndSize"];
     if (torchButtonPositionAndSize && [torchButtonPositionAndSize isKindOfClass:[NSString class]]) {
         NSArray *split = [((NSString *) torchButtonPositionAndSize) componentsSeparatedByString:@"/"];
@@ -326,35 +1681,48 @@
     if (maxManual && [maxManual isKindOfClass:[NSNumber class]]) {
         [scanditSDKBarcodePicker.overlayController setMaxSearchBarBarcodeLength:[((NSNumber *) maxManual) integerValue]];
     }
-    
-    // Show the toolbar that contains a cancel button.
-    [scanditSDKBarcodePicker.overlayController showToolBar:YES];
-	
-    // Set this class as the delegate for the overlay controller. It will now receive events when
-    // a barcode was successfully scanned, manually entered or the cancel button was pressed.
-	scanditSDKBarcodePicker.overlayController.delegate = self;
-    
-	startAnimationDone = NO;
-	self.bufferedResult = nil;
-	
-	// Present the barcode picker modally and start scanning.
-	if ([self.viewController respondsToSelector:@selector(presentViewController:animated:completion:)]) {
-		[self.viewController presentViewController:scanditSDKBarcodePicker animated:YES completion:^{
-			startAnimationDone = YES;
-			if (self.bufferedResult != nil) {
-				[self scanditSDKOverlayController:scanditSDKBarcodePicker.overlayController
-								   didScanBarcode:self.bufferedResult];
-				self.bufferedResult = nil;
-			}
-		}];
-	} else {
-		[self.viewController presentModalViewController:scanditSDKBarcodePicker animated:NO];
-		startAnimationDone = YES;
-	}
-	
-	[scanditSDKBarcodePicker performSelector:@selector(startScanning) withObject:nil afterDelay:0.1];
 }
 
+#pragma mark -
+#pragma mark Scan results
+
+/**
+ * Builds the result for a scanned or entered code with the encoder generated from
+ * schema/scan-result.json. The payload starts with [barcode, symbology] like before.
+ */
+- (CDVPluginResult *)resultForCode:(NSString *)code symbology:(NSString *)symbology manual:(BOOL)manual {
+    NSString *json = ScanditSDKEncodeScanResult(code, symbology, [[NSDate date] timeIntervalSince1970] * 1000.0,
+                                                manual, [self gtinForCode:code symbology:symbology]);
+    return [CDVPluginResult resultWithStatus:CDVCommandStatus_OK messageAsEncodedJSON:json];
+}
+
+/**
+ * Returns the code as a zero-padded GTIN-14 for retail symbologies, nil otherwise.
+ */
+- (NSString *)gtinForCode:(NSString *)code symbology:(NSString *)symbology {
+    switch (ScanditSDKSymbologyFromString(symbology)) {
+        case ScanditSDKSymbologyEan13:
+        case ScanditSDKSymbologyUpc12:
+        case ScanditSDKSymbologyEan8:
+        case ScanditSDKSymbologyItf:
+            break;
+        default:
+            return nil;
+    }
+    NSUInteger length = [code length];
+    if (length > 14 || (length != 8 && length < 12)) {
+        return nil;
+    }
+    for (NSUInteger i = 0; i < length; i++) {
+        unichar c = [code characterAtIndex:i];
+        if (c < '0' || c > '9') {
+            return nil;
+        }
+    }
+    return [[@"00000000000000" substringToIndex:14 - length] stringByAppendingString:code];
+}
+
+
 #pragma mark -
 #pragma mark ScanDKOverlayControllerDelegate methods
 
@@ -366,13 +1734,26 @@
  */
 - (void)scanditSDKOverlayController:(ScanditSDKOverlayController *)scanditSDKOverlayController1
                      didScanBarcode:(NSDictionary *)barcodeResult {
+    [self noteDecode];
+    
 	if (!startAnimationDone) {
 		// If the initial animation hasn't finished yet we buffer the result and return it as soon
 		// as the animation finishes.
 		self.bufferedResult = barcodeResult;
 		return;
 	}
+    [self countDecode];
 	
+    [self reconcileCode:[barcodeResult objectForKey:@"barcode"]];
+    
+    if (self.embedded) {
+        // The embedded picker keeps scanning until the page stops or hides it.
+        [self sendEmbeddedResult:[self resultForCode:[barcodeResult objectForKey:@"barcode"]
+                                           symbology:[barcodeResult objectForKey:@"symbology"]
+                                              manual:NO]];
+        return;
+    }
+    
     if (!wasStatusBarHidden) {
         [[UIApplication sharedApplication] setStatusBarHidden:NO withAnimation:UIStatusBarAnimationNone];
     }
@@ -383,13 +1764,9 @@
     [self.viewController dismissModalViewControllerAnimated:YES];
 	self.scanditSDKBarcodePicker = nil;
 	
-    NSArray *result = [[NSArray alloc] initWithObjects:barcode, symbology, nil];
-    
-    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
-													   messageAsArray:result];
-	
-    [self writeJavascript:[pluginResult toSuccessCallbackString:self.callbackId]];
-    self.hasPendingOperation = NO;
+    CDVPluginResult *pluginResult = [self resultForCode:barcode symbology:symbology manual:NO];
+    [self sendSessionResult:pluginResult asError:NO];
+    [self finishSession];
 }
 
 /**
@@ -401,6 +1778,15 @@
 - (void)scanditSDKOverlayController:(ScanditSDKOverlayController *)scanditSDKOverlayController1
                 didCancelWithStatus:(NSDictionary *)status {
 	
+    if (self.embedded) {
+        [self removeEmbeddedPicker];
+        CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
+                                                          messageAsString:@"Canceled"];
+        [self sendSessionResult:pluginResult asError:YES];
+        [self finishSession];
+        return;
+    }
+    
     if (!wasStatusBarHidden) {
         [[UIApplication sharedApplication] setStatusBarHidden:NO withAnimation:UIStatusBarAnimationNone];
     }
@@ -410,8 +1796,8 @@
     
 	CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
                                                       messageAsString:@"Canceled"];
-    [self writeJavascript:[pluginResult toErrorCallbackString:self.callbackId]];
-    self.hasPendingOperation = NO;
+    [self sendSessionResult:pluginResult asError:YES];
+    [self finishSession];
 }
 
 /**
@@ -423,6 +1809,13 @@
 - (void)scanditSDKOverlayController:(ScanditSDKOverlayController *)scanditSDKOverlayController
                     didManualSearch:(NSString *)input {
 	
+    [self reconcileCode:input];
+    
+    if (self.embedded) {
+        [self sendEmbeddedResult:[self resultForCode:input symbology:[self symbologyForManualEntry:input] manual:YES]];
+        return;
+    }
+    
     if (!wasStatusBarHidden) {
         [[UIApplication sharedApplication] setStatusBarHidden:NO withAnimation:UIStatusBarAnimationNone];
     }
@@ -431,12 +1824,11 @@
 	self.scanditSDKBarcodePicker = nil;
     
 	
-    NSArray *result = [[NSArray alloc] initWithObjects:input, @"UNKNOWN", nil];
-    
-    CDVPluginResult *pluginResult = [CDVPluginResult resultWithStatus:CDVCommandStatus_OK
-													   messageAsArray:result];
-    [self writeJavascript:[pluginResult toSuccessCallbackString:self.callbackId]];
-    self.hasPendingOperation = NO;
+    CDVPluginResult *pluginResult = [self resultForCode:input
+                                           symbology:[self symbologyForManualEntry:input]
+                                              manual:YES];
+    [self sendSessionResult:pluginResult asError:NO];
+    [self finishSession];
 }
 
 
@@ -0,0 +1,97 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_BARCODEENCODER_HPP
+#define SCANDITSDK_BARCODEENCODER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Encoding of codes into barcode symbols for the symbologies the picker reads, in portable C++
+ * like ScanditSDKChecksum. A symbol is a grid of dark and light modules; linear symbologies have
+ * a single row that the rasterizer (ScanditSDKBarcodeImage) stretches to the bar height.
+ *
+ * EAN-13, UPC-A, EAN-8 and UPC-E take the code with or without its check digit (a given one is
+ * verified); ITF takes an even number of digits, or 13 for an ITF-14 with its check digit added.
+ * Code 39 takes its 43 characters without the '*' delimiters, Code 128 any ASCII. QR and Data
+ * Matrix take bytes; QR uses numeric or alphanumeric mode when the whole code allows it, Data
+ * Matrix packs digit pairs. PDF417 takes bytes too, in text, byte and numeric compaction by runs;
+ * its rows are three modules high, so every row of the symbol is repeated three times.
+ */
+namespace scanditsdk {
+namespace encoder {
+
+enum Symbology {
+    SymbologyEAN13 = 0,
+    SymbologyUPCA,
+    SymbologyEAN8,
+    SymbologyUPCE,
+    SymbologyCode39,
+    SymbologyCode128,
+    SymbologyITF,
+    SymbologyQR,
+    SymbologyDataMatrix,
+    SymbologyPDF417,
+    SymbologyCount
+};
+
+enum Error {
+    ErrorNone = 0,
+    ErrorCharacters, // a character the symbology cannot encode
+    ErrorLength,     // a length the symbology does not allow
+    ErrorCheckDigit, // the given check digit is wrong
+    ErrorCapacity    // too long for the largest symbol
+};
+
+enum QRLevel {
+    QRLevelL = 0, // ~7% of the codewords can be restored
+    QRLevelM,     // ~15%
+    QRLevelQ,     // ~25%
+    QRLevelH      // ~30%
+};
+
+struct Options {
+    Options() : qrLevel(QRLevelM), qrMask(-1), code39CheckCharacter(false), wideRatio(3), pdf417Level(-1),
+                pdf417Columns(0) {}
+
+    QRLevel qrLevel;
+    int qrMask;                // 0..7, or -1 for the one with the lowest penalty
+    bool code39CheckCharacter; // append the mod 43 check character
+    unsigned wideRatio;        // width of wide elements in Code 39 and ITF, 2 or 3 narrow modules
+    int pdf417Level;           // 0..8 (2^(level + 1) codewords), or -1 for the minimum recommended for the length
+    unsigned pdf417Columns;    // 1..30 data columns, or 0 for an image about three times as wide as high
+};
+
+struct Symbol {
+    Symbol() : width(0), height(0), quietZone(0) {}
+
+    unsigned width;
+    unsigned height;              // 1 for linear symbologies
+    unsigned quietZone;           // light modules the symbology needs on each side
+    std::vector<uint8_t> modules; // width * height, row by row; 1 is dark
+
+    bool isLinear() const { return height == 1; }
+    bool dark(unsigned x, unsigned y) const { return modules[y * width + x] != 0; }
+};
+
+/** Encodes length bytes of data. out is only valid if ErrorNone is returned. */
+Error encode(Symbology symbology, const char *data, size_t length, const Options &options, Symbol *out);
+
+} // namespace encoder
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_BARCODEENCODER_HPP
@@ -0,0 +1,87 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_BARCODEIMAGE_HPP
+#define SCANDITSDK_BARCODEIMAGE_HPP
+
+#include "ScanditSDKBarcodeEncoder.hpp"
+
+#include <list>
+#include <map>
+#include <string>
+
+/**
+ * Rendering of encoded symbols (ScanditSDKBarcodeEncoder) to PNG, and a cache of the results.
+ *
+ * The PNG is 1-bit grayscale: every module is scale x scale pixels, each pixel row is built once
+ * per module row and repeated, so rendering is linear in the number of pixel rows rather than in
+ * pixels and deflate sees long identical runs. No image library is needed beyond zlib.
+ */
+namespace scanditsdk {
+namespace image {
+
+/** Longest side of a rendered image in pixels. */
+const unsigned kMaxSide = 4096;
+
+struct RenderOptions {
+    RenderOptions() : scale(2), barHeight(0), quietZone(-1) {}
+
+    unsigned scale;     // pixels per module, at least 1
+    unsigned barHeight; // height of linear symbols in modules; 0 for half the symbol width
+    int quietZone;      // light modules on each side; negative for what the symbology needs
+};
+
+/** Pixel size of the rendered symbol. Returns false if a side would exceed kMaxSide. */
+bool imageSize(const encoder::Symbol &symbol, const RenderOptions &options, unsigned *width, unsigned *height);
+
+/** Renders symbol as a PNG into png. Returns false (png untouched) if the image would be too large. */
+bool renderPNG(const encoder::Symbol &symbol, const RenderOptions &options, std::vector<uint8_t> *png);
+
+/**
+ * Least recently used cache of rendered images by key, bounded by both the number of entries and
+ * their total size. An entry larger than the whole budget is not kept. Not thread safe.
+ */
+class Cache {
+public:
+    Cache(size_t maxBytes, size_t maxEntries);
+
+    /** Copies the entry into data and marks it as most recently used. */
+    bool get(const std::string &key, std::vector<uint8_t> *data);
+    void put(const std::string &key, const std::vector<uint8_t> &data);
+    void clear();
+
+    size_t entryCount() const { return entries_.size(); }
+    size_t byteCount() const { return bytes_; }
+    uint64_t hitCount() const { return hits_; }
+    uint64_t missCount() const { return misses_; }
+
+private:
+    typedef std::list<std::pair<std::string, std::vector<uint8_t> > > Entries;
+
+    void erase(Entries::iterator entry);
+
+    size_t maxBytes_;
+    size_t maxEntries_;
+    size_t bytes_;
+    uint64_t hits_;
+    uint64_t misses_;
+    Entries entries_; // most recently used first
+    std::map<std::string, Entries::iterator> index_;
+};
+
+} // namespace image
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_BARCODEIMAGE_HPP
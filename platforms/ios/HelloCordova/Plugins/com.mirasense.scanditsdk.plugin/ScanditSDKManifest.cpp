@@ -0,0 +1,241 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKManifest.hpp"
+
+#include <string.h>
+
+namespace scanditsdk {
+namespace manifest {
+
+namespace {
+
+// The table is grown before it is more than 3/4 full.
+const size_t kMinCapacity = 16;
+
+size_t capacityFor(size_t lines) {
+    size_t capacity = kMinCapacity;
+    while (capacity - capacity / 4 <= lines) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+} // namespace
+
+Manifest::Manifest() : slots_(kMinCapacity, 0) {
+    memset(&totals_, 0, sizeof(totals_));
+}
+
+uint32_t Manifest::hash(const char *code, size_t length) {
+    // FNV-1a; codes are short, so a byte loop beats anything wider.
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        h = (h ^ (uint8_t)code[i]) * 16777619u;
+    }
+    return h;
+}
+
+const char *Manifest::codeBytes(uint32_t line) const {
+    return codes_.empty() ? "" : &codes_[0] + codeOffsets_[line];
+}
+
+Status Manifest::statusOf(uint32_t expected, uint32_t received) {
+    if (expected == 0) {
+        return StatusUnexpected;
+    }
+    if (received < expected) {
+        return StatusShort;
+    }
+    return received == expected ? StatusComplete : StatusOver;
+}
+
+bool Manifest::lookup(const char *code, size_t length, uint32_t h, size_t *slot) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        uint32_t entry = slots_[i];
+        if (entry == 0) {
+            *slot = i;
+            return false;
+        }
+        uint32_t line = entry - 1;
+        if (hashes_[line] == h && codeLengths_[line] == length &&
+            memcmp(codeBytes(line), code, length) == 0) {
+            *slot = i;
+            return true;
+        }
+    }
+}
+
+void Manifest::rehash(size_t capacity) {
+    slots_.assign(capacity, 0);
+    size_t mask = capacity - 1;
+    for (uint32_t line = 0; line < hashes_.size(); ++line) {
+        size_t i = hashes_[line] & mask;
+        while (slots_[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = line + 1;
+    }
+}
+
+void Manifest::reserve(size_t lines, size_t codeBytes) {
+    codes_.reserve(codeBytes);
+    codeOffsets_.reserve(lines);
+    codeLengths_.reserve(lines);
+    hashes_.reserve(lines);
+    expected_.reserve(lines);
+    received_.reserve(lines);
+    if (capacityFor(lines) > slots_.size()) {
+        rehash(capacityFor(lines));
+    }
+}
+
+uint32_t Manifest::insert(const char *code, size_t length, uint32_t h, size_t slot, uint32_t expected) {
+    uint32_t line = (uint32_t)expected_.size();
+    codeOffsets_.push_back((uint32_t)codes_.size());
+    codeLengths_.push_back((uint32_t)length);
+    codes_.insert(codes_.end(), code, code + length);
+    hashes_.push_back(h);
+    expected_.push_back(expected);
+    received_.push_back(0);
+    slots_[slot] = line + 1;
+    totals_.expectedUnits += expected;
+    totals_.lines[statusOf(expected, 0)]++;
+
+    if (capacityFor(expected_.size()) > slots_.size()) {
+        rehash(slots_.size() * 2);
+    }
+    return line;
+}
+
+uint32_t Manifest::add(const char *code, size_t length, uint32_t expected) {
+    uint32_t h = hash(code, length);
+    size_t slot;
+    if (!lookup(code, length, h, &slot)) {
+        return insert(code, length, h, slot, expected);
+    }
+    uint32_t line = slots_[slot] - 1;
+    totals_.lines[statusOf(expected_[line], received_[line])]--;
+    expected_[line] += expected;
+    totals_.expectedUnits += expected;
+    totals_.lines[statusOf(expected_[line], received_[line])]++;
+    return line;
+}
+
+size_t Manifest::addRows(const char *text, size_t length, size_t *invalidRow) {
+    size_t rows = 0;
+    size_t number = 0;
+    const char *end = text + length;
+    for (const char *row = text; row < end;) {
+        number++;
+        const char *newline = (const char *)memchr(row, '\n', end - row);
+        const char *rowEnd = newline ? newline : end;
+        const char *next = newline ? newline + 1 : end;
+        if (rowEnd > row && rowEnd[-1] == '\r') {
+            rowEnd--;
+        }
+
+        // The count follows the last separator; without a numeric count the row is all code.
+        const char *separator = rowEnd;
+        for (const char *p = rowEnd; p > row; --p) {
+            if (p[-1] == ',' || p[-1] == '\t') {
+                separator = p - 1;
+                break;
+            }
+        }
+        const char *digits = separator + 1;
+        bool negative = digits < rowEnd && *digits == '-';
+        if (negative) {
+            digits++;
+        }
+        uint64_t expected = 0;
+        const char *p = digits;
+        for (; p < rowEnd && *p >= '0' && *p <= '9'; ++p) {
+            expected = expected > 0xffffffffu ? expected : expected * 10 + (uint64_t)(*p - '0');
+        }
+        if (separator == rowEnd || p == digits || p < rowEnd) {
+            separator = rowEnd;
+            expected = 1;
+        } else if (negative || expected == 0 || expected > 0xffffffffu) {
+            if (invalidRow != NULL) {
+                *invalidRow = number;
+            }
+            break;
+        }
+        if (separator > row) {
+            add(row, separator - row, (uint32_t)expected);
+            rows++;
+        }
+        row = next;
+    }
+    return rows;
+}
+
+Delta Manifest::receive(const char *code, size_t length, int32_t quantity) {
+    uint32_t h = hash(code, length);
+    size_t slot;
+    uint32_t line = lookup(code, length, h, &slot) ? slots_[slot] - 1 : insert(code, length, h, slot, 0);
+
+    uint32_t before = received_[line];
+    uint32_t after = before;
+    if (quantity >= 0) {
+        after = before + (uint32_t)quantity;
+    } else {
+        after = (uint32_t)-quantity > before ? 0 : before - (uint32_t)-quantity;
+    }
+    Status oldStatus = statusOf(expected_[line], before);
+    Status newStatus = statusOf(expected_[line], after);
+    received_[line] = after;
+    totals_.receivedUnits = totals_.receivedUnits - before + after;
+    totals_.lines[oldStatus]--;
+    totals_.lines[newStatus]++;
+
+    Delta delta = { line, expected_[line], after, newStatus };
+    return delta;
+}
+
+bool Manifest::find(const char *code, size_t length, uint32_t *line) const {
+    size_t slot;
+    if (!lookup(code, length, hash(code, length), &slot)) {
+        return false;
+    }
+    *line = slots_[slot] - 1;
+    return true;
+}
+
+Delta Manifest::line(uint32_t line) const {
+    Delta delta = { line, expected_[line], received_[line], statusOf(expected_[line], received_[line]) };
+    return delta;
+}
+
+const char *Manifest::code(uint32_t line, size_t *length) const {
+    *length = codeLengths_[line];
+    return codeBytes(line);
+}
+
+size_t Manifest::diff(std::vector<Delta> &out, bool includeComplete) const {
+    size_t before = out.size();
+    for (uint32_t i = 0; i < expected_.size(); ++i) {
+        Delta delta = line(i);
+        if (includeComplete || delta.status != StatusComplete) {
+            out.push_back(delta);
+        }
+    }
+    return out.size() - before;
+}
+
+} // namespace manifest
+} // namespace scanditsdk
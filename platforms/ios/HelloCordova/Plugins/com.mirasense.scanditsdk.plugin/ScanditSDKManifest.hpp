@@ -0,0 +1,112 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_MANIFEST_HPP
+#define SCANDITSDK_MANIFEST_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Expected-items manifest for receiving workflows, in portable C++ like ScanditSDKChecksum.
+ *
+ * Lines are kept in parallel arrays with their codes in one byte arena; an open-addressing
+ * table (linear probing, power-of-two capacity) maps codes to lines, so matching a scan is a
+ * hash plus usually one probe. Per-status line counts are updated with every scan, so the
+ * totals never need a pass over the manifest. Not thread safe.
+ */
+namespace scanditsdk {
+namespace manifest {
+
+enum Status {
+    StatusShort = 0,  // fewer received than expected
+    StatusComplete,
+    StatusOver,       // more received than expected
+    StatusUnexpected, // scanned but not on the manifest
+    StatusCount
+};
+
+/** State of one line after a change. */
+struct Delta {
+    uint32_t line;
+    uint32_t expected;
+    uint32_t received;
+    Status status;
+};
+
+struct Totals {
+    uint64_t expectedUnits;
+    uint64_t receivedUnits;
+    uint32_t lines[StatusCount];
+};
+
+class Manifest {
+public:
+    Manifest();
+
+    /** Adds expected units of code. A code that is already listed adds to its line. Returns the line. */
+    uint32_t add(const char *code, size_t length, uint32_t expected);
+
+    /**
+     * Adds one line per "code,expected" row of text. The last ',' or tab of a row separates the
+     * count, so codes may contain commas; a row without a numeric count is a code that expects 1.
+     * Blank rows and a trailing '\r' are ignored. A count of 0, a negative one or one that does not
+     * fit 32 bits stops at that row and stores its 1-based number in invalidRow, if given; the
+     * rows before it stay added. Returns the number of rows added.
+     */
+    size_t addRows(const char *text, size_t length, size_t *invalidRow = NULL);
+
+    /**
+     * Records quantity received units of code (negative to undo, received never drops below 0).
+     * A code that is not on the manifest gets a line of its own with nothing expected.
+     */
+    Delta receive(const char *code, size_t length, int32_t quantity = 1);
+
+    /** Looks up a code without recording anything. Returns false if it has no line. */
+    bool find(const char *code, size_t length, uint32_t *line) const;
+
+    size_t lineCount() const { return expected_.size(); }
+    Delta line(uint32_t line) const;
+    const char *code(uint32_t line, size_t *length) const;
+    const Totals &totals() const { return totals_; }
+
+    /** Appends the lines that are not complete, or all lines, in manifest order. Returns the number appended. */
+    size_t diff(std::vector<Delta> &out, bool includeComplete) const;
+
+    void reserve(size_t lines, size_t codeBytes);
+
+private:
+    static uint32_t hash(const char *code, size_t length);
+    static Status statusOf(uint32_t expected, uint32_t received);
+    const char *codeBytes(uint32_t line) const;
+    bool lookup(const char *code, size_t length, uint32_t hash, size_t *slot) const;
+    uint32_t insert(const char *code, size_t length, uint32_t hash, size_t slot, uint32_t expected);
+    void rehash(size_t capacity);
+
+    std::vector<char> codes_;
+    std::vector<uint32_t> codeOffsets_;
+    std::vector<uint32_t> codeLengths_;
+    std::vector<uint32_t> hashes_;
+    std::vector<uint32_t> expected_;
+    std::vector<uint32_t> received_;
+    std::vector<uint32_t> slots_; // line + 1, 0 for empty
+    Totals totals_;
+};
+
+} // namespace manifest
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_MANIFEST_HPP
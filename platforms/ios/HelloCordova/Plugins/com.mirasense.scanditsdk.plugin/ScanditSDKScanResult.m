@@ -0,0 +1,58 @@
+// Generated by tools/gen-scan-result.js from schema/scan-result.json. Do not edit.
+
+#import "ScanditSDKScanResult.h"
+
+static NSString* const kScanditSDKSymbologyNames[ScanditSDKSymbologyCount] = {
+    @"UNKNOWN", @"EAN13", @"UPC12", @"EAN8", @"UPCE", @"CODE128", @"CODE39", @"CODE93", @"ITF", @"MSI", @"CODABAR", @"GS1-DATABAR", @"GS1-DATABAR-EXPANDED", @"QR", @"DATAMATRIX", @"PDF417", @"AZTEC"
+};
+
+ScanditSDKSymbology ScanditSDKSymbologyFromString(NSString* name)
+{
+    for (int i = 0; i < ScanditSDKSymbologyCount; ++i) {
+        if ([name isEqualToString:kScanditSDKSymbologyNames[i]]) {
+            return (ScanditSDKSymbology)i;
+        }
+    }
+    return ScanditSDKSymbologyUnknown;
+}
+
+NSString* ScanditSDKSymbologyName(ScanditSDKSymbology value)
+{
+    return (value < ScanditSDKSymbologyCount) ? kScanditSDKSymbologyNames[value] : kScanditSDKSymbologyNames[0];
+}
+
+// Up to this many characters, the strings and the literal are built on the stack.
+#define ENCODE_STACK_CHARS 1024
+
+NSString* ScanditSDKEncodeScanResult(NSString* code, NSString* symbology, double timestamp, BOOL manual, NSString* gtin)
+{
+    NSUInteger codeLength = [code length];
+    NSUInteger symbologyLength = [symbology length];
+    NSUInteger gtinLength = [gtin length];
+    // The characters of the strings, then the literal.
+    size_t capacity = codeLength + symbologyLength + gtinLength + scanditsdk_scan_result_bound(codeLength, symbologyLength, gtinLength);
+    unichar stackBuffer[ENCODE_STACK_CHARS];
+    unichar* buffer = (capacity <= ENCODE_STACK_CHARS) ? stackBuffer : malloc(capacity * sizeof(unichar));
+    unichar* next = buffer;
+
+    if (buffer == NULL) {
+        return nil;
+    }
+    const unichar* codeChars = next;
+    [code getCharacters:next range:NSMakeRange(0, codeLength)];
+    next += codeLength;
+    const unichar* symbologyChars = next;
+    [symbology getCharacters:next range:NSMakeRange(0, symbologyLength)];
+    next += symbologyLength;
+    const unichar* gtinChars = next;
+    [gtin getCharacters:next range:NSMakeRange(0, gtinLength)];
+    next += gtinLength;
+
+    size_t length = scanditsdk_scan_result_encode(next, (code != nil) ? codeChars : NULL, codeLength, (symbology != nil) ? symbologyChars : NULL, symbologyLength, timestamp, manual, (gtin != nil) ? gtinChars : NULL, gtinLength);
+    NSString* js = [[NSString alloc] initWithCharacters:next length:length];
+
+    if (buffer != stackBuffer) {
+        free(buffer);
+    }
+    return js;
+}
@@ -0,0 +1,222 @@
+#!/usr/bin/env node
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ * Links the plugin js-modules listed in cordova_plugins.js into cordova.js, together with the
+ * module mapper entries (clobbers/merges/runs) that cordova/pluginloader would otherwise compute
+ * after injecting one <script> per module. The page then loads a single script and
+ * pluginloader finds the "cordova/plugin_bundle" module and skips injection altogether.
+ *
+ * Usage:
+ *   bundle-plugins.js <www dir> <output cordova.js> [--check]
+ *
+ *   --check  start the bundled and the unbundled cordova.js in a sandbox, check that both
+ *            reach deviceready with every clobbered symbol in place, and print their
+ *            startup marks
+ *
+ * The output is written to a temporary file and renamed, so it may replace a hard link to the
+ * source cordova.js (as created by copy-www-build-step.sh) without touching the source.
+ * pack-www.js --bundle-plugins uses the same code for packed builds.
+ */
+
+var fs = require('fs'),
+    path = require('path'),
+    vm = require('vm');
+
+var SPLICE_BEFORE = "\nwindow.cordova = require('cordova');",
+    DEFINE_PATTERN = /^\s*cordova\.define\(\s*(['"])([^'"]+)\1/;
+
+// Evaluates cordova_plugins.js with a stub define to get the module list.
+function readPluginList(wwwDir) {
+    var file = path.join(wwwDir, 'cordova_plugins.js'),
+        list = null;
+    if (!fs.existsSync(file)) {
+        return null;
+    }
+    vm.runInNewContext(fs.readFileSync(file, 'utf8'), {
+        cordova: {
+            define: function(id, factory) {
+                var module = { exports: {} };
+                factory(function() {}, module.exports, module);
+                list = module.exports;
+            }
+        }
+    }, { filename: file });
+    return list;
+}
+
+// Same order as onScriptLoadingComplete() in cordova/pluginloader.
+function mapperEntries(moduleList) {
+    var entries = [];
+    moduleList.forEach(function(module) {
+        var clobbers = module.clobbers || [],
+            merges = module.merges || [];
+        clobbers.forEach(function(symbol) { entries.push('c', module.id, symbol); });
+        merges.forEach(function(symbol) { entries.push('m', module.id, symbol); });
+        if (module.runs && !clobbers.length && !merges.length) {
+            entries.push('r', module.id, null);
+        }
+    });
+    return entries;
+}
+
+// plugman wraps every js-module in cordova.define(id, factory). Inside cordova.js the module
+// system's own define is in scope and window.cordova does not exist yet, so the call is
+// rewritten to that.
+function relink(source, expectedId, file) {
+    var match = DEFINE_PATTERN.exec(source);
+    if (!match) {
+        throw new Error(file + ' does not start with cordova.define()');
+    }
+    if (expectedId && match[2] != expectedId) {
+        throw new Error(file + ' defines ' + match[2] + ' instead of ' + expectedId);
+    }
+    return source.replace(/cordova\.define\(/, 'define(');
+}
+
+/**
+ * Returns the contents of cordova.js with the plugins of wwwDir linked in, or null if there is
+ * no cordova_plugins.js.
+ */
+function bundle(wwwDir) {
+    var cordovaJs = fs.readFileSync(path.join(wwwDir, 'cordova.js'), 'utf8'),
+        moduleList = readPluginList(wwwDir);
+    if (moduleList === null) {
+        return null;
+    }
+    var at = cordovaJs.indexOf(SPLICE_BEFORE);
+    if (at < 0) {
+        throw new Error('cordova.js has no bootstrap to insert the plugins before');
+    }
+
+    var parts = ['// file: cordova_plugins.js (linked by cordova/lib/bundle-plugins.js)',
+                 relink(fs.readFileSync(path.join(wwwDir, 'cordova_plugins.js'), 'utf8'),
+                        'cordova/plugin_list', 'cordova_plugins.js')];
+    moduleList.forEach(function(module) {
+        parts.push('// file: ' + module.file,
+                   relink(fs.readFileSync(path.join(wwwDir, module.file), 'utf8'), module.id, module.file));
+    });
+    parts.push('// file: module mapper entries of the plugins above',
+               'define("cordova/plugin_bundle", function(require, exports, module) {',
+               'module.exports = ' + JSON.stringify(mapperEntries(moduleList)) + ';',
+               '});');
+
+    return cordovaJs.slice(0, at) + '\n' + parts.join('\n\n') + '\n' + cordovaJs.slice(at);
+}
+
+// Minimal page environment, enough for cordova.js to initialize and load plugin scripts.
+function runInSandbox(source, wwwDir) {
+    var marks,
+        pending = [],
+        noop = function() {},
+        document = {
+            readyState: 'complete',
+            head: {
+                appendChild: function(script) {
+                    pending.push(function() {
+                        vm.runInContext(fs.readFileSync(path.join(wwwDir, script.src), 'utf8'), context);
+                        script.onload();
+                    });
+                }
+            },
+            createElement: function() { return {}; },
+            createEvent: function() { return { initEvent: noop }; },
+            getElementsByTagName: function() { return [{ src: 'cordova.js' }]; },
+            addEventListener: noop,
+            removeEventListener: noop,
+            dispatchEvent: noop
+        },
+        context = vm.createContext({
+            console: { log: noop, warn: noop },
+            document: document,
+            navigator: { userAgent: 'Mozilla/5.0 (iPhone; CPU iPhone OS 6_0 like Mac OS X)' },
+            setTimeout: noop,
+            XMLHttpRequest: function() {}
+        });
+    context.window = context;
+    context.addEventListener = context.removeEventListener = context.dispatchEvent = noop;
+    context._nativeReady = true;
+    vm.runInContext(source, context);
+    while (pending.length) {
+        pending.shift()();
+    }
+    marks = context.cordova.require('cordova/startup').marks.map(function(m) { return m.name; });
+    return { marks: marks, context: context };
+}
+
+function check(wwwDir, bundled) {
+    var plain = runInSandbox(fs.readFileSync(path.join(wwwDir, 'cordova.js'), 'utf8'), wwwDir),
+        linked = runInSandbox(bundled, wwwDir),
+        moduleList = readPluginList(wwwDir) || [],
+        failures = 0;
+
+    [plain, linked].forEach(function(run, i) {
+        var name = i ? 'bundled' : 'injected';
+        if (run.marks.indexOf('deviceready') < 0) {
+            console.error(name + ': deviceready was not reached (' + run.marks.join(', ') + ')');
+            failures++;
+        }
+        moduleList.forEach(function(module) {
+            (module.clobbers || []).forEach(function(symbol) {
+                var value = symbol.split('.').reduce(function(obj, key) { return obj && obj[key]; }, run.context.window);
+                if (value !== run.context.cordova.require(module.id)) {
+                    console.error(name + ': ' + symbol + ' is not ' + module.id);
+                    failures++;
+                }
+            });
+        });
+    });
+    console.log('injected: ' + plain.marks.join(' > '));
+    console.log('bundled:  ' + linked.marks.join(' > '));
+    if (failures) {
+        process.exit(1);
+    }
+}
+
+function main(argv) {
+    var args = argv.filter(function(a) { return a.indexOf('--') !== 0; }),
+        flags = argv.filter(function(a) { return a.indexOf('--') === 0; });
+    if (args.length != 2) {
+        console.error('Usage: bundle-plugins.js <www dir> <output cordova.js> [--check]');
+        process.exit(2);
+    }
+    var wwwDir = args[0],
+        out = args[1],
+        result = bundle(wwwDir);
+    if (result === null) {
+        console.log('No cordova_plugins.js in ' + wwwDir + ', nothing to bundle.');
+        return;
+    }
+
+    var tmp = out + '.tmp';
+    fs.writeFileSync(tmp, result);
+    fs.renameSync(tmp, out);
+    console.log('Linked ' + readPluginList(wwwDir).length + ' plugin module(s) into ' + out + '.');
+
+    if (flags.indexOf('--check') != -1) {
+        check(wwwDir, result);
+    }
+}
+
+exports.bundle = bundle;
+
+if (require.main === module) {
+    main(process.argv.slice(2));
+}
@@ -20,11 +20,21 @@
 #
 #   This script copies the www directory into the Xcode project.
 #
+#   With the build setting CORDOVA_PACK_WWW=YES the directory is packed into a
+#   single www.cdvpak archive instead (see pack-www.js), which CDVURLProtocol
+#   serves from a memory-mapped file. CORDOVA_PACK_WWW_COMPRESS=YES additionally
+#   deflates entries that compress well.
+#
+#   Unless CORDOVA_BUNDLE_PLUGINS=NO, the plugin js-modules are linked into the
+#   shipped cordova.js (see bundle-plugins.js), so the page loads one script
+#   instead of cordova_plugins.js plus one per module.
+#
 #   This script should not be called directly.
 #   It is called as a build step from Xcode.
 
 SRC_DIR="www/"
 DST_DIR="$BUILT_PRODUCTS_DIR/$FULL_PRODUCT_NAME/www"
+DST_ARCHIVE="$BUILT_PRODUCTS_DIR/$FULL_PRODUCT_NAME/www.cdvpak"
 COPY_HIDDEN=
 ORIG_IFS=$IFS
 IFS=$(echo -en "\n\b")
@@ -43,11 +53,26 @@ fi
 time (
 # Code signing files must be removed or else there are
 # resource signing errors.
-rm -rf "$DST_DIR" \
+rm -rf "$DST_DIR" "$DST_ARCHIVE" \
        "$BUILT_PRODUCTS_DIR/$FULL_PRODUCT_NAME/_CodeSignature" \
        "$BUILT_PRODUCTS_DIR/$FULL_PRODUCT_NAME/PkgInfo" \
        "$BUILT_PRODUCTS_DIR/$FULL_PRODUCT_NAME/embedded.mobileprovision"
 
+# Packed archive; without node the loose files below are copied instead
+if [[ "$CORDOVA_PACK_WWW" == "YES" ]] && ! which node > /dev/null; then
+  echo "warning: node was not found, $DST_ARCHIVE was not packed."
+elif [[ "$CORDOVA_PACK_WWW" == "YES" ]]; then
+  PACK_FLAGS=
+  if [[ "$CORDOVA_PACK_WWW_COMPRESS" == "YES" ]]; then
+    PACK_FLAGS=--compress
+  fi
+  if [[ "$CORDOVA_BUNDLE_PLUGINS" != "NO" ]]; then
+    PACK_FLAGS="$PACK_FLAGS --bundle-plugins"
+  fi
+  node cordova/lib/pack-www.js "$SRC_DIR" "$DST_ARCHIVE" $PACK_FLAGS || exit 5
+  exit 0
+fi
+
 # Directories
 for p in $(do_find -type d -print); do
   subpath="${p#$SRC_DIR}"
@@ -74,6 +99,15 @@ for p in $(do_find -type f -print); do
   fi
 done
 
+# Plugin bundle; replaces the copy of cordova.js, never the source
+if [[ "$CORDOVA_BUNDLE_PLUGINS" != "NO" ]]; then
+  if ! which node > /dev/null; then
+    echo "warning: node was not found, plugins were not bundled into ${DST_DIR}/cordova.js."
+  else
+    node cordova/lib/bundle-plugins.js "$SRC_DIR" "${DST_DIR}/cordova.js" || exit 6
+  fi
+fi
+
 )
 IFS=$ORIG_IFS
 
@@ -0,0 +1,198 @@
+#!/usr/bin/env node
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ * Generates the CDVPluginRegistry table (see CordovaLib/Classes/CDVPluginRegistry.h)
+ * from the <feature> entries of config.xml, after checking that every
+ * ios-package names a class declared in the given source directories and
+ * that the class implements each action the feature declares.
+ *
+ * Usage:
+ *   gen-plugin-registry.js <config.xml> <output.m> <source dir>...
+ *
+ * Actions are declared with <param name="actions" value="a,b"/>; actions
+ * listed in idempotent-actions or sync-actions must exist too. Problems are printed in the
+ * "error:" format Xcode understands and the script exits with status 1.
+ * The output file is only rewritten when its contents change.
+ */
+
+var fs = require('fs'),
+    path = require('path');
+
+function parseFeatures(xml) {
+    var features = [],
+        featureRe = /<feature\s+name\s*=\s*"([^"]+)"[^>]*>([\s\S]*?)<\/feature>/g,
+        paramRe = /<param\s+name\s*=\s*"([^"]+)"\s+value\s*=\s*"([^"]*)"/g,
+        m, p;
+
+    xml = xml.replace(/<!--[\s\S]*?-->/g, '');
+    while ((m = featureRe.exec(xml))) {
+        var feature = { name: m[1], className: null, actions: [] };
+        while ((p = paramRe.exec(m[2]))) {
+            var paramName = p[1].toLowerCase();
+            if (paramName == 'ios-package') {
+                feature.className = p[2];
+            } else if (paramName == 'actions' || paramName == 'idempotent-actions' || paramName == 'sync-actions') {
+                p[2].split(',').forEach(function(action) {
+                    action = action.trim();
+                    if (action && feature.actions.indexOf(action) < 0) {
+                        feature.actions.push(action);
+                    }
+                });
+            }
+        }
+        features.push(feature);
+    }
+    return features;
+}
+
+function listSources(dir, out) {
+    fs.readdirSync(dir).forEach(function(name) {
+        var file = path.join(dir, name),
+            stat = fs.statSync(file);
+        if (stat.isDirectory()) {
+            listSources(file, out);
+        } else if (/\.(h|m|mm)$/.test(name)) {
+            out.push(file);
+        }
+    });
+    return out;
+}
+
+// class name -> { header: path, methods: { selector: true } }
+function scanClasses(files) {
+    var classes = {};
+
+    function classInfo(name) {
+        return classes[name] || (classes[name] = { header: null, methods: {} });
+    }
+
+    files.forEach(function(file) {
+        var text = fs.readFileSync(file, 'utf8').replace(/\/\*[\s\S]*?\*\//g, '').replace(/\/\/.*$/gm, ''),
+            blockRe = /@(interface|implementation)\s+(\w+)\b([\s\S]*?)@end/g,
+            methodRe = /^\s*-\s*\(\s*void\s*\)\s*(\w+)\s*:\s*\(\s*CDVInvokedUrlCommand\s*\*\s*\)/gm,
+            m, method;
+
+        while ((m = blockRe.exec(text))) {
+            var info = classInfo(m[2]);
+            // "@interface Foo : Bar" declares the class; "@interface Foo ()" is an extension.
+            if (m[1] == 'interface' && /^\s*:/.test(m[3]) && /\.h$/.test(file)) {
+                info.header = file;
+            }
+            while ((method = methodRe.exec(m[3]))) {
+                info.methods[method[1]] = true;
+            }
+        }
+    });
+    return classes;
+}
+
+function importLine(header, outputDir) {
+    // CordovaLib headers are reached through the framework-style include path.
+    if (/CordovaLib\/Classes\//.test(header)) {
+        return '#import <Cordova/' + path.basename(header) + '>';
+    }
+    return '#import "' + path.relative(outputDir, header).split(path.sep).join('/') + '"';
+}
+
+function generate(features, classes, outputDir) {
+    var imports = [], factories = [], entries = [];
+
+    features.forEach(function(feature) {
+        var line = importLine(classes[feature.className].header, outputDir);
+        if (imports.indexOf(line) < 0) {
+            imports.push(line);
+        }
+        factories.push('static CDVPlugin* CDVCreate' + feature.className + '(UIWebView* webView)\n' +
+                       '{\n' +
+                       '    return [[' + feature.className + ' alloc] initWithWebView:webView];\n' +
+                       '}\n');
+        entries.push('    {"' + feature.name.toLowerCase() + '", "' + feature.className + '", CDVCreate' + feature.className + '},');
+    });
+
+    return '// Generated by cordova/lib/gen-plugin-registry.js from config.xml. Do not edit.\n\n' +
+           '#import <Cordova/CDVPluginRegistry.h>\n' +
+           '#import <Cordova/CDVPlugin.h>\n' +
+           imports.join('\n') + '\n\n' +
+           factories.join('\n') + '\n' +
+           'static const CDVPluginRegistryEntry kGeneratedPluginEntries[] = {\n' +
+           entries.join('\n') + '\n' +
+           '};\n\n' +
+           '@interface CDVGeneratedPluginRegistry : NSObject\n' +
+           '@end\n\n' +
+           '@implementation CDVGeneratedPluginRegistry\n\n' +
+           '+ (void)load\n' +
+           '{\n' +
+           '    [CDVPluginRegistry registerEntries:kGeneratedPluginEntries\n' +
+           '                                 count:sizeof(kGeneratedPluginEntries) / sizeof(kGeneratedPluginEntries[0])];\n' +
+           '}\n\n' +
+           '@end\n';
+}
+
+function main(args) {
+    if (args.length < 3) {
+        console.error('Usage: gen-plugin-registry.js <config.xml> <output.m> <source dir>...');
+        return 2;
+    }
+    var configPath = args[0],
+        outputPath = args[1],
+        files = [];
+
+    args.slice(2).forEach(function(dir) {
+        listSources(dir, files);
+    });
+
+    var features = parseFeatures(fs.readFileSync(configPath, 'utf8')),
+        classes = scanClasses(files),
+        errors = [];
+
+    features = features.filter(function(feature) {
+        if (!feature.className) {
+            return false;
+        }
+        var info = classes[feature.className];
+        if (!info || !info.header) {
+            errors.push(configPath + ': error: feature "' + feature.name + '" maps to class ' +
+                        feature.className + ', which is not declared in any header');
+            return false;
+        }
+        feature.actions.forEach(function(action) {
+            if (!info.methods[action]) {
+                errors.push(configPath + ': error: feature "' + feature.name + '" declares action "' + action +
+                            '", but ' + feature.className + ' has no -' + action + ':(CDVInvokedUrlCommand*) method');
+            }
+        });
+        return true;
+    });
+
+    if (errors.length) {
+        errors.forEach(function(e) { console.error(e); });
+        return 1;
+    }
+
+    var output = generate(features, classes, path.dirname(outputPath));
+    if (!fs.existsSync(outputPath) || fs.readFileSync(outputPath, 'utf8') != output) {
+        fs.writeFileSync(outputPath, output);
+        console.log('Wrote ' + features.length + ' plugin(s) to ' + outputPath);
+    }
+    return 0;
+}
+
+process.exit(main(process.argv.slice(2)));
@@ -0,0 +1,586 @@
+#!/usr/bin/env node
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ * Compiles the <access> origins of config.xml into the static decision table that
+ * CDVWhitelist uses instead of building NSRegularExpressions at startup (see
+ * CordovaLib/Classes/CDVWhitelistLookup.h).
+ *
+ * Usage:
+ *   gen-whitelist-table.js <config.xml> <output.m|output.c> [--check] [--corpus=<file>]
+ *
+ *   --check          compare the table against a port of the regular expression matcher
+ *                    of CDVWhitelist.m on URLs derived from the origins, and exit with
+ *                    status 1 if they disagree on any of them
+ *   --corpus=<file>  write those URLs and the decisions of the regular expression port
+ *                    to file, one per line, for the C lookups to be checked against
+ *                    (CordovaLib/tests/CDVWhitelistLookupTests.c)
+ *
+ * An output file ending in .c gets the table alone, as the plain C definition
+ * cdv_generated_whitelist_table; an .m file also registers it with CDVWhitelistTable.
+ *
+ * Origins are parsed with the same expression and rules as -[CDVWhitelist
+ * addWhiteListEntry:]. Each resulting pattern becomes a rule (scheme, port, path glob)
+ * filed under its host: one group for "*", an open-addressing hash of exact hosts and
+ * one of "*.suffix" hosts, which lookups probe at every dot of the host. The output file
+ * is only rewritten when its contents change.
+ */
+
+var fs = require('fs'),
+    path = require('path');
+
+// Prepended by CDVConfigParser before the <access> origins.
+var DEFAULT_ORIGINS = ['file:///*', 'content:///*', 'data:///*'],
+    DEFAULT_SCHEME = 'cdv-default-scheme',
+    ALWAYS_ALLOWED_SCHEMES = ['http', 'https', 'ftp', 'ftps'],
+    // ICU line terminators: "." does not match them and "$" also matches before one at the end.
+    NOT_TERMINATOR = '[^\\n\\r\\u0085\\u2028\\u2029]',
+    TERMINATOR = '(?:\\r\\n|[\\n\\r\\u0085\\u2028\\u2029])',
+    ORIGIN_RE = new RegExp('^((\\*|[a-z-]+)://)?(((\\*\\.)?[^*/:]+)|\\*)?(:(\\d+))?(/' + NOT_TERMINATOR + '*)?');
+
+function unescapeXml(s) {
+    return s.replace(/&(#x[0-9a-f]+|#\d+|lt|gt|amp|quot|apos);/gi, function(all, entity) {
+        switch (entity.toLowerCase()) {
+            case 'lt': return '<';
+            case 'gt': return '>';
+            case 'amp': return '&';
+            case 'quot': return '"';
+            case 'apos': return "'";
+        }
+        return String.fromCharCode(entity[1].toLowerCase() == 'x' ? parseInt(entity.slice(2), 16) : parseInt(entity.slice(1), 10));
+    });
+}
+
+// Same list as CDVConfigParser builds: the defaults, then every <access origin> in document order.
+function parseOrigins(xml, configPath, errors, warnings) {
+    var origins = DEFAULT_ORIGINS.slice(),
+        accessRe = /<access\b([^>]*)>/g,
+        m;
+
+    xml = xml.replace(/<!--[\s\S]*?-->/g, '');
+    while ((m = accessRe.exec(xml))) {
+        var origin = /\borigin\s*=\s*("([^"]*)"|'([^']*)')/.exec(m[1]);
+        if (!origin) {
+            errors.push(configPath + ': error: <access> without an origin attribute');
+            continue;
+        }
+        origin = unescapeXml(origin[2] !== undefined ? origin[2] : origin[3]);
+        // The runtime ignores whatever follows the part its expression matches.
+        if (origin != '*' && ORIGIN_RE.exec(origin)[0] != origin) {
+            warnings.push(configPath + ': warning: only "' + ORIGIN_RE.exec(origin)[0] + '" of access origin "' + origin + '" is used');
+        }
+        origins.push(origin);
+    }
+    return origins;
+}
+
+// -[CDVWhitelist addWhiteListEntry:] for every origin, producing the pattern list and the
+// permitted schemes. host is null when the origin has none, which never matches (the runtime
+// builds that host expression from nil).
+function compilePatterns(origins) {
+    var result = { allowAll: false, anyScheme: false, schemes: [], patterns: [] };
+
+    origins.forEach(function(origin) {
+        if (result.allowAll) {
+            return;
+        }
+        if (origin == '*') {
+            result.allowAll = true;
+            return;
+        }
+        var m = ORIGIN_RE.exec(origin),
+            scheme = m[2] === undefined ? null : m[2],
+            host = m[3] === undefined ? null : m[3],
+            port = m[7] === undefined ? null : m[7],
+            urlPath = m[8] === undefined ? null : m[8];
+
+        if ((scheme == 'file' || scheme == 'content') && host === null) {
+            host = '*';
+        }
+        var pattern = function(s) {
+            return {
+                scheme: s == '*' ? null : s,
+                hostKind: host === null ? 'none' : host == '*' ? 'any' : host.indexOf('*.') === 0 ? 'suffix' : 'exact',
+                host: host === null || host == '*' ? null : host.indexOf('*.') === 0 ? host.slice(2) : host,
+                port: port === null ? -1 : parseInt(port, 10),
+                path: urlPath === null || urlPath == '/*' ? null : urlPath
+            };
+        };
+        if (scheme === null) {
+            result.patterns.push(pattern('http'), pattern('https'));
+        } else {
+            result.patterns.push(pattern(scheme));
+        }
+        if (!result.anyScheme) {
+            if (scheme == '*') {
+                result.anyScheme = true;
+            } else if (scheme !== null && result.schemes.indexOf(scheme) < 0) {
+                result.schemes.push(scheme);
+            }
+        }
+    });
+    result.schemes.sort(compareBytes);
+    return result;
+}
+
+function utf8(s) {
+    return Buffer.from(s, 'utf8');
+}
+
+function compareBytes(a, b) {
+    return Buffer.compare(utf8(a), utf8(b));
+}
+
+function fnv1a(s) {
+    var bytes = utf8(s),
+        hash = 0x811c9dc5;
+    for (var i = 0; i < bytes.length; i++) {
+        hash = Math.imul(hash ^ bytes[i], 0x01000193) >>> 0;
+    }
+    return hash;
+}
+
+// Rules grouped by host: those for any host first, then one run per exact host and per
+// suffix, each run referenced from a hash slot. Duplicate rules within a group are dropped.
+function buildTable(origins) {
+    var compiled = compilePatterns(origins),
+        table = { origins: origins, allowAll: compiled.allowAll, anyScheme: compiled.anyScheme,
+                  schemes: compiled.schemes, rules: [], anyHostRuleCount: 0, exactHosts: [], suffixHosts: [] },
+        groups = { any: [], exact: {}, suffix: {} };
+
+    function add(list, pattern) {
+        var rule = { scheme: pattern.scheme, port: pattern.port, path: pattern.path };
+        if (!list.some(function(r) { return r.scheme === rule.scheme && r.port === rule.port && r.path === rule.path; })) {
+            list.push(rule);
+        }
+    }
+
+    if (compiled.allowAll) {
+        return table;
+    }
+    compiled.patterns.forEach(function(p) {
+        if (p.hostKind == 'any') {
+            add(groups.any, p);
+        } else if (p.hostKind != 'none') {
+            var byHost = groups[p.hostKind];
+            add(byHost[p.host] || (byHost[p.host] = []), p);
+        }
+    });
+
+    table.rules = groups.any.slice();
+    table.anyHostRuleCount = groups.any.length;
+    ['exact', 'suffix'].forEach(function(kind) {
+        var hosts = Object.keys(groups[kind]).sort(compareBytes),
+            size = 0,
+            slots;
+        if (hosts.length) {
+            size = 2;
+            while (size < hosts.length * 2) {
+                size *= 2;
+            }
+        }
+        slots = new Array(size);
+        hosts.forEach(function(host) {
+            var hash = fnv1a(host),
+                i = hash & (size - 1);
+            while (slots[i]) {
+                i = (i + 1) & (size - 1);
+            }
+            slots[i] = { hash: hash, host: host, firstRule: table.rules.length, ruleCount: groups[kind][host].length };
+            table.rules = table.rules.concat(groups[kind][host]);
+        });
+        table[kind + 'Hosts'] = slots;
+    });
+    if (table.rules.length > 0xffff) {
+        throw new Error('too many whitelist rules (' + table.rules.length + ')');
+    }
+    return table;
+}
+
+// ---- Lookups, the same as CDVWhitelistTable.m ----
+
+function isTerminator(c) {
+    return c == '\n' || c == '\r' || c == '\u0085' || c == '\u2028' || c == '\u2029';
+}
+
+// "*" matches any run of characters except line terminators; one terminator (or "\r\n") at
+// the end of the text is ignored, like "$" in ICU.
+function globMatches(glob, text) {
+    var n = text.length;
+    if (n >= 2 && text.slice(n - 2) == '\r\n') {
+        n -= 2;
+    } else if (n >= 1 && isTerminator(text[n - 1])) {
+        n -= 1;
+    }
+    for (var k = 0; k < n; k++) {
+        if (isTerminator(text[k])) {
+            return false;
+        }
+    }
+    var t = 0, g = 0, starG = -1, starT = 0;
+    while (t < n) {
+        if (g < glob.length && glob[g] == '*') {
+            starG = g++;
+            starT = t;
+        } else if (g < glob.length && glob[g] == text[t]) {
+            g++;
+            t++;
+        } else if (starG >= 0) {
+            g = starG + 1;
+            t = ++starT;
+        } else {
+            return false;
+        }
+    }
+    while (g < glob.length && glob[g] == '*') {
+        g++;
+    }
+    return g == glob.length;
+}
+
+function rulesMatch(table, first, count, url) {
+    for (var i = first; i < first + count; i++) {
+        var rule = table.rules[i];
+        if ((rule.scheme === null || rule.scheme === url.scheme) &&
+            (rule.port == -1 || url.port === rule.port) &&
+            (rule.path === null || globMatches(rule.path, url.path === null ? '' : url.path))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+function lookup(slots, host) {
+    if (!slots.length) {
+        return null;
+    }
+    var hash = fnv1a(host);
+    for (var i = hash & (slots.length - 1); slots[i]; i = (i + 1) & (slots.length - 1)) {
+        if (slots[i].hash === hash && slots[i].host === host) {
+            return slots[i];
+        }
+    }
+    return null;
+}
+
+function tableMatches(table, url) {
+    if (rulesMatch(table, 0, table.anyHostRuleCount, url)) {
+        return true;
+    }
+    if (url.host === null) {
+        return false;
+    }
+    var slot = lookup(table.exactHosts, url.host);
+    if (slot && rulesMatch(table, slot.firstRule, slot.ruleCount, url)) {
+        return true;
+    }
+    // "*.x" matches x itself and p.x, where p only has [a-z0-9.-].
+    var firstOther = url.host.search(/[^a-z0-9.-]/);
+    if (firstOther < 0) {
+        firstOther = url.host.length;
+    }
+    var d = -1;
+    do {
+        if (d > firstOther) {
+            break;
+        }
+        slot = lookup(table.suffixHosts, url.host.slice(d + 1));
+        if (slot && rulesMatch(table, slot.firstRule, slot.ruleCount, url)) {
+            return true;
+        }
+        d = url.host.indexOf('.', d + 1);
+    } while (d >= 0);
+    return false;
+}
+
+function tableSchemeIsAllowed(table, scheme) {
+    return ALWAYS_ALLOWED_SCHEMES.indexOf(scheme) >= 0 || table.allowAll || table.anyScheme ||
+           table.schemes.indexOf(scheme) >= 0;
+}
+
+function tableURLIsAllowed(table, url) {
+    if (table.allowAll) {
+        return true;
+    }
+    if (!tableSchemeIsAllowed(table, url.scheme)) {
+        return false;
+    }
+    if (ALWAYS_ALLOWED_SCHEMES.indexOf(url.scheme) >= 0 && tableSchemeIsAllowed(table, DEFAULT_SCHEME) &&
+        tableMatches(table, { scheme: DEFAULT_SCHEME, host: url.host, port: null, path: url.path })) {
+        return true;
+    }
+    return tableMatches(table, url);
+}
+
+// ---- Port of the regular expression matcher in CDVWhitelist.m, for --check ----
+
+function escapeRegex(s) {
+    return s.replace(/[\\^$.|?*+()[\]{}]/g, '\\$&');
+}
+
+function regexFromPattern(pattern, allowWildcards) {
+    var regex = escapeRegex(pattern);
+    if (allowWildcards) {
+        regex = regex.replace(/\\\*/g, NOT_TERMINATOR + '*');
+    }
+    return regex + '(?=' + TERMINATOR + '?$)';
+}
+
+function referenceMatcher(origins) {
+    var compiled = compilePatterns(origins),
+        patterns = compiled.patterns.map(function(p) {
+            var host = null;
+            if (p.hostKind == 'suffix') {
+                host = new RegExp('^(?:([a-z0-9.-]*\\.)?' + regexFromPattern(p.host, false) + ')');
+            } else if (p.hostKind == 'exact') {
+                host = new RegExp('^(?:' + regexFromPattern(p.host, false) + ')');
+            }
+            return {
+                scheme: p.scheme === null ? null : new RegExp('^(?:' + regexFromPattern(p.scheme, false) + ')'),
+                hostKind: p.hostKind,
+                host: host,
+                port: p.port,
+                path: p.path === null ? null : new RegExp('^(?:' + regexFromPattern(p.path, true) + ')')
+            };
+        });
+
+    function schemeIsAllowed(scheme) {
+        return ALWAYS_ALLOWED_SCHEMES.indexOf(scheme) >= 0 || compiled.allowAll || compiled.anyScheme ||
+               compiled.schemes.indexOf(scheme) >= 0;
+    }
+
+    function matches(p, url) {
+        return (p.scheme === null || (url.scheme !== null && p.scheme.test(url.scheme))) &&
+               (p.hostKind == 'any' || (p.host !== null && url.host !== null && p.host.test(url.host))) &&
+               (p.port == -1 || url.port === p.port) &&
+               (p.path === null || p.path.test(url.path === null ? '' : url.path));
+    }
+
+    function allowed(url) {
+        if (compiled.allowAll) {
+            return true;
+        }
+        if (!schemeIsAllowed(url.scheme)) {
+            return false;
+        }
+        if (ALWAYS_ALLOWED_SCHEMES.indexOf(url.scheme) >= 0 &&
+            allowed({ scheme: DEFAULT_SCHEME, host: url.host, port: null, path: url.path })) {
+            return true;
+        }
+        return patterns.some(function(p) { return matches(p, url); });
+    }
+
+    return { URLIsAllowed: allowed, schemeIsAllowed: schemeIsAllowed };
+}
+
+// URLs around every origin: the host itself, sub- and look-alike hosts, other schemes,
+// ports and paths, including paths with line terminators.
+function checkURLs(table) {
+    var compiled = compilePatterns(table.origins),
+        schemes = ['http', 'https', 'ftp', 'file', 'data', 'content', 'ws', 'mailto', DEFAULT_SCHEME].concat(compiled.schemes),
+        hosts = [null, '', 'example.com', 'localhost', '10.0.0.1'],
+        ports = [null, 80, 443, 8080],
+        paths = [null, '', '/', '/index.html', '/a/b/c', '/a\n', '/a\nb', '/a\r\n', '/a\n\r', '/x y',
+                 '/a\u2028', '/a\u2029b', '/a\u0085', '/\u00e9'],
+        urls = [];
+
+    compiled.patterns.forEach(function(p) {
+        if (p.host !== null) {
+            hosts.push(p.host, 'www.' + p.host, 'a.b.' + p.host, 'A.' + p.host, 'a_b.' + p.host, 'x' + p.host,
+                       p.host + '.evil.com', p.host.toUpperCase());
+        }
+        if (p.port != -1) {
+            ports.push(p.port, p.port + 1);
+        }
+        if (p.path !== null) {
+            var base = p.path.replace(/\*/g, '');
+            paths.push(base, p.path.replace(/\*/g, 'zz/q'), base + '/more', base.slice(0, -1), base + '\n', base + '\r\n',
+                       base + '\u2029', p.path.replace(/\*/g, 'a\u2028b'), p.path.replace(/\*/g, '\u0085'),
+                       p.path.replace(/\*/g, 'z\u2029'));
+        }
+    });
+    schemes.forEach(function(scheme) {
+        hosts.forEach(function(host) {
+            ports.forEach(function(port) {
+                paths.forEach(function(urlPath) {
+                    urls.push({ scheme: scheme, host: host, port: port, path: urlPath });
+                });
+            });
+        });
+    });
+    return urls;
+}
+
+function check(table) {
+    var reference = referenceMatcher(table.origins),
+        urls = checkURLs(table),
+        failures = 0;
+
+    urls.forEach(function(url) {
+        var expected = reference.URLIsAllowed(url),
+            actual = tableURLIsAllowed(table, url);
+        if (expected !== actual) {
+            if (failures++ < 20) {
+                console.error('mismatch for ' + JSON.stringify(url) + ': regex ' + expected + ', table ' + actual);
+            }
+        }
+        if (reference.schemeIsAllowed(url.scheme) !== tableSchemeIsAllowed(table, url.scheme)) {
+            failures++;
+            console.error('scheme mismatch for ' + url.scheme);
+        }
+    });
+    console.log('Checked ' + urls.length + ' URL(s) against ' + table.origins.length + ' origin(s): ' +
+                (failures ? failures + ' mismatch(es)' : 'no mismatches'));
+    return failures;
+}
+
+// One line per URL: the URL decision and the scheme decision of the regular expression
+// port (0 or 1), then scheme, host, port and path. A string is "-" for none, else "="
+// and its UTF-8 bytes in hex; the port is -1 for none.
+function corpus(table) {
+    var reference = referenceMatcher(table.origins);
+
+    function field(s) {
+        return s === null ? '-' : '=' + utf8(s).toString('hex');
+    }
+
+    return checkURLs(table).map(function(url) {
+        return [reference.URLIsAllowed(url) ? 1 : 0, reference.schemeIsAllowed(url.scheme) ? 1 : 0, field(url.scheme),
+                field(url.host), url.port === null ? -1 : url.port, field(url.path)].join(' ') + '\n';
+    }).join('');
+}
+
+// ---- Output ----
+
+function cString(s) {
+    if (s === null) {
+        return 'NULL';
+    }
+    return '"' + Array.prototype.map.call(utf8(s), function(b) {
+        if (b == 0x22 || b == 0x5c) {
+            return '\\' + String.fromCharCode(b);
+        }
+        if (b < 0x20 || b >= 0x7f || b == 0x3f) { // also "?", against trigraphs
+            return '\\' + ('00' + b.toString(8)).slice(-3);
+        }
+        return String.fromCharCode(b);
+    }).join('') + '"';
+}
+
+function slotsSource(name, slots) {
+    if (!slots.length) {
+        return '';
+    }
+    return 'static const cdv_whitelist_host_slot ' + name + '[] = {\n' +
+           Array.from(slots, function(slot) {
+               return slot ? '    {0x' + ('0000000' + slot.hash.toString(16)).slice(-8) + 'u, ' + cString(slot.host) + ', ' +
+                             slot.firstRule + ', ' + slot.ruleCount + '},'
+                           : '    {0, NULL, 0, 0},';
+           }).join('\n') + '\n};\n\n';
+}
+
+function generate(table, objc) {
+    function list(name, type, values, format) {
+        return values.length ? 'static const ' + type + ' ' + name + '[] = {\n' + values.map(function(v) { return '    ' + format(v) + ','; }).join('\n') + '\n};\n\n' : '';
+    }
+    function ref(name, values) {
+        return values.length ? name : 'NULL';
+    }
+
+    return '// Generated by cordova/lib/gen-whitelist-table.js from config.xml. Do not edit.\n\n' +
+           (objc ? '#import <Cordova/CDVWhitelistTable.h>\n\n' : '#include "CDVWhitelistLookup.h"\n\n') +
+           list('kOrigins', 'char* const', table.origins, cString) +
+           list('kSchemes', 'char* const', table.schemes, cString) +
+           list('kRules', 'cdv_whitelist_rule', table.rules, function(r) {
+               return '{' + cString(r.scheme) + ', ' + r.port + ', ' + cString(r.path) + '}';
+           }) +
+           slotsSource('kExactHosts', table.exactHosts) +
+           slotsSource('kSuffixHosts', table.suffixHosts) +
+           (objc ? 'static const cdv_whitelist_table kGeneratedWhitelistTable' : 'const cdv_whitelist_table cdv_generated_whitelist_table') +
+           ' = {\n' +
+           '    ' + ref('kOrigins', table.origins) + ', ' + table.origins.length + ',\n' +
+           '    ' + (table.allowAll ? 1 : 0) + ', ' + (table.anyScheme ? 1 : 0) + ',\n' +
+           '    ' + ref('kSchemes', table.schemes) + ', ' + table.schemes.length + ',\n' +
+           '    ' + ref('kRules', table.rules) + ', ' + table.anyHostRuleCount + ',\n' +
+           '    ' + ref('kExactHosts', table.exactHosts) + ', ' + table.exactHosts.length + ',\n' +
+           '    ' + ref('kSuffixHosts', table.suffixHosts) + ', ' + table.suffixHosts.length + '\n' +
+           '};\n' +
+           (!objc ? '' : '\n' +
+           '@interface CDVGeneratedWhitelistTable : NSObject\n' +
+           '@end\n\n' +
+           '@implementation CDVGeneratedWhitelistTable\n\n' +
+           '+ (void)load\n' +
+           '{\n' +
+           '    [CDVWhitelistTable registerTable:&kGeneratedWhitelistTable];\n' +
+           '}\n\n' +
+           '@end\n');
+}
+
+function writeIfChanged(file, contents) {
+    if (fs.existsSync(file) && fs.readFileSync(file, 'utf8') == contents) {
+        return false;
+    }
+    fs.writeFileSync(file, contents);
+    return true;
+}
+
+function main(argv) {
+    var args = argv.filter(function(a) { return a.indexOf('--') !== 0; }),
+        flags = argv.filter(function(a) { return a.indexOf('--') === 0; });
+    if (args.length != 2) {
+        console.error('Usage: gen-whitelist-table.js <config.xml> <output.m|output.c> [--check] [--corpus=<file>]');
+        return 2;
+    }
+    var configPath = args[0],
+        outputPath = args[1],
+        errors = [],
+        warnings = [],
+        origins = parseOrigins(fs.readFileSync(configPath, 'utf8'), configPath, errors, warnings);
+
+    warnings.forEach(function(w) { console.log(w); });
+    if (errors.length) {
+        errors.forEach(function(e) { console.error(e); });
+        return 1;
+    }
+    var table = buildTable(origins);
+    if (flags.indexOf('--check') != -1 && check(table)) {
+        return 1;
+    }
+
+    flags.forEach(function(flag) {
+        if (flag.indexOf('--corpus=') === 0) {
+            writeIfChanged(flag.slice('--corpus='.length), corpus(table));
+        }
+    });
+
+    var output = generate(table, path.extname(outputPath) != '.c');
+    if (writeIfChanged(outputPath, output)) {
+        console.log('Wrote ' + table.rules.length + ' whitelist rule(s) for ' + origins.length + ' origin(s) to ' + outputPath);
+    }
+    return 0;
+}
+
+exports.buildTable = buildTable;
+exports.tableURLIsAllowed = tableURLIsAllowed;
+exports.referenceMatcher = referenceMatcher;
+
+if (require.main === module) {
+    process.exit(main(process.argv.slice(2)));
+}
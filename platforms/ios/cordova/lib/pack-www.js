@@ -0,0 +1,314 @@
+#!/usr/bin/env node
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+/*
+ * Packs a www directory into a single indexed archive that CDVURLProtocol
+ * serves from a memory-mapped file (see CDVWwwArchive.m for the layout).
+ *
+ * Usage:
+ *   pack-www.js <www dir> <archive> [--compress] [--bundle-plugins] [--verify] [--bench]
+ *
+ *   --compress  deflate entries that get at least 10% smaller
+ *   --bundle-plugins
+ *               pack cordova.js with the plugin modules linked in (see bundle-plugins.js)
+ *   --verify    read the archive back and compare every entry with its source
+ *   --bench     time index lookups of every entry against the written archive
+ *
+ * Runs on any host with node, the archive does not depend on the build machine.
+ */
+
+var fs = require('fs'),
+    path = require('path'),
+    zlib = require('zlib');
+
+var MAGIC = 'CDVPAK01',
+    HEADER_SIZE = 40,
+    ENTRY_SIZE = 24,
+    FLAG_DEFLATED = 1;
+
+var MIME_TYPES = {
+    '.html': 'text/html',
+    '.htm': 'text/html',
+    '.js': 'application/javascript',
+    '.json': 'application/json',
+    '.css': 'text/css',
+    '.xml': 'text/xml',
+    '.txt': 'text/plain',
+    '.md': 'text/plain',
+    '.svg': 'image/svg+xml',
+    '.png': 'image/png',
+    '.jpg': 'image/jpeg',
+    '.jpeg': 'image/jpeg',
+    '.gif': 'image/gif',
+    '.ico': 'image/x-icon',
+    '.wav': 'audio/wav',
+    '.mp3': 'audio/mpeg',
+    '.mp4': 'video/mp4',
+    '.woff': 'application/font-woff',
+    '.ttf': 'application/x-font-ttf'
+};
+
+// FNV-1a over the UTF-8 bytes, must match CDVWwwArchiveHash().
+function hashPath(bytes) {
+    var hash = 2166136261;
+    for (var i = 0; i < bytes.length; i++) {
+        hash ^= bytes[i];
+        hash = Math.imul(hash, 16777619) >>> 0;
+    }
+    return hash >>> 0;
+}
+
+function listFiles(root) {
+    var files = [];
+    (function walk(dir) {
+        fs.readdirSync(dir).sort().forEach(function(name) {
+            // same rule as copy-www-build-step.sh: hidden files are not shipped
+            if (name.charAt(0) == '.') {
+                return;
+            }
+            var full = path.join(dir, name),
+                stat = fs.statSync(full);
+            if (stat.isDirectory()) {
+                walk(full);
+            } else if (stat.isFile()) {
+                files.push(path.relative(root, full).split(path.sep).join('/'));
+            }
+        });
+    })(root);
+    return files;
+}
+
+// overrides maps paths to contents that replace the files of wwwDir.
+function pack(wwwDir, compress, overrides) {
+    var files = listFiles(wwwDir),
+        mimes = [],
+        mimeIndex = {},
+        entries = [];
+
+    files.forEach(function(rel) {
+        var mime = MIME_TYPES[path.extname(rel).toLowerCase()] || 'application/octet-stream';
+        if (!(mime in mimeIndex)) {
+            mimeIndex[mime] = mimes.length;
+            mimes.push(mime);
+        }
+        var raw = overrides[rel] || fs.readFileSync(path.join(wwwDir, rel)),
+            data = raw,
+            flags = 0;
+        if (compress && raw.length > 0) {
+            var deflated = zlib.deflateSync(raw, { level: 9 });
+            if (deflated.length < raw.length * 0.9) {
+                data = deflated;
+                flags = FLAG_DEFLATED;
+            }
+        }
+        entries.push({ path: Buffer.from(rel, 'utf8'), raw: raw, data: data, flags: flags, mime: mimeIndex[mime] });
+    });
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short.
+    var bucketCount = 1;
+    while (bucketCount < entries.length * 2 + 1) {
+        bucketCount *= 2;
+    }
+
+    var buckets = new Uint32Array(bucketCount);
+    entries.forEach(function(entry, i) {
+        var slot = hashPath(entry.path) & (bucketCount - 1);
+        while (buckets[slot] !== 0) {
+            slot = (slot + 1) & (bucketCount - 1);
+        }
+        buckets[slot] = i + 1;
+    });
+
+    var strings = [], stringsLength = 0;
+    function addString(buf) {
+        var offset = stringsLength;
+        strings.push(buf);
+        stringsLength += buf.length;
+        return offset;
+    }
+    entries.forEach(function(entry) {
+        entry.pathOffset = addString(entry.path);
+    });
+    var mimeOffsets = mimes.map(function(mime) {
+        var buf = Buffer.from(mime, 'ascii');
+        return [addString(buf), buf.length];
+    });
+
+    var bucketsOffset = HEADER_SIZE,
+        entriesOffset = bucketsOffset + bucketCount * 4,
+        mimesOffset = entriesOffset + entries.length * ENTRY_SIZE,
+        stringsOffset = mimesOffset + mimes.length * 8,
+        dataOffset = stringsOffset + stringsLength;
+
+    // Align file data to 16 bytes, it is handed out as views into the mapping.
+    var chunks = [], offset = dataOffset;
+    entries.forEach(function(entry) {
+        var pad = (16 - (offset % 16)) % 16;
+        if (pad) {
+            chunks.push(Buffer.alloc(pad));
+            offset += pad;
+        }
+        entry.dataOffset = offset;
+        chunks.push(entry.data);
+        offset += entry.data.length;
+    });
+
+    var head = Buffer.alloc(dataOffset);
+    head.write(MAGIC, 0, 'ascii');
+    head.writeUInt32LE(entries.length, 8);
+    head.writeUInt32LE(bucketCount, 12);
+    head.writeUInt32LE(mimes.length, 16);
+    head.writeUInt32LE(bucketsOffset, 20);
+    head.writeUInt32LE(entriesOffset, 24);
+    head.writeUInt32LE(mimesOffset, 28);
+    head.writeUInt32LE(stringsOffset, 32);
+    for (var b = 0; b < bucketCount; b++) {
+        head.writeUInt32LE(buckets[b], bucketsOffset + b * 4);
+    }
+    entries.forEach(function(entry, i) {
+        var at = entriesOffset + i * ENTRY_SIZE;
+        head.writeUInt32LE(entry.pathOffset, at);
+        head.writeUInt32LE(entry.path.length, at + 4);
+        head.writeUInt32LE(entry.dataOffset, at + 8);
+        head.writeUInt32LE(entry.data.length, at + 12);
+        head.writeUInt32LE(entry.raw.length, at + 16);
+        head.writeUInt16LE(entry.mime, at + 20);
+        head.writeUInt16LE(entry.flags, at + 22);
+    });
+    mimeOffsets.forEach(function(mo, i) {
+        head.writeUInt32LE(mo[0], mimesOffset + i * 8);
+        head.writeUInt32LE(mo[1], mimesOffset + i * 8 + 4);
+    });
+    Buffer.concat(strings).copy(head, stringsOffset);
+
+    return { buffer: Buffer.concat([head].concat(chunks)), files: files };
+}
+
+// Mirror of -[CDVWwwArchive dataForPath:mimeType:].
+function Reader(buf) {
+    if (buf.toString('ascii', 0, 8) != MAGIC) {
+        throw new Error('not a www archive');
+    }
+    this.buf = buf;
+    this.entryCount = buf.readUInt32LE(8);
+    this.bucketCount = buf.readUInt32LE(12);
+    this.bucketsOffset = buf.readUInt32LE(20);
+    this.entriesOffset = buf.readUInt32LE(24);
+    this.mimesOffset = buf.readUInt32LE(28);
+    this.stringsOffset = buf.readUInt32LE(32);
+}
+
+Reader.prototype.lookup = function(rel) {
+    var buf = this.buf,
+        key = Buffer.from(rel, 'utf8'),
+        mask = this.bucketCount - 1;
+    for (var slot = hashPath(key) & mask;; slot = (slot + 1) & mask) {
+        var index = buf.readUInt32LE(this.bucketsOffset + slot * 4);
+        if (index === 0) {
+            return null;
+        }
+        var at = this.entriesOffset + (index - 1) * ENTRY_SIZE,
+            pathOffset = this.stringsOffset + buf.readUInt32LE(at),
+            pathLength = buf.readUInt32LE(at + 4);
+        if (pathLength == key.length && buf.compare(key, 0, key.length, pathOffset, pathOffset + pathLength) === 0) {
+            var dataOffset = buf.readUInt32LE(at + 8),
+                mime = buf.readUInt16LE(at + 20),
+                mimeAt = this.mimesOffset + mime * 8;
+            return {
+                data: buf.slice(dataOffset, dataOffset + buf.readUInt32LE(at + 12)),
+                rawLength: buf.readUInt32LE(at + 16),
+                flags: buf.readUInt16LE(at + 22),
+                mime: buf.toString('ascii', this.stringsOffset + buf.readUInt32LE(mimeAt),
+                    this.stringsOffset + buf.readUInt32LE(mimeAt) + buf.readUInt32LE(mimeAt + 4))
+            };
+        }
+    }
+};
+
+function verify(archive, wwwDir, files, overrides) {
+    var reader = new Reader(archive);
+    files.forEach(function(rel) {
+        var entry = reader.lookup(rel);
+        if (!entry) {
+            throw new Error('missing entry: ' + rel);
+        }
+        var data = (entry.flags & FLAG_DEFLATED) ? zlib.inflateSync(entry.data) : entry.data;
+        if (data.length != entry.rawLength || !data.equals(overrides[rel] || fs.readFileSync(path.join(wwwDir, rel)))) {
+            throw new Error('entry does not round-trip: ' + rel);
+        }
+    });
+    if (reader.lookup('does/not/exist.html') !== null) {
+        throw new Error('lookup of a missing path succeeded');
+    }
+    console.log('Verified ' + files.length + ' entries.');
+}
+
+function bench(archive, files) {
+    var reader = new Reader(archive),
+        rounds = Math.max(1, Math.ceil(200000 / Math.max(files.length, 1))),
+        start = process.hrtime(),
+        found = 0;
+    for (var r = 0; r < rounds; r++) {
+        for (var i = 0; i < files.length; i++) {
+            if (reader.lookup(files[i])) {
+                found++;
+            }
+        }
+    }
+    var elapsed = process.hrtime(start),
+        ns = elapsed[0] * 1e9 + elapsed[1];
+    console.log('Index lookups: ' + found + ' in ' + (ns / 1e6).toFixed(2) + 'ms (' +
+        (ns / Math.max(found, 1)).toFixed(0) + 'ns/lookup, ' + reader.bucketCount + ' buckets for ' +
+        reader.entryCount + ' entries)');
+}
+
+function main(argv) {
+    var args = argv.filter(function(a) { return a.indexOf('--') !== 0; }),
+        flags = argv.filter(function(a) { return a.indexOf('--') === 0; });
+    if (args.length != 2) {
+        console.error('Usage: pack-www.js <www dir> <archive> [--compress] [--bundle-plugins] [--verify] [--bench]');
+        process.exit(2);
+    }
+    var wwwDir = args[0],
+        out = args[1],
+        overrides = {};
+
+    if (flags.indexOf('--bundle-plugins') != -1) {
+        var bundled = require('./bundle-plugins').bundle(wwwDir);
+        if (bundled !== null) {
+            overrides['cordova.js'] = Buffer.from(bundled, 'utf8');
+        }
+    }
+
+    var result = pack(wwwDir, flags.indexOf('--compress') != -1, overrides);
+
+    fs.writeFileSync(out, result.buffer);
+    console.log('Packed ' + result.files.length + ' files from ' + wwwDir + ' into ' + out +
+        ' (' + result.buffer.length + ' bytes).');
+
+    if (flags.indexOf('--verify') != -1) {
+        verify(result.buffer, wwwDir, result.files, overrides);
+    }
+    if (flags.indexOf('--bench') != -1) {
+        bench(result.buffer, result.files);
+    }
+}
+
+main(process.argv.slice(2));
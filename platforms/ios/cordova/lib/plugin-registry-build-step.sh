@@ -0,0 +1,40 @@
+#!/bin/sh
+#
+#    Licensed to the Apache Software Foundation (ASF) under one
+#    or more contributor license agreements.  See the NOTICE file
+#    distributed with this work for additional information
+#    regarding copyright ownership.  The ASF licenses this file
+#    to you under the Apache License, Version 2.0 (the
+#    "License"); you may not use this file except in compliance
+#    with the License.  You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing,
+#    software distributed under the License is distributed on an
+#    "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+#    KIND, either express or implied.  See the License for the
+#    specific language governing permissions and limitations
+#    under the License.
+#
+#
+#   This script regenerates Plugins/CDVGeneratedPluginRegistry.m from
+#   config.xml (see gen-plugin-registry.js). It fails the build when a
+#   <feature> names a class or action that does not exist.
+#   It also compiles the <access> origins into
+#   Plugins/CDVGeneratedWhitelistTable.m (see gen-whitelist-table.js).
+#
+#   This script should not be called directly.
+#   It is called as a build step from Xcode.
+
+CONFIG="$PROJECT_NAME/config.xml"
+OUTPUT="$PROJECT_NAME/Plugins/CDVGeneratedPluginRegistry.m"
+WHITELIST_OUTPUT="$PROJECT_NAME/Plugins/CDVGeneratedWhitelistTable.m"
+
+if ! which node > /dev/null; then
+  echo "warning: node was not found, $OUTPUT and $WHITELIST_OUTPUT were not regenerated."
+  exit 0
+fi
+
+node cordova/lib/gen-plugin-registry.js "$CONFIG" "$OUTPUT" "$PROJECT_NAME/Plugins" "$PROJECT_NAME/Classes" CordovaLib/Classes || exit $?
+node cordova/lib/gen-whitelist-table.js "$CONFIG" "$WHITELIST_OUTPUT"
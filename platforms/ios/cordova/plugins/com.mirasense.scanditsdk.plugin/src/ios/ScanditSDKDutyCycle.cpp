@@ -0,0 +1,147 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKDutyCycle.hpp"
+
+namespace scanditsdk {
+namespace dutycycle {
+
+Controller::Controller(const Config &config) : config_(config) {
+    if (config_.probeOnSeconds > config_.probePeriodSeconds) {
+        config_.probeOnSeconds = config_.probePeriodSeconds;
+    }
+    start(0);
+}
+
+void Controller::start(double now) {
+    state_ = StateActive;
+    since_ = now;
+    lastActivity_ = now;
+    phaseEnd_ = 0;
+    cameraSince_ = now;
+    haveScene_ = false;
+    scene_ = 0;
+    for (int i = 0; i < StateCount; i++) {
+        totals_[i] = 0;
+    }
+    probes_ = 0;
+    for (int i = 0; i < WakeCount; i++) {
+        wakes_[i] = 0;
+    }
+}
+
+void Controller::enter(State state, double now) {
+    totals_[state_] += now - since_;
+    if ((state == StateActive || state == StateProbeOn)
+            && (state_ == StateProbeOff || state_ == StatePaused)) {
+        cameraSince_ = now;
+    }
+    state_ = state;
+    since_ = now;
+}
+
+Action Controller::tick(double now) {
+    switch (state_) {
+        case StateActive:
+            if (now - lastActivity_ < config_.idleSeconds) {
+                return ActionNone;
+            }
+            probes_++;
+            enter(StateProbeOff, now);
+            phaseEnd_ = now + (config_.probePeriodSeconds - config_.probeOnSeconds);
+            return ActionStopScanning;
+        case StateProbeOff:
+            if (now < phaseEnd_) {
+                return ActionNone;
+            }
+            enter(StateProbeOn, now);
+            phaseEnd_ = now + config_.probeOnSeconds;
+            return ActionStartScanning;
+        case StateProbeOn:
+            if (now < phaseEnd_) {
+                return ActionNone;
+            }
+            enter(StateProbeOff, now);
+            phaseEnd_ = now + (config_.probePeriodSeconds - config_.probeOnSeconds);
+            return ActionStopScanning;
+        default:
+            return ActionNone;
+    }
+}
+
+Action Controller::wake(double now, Wake reason) {
+    if (state_ == StatePaused) {
+        return ActionNone;
+    }
+    lastActivity_ = now;
+    if (state_ == StateActive) {
+        return ActionNone;
+    }
+    wakes_[reason]++;
+    bool wasStopped = state_ == StateProbeOff;
+    enter(StateActive, now);
+    return wasStopped ? ActionStartScanning : ActionNone;
+}
+
+Action Controller::sample(double now, float luminance) {
+    if (state_ == StatePaused || state_ == StateProbeOff || now - cameraSince_ < config_.settleSeconds) {
+        return ActionNone;
+    }
+    if (!haveScene_) {
+        haveScene_ = true;
+        scene_ = luminance;
+        return ActionNone;
+    }
+    float delta = luminance - scene_;
+    if (delta >= config_.presenceDelta || -delta >= config_.presenceDelta) {
+        // The new scene is the reference from now on, so a parked object does not keep waking.
+        scene_ = luminance;
+        return wake(now, WakePresence);
+    }
+    scene_ += config_.smoothing * delta;
+    return ActionNone;
+}
+
+void Controller::pause(double now) {
+    if (state_ != StatePaused) {
+        enter(StatePaused, now);
+    }
+}
+
+void Controller::resume(double now) {
+    if (state_ != StateActive) {
+        enter(StateActive, now);
+    }
+    lastActivity_ = now;
+}
+
+double Controller::nextDeadline() const {
+    switch (state_) {
+        case StateActive:
+            return lastActivity_ + config_.idleSeconds;
+        case StateProbeOn:
+        case StateProbeOff:
+            return phaseEnd_;
+        default:
+            return -1;
+    }
+}
+
+double Controller::seconds(State state, double now) const {
+    return state == state_ ? totals_[state] + (now - since_) : totals_[state];
+}
+
+} // namespace dutycycle
+} // namespace scanditsdk
@@ -0,0 +1,124 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#ifndef SCANDITSDK_DUTYCYCLE_HPP
+#define SCANDITSDK_DUTYCYCLE_HPP
+
+#include <stdint.h>
+
+/**
+ * Duty cycling of the camera for pickers that stay up for a long time, in portable C++ like
+ * ScanditSDKTorch. The controller only decides; starting and stopping the picker is up to the
+ * caller.
+ *
+ * A picker scans at full rate (active) until nothing was decoded for idleSeconds. It then probes:
+ * scanning runs for probeOnSeconds at the start of every probePeriodSeconds and is stopped for the
+ * rest of the period. A decode, a touch or presence in front of the camera returns to active at
+ * once. Presence is a change of the sampled luminance by at least presenceDelta against the
+ * smoothed luminance of the idle scene; samples taken within settleSeconds of the camera starting
+ * are ignored while the exposure settles. Times are in seconds on any monotonic clock.
+ */
+namespace scanditsdk {
+namespace dutycycle {
+
+struct Config {
+    Config() : idleSeconds(20), probeOnSeconds(1.5), probePeriodSeconds(6), presenceDelta(12),
+            settleSeconds(0.3), smoothing(0.25f) {}
+
+    double idleSeconds;
+    double probeOnSeconds;
+    double probePeriodSeconds;
+    float presenceDelta;    // mean luminance 0..255
+    double settleSeconds;
+    float smoothing;        // weight of a new sample in the idle scene average, 0..1
+};
+
+enum State {
+    StateActive = 0,
+    StateProbeOn,   // probing, camera running
+    StateProbeOff,  // probing, camera stopped
+    StatePaused,    // stopped by the app or in the background; not counted as either
+    StateCount
+};
+
+enum Wake {
+    WakeNone = 0,
+    WakeDecode,
+    WakePresence,
+    WakeTouch,
+    WakeCount
+};
+
+enum Action {
+    ActionNone = 0,
+    ActionStartScanning,
+    ActionStopScanning
+};
+
+class Controller {
+public:
+    explicit Controller(const Config &config = Config());
+
+    /** Resets the controller and its totals for a picker that starts scanning at now. */
+    void start(double now);
+
+    /** Moves on to the next state once its time is up. Call at nextDeadline() or later. */
+    Action tick(double now);
+
+    /** Returns to active for a decode or a touch (or presence, see sample). */
+    Action wake(double now, Wake reason);
+
+    /**
+     * Feeds the mean luminance of a frame taken at now. Wakes a probing picker if the scene
+     * changed; keeps an active one awake.
+     */
+    Action sample(double now, float luminance);
+
+    /** The caller stopped the camera; time is not counted until resume. */
+    void pause(double now);
+    /** The caller started the camera again, at full rate. */
+    void resume(double now);
+
+    State state() const { return state_; }
+    bool isProbing() const { return state_ == StateProbeOn || state_ == StateProbeOff; }
+    /** Time of the next timed transition, or a negative value if there is none. */
+    double nextDeadline() const;
+    /** Total time spent in a state since start, including the current period. */
+    double seconds(State state, double now) const;
+    /** How often probing was entered. */
+    uint32_t probeCount() const { return probes_; }
+    uint32_t wakeCount(Wake reason) const { return wakes_[reason]; }
+    const Config &config() const { return config_; }
+
+private:
+    void enter(State state, double now);
+
+    Config config_;
+    State state_;
+    double since_;        // start of the current state
+    double lastActivity_; // start, last resume, decode, touch or presence
+    double phaseEnd_;     // end of the current probe phase
+    double cameraSince_;  // camera start, for settleSeconds
+    bool haveScene_;
+    float scene_;
+    double totals_[StateCount];
+    uint32_t probes_;
+    uint32_t wakes_[WakeCount];
+};
+
+} // namespace dutycycle
+} // namespace scanditsdk
+
+#endif // SCANDITSDK_DUTYCYCLE_HPP
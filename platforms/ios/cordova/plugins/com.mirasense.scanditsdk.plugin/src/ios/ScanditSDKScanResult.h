@@ -0,0 +1,22 @@
+// Generated by tools/gen-scan-result.js from schema/scan-result.json. Do not edit.
+
+#import <Foundation/Foundation.h>
+#include "ScanditSDKScanResultEncoder.h"
+
+// Returns ScanditSDKSymbologyUnknown for names outside the schema.
+FOUNDATION_EXPORT ScanditSDKSymbology ScanditSDKSymbologyFromString(NSString* name);
+FOUNDATION_EXPORT NSString* ScanditSDKSymbologyName(ScanditSDKSymbology value);
+
+/*
+ One decoded or manually entered code. Fields are sent positionally in this order, so the first two keep the legacy [barcode, symbology] layout.
+
+ 0: code (string)
+ 1: symbology (enum)
+ 2: timestamp (double) - milliseconds since 1970
+ 3: manual (bool) - entered in the search bar instead of scanned
+ 4: gtin (string, optional, nil to omit) - GTIN-14 for retail codes
+
+ Enum names outside the schema are passed through as strings. Returns nil if
+ out of memory. The literal is written by scanditsdk_scan_result_encode.
+ */
+FOUNDATION_EXPORT NSString* ScanditSDKEncodeScanResult(NSString* code, NSString* symbology, double timestamp, BOOL manual, NSString* gtin);
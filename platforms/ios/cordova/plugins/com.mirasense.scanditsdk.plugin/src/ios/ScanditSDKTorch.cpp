@@ -0,0 +1,78 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKTorch.hpp"
+
+namespace scanditsdk {
+namespace torch {
+
+Controller::Controller(const Config &config) : config_(config) {
+    start(0);
+}
+
+void Controller::start(double now) {
+    on_ = false;
+    haveLuminance_ = false;
+    luminance_ = 0;
+    lastActivity_ = now;
+    lastDecode_ = now;
+    onSince_ = 0;
+    quietUntil_ = now;
+    onTotal_ = 0;
+    switches_ = 0;
+}
+
+Reason Controller::sample(double now, float luminance) {
+    if (on_) {
+        if (now - onSince_ >= config_.holdSeconds && now - lastDecode_ >= config_.holdSeconds) {
+            on_ = false;
+            onTotal_ += now - onSince_;
+            lastActivity_ = now;
+            quietUntil_ = now + config_.holdSeconds;
+            return ReasonIdle;
+        }
+        return ReasonNone;
+    }
+
+    luminance_ = haveLuminance_ ? luminance_ + config_.smoothing * (luminance - luminance_) : luminance;
+    haveLuminance_ = true;
+    if (now < quietUntil_) {
+        return ReasonNone;
+    }
+    Reason reason = ReasonNone;
+    if (luminance_ < config_.darkLevel) {
+        reason = ReasonDark;
+    } else if (luminance_ < config_.dimLevel && now - lastActivity_ >= config_.noDecodeSeconds) {
+        reason = ReasonNoDecode;
+    }
+    if (reason != ReasonNone) {
+        on_ = true;
+        onSince_ = now;
+        switches_++;
+    }
+    return reason;
+}
+
+void Controller::decoded(double now) {
+    lastDecode_ = now;
+    lastActivity_ = now;
+}
+
+double Controller::onSeconds(double now) const {
+    return on_ ? onTotal_ + (now - onSince_) : onTotal_;
+}
+
+} // namespace torch
+} // namespace scanditsdk
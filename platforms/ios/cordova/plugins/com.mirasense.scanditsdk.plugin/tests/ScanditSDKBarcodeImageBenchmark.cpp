@@ -0,0 +1,71 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+#include "ScanditSDKBarcodeImage.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <string.h>
+#include <vector>
+
+using namespace scanditsdk;
+
+/**
+ * Encode and render throughput of every symbology at scale 3, on typical codes, and the cost of
+ * a cache hit for comparison. Each case runs for 0.2 s (times the scale argument).
+ */
+int main(int argc, char **argv) {
+    const double seconds = 0.2 * test::benchScale(argc, argv);
+    static const char *const kNames[encoder::SymbologyCount] = {
+        "EAN-13", "UPC-A", "EAN-8", "UPC-E", "Code 39", "Code 128", "ITF", "QR", "Data Matrix", "PDF417"
+    };
+    static const char *const kCodes[encoder::SymbologyCount] = {
+        "590123412345", "03600029145", "9638507", "0425261", "CODE39 TEST", "Hello, world 1234567890",
+        "1234567890123", "https://example.com/product/8711253001202?lot=A1234", "0101234567890128172512311012345",
+        "SHIP TO: Jane Doe, 12 Main St., Springfield IL 62704; tracking 1Z999AA10123456784"
+    };
+    image::RenderOptions options;
+    options.scale = 3;
+    image::Cache cache(4 << 20, 256);
+    int result = 0;
+    for (int s = 0; s < encoder::SymbologyCount; ++s) {
+        encoder::Symbology symbology = (encoder::Symbology)s;
+        encoder::Symbol symbol;
+        std::vector<uint8_t> png;
+        unsigned runs = 0;
+        double start = test::now(), elapsed = 0;
+        do {
+            if (encoder::encode(symbology, kCodes[s], strlen(kCodes[s]), encoder::Options(), &symbol) !=
+                    encoder::ErrorNone || !image::renderPNG(symbol, options, &png)) {
+                result = 1;
+                break;
+            }
+            ++runs;
+        } while ((elapsed = test::now() - start) < seconds);
+
+        cache.put(kCodes[s], png);
+        std::vector<uint8_t> cached;
+        unsigned hits = 0;
+        start = test::now();
+        double hitElapsed = 0;
+        do {
+            hits += cache.get(kCodes[s], &cached);
+        } while ((hitElapsed = test::now() - start) < seconds / 10);
+
+        unsigned width = 0, height = 0;
+        image::imageSize(symbol, options, &width, &height);
+        printf("%-12s %4ux%-4u px %6lu bytes %8.1f us/encode+render %6.2f us/cache hit\n", kNames[s], width,
+               height, (unsigned long)png.size(), runs ? elapsed * 1e6 / runs : 0.0, hits ? hitElapsed * 1e6 / hits : 0.0);
+    }
+    return result;
+}
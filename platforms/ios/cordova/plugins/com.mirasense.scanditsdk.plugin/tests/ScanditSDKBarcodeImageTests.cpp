@@ -0,0 +1,198 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+#include "ScanditSDKBarcodeImage.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace scanditsdk;
+
+/**
+ * Renders symbols to PNG and reads them back with a minimal PNG reader (chunk CRCs, inflate,
+ * 1-bit rows) to compare every pixel with the modules, and checks the bounds of the cache.
+ */
+namespace {
+
+uint32_t bigEndian(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+struct Bitmap {
+    unsigned width, height;
+    std::vector<uint8_t> dark; // width * height
+};
+
+// Empty error on success.
+std::string readPNG(const std::vector<uint8_t> &png, Bitmap *out) {
+    static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (png.size() < 8 || memcmp(&png[0], kSignature, 8) != 0) {
+        return "signature";
+    }
+    std::vector<uint8_t> compressed;
+    bool header = false, end = false;
+    size_t offset = 8;
+    while (offset + 12 <= png.size() && !end) {
+        uint32_t length = bigEndian(&png[offset]);
+        if (offset + 12 + length > png.size()) {
+            return "truncated chunk";
+        }
+        const uint8_t *type = &png[offset + 4], *data = type + 4;
+        uLong crc = crc32(crc32(0L, Z_NULL, 0), type, 4 + length);
+        if (crc != bigEndian(data + length)) {
+            return "chunk CRC";
+        }
+        if (memcmp(type, "IHDR", 4) == 0) {
+            // Bit depth 1, grayscale, deflate, filter method 0, no interlace.
+            if (length != 13 || data[8] != 1 || data[9] != 0 || data[10] != 0 || data[11] != 0 || data[12] != 0) {
+                return "header";
+            }
+            out->width = bigEndian(data);
+            out->height = bigEndian(data + 4);
+            header = true;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            compressed.insert(compressed.end(), data, data + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            end = true;
+        }
+        offset += 12 + length;
+    }
+    if (!header || !end || offset != png.size()) {
+        return "chunks";
+    }
+    size_t stride = 1 + (out->width + 7) / 8;
+    std::vector<uint8_t> raw(stride * out->height + 1);
+    uLongf rawLength = (uLongf)raw.size();
+    if (uncompress(&raw[0], &rawLength, &compressed[0], (uLong)compressed.size()) != Z_OK ||
+            rawLength != stride * out->height) {
+        return "inflate";
+    }
+    out->dark.assign((size_t)out->width * out->height, 0);
+    for (unsigned y = 0; y < out->height; ++y) {
+        const uint8_t *row = &raw[y * stride];
+        if (row[0] != 0) {
+            return "filter type";
+        }
+        for (unsigned x = 0; x < out->width; ++x) {
+            // 1 is white in a grayscale PNG.
+            out->dark[y * out->width + x] = ((row[1 + x / 8] >> (7 - x % 8)) & 1) ? 0 : 1;
+        }
+    }
+    return std::string();
+}
+
+void testPixels() {
+    static const struct {
+        encoder::Symbology symbology;
+        const char *code;
+        unsigned scale, barHeight;
+        int quietZone;
+    } kCases[] = {
+        { encoder::SymbologyQR, "hello", 3, 0, -1 },
+        { encoder::SymbologyDataMatrix, "123456", 4, 0, 2 },
+        { encoder::SymbologyEAN13, "590123412345", 2, 0, -1 },
+        { encoder::SymbologyCode128, "Abc123", 1, 20, 0 },
+        { encoder::SymbologyCode39, "X", 5, 7, 3 },
+        { encoder::SymbologyITF, "12345678", 7, 0, -1 }, // width not a multiple of 8 pixels
+        { encoder::SymbologyQR, "https://example.com/product/8711253001202?lot=A1234", 1, 0, 0 }
+    };
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); ++i) {
+        encoder::Symbol symbol;
+        CHECK(encoder::encode(kCases[i].symbology, kCases[i].code, strlen(kCases[i].code), encoder::Options(),
+                              &symbol) == encoder::ErrorNone);
+        image::RenderOptions options;
+        options.scale = kCases[i].scale;
+        options.barHeight = kCases[i].barHeight;
+        options.quietZone = kCases[i].quietZone;
+        std::vector<uint8_t> png;
+        unsigned width = 0, height = 0;
+        CHECK(image::renderPNG(symbol, options, &png) && image::imageSize(symbol, options, &width, &height));
+
+        Bitmap bitmap = Bitmap();
+        std::string error = readPNG(png, &bitmap);
+        CHECK(error.empty());
+        if (!error.empty()) {
+            fprintf(stderr, "case %lu: %s\n", (unsigned long)i, error.c_str());
+            continue;
+        }
+        unsigned quiet = kCases[i].quietZone >= 0 ? (unsigned)kCases[i].quietZone : symbol.quietZone;
+        unsigned rows = symbol.isLinear() ? (kCases[i].barHeight ? kCases[i].barHeight : (symbol.width + 1) / 2)
+                                          : symbol.height;
+        unsigned scale = kCases[i].scale;
+        CHECK(bitmap.width == width && bitmap.height == height);
+        CHECK(width == (symbol.width + 2 * quiet) * scale && height == (rows + 2 * quiet) * scale);
+        unsigned wrong = 0;
+        for (unsigned y = 0; y < bitmap.height; ++y) {
+            for (unsigned x = 0; x < bitmap.width; ++x) {
+                int mx = (int)(x / scale) - (int)quiet, my = (int)(y / scale) - (int)quiet;
+                bool inside = mx >= 0 && my >= 0 && mx < (int)symbol.width && my < (int)rows;
+                bool dark = inside && symbol.dark((unsigned)mx, symbol.isLinear() ? 0 : (unsigned)my);
+                wrong += bitmap.dark[y * bitmap.width + x] != (dark ? 1 : 0);
+            }
+        }
+        CHECK(wrong == 0);
+    }
+}
+
+void testLimits() {
+    encoder::Symbol symbol;
+    const std::string code(2000, 'a');
+    CHECK(encoder::encode(encoder::SymbologyQR, code.data(), code.size(), encoder::Options(), &symbol) ==
+          encoder::ErrorNone);
+    image::RenderOptions options;
+    unsigned width, height;
+    options.scale = image::kMaxSide / (symbol.width + 8);
+    CHECK(image::imageSize(symbol, options, &width, &height) && width <= image::kMaxSide);
+    options.scale += 1;
+    std::vector<uint8_t> png(1, 42);
+    CHECK(!image::imageSize(symbol, options, &width, &height));
+    CHECK(!image::renderPNG(symbol, options, &png) && png.size() == 1 && png[0] == 42);
+    options.scale = 1;
+    options.quietZone = (int)image::kMaxSide;
+    CHECK(!image::renderPNG(symbol, options, &png));
+    CHECK(!image::renderPNG(encoder::Symbol(), image::RenderOptions(), &png));
+}
+
+void testCache() {
+    image::Cache cache(100, 3);
+    std::vector<uint8_t> data(40, 1), out;
+    cache.put("a", data);
+    cache.put("b", data);
+    CHECK(cache.byteCount() == 80 && cache.entryCount() == 2);
+    cache.put("c", data); // over the byte budget: drops "a", the least recently used
+    CHECK(cache.entryCount() == 2 && !cache.get("a", &out));
+    CHECK(cache.get("b", &out) && out == data);
+    cache.put("d", std::vector<uint8_t>(10));
+    cache.put("e", std::vector<uint8_t>(10)); // over the entry budget: drops "c", not the used "b"
+    CHECK(!cache.get("c", &out) && cache.get("b", &out) && cache.entryCount() == 3);
+    cache.put("huge", std::vector<uint8_t>(101));
+    CHECK(!cache.get("huge", &out) && cache.entryCount() == 3);
+    cache.put("b", std::vector<uint8_t>(5)); // replacing an entry updates the size
+    CHECK(cache.byteCount() == 25 && cache.get("b", &out) && out.size() == 5);
+    CHECK(cache.hitCount() == 3 && cache.missCount() == 3);
+    cache.clear();
+    CHECK(cache.entryCount() == 0 && cache.byteCount() == 0 && !cache.get("d", &out));
+}
+
+} // namespace
+
+int main() {
+    testPixels();
+    testLimits();
+    testCache();
+    return scanditsdk::test::testResult();
+}
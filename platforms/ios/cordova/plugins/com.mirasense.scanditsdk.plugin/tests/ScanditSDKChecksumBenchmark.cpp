@@ -0,0 +1,63 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKChecksum.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <vector>
+
+using namespace scanditsdk::checksum;
+
+/**
+ * Throughput of EAN-13 validation: scalar validate() per code, the validateBatch() API and the
+ * fixed-stride vector kernel, on 1M random codes (times the scale argument).
+ */
+int main(int argc, char **argv) {
+    const size_t count = (size_t)(1000000 * scanditsdk::test::benchScale(argc, argv));
+    const size_t length = 13, stride = 16;
+    scanditsdk::test::Random random;
+    std::vector<char> fixed(count * stride + 16, 0);
+    std::vector<const char *> codes(count);
+    std::vector<size_t> lengths(count, length);
+    for (size_t i = 0; i < count; ++i) {
+        char *code = &fixed[i * stride];
+        for (size_t d = 0; d < length; ++d) {
+            code[d] = (char)('0' + random.below(10));
+        }
+        codes[i] = code;
+    }
+    std::vector<uint8_t> results(count);
+
+    double start = scanditsdk::test::now();
+    size_t scalar = 0;
+    for (size_t i = 0; i < count; ++i) {
+        scalar += validate(CheckEAN13, codes[i], length);
+    }
+    double scalarSeconds = scanditsdk::test::now() - start;
+
+    start = scanditsdk::test::now();
+    size_t batch = validateBatch(CheckEAN13, &codes[0], &lengths[0], count, &results[0]);
+    double batchSeconds = scanditsdk::test::now() - start;
+
+    start = scanditsdk::test::now();
+    size_t vector = validateGS1Fixed(&fixed[0], length, stride, count, &results[0]);
+    double vectorSeconds = scanditsdk::test::now() - start;
+
+    printf("%lu EAN-13 codes, %lu valid\n", (unsigned long)count, (unsigned long)scalar);
+    printf("scalar validate     %6.1f ns/code\n", scalarSeconds * 1e9 / count);
+    printf("validateBatch       %6.1f ns/code\n", batchSeconds * 1e9 / count);
+    printf("validateGS1Fixed    %6.1f ns/code\n", vectorSeconds * 1e9 / count);
+    return (batch == scalar && vector == scalar) ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKDutyCycle.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <math.h>
+
+using namespace scanditsdk::dutycycle;
+
+namespace {
+
+// The synthetic clock steps by an exact binary fraction, so sums of durations are exact.
+const double kStep = 0.125;
+
+double totalSeconds(const Controller &cycle, double now) {
+    double total = 0;
+    for (int s = 0; s < StateCount; ++s) {
+        total += cycle.seconds((State)s, now);
+    }
+    return total;
+}
+
+// Active until idleSeconds without activity, then probe periods: probePeriodSeconds -
+// probeOnSeconds stopped, probeOnSeconds scanning.
+void testProbeTransitions() {
+    Controller cycle;
+    const Config &config = cycle.config();
+    double off = config.probePeriodSeconds - config.probeOnSeconds;
+    cycle.start(100);
+    CHECK(cycle.state() == StateActive && cycle.nextDeadline() == 100 + config.idleSeconds);
+    CHECK(cycle.tick(100 + config.idleSeconds - kStep) == ActionNone && cycle.state() == StateActive);
+
+    double now = 100 + config.idleSeconds;
+    CHECK(cycle.tick(now) == ActionStopScanning);
+    CHECK(cycle.state() == StateProbeOff && cycle.isProbing() && cycle.probeCount() == 1);
+    CHECK(cycle.nextDeadline() == now + off);
+    for (int period = 0; period < 3; ++period) {
+        CHECK(cycle.tick(now + off - kStep) == ActionNone && cycle.state() == StateProbeOff);
+        now += off;
+        CHECK(cycle.tick(now) == ActionStartScanning && cycle.state() == StateProbeOn);
+        CHECK(cycle.nextDeadline() == now + config.probeOnSeconds);
+        CHECK(cycle.tick(now + config.probeOnSeconds - kStep) == ActionNone && cycle.state() == StateProbeOn);
+        now += config.probeOnSeconds;
+        CHECK(cycle.tick(now) == ActionStopScanning && cycle.state() == StateProbeOff);
+    }
+    CHECK(cycle.probeCount() == 1);
+    CHECK(cycle.seconds(StateActive, now) == config.idleSeconds);
+    CHECK(cycle.seconds(StateProbeOn, now) == 3 * config.probeOnSeconds);
+    CHECK(cycle.seconds(StateProbeOff, now) == 3 * off);
+
+    // Back to active and idle again: probing is entered a second time.
+    CHECK(cycle.wake(now, WakeTouch) == ActionStartScanning && cycle.state() == StateActive);
+    CHECK(cycle.tick(now + config.idleSeconds) == ActionStopScanning && cycle.probeCount() == 2);
+}
+
+// wake starts the camera only from ProbeOff; from ProbeOn it was running already, and an active
+// picker only has its idle time restarted.
+void testWake() {
+    Config config;
+    Controller cycle(config);
+    double off = config.probePeriodSeconds - config.probeOnSeconds;
+    cycle.start(0);
+
+    CHECK(cycle.wake(5, WakeDecode) == ActionNone && cycle.state() == StateActive);
+    CHECK(cycle.nextDeadline() == 5 + config.idleSeconds && cycle.wakeCount(WakeDecode) == 0);
+
+    double now = 5 + config.idleSeconds;
+    CHECK(cycle.tick(now) == ActionStopScanning);
+    CHECK(cycle.wake(now + 1, WakeDecode) == ActionStartScanning && cycle.state() == StateActive);
+    CHECK(cycle.wakeCount(WakeDecode) == 1);
+
+    now += 1 + config.idleSeconds;
+    CHECK(cycle.tick(now) == ActionStopScanning);
+    CHECK(cycle.tick(now + off) == ActionStartScanning && cycle.state() == StateProbeOn);
+    CHECK(cycle.wake(now + off + 0.5, WakeTouch) == ActionNone && cycle.state() == StateActive);
+    CHECK(cycle.wakeCount(WakeTouch) == 1 && cycle.wakeCount(WakePresence) == 0);
+
+    // A paused picker ignores wakes and ticks until resumed, at full rate.
+    cycle.pause(now + 10);
+    CHECK(cycle.state() == StatePaused && cycle.nextDeadline() < 0);
+    CHECK(cycle.wake(now + 11, WakeTouch) == ActionNone && cycle.state() == StatePaused);
+    CHECK(cycle.tick(now + 1000) == ActionNone && cycle.state() == StatePaused);
+    CHECK(cycle.wakeCount(WakeTouch) == 1);
+    cycle.resume(now + 1000);
+    CHECK(cycle.state() == StateActive && cycle.nextDeadline() == now + 1000 + config.idleSeconds);
+    CHECK(cycle.seconds(StatePaused, now + 1000) == 990);
+}
+
+// Samples within settleSeconds of the camera starting are ignored; the first one after sets the
+// idle scene, small changes drift it, and presence re-baselines it on the new scene.
+void testPresence() {
+    Controller cycle;
+    const Config &config = cycle.config();
+    double off = config.probePeriodSeconds - config.probeOnSeconds;
+    cycle.start(0);
+
+    // The scene is learned while active, after the first settle.
+    CHECK(cycle.sample(config.settleSeconds / 2, 10) == ActionNone);
+    CHECK(cycle.sample(config.settleSeconds, 100) == ActionNone);
+    // Flicker around the scene is averaged out rather than taken as the scene: a swing from +1/2 to
+    // -3/4 presenceDelta does not count as presence, which would restart the idle time.
+    CHECK(cycle.sample(1, 100 + config.presenceDelta / 2) == ActionNone);
+    CHECK(cycle.sample(2, 100 - config.presenceDelta * 3 / 4) == ActionNone);
+    CHECK(cycle.nextDeadline() == config.idleSeconds);
+    // Light that changes slowly (a cloud, dusk) is followed by the scene and wakes nothing either.
+    for (int i = 1; i <= 12; ++i) {
+        CHECK(cycle.sample(2 + i * kStep, 100 + i * config.presenceDelta / 4) == ActionNone);
+    }
+    for (int i = 11; i >= 0; --i) {
+        CHECK(cycle.sample(5 - i * kStep, 100 + i * config.presenceDelta / 4) == ActionNone);
+    }
+    CHECK(cycle.nextDeadline() == config.idleSeconds);
+    double now = config.idleSeconds;
+    CHECK(cycle.tick(now) == ActionStopScanning);
+    // Stopped frames say nothing.
+    CHECK(cycle.sample(now + 1, 250) == ActionNone && cycle.state() == StateProbeOff);
+    now += off;
+    CHECK(cycle.tick(now) == ActionStartScanning);
+    // Exposure settling after the restart does not count as presence.
+    CHECK(cycle.sample(now + config.settleSeconds / 2, 250) == ActionNone && cycle.state() == StateProbeOn);
+    CHECK(cycle.sample(now + config.settleSeconds, 100) == ActionNone && cycle.state() == StateProbeOn);
+    // An object in front of the camera changes the scene by presenceDelta and wakes.
+    float object = 100 + 2 * config.presenceDelta;
+    CHECK(cycle.sample(now + 1, object) == ActionNone);
+    CHECK(cycle.state() == StateActive && cycle.wakeCount(WakePresence) == 1);
+    now += 1;
+    CHECK(cycle.nextDeadline() == now + config.idleSeconds);
+
+    // It is the scene from then on, so staying there does not keep the picker awake...
+    CHECK(cycle.sample(now + 2, object) == ActionNone);
+    CHECK(cycle.nextDeadline() == now + config.idleSeconds);
+    // ...but leaving does, and the empty scene is the reference again.
+    CHECK(cycle.sample(now + 4, 100) == ActionNone && cycle.state() == StateActive);
+    now += 4;
+    CHECK(cycle.nextDeadline() == now + config.idleSeconds && cycle.wakeCount(WakePresence) == 1);
+
+    // Probing again, the empty scene does not wake and the object does.
+    now += config.idleSeconds;
+    CHECK(cycle.tick(now) == ActionStopScanning);
+    now += off;
+    CHECK(cycle.tick(now) == ActionStartScanning);
+    CHECK(cycle.sample(now + config.settleSeconds, 100) == ActionNone && cycle.state() == StateProbeOn);
+    CHECK(cycle.sample(now + config.settleSeconds + kStep, 100) == ActionNone && cycle.state() == StateProbeOn);
+    CHECK(cycle.sample(now + 1, object) == ActionNone && cycle.state() == StateActive);
+    CHECK(cycle.wakeCount(WakePresence) == 2);
+}
+
+// probeOnSeconds longer than the period is clamped to it, leaving no stopped phase.
+void testProbeOnClamped() {
+    Config config;
+    config.probeOnSeconds = 10;
+    config.probePeriodSeconds = 6;
+    Controller cycle(config);
+    CHECK(cycle.config().probeOnSeconds == 6);
+    cycle.start(0);
+    CHECK(cycle.tick(config.idleSeconds) == ActionStopScanning);
+    CHECK(cycle.nextDeadline() == config.idleSeconds);
+    CHECK(cycle.tick(config.idleSeconds) == ActionStartScanning);
+    CHECK(cycle.nextDeadline() == config.idleSeconds + 6);
+}
+
+// A long random session: ticks at every deadline, random wakes, samples, pauses and resumes. The
+// totals always add up to the elapsed time and match the state the test observed at every step.
+void testSecondsAddUp() {
+    scanditsdk::test::Random random(71);
+    Controller cycle;
+    double observed[StateCount] = { 0 };
+    const double start = 50;
+    cycle.start(start);
+    for (int step = 1; step <= 400000; ++step) {
+        double now = start + step * kStep;
+        observed[cycle.state()] += kStep;
+        double deadline = cycle.nextDeadline();
+        if (deadline >= 0 && now >= deadline) {
+            cycle.tick(now);
+        }
+        uint32_t event = random.below(1000);
+        if (event < 2) {
+            cycle.wake(now, (Wake)(1 + random.below(WakeCount - 1)));
+        } else if (event < 3) {
+            cycle.pause(now);
+        } else if (event < 6 && cycle.state() == StatePaused) {
+            cycle.resume(now);
+        } else if (event < 300) {
+            cycle.sample(now, (float)(random.below(100) < 2 ? random.below(256) : 120 + random.below(8)));
+        }
+        if (step % 1000 == 0) {
+            CHECK(fabs(totalSeconds(cycle, now) - (now - start)) < 1e-9);
+            for (int s = 0; s < StateCount; ++s) {
+                CHECK(fabs(cycle.seconds((State)s, now) - observed[s]) < 1e-9);
+            }
+        }
+    }
+    // Every state was visited, or the check above proved little.
+    for (int s = 0; s < StateCount; ++s) {
+        CHECK(observed[s] > 0);
+    }
+    CHECK(cycle.probeCount() > 10 && cycle.wakeCount(WakePresence) > 0);
+}
+
+} // namespace
+
+int main() {
+    testProbeTransitions();
+    testWake();
+    testPresence();
+    testProbeOnClamped();
+    testSecondsAddUp();
+    return scanditsdk::test::testResult();
+}
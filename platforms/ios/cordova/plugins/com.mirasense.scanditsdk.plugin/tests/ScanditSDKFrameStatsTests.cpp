@@ -0,0 +1,131 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKFrameStats.hpp"
+#include "ScanditSDKSampleFrames.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace scanditsdk::framestats;
+using scanditsdk::test::Scene;
+
+namespace {
+
+bool sameStats(const Stats &a, const Stats &b) {
+    // Both paths sum the same integers, so the results are bit for bit equal.
+    return memcmp(&a, &b, sizeof(Stats)) == 0;
+}
+
+// The vector kernels match the scalar reference on every scene, for widths around the 16 pixel
+// chunks, padded strides, tiny planes and frames large enough to flush the 16-bit lane sums.
+void testVectorMatchesScalar() {
+    const size_t widths[] = { 1, 2, 3, 15, 16, 17, 18, 31, 33, 64, 100, 257, 640, 4200 };
+    const size_t heights[] = { 1, 2, 3, 4, 9, 48 };
+    for (int s = 0; s < scanditsdk::test::SceneCount; ++s) {
+        Scene scene = (Scene)s;
+        for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+            for (size_t h = 0; h < sizeof(heights) / sizeof(heights[0]); ++h) {
+                for (size_t padding = 0; padding <= 5; padding += 5) {
+                    size_t width = widths[w], height = heights[h], stride = width + padding;
+                    std::vector<uint8_t> frame = scanditsdk::test::sampleFrame(scene, width, height, stride,
+                                                                               (uint32_t)(w * 31 + h + 1));
+                    const uint8_t glare[] = { 0, 128, kDefaultGlareThreshold, 255 };
+                    for (size_t g = 0; g < sizeof(glare); ++g) {
+                        Stats vector = analyze(&frame[0], width, height, stride, glare[g]);
+                        Stats scalar = analyzeScalar(&frame[0], width, height, stride, glare[g]);
+                        if (!sameStats(vector, scalar)) {
+                            fprintf(stderr, "%s %lux%lu stride %lu glare %u: %g/%g/%g != %g/%g/%g\n",
+                                    scanditsdk::test::sceneName(scene), (unsigned long)width,
+                                    (unsigned long)height, (unsigned long)stride, glare[g], vector.meanLuminance,
+                                    vector.sharpness, vector.glareFraction, scalar.meanLuminance,
+                                    scalar.sharpness, scalar.glareFraction);
+                            CHECK(!"analyze differs from analyzeScalar");
+                        }
+                    }
+                    for (size_t rowStep = 0; rowStep <= 4; rowStep += 2) {
+                        CHECK(meanLuminance(&frame[0], width, height, stride, rowStep) ==
+                              meanLuminanceScalar(&frame[0], width, height, stride, rowStep));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Extreme planes: all white flushes the luminance lanes at their limit and the strongest
+// Laplacian (a checkerboard) does the same for the Laplacian lanes.
+void testExtremes() {
+    const size_t width = 1920, height = 8;
+    std::vector<uint8_t> frame(width * height, 255);
+    Stats stats = analyze(&frame[0], width, height, width);
+    CHECK(sameStats(stats, analyzeScalar(&frame[0], width, height, width)));
+    CHECK(stats.meanLuminance == 255 && stats.glareFraction == 1 && stats.sharpness == 0);
+
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            frame[y * width + x] = ((x + y) & 1) ? 255 : 0;
+        }
+    }
+    stats = analyze(&frame[0], width, height, width);
+    CHECK(sameStats(stats, analyzeScalar(&frame[0], width, height, width)));
+    CHECK(stats.sharpness > 1000000);
+
+    CHECK(analyze(&frame[0], 0, 0, 0).meanLuminance == 0);
+    CHECK(meanLuminance(&frame[0], 0, 4, 0) == 0);
+}
+
+// The statistics tell the scenes apart the way the torch and quality metrics rely on.
+void testScenes() {
+    const size_t width = 640, height = 480;
+    Stats stats[scanditsdk::test::SceneCount];
+    for (int s = 0; s < scanditsdk::test::SceneCount; ++s) {
+        std::vector<uint8_t> frame = scanditsdk::test::sampleFrame((Scene)s, width, height, width);
+        stats[s] = analyze(&frame[0], width, height, width);
+    }
+    CHECK(stats[scanditsdk::test::SceneDark].meanLuminance < 60);
+    CHECK(stats[scanditsdk::test::SceneBarcode].meanLuminance > 60);
+    CHECK(stats[scanditsdk::test::SceneBlurred].sharpness < stats[scanditsdk::test::SceneBarcode].sharpness / 4);
+    CHECK(stats[scanditsdk::test::SceneGlare].glareFraction > 0.05f);
+    CHECK(stats[scanditsdk::test::SceneBarcode].glareFraction < 0.01f);
+}
+
+void testWindow() {
+    Window window;
+    Stats mean = window.mean();
+    CHECK(window.count() == 0 && mean.meanLuminance == 0);
+    for (int i = 0; i < 20; ++i) {
+        Stats stats = { (float)i, 2 * (float)i, 0.5f };
+        window.push(stats);
+    }
+    // Only the last 16 samples, 4..19, count.
+    mean = window.mean();
+    CHECK(window.count() == Window::kSize);
+    CHECK(mean.meanLuminance == 11.5f && mean.sharpness == 23 && mean.glareFraction == 0.5f);
+    window.clear();
+    CHECK(window.count() == 0);
+}
+
+} // namespace
+
+int main() {
+    testVectorMatchesScalar();
+    testExtremes();
+    testScenes();
+    testWindow();
+    return scanditsdk::test::testResult();
+}
@@ -0,0 +1,179 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKManifest.hpp"
+#include "ScanditSDKTest.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace scanditsdk::manifest;
+
+namespace {
+
+Delta receive(Manifest &manifest, const char *code, int32_t quantity = 1) {
+    return manifest.receive(code, strlen(code), quantity);
+}
+
+void testRows() {
+    Manifest manifest;
+    const char text[] = "4006381333931,12\r\n96385074\t3\n\nA,B,2\nplain\nodd,x\n";
+    size_t invalidRow = 0;
+    CHECK(manifest.addRows(text, sizeof(text) - 1, &invalidRow) == 5);
+    CHECK(invalidRow == 0);
+    CHECK(manifest.lineCount() == 5);
+    CHECK(manifest.totals().expectedUnits == 12 + 3 + 2 + 1 + 1);
+
+    uint32_t line;
+    CHECK(manifest.find("4006381333931", 13, &line) && line == 0 && manifest.line(line).expected == 12);
+    CHECK(manifest.find("96385074", 8, &line) && manifest.line(line).expected == 3);
+    CHECK(manifest.find("A,B", 3, &line) && manifest.line(line).expected == 2); // last ',' separates
+    CHECK(manifest.find("plain", 5, &line) && manifest.line(line).expected == 1);
+    CHECK(manifest.find("odd,x", 5, &line) && manifest.line(line).expected == 1); // no numeric count
+    CHECK(!manifest.find("4006381333931,12", 16, &line));
+
+    size_t length;
+    const char *code = manifest.code(1, &length);
+    CHECK(length == 8 && memcmp(code, "96385074", 8) == 0);
+}
+
+void testInvalidCounts() {
+    const char *rows[] = { "a,1\nb,0\nc,2", "a,1\n\nb,-3", "a,4294967296", "a,99999999999999999999" };
+    const size_t expectedRows[] = { 2, 3, 1, 1 };
+    const size_t expectedAdded[] = { 1, 1, 0, 0 };
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); ++i) {
+        Manifest manifest;
+        size_t invalidRow = 0;
+        CHECK(manifest.addRows(rows[i], strlen(rows[i]), &invalidRow) == expectedAdded[i]);
+        CHECK(invalidRow == expectedRows[i]);
+    }
+    Manifest manifest;
+    size_t invalidRow = 0;
+    CHECK(manifest.addRows("a,4294967295", 12, &invalidRow) == 1 && invalidRow == 0);
+    CHECK(manifest.totals().expectedUnits == 4294967295u);
+}
+
+void testReceive() {
+    Manifest manifest;
+    manifest.add("A", 1, 2);
+    manifest.add("B", 1, 1);
+    manifest.add("A", 1, 1); // repeated codes add up
+    CHECK(manifest.lineCount() == 2);
+    CHECK(manifest.totals().lines[StatusShort] == 2);
+
+    Delta delta = receive(manifest, "A");
+    CHECK(delta.line == 0 && delta.expected == 3 && delta.received == 1 && delta.status == StatusShort);
+    delta = receive(manifest, "A", 2);
+    CHECK(delta.received == 3 && delta.status == StatusComplete);
+    delta = receive(manifest, "A");
+    CHECK(delta.status == StatusOver);
+    delta = receive(manifest, "A", -10); // received never drops below 0
+    CHECK(delta.received == 0 && delta.status == StatusShort);
+
+    delta = receive(manifest, "C");
+    CHECK(delta.line == 2 && delta.expected == 0 && delta.received == 1 && delta.status == StatusUnexpected);
+    delta = receive(manifest, "B");
+    CHECK(delta.status == StatusComplete);
+
+    const Totals &totals = manifest.totals();
+    CHECK(totals.expectedUnits == 4 && totals.receivedUnits == 2);
+    CHECK(totals.lines[StatusShort] == 1 && totals.lines[StatusComplete] == 1 &&
+          totals.lines[StatusOver] == 0 && totals.lines[StatusUnexpected] == 1);
+
+    std::vector<Delta> lines;
+    CHECK(manifest.diff(lines, false) == 2);
+    CHECK(lines[0].line == 0 && lines[1].line == 2);
+    CHECK(manifest.diff(lines, true) == 3 && lines.size() == 5);
+}
+
+struct Line {
+    Line() : expected(0), received(0), order(0) {}
+    uint32_t expected;
+    uint32_t received;
+    uint32_t order;
+};
+
+Status statusOf(const Line &line) {
+    if (line.expected == 0) {
+        return StatusUnexpected;
+    }
+    return line.received < line.expected ? StatusShort : line.received == line.expected ? StatusComplete : StatusOver;
+}
+
+// Random adds and scans, including undos and codes that are not on the manifest, against a
+// std::map model; enough lines to make the table grow several times.
+void testMatchesModel() {
+    scanditsdk::test::Random random;
+    Manifest manifest;
+    std::map<std::string, Line> model;
+    std::vector<std::string> order;
+    for (size_t i = 0; i < 200000; ++i) {
+        char code[16];
+        snprintf(code, sizeof(code), "%u", (unsigned)random.below(30000));
+        std::map<std::string, Line>::iterator it = model.find(code);
+        if (it == model.end()) {
+            it = model.insert(std::make_pair(std::string(code), Line())).first;
+            it->second.order = (uint32_t)order.size();
+            order.push_back(code);
+        }
+        Line &line = it->second;
+        if (i < 40000 && random.below(2) == 0) {
+            uint32_t expected = 1 + random.below(5);
+            CHECK(manifest.add(code, strlen(code), expected) == line.order);
+            line.expected += expected;
+            continue;
+        }
+        int32_t quantity = random.below(8) == 0 ? -(int32_t)random.below(3) : 1;
+        Delta delta = manifest.receive(code, strlen(code), quantity);
+        line.received = quantity >= 0 ? line.received + quantity
+                                      : ((uint32_t)-quantity > line.received ? 0 : line.received + quantity);
+        CHECK(delta.line == line.order && delta.expected == line.expected && delta.received == line.received &&
+              delta.status == statusOf(line));
+    }
+
+    CHECK(manifest.lineCount() == model.size());
+    Totals totals;
+    memset(&totals, 0, sizeof(totals));
+    for (std::map<std::string, Line>::const_iterator it = model.begin(); it != model.end(); ++it) {
+        totals.expectedUnits += it->second.expected;
+        totals.receivedUnits += it->second.received;
+        totals.lines[statusOf(it->second)]++;
+    }
+    CHECK(memcmp(&totals, &manifest.totals(), sizeof(totals)) == 0);
+
+    std::vector<Delta> lines;
+    manifest.diff(lines, false);
+    CHECK(lines.size() == model.size() - totals.lines[StatusComplete]);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        size_t length;
+        const char *code = manifest.code(lines[i].line, &length);
+        const Line &line = model[std::string(code, length)];
+        CHECK(line.order == lines[i].line && line.received == lines[i].received && statusOf(line) != StatusComplete);
+        CHECK(i == 0 || lines[i - 1].line < lines[i].line);
+    }
+}
+
+} // namespace
+
+int main() {
+    testRows();
+    testInvalidCounts();
+    testReceive();
+    testMatchesModel();
+    return scanditsdk::test::testResult();
+}
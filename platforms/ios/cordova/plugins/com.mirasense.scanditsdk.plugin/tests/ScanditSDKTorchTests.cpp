@@ -0,0 +1,179 @@
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+//
+
+#include "ScanditSDKTorch.hpp"
+#include "ScanditSDKTest.hpp"
+
+using namespace scanditsdk::torch;
+
+namespace {
+
+// Frames arrive every kStep seconds; an exact binary fraction, so times add up exactly.
+const double kStep = 0.25;
+
+// Feeds one luminance from from (inclusive) to to (exclusive) and returns the first switch, with
+// its time in *when; ReasonNone if there is none.
+Reason runUntilSwitch(Controller &torch, double from, double to, float luminance, double *when) {
+    for (double now = from; now < to; now += kStep) {
+        Reason reason = torch.sample(now, luminance);
+        if (reason != ReasonNone) {
+            *when = now;
+            return reason;
+        }
+    }
+    *when = -1;
+    return ReasonNone;
+}
+
+void testDark() {
+    Controller torch;
+    torch.start(100);
+    CHECK(torch.sample(100, 20) == ReasonDark);
+    CHECK(torch.isOn() && torch.switchCount() == 1);
+    CHECK(torch.onSeconds(103) == 3);
+}
+
+// A bright scene without barcodes never turns the torch on, however long nothing is decoded.
+void testBrightWithoutDecodes() {
+    Controller torch;
+    double when;
+    torch.start(0);
+    CHECK(runUntilSwitch(torch, 0, 120, 200, &when) == ReasonNone);
+    CHECK(!torch.isOn() && torch.switchCount() == 0 && torch.onSeconds(120) == 0);
+    // Just above dimLevel is bright too.
+    CHECK(runUntilSwitch(torch, 120, 240, torch.config().dimLevel, &when) == ReasonNone);
+}
+
+// In dim light the torch goes on after noDecodeSeconds without a decode, counted from the last one.
+void testNoDecodeStreakInDimLight() {
+    Controller torch;
+    double when;
+    torch.start(0);
+    CHECK(runUntilSwitch(torch, 0, 2, 90, &when) == ReasonNone);
+    torch.decoded(2);
+    CHECK(runUntilSwitch(torch, 2, 30, 90, &when) == ReasonNoDecode);
+    CHECK(when == 2 + torch.config().noDecodeSeconds);
+    CHECK(torch.isOn());
+}
+
+// Switching off restarts the no-decode streak, so with a short hold the torch stays off for
+// noDecodeSeconds rather than just the quiet period.
+void testNoDecodeStreakRestartsAfterSwitchOff() {
+    Config config;
+    config.holdSeconds = 2;
+    config.noDecodeSeconds = 4;
+    Controller torch(config);
+    double when;
+    torch.start(0);
+    CHECK(runUntilSwitch(torch, 0, 30, 90, &when) == ReasonNoDecode && when == 4);
+    CHECK(runUntilSwitch(torch, 4 + kStep, 30, 90, &when) == ReasonIdle && when == 6);
+    CHECK(runUntilSwitch(torch, 6 + kStep, 30, 90, &when) == ReasonNoDecode && when == 10);
+}
+
+// The torch goes off once it has been on for holdSeconds and nothing was decoded for holdSeconds,
+// then stays off for holdSeconds whatever the light.
+void testHoldAndQuietPeriod() {
+    Controller torch;
+    double when;
+    double hold = torch.config().holdSeconds;
+    torch.start(0);
+    CHECK(torch.sample(0, 20) == ReasonDark);
+    torch.decoded(6);
+    // On for hold at 10, but the decode at 6 keeps it on until 16.
+    CHECK(runUntilSwitch(torch, kStep, 60, 20, &when) == ReasonIdle);
+    CHECK(when == 6 + hold);
+    CHECK(!torch.isOn() && torch.onSeconds(when) == 6 + hold);
+    double off = when;
+    CHECK(runUntilSwitch(torch, off + kStep, off + hold, 0, &when) == ReasonNone);
+    CHECK(torch.sample(off + hold, 0) == ReasonDark);
+    CHECK(torch.switchCount() == 2);
+}
+
+// Frames taken with the torch on are lit by it, so they leave the ambient luminance alone.
+void testLuminanceFrozenWhileOn() {
+    Controller torch;
+    double when;
+    double hold = torch.config().holdSeconds;
+    torch.start(0);
+    CHECK(torch.sample(0, 20) == ReasonDark);
+    CHECK(runUntilSwitch(torch, kStep, 60, 255, &when) == ReasonIdle);
+    // Smoothed from the frozen 20 the scene is still dark (20 + 0.5 * (90 - 20) = 55); from the
+    // torch-lit frames it would be bright.
+    CHECK(torch.sample(when + hold, 90) == ReasonDark);
+}
+
+// An idle picker in a dark aisle cycles: holdSeconds on, holdSeconds off.
+void testDarkAisleCycles() {
+    Controller torch;
+    double hold = torch.config().holdSeconds;
+    uint32_t ons = 0, offs = 0;
+    torch.start(0);
+    for (double now = 0; now < 10 * hold; now += kStep) {
+        Reason reason = torch.sample(now, 20);
+        if (reason == ReasonDark) {
+            CHECK(now == 2 * hold * ons);
+            ons++;
+        } else if (reason == ReasonIdle) {
+            CHECK(now == 2 * hold * offs + hold);
+            offs++;
+        } else {
+            CHECK(reason == ReasonNone);
+        }
+    }
+    CHECK(ons == 5 && offs == 5 && torch.switchCount() == 5);
+    CHECK(torch.onSeconds(10 * hold) == 5 * hold);
+    // A decode now and then keeps the torch on for good.
+    torch.sample(10 * hold, 20);
+    for (int i = 0; i < 20 * hold / kStep; ++i) {
+        double now = 10 * hold + i * kStep;
+        if (i % 20 == 0) {
+            torch.decoded(now); // every 5 seconds
+        }
+        CHECK(torch.sample(now, 20) == ReasonNone);
+    }
+    CHECK(torch.isOn() && torch.onSeconds(30 * hold) == 25 * hold);
+}
+
+// onSeconds counts every period, including the current one, and start resets it.
+void testOnSecondsAccounting() {
+    Config config;
+    config.holdSeconds = 2;
+    Controller torch(config);
+    double when;
+    torch.start(0);
+    CHECK(torch.onSeconds(0) == 0);
+    CHECK(torch.sample(1, 10) == ReasonDark);
+    CHECK(torch.onSeconds(2.5) == 1.5);
+    CHECK(runUntilSwitch(torch, 1 + kStep, 10, 10, &when) == ReasonIdle && when == 3);
+    CHECK(torch.onSeconds(4) == 2);
+    CHECK(runUntilSwitch(torch, 3 + kStep, 10, 10, &when) == ReasonDark && when == 5);
+    CHECK(torch.onSeconds(6) == 3);
+    torch.start(6);
+    CHECK(!torch.isOn() && torch.onSeconds(7) == 0 && torch.switchCount() == 0);
+}
+
+} // namespace
+
+int main() {
+    testDark();
+    testBrightWithoutDecodes();
+    testNoDecodeStreakInDimLight();
+    testNoDecodeStreakRestartsAfterSwitchOff();
+    testHoldAndQuietPeriod();
+    testLuminanceFrozenWhileOn();
+    testDarkAisleCycles();
+    testOnSecondsAccounting();
+    return scanditsdk::test::testResult();
+}
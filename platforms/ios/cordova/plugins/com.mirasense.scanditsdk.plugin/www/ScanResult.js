@@ -0,0 +1,29 @@
+// Generated by tools/gen-scan-result.js from schema/scan-result.json. Do not edit.
+
+var SYMBOLOGY_NAMES = ["UNKNOWN","EAN13","UPC12","EAN8","UPCE","CODE128","CODE39","CODE93","ITF","MSI","CODABAR","GS1-DATABAR","GS1-DATABAR-EXPANDED","QR","DATAMATRIX","PDF417","AZTEC"];
+var SYMBOLOGY_IDS = {};
+SYMBOLOGY_NAMES.forEach(function(name, i) { SYMBOLOGY_IDS[name] = i; });
+
+/**
+ * One decoded or manually entered code. Fields are sent positionally in this order, so the first two keep the legacy [barcode, symbology] layout.
+ */
+function ScanResult(payload) {
+    this.code = payload[0];
+    this.symbology = payload[1];
+    this.symbologyId = SYMBOLOGY_IDS.hasOwnProperty(payload[1]) ? SYMBOLOGY_IDS[payload[1]] : 0;
+    this.timestamp = payload[2];
+    this.manual = payload[3] === true;
+    this.gtin = (payload[4] == null) ? undefined : payload[4];
+}
+
+/**
+ * Turns the array passed to a scan callback into a ScanResult.
+ */
+ScanResult.decode = function(payload) {
+    return new ScanResult(payload);
+};
+
+ScanResult.Symbology = {};
+SYMBOLOGY_NAMES.forEach(function(name, i) { ScanResult.Symbology[name] = i; });
+
+module.exports = ScanResult;
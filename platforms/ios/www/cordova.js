@@ -101,6 +101,7 @@ define("cordova", function(require, exports, module) {
 
 var channel = require('cordova/channel');
 var platform = require('cordova/platform');
+var CallbackTable = require('cordova/callbacktable');
 
 /**
  * Intercept calls to addEventListener + removeEventListener and handle deviceready,
@@ -238,9 +239,10 @@ var cordova = {
     /**
      * Plugin callback mechanism.
      */
-    // Randomize the starting callbackId to avoid collisions after refreshing or navigating.
-    // This way, it's very unlikely that any new callback would get the same callbackId as an old callback.
-    callbackId: Math.floor(Math.random() * 2000000000),
+    // Callbacks of pending exec() calls, see cordova/callbacktable.
+    // cordova.callbackTable.stats() and .list() show which ones are still live.
+    callbackTable: new CallbackTable(),
+    // Callbacks registered by id directly, by code that predates the callback table.
     callbacks:  {},
     callbackStatus: {
         NO_RESULT: 0,
@@ -283,6 +285,24 @@ var cordova = {
      * Called by native code when returning the result from an action.
      */
     callbackFromNative: function(callbackId, success, status, args, keepCallback) {
+        var table = cordova.callbackTable,
+            slot = table.slotOf(CallbackTable.handleFromCallbackId(callbackId));
+        if (slot >= 0) {
+            var successCallback = table.success[slot],
+                failCallback = table.fail[slot];
+            table.results[slot]++;
+            // Release before calling out so that a throwing callback cannot leak its slot.
+            if (!keepCallback) {
+                table.release(slot);
+            }
+            if (success && status == cordova.callbackStatus.OK) {
+                successCallback && successCallback.apply(null, args);
+            } else if (!success) {
+                failCallback && failCallback.apply(null, args);
+            }
+            return;
+        }
+
         var callback = cordova.callbacks[callbackId];
         if (callback) {
             if (success && status == cordova.callbackStatus.OK) {
@@ -548,6 +568,151 @@ exports.replaceHookForTesting = function() {};
 
 });
 
+// file: lib/common/callbacktable.js
+define("cordova/callbacktable", function(require, exports, module) {
+
+/**
+ * Table of the callbacks of pending exec() calls.
+ *
+ * Callbacks live in parallel arrays indexed by slot, and freed slots are reused, so the table stays
+ * as large as the peak number of pending calls instead of growing with every call. A callback is
+ * addressed by an integer handle that combines its slot with the slot's generation:
+ *
+ *     handle = generation * SLOT_LIMIT + slot
+ *
+ * The generation is bumped whenever a slot is freed, so a late or repeated result for a released
+ * callback never reaches the callback that now occupies the slot. Generations start at a random
+ * epoch, which keeps handles from before a reload or navigation from matching new ones.
+ *
+ * The callbackId sent to native is "<service>:<handle>"; native can pass back either that id or
+ * the bare handle.
+ */
+var SLOT_LIMIT = 1 << 20;
+
+function CallbackTable() {
+    this.epoch = Math.floor(Math.random() * 2000000000);
+    this.success = [];
+    this.fail = [];
+    this.service = [];
+    this.action = [];
+    this.created = [];
+    this.results = [];
+    this.generation = [];
+    this.freeSlots = [];
+    this.length = 0;
+    this.live = 0;
+}
+
+CallbackTable.SLOT_LIMIT = SLOT_LIMIT;
+
+/**
+ * Stores a callback pair and returns its handle.
+ */
+CallbackTable.prototype.add = function(service, action, success, fail) {
+    var slot;
+    if (this.freeSlots.length) {
+        slot = this.freeSlots.pop();
+    } else {
+        if (this.length == SLOT_LIMIT) {
+            throw new Error('Too many pending callbacks');
+        }
+        slot = this.length++;
+        this.generation[slot] = this.epoch;
+    }
+    this.success[slot] = success;
+    this.fail[slot] = fail;
+    this.service[slot] = service;
+    this.action[slot] = action;
+    this.created[slot] = +new Date();
+    this.results[slot] = 0;
+    this.live++;
+    return this.generation[slot] * SLOT_LIMIT + slot;
+};
+
+/**
+ * Returns the slot of a live handle, or -1 if the handle is unknown or has been released.
+ */
+CallbackTable.prototype.slotOf = function(handle) {
+    if (typeof handle != 'number' || handle < 0 || handle % 1) {
+        return -1;
+    }
+    var slot = handle % SLOT_LIMIT;
+    if (slot >= this.length || this.service[slot] == null ||
+        this.generation[slot] != (handle - slot) / SLOT_LIMIT) {
+        return -1;
+    }
+    return slot;
+};
+
+/**
+ * Frees a slot; its handle becomes stale.
+ */
+CallbackTable.prototype.release = function(slot) {
+    this.success[slot] = this.fail[slot] = null;
+    this.service[slot] = this.action[slot] = null;
+    this.generation[slot]++;
+    this.freeSlots.push(slot);
+    this.live--;
+};
+
+/**
+ * Returns the handle of a callbackId from exec(), or the argument itself if it already is one.
+ */
+CallbackTable.handleFromCallbackId = function(callbackId) {
+    if (typeof callbackId == 'number') {
+        return callbackId;
+    }
+    var separator = typeof callbackId == 'string' ? callbackId.lastIndexOf(':') : -1;
+    return separator < 0 ? -1 : +callbackId.slice(separator + 1);
+};
+
+/**
+ * Debug view of the live callbacks: their number per service with the age of the oldest and
+ * newest one in milliseconds, plus the table size. Callbacks that are old and still live are
+ * either kept on purpose or leaked.
+ */
+CallbackTable.prototype.stats = function() {
+    var now = +new Date(),
+        services = {};
+    for (var slot = 0; slot < this.length; slot++) {
+        var service = this.service[slot];
+        if (service == null) {
+            continue;
+        }
+        var age = now - this.created[slot],
+            entry = services[service] || (services[service] = {count: 0, oldestAgeMs: 0, newestAgeMs: age});
+        entry.count++;
+        entry.oldestAgeMs = Math.max(entry.oldestAgeMs, age);
+        entry.newestAgeMs = Math.min(entry.newestAgeMs, age);
+    }
+    return {live: this.live, slots: this.length, freeSlots: this.freeSlots.length, services: services};
+};
+
+/**
+ * Debug list of live callbacks older than minAgeMs (default 0), oldest first.
+ */
+CallbackTable.prototype.list = function(minAgeMs) {
+    var now = +new Date(),
+        entries = [];
+    for (var slot = 0; slot < this.length; slot++) {
+        if (this.service[slot] == null || now - this.created[slot] < (minAgeMs || 0)) {
+            continue;
+        }
+        entries.push({
+            callbackId: this.service[slot] + ':' + (this.generation[slot] * SLOT_LIMIT + slot),
+            service: this.service[slot],
+            action: this.action[slot],
+            ageMs: now - this.created[slot],
+            results: this.results[slot]
+        });
+    }
+    return entries.sort(function(a, b) { return b.ageMs - a.ageMs; });
+};
+
+module.exports = CallbackTable;
+
+});
+
 // file: lib/common/channel.js
 define("cordova/channel", function(require, exports, module) {
 
@@ -814,7 +979,15 @@ var cordova = require('cordova'),
     requestCount = 0,
     vcHeaderValue = null,
     commandQueue = [], // Contains pending JS->Native messages.
-    isInContextOfEvalJs = 0;
+    isInContextOfEvalJs = 0,
+    stagedDeliveries = {}; // callbackId -> results waiting for staged buffers, in order.
+
+function getVcHeaderValue() {
+    if (!vcHeaderValue) {
+        vcHeaderValue = /.*\((.*)\)/.exec(navigator.userAgent)[1];
+    }
+    return vcHeaderValue;
+}
 
 function createExecIframe() {
     var iframe = document.createElement("iframe");
@@ -869,10 +1042,124 @@ function massageMessageNativeToJs(message) {
             return stringToArrayBuffer(atob(b64));
         };
         message = base64ToArrayBuffer(message.data);
+    } else if (message.CDVType == 'StagedArrayBuffer') {
+        message = new StagedArrayBuffer(message.id, message.length);
+    } else if (message.CDVType == 'Cursor') {
+        message = new Cursor(message.id, message.count);
     }
     return message;
 }
 
+// A native collection that is read page by page (see CDVCursor.h). count is -1 if native does
+// not know it up front. The native side lets go of it after the last page, on close(), when it
+// is not read for a minute, or when too many cursors are open; next() then fails.
+function Cursor(id, count) {
+    this.id = id;
+    this.count = count;
+    this.position = 0;
+    this.done = count === 0;
+}
+
+// Calls success with the next elements, at most pageSize (50 by default, 500 at most), or with
+// an empty array once done.
+Cursor.prototype.next = function(pageSize, success, fail) {
+    var cursor = this;
+    if (this.done) {
+        setTimeout(function() {
+            success && success([]);
+        }, 0);
+        return;
+    }
+    iOSExec(function(page) {
+        cursor.position = page.position;
+        cursor.done = page.done;
+        success && success(page.elements);
+    }, function(error) {
+        cursor.done = true;
+        fail && fail(error);
+    }, 'CDVCommandQueue', 'cursorNext', [this.id, pageSize || 50]);
+};
+
+// Releases the native side of a cursor that is not read to the end.
+Cursor.prototype.close = function() {
+    if (!this.done) {
+        this.done = true;
+        iOSExec(null, null, 'CDVCommandQueue', 'cursorClose', [this.id]);
+    }
+};
+
+// Placeholder for an ArrayBuffer that native staged in CDVURLProtocol instead of sending it
+// Base64 encoded. It is replaced by the fetched buffer before the callback sees it.
+function StagedArrayBuffer(id, length) {
+    this.id = id;
+    this.length = length;
+}
+
+function fetchStagedArrayBuffer(staged, done) {
+    var xhr = new XMLHttpRequest();
+    xhr.open('GET', '/!gap_blob/' + staged.id, true);
+    xhr.responseType = 'arraybuffer';
+    xhr.setRequestHeader('vc', getVcHeaderValue());
+    xhr.onload = function() {
+        if (xhr.status != 200) {
+            console.log('Failed to fetch a staged ArrayBuffer of ' + staged.length + ' bytes: ' + xhr.status);
+        }
+        done(xhr.status == 200 ? xhr.response : null);
+    };
+    xhr.onerror = function() {
+        console.log('Failed to fetch a staged ArrayBuffer of ' + staged.length + ' bytes.');
+        done(null);
+    };
+    xhr.send(null);
+}
+
+function hasStagedArgs(args) {
+    for (var i = 0; i < args.length; i++) {
+        if (args[i] instanceof StagedArrayBuffer) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replaces the staged buffers in args with the fetched ones, in parallel.
+function resolveStagedArgs(args, done) {
+    var pending = 1;
+    var finish = function() {
+        if (--pending === 0) {
+            done();
+        }
+    };
+    args.forEach(function(arg, i) {
+        if (arg instanceof StagedArrayBuffer) {
+            pending++;
+            fetchStagedArrayBuffer(arg, function(buffer) {
+                args[i] = buffer;
+                finish();
+            });
+        }
+    });
+    finish();
+}
+
+// Delivers the queued results of a callback one after the other, each once its buffers are in.
+function deliverStaged(callbackId) {
+    var queue = stagedDeliveries[callbackId];
+    if (!queue.length) {
+        delete stagedDeliveries[callbackId];
+        return;
+    }
+    var entry = queue[0];
+    resolveStagedArgs(entry.args, function() {
+        queue.shift();
+        try {
+            entry.deliver();
+        } finally {
+            deliverStaged(callbackId);
+        }
+    });
+}
+
 function convertMessageToArgsNativeToJs(message) {
     var args = [];
     if (!message || !message.hasOwnProperty('CDVType')) {
@@ -928,9 +1215,7 @@ function iOSExec() {
     // Register the callbacks and add the callbackId to the positional
     // arguments if given.
     if (successCallback || failCallback) {
-        callbackId = service + cordova.callbackId++;
-        cordova.callbacks[callbackId] =
-            {success:successCallback, fail:failCallback};
+        callbackId = service + ':' + cordova.callbackTable.add(service, action, successCallback, failCallback);
     }
 
     actionArgs = massageArgsJsToNative(actionArgs);
@@ -959,10 +1244,7 @@ function iOSExec() {
             // For some reason it still doesn't work though...
             // Add a timestamp to the query param to prevent caching.
             execXhr.open('HEAD', "/!gap_exec?" + (+new Date()), true);
-            if (!vcHeaderValue) {
-                vcHeaderValue = /.*\((.*)\)/.exec(navigator.userAgent)[1];
-            }
-            execXhr.setRequestHeader('vc', vcHeaderValue);
+            execXhr.setRequestHeader('vc', getVcHeaderValue());
             execXhr.setRequestHeader('rc', ++requestCount);
             if (shouldBundleCommandJson()) {
                 execXhr.setRequestHeader('cmds', iOSExec.nativeFetchMessages());
@@ -975,6 +1257,90 @@ function iOSExec() {
     }
 }
 
+// Runs calls, an array of [service, action, args], in order with a single exec. Each call starts
+// once the previous one sent its first result, so calls that answer right away all run in one
+// native turn. With options.stopOnError the batch ends after the first failed call;
+// options.timeout (ms) gives up on a call that does not answer. The callback gets one
+// {status, ok, message, args} per call that ran: successCallback if all of them succeeded,
+// failCallback otherwise. Later results of calls that keep their callback are dropped.
+iOSExec.batch = function(successCallback, failCallback, calls, options) {
+    var nativeCalls = calls.map(function(call) {
+        return [call[0], call[1], massageArgsJsToNative(call[2] || [])];
+    });
+    var nativeOptions = {
+        stopOnError: !!(options && options.stopOnError),
+        timeout: (options && options.timeout) || 0
+    };
+    var deliverTo = function(callback) {
+        return callback && function(entries) {
+            var results = entries.map(function(entry) {
+                return {
+                    status: entry.status,
+                    ok: entry.status === 0 || entry.status === 1,
+                    args: convertMessageToArgsNativeToJs(entry.message)
+                };
+            });
+            var pending = 1;
+            var finish = function() {
+                if (--pending === 0) {
+                    results.forEach(function(result) {
+                        result.message = result.args[0];
+                    });
+                    callback(results);
+                }
+            };
+            results.forEach(function(result) {
+                if (hasStagedArgs(result.args)) {
+                    pending++;
+                    resolveStagedArgs(result.args, finish);
+                }
+            });
+            finish();
+        };
+    };
+    iOSExec(deliverTo(successCallback), deliverTo(failCallback), 'CDVCommandQueue', 'batch', [nativeCalls, nativeOptions]);
+};
+
+// Calls a cheap getter and delivers its result before returning, for actions a plugin marks as
+// non-blocking and config.xml lists under sync-actions. Returns true if the callback already ran.
+// Otherwise, e.g. before the plugin is loaded or when the action is not allowed, the call goes
+// through exec() and false is returned; so does a result with staged data, which is fetched
+// first. Blocks the page while the native side runs, so keep it to getters.
+iOSExec.sync = function(successCallback, failCallback, service, action, args) {
+    if (bridgeMode === undefined) {
+        bridgeMode = navigator.userAgent.indexOf(' 4_') == -1 ? jsToNativeModes.XHR_NO_PAYLOAD : jsToNativeModes.IFRAME_NAV;
+    }
+    var response = '';
+    if (bridgeMode != jsToNativeModes.IFRAME_NAV) {
+        var command = [service, action, massageArgsJsToNative(args || [])];
+        try {
+            var xhr = new XMLHttpRequest();
+            xhr.open('GET', "/!gap_exec_sync?" + (+new Date()), false);
+            xhr.setRequestHeader('vc', getVcHeaderValue());
+            xhr.setRequestHeader('cmd', encodeURIComponent(JSON.stringify(command)));
+            xhr.send(null);
+            response = xhr.status == 200 ? xhr.responseText : '';
+        } catch (e) {}
+    }
+    if (!response) {
+        iOSExec(successCallback, failCallback, service, action, args);
+        return false;
+    }
+    var result = JSON.parse(response);
+    var status = result[0];
+    var callback = (status === cordova.callbackStatus.OK || status === cordova.callbackStatus.NO_RESULT) ? successCallback : failCallback;
+    var callbackArgs = convertMessageToArgsNativeToJs(result[1]);
+    if (hasStagedArgs(callbackArgs)) {
+        resolveStagedArgs(callbackArgs, function() {
+            callback && callback.apply(null, callbackArgs);
+        });
+        return false;
+    }
+    callback && callback.apply(null, callbackArgs);
+    return true;
+};
+
+iOSExec.Cursor = Cursor;
 iOSExec.jsToNativeModes = jsToNativeModes;
 
 iOSExec.setJsToNativeBridgeMode = function(mode) {
@@ -998,11 +1364,38 @@ iOSExec.nativeFetchMessages = function() {
     return json;
 };
 
+function deliverNativeResult(callbackId, status, message, keepCallback) {
+    var success = status === 0 || status === 1;
+    var args = convertMessageToArgsNativeToJs(message);
+    var deliver = function() {
+        cordova.callbackFromNative(callbackId, success, status, args, keepCallback);
+    };
+    // A result with staged buffers is delivered once they are fetched; results after it for
+    // the same callback wait behind it so that the order is kept.
+    var queue = stagedDeliveries[callbackId];
+    if (queue) {
+        queue.push({ args: args, deliver: deliver });
+    } else if (hasStagedArgs(args)) {
+        stagedDeliveries[callbackId] = [{ args: args, deliver: deliver }];
+        deliverStaged(callbackId);
+    } else {
+        deliver();
+    }
+}
+
 iOSExec.nativeCallback = function(callbackId, status, message, keepCallback) {
     return iOSExec.nativeEvalAndFetch(function() {
-        var success = status === 0 || status === 1;
-        var args = convertMessageToArgsNativeToJs(message);
-        cordova.callbackFromNative(callbackId, success, status, args, keepCallback);
+        deliverNativeResult(callbackId, status, message, keepCallback);
+    });
+};
+
+// Results held back by a native result throttle arrive together, as
+// [[callbackId, status, message, keepCallback], ...] in the order they were sent.
+iOSExec.nativeCallbackBatch = function(results) {
+    return iOSExec.nativeEvalAndFetch(function() {
+        for (var i = 0; i < results.length; i++) {
+            deliverNativeResult(results[i][0], results[i][1], results[i][2], results[i][3]);
+        }
     });
 };
 
@@ -1029,6 +1422,9 @@ var cordova = require('cordova');
 var modulemapper = require('cordova/modulemapper');
 var platform = require('cordova/platform');
 var pluginloader = require('cordova/pluginloader');
+var startup = require('cordova/startup');
+
+startup.mark('init');
 
 var platformInitChannelsArray = [channel.onNativeReady, channel.onPluginsReady];
 
@@ -1085,6 +1481,13 @@ channel.onPause = cordova.addDocumentEventHandler('pause');
 channel.onResume = cordova.addDocumentEventHandler('resume');
 channel.onDeviceReady = cordova.addStickyDocumentEventHandler('deviceready');
 
+channel.onNativeReady.subscribe(function() {
+    startup.mark('nativeready');
+});
+channel.onDOMContentLoaded.subscribe(function() {
+    startup.mark('domcontentloaded');
+});
+
 // Listen for DOMContentLoaded and notify our channel subscribers.
 if (document.readyState == 'complete' || document.readyState == 'interactive') {
     channel.onDOMContentLoaded.fire();
@@ -1109,6 +1512,7 @@ modulemapper.clobbers('cordova/exec', 'Cordova.exec');
 platform.bootstrap && platform.bootstrap();
 
 pluginloader.load(function() {
+    startup.mark('pluginsready');
     channel.onPluginsReady.fire();
 });
 
@@ -1121,12 +1525,14 @@ channel.join(function() {
     platform.initialize && platform.initialize();
 
     // Fire event to notify that all objects are created
+    startup.mark('cordovaready');
     channel.onCordovaReady.fire();
 
     // Fire onDeviceReady event once page has fully loaded, all
     // constructors have run and cordova info has been received from native
     // side.
     channel.join(function() {
+        startup.mark('deviceready');
         require('cordova').fireDocumentEvent('deviceready');
     }, channel.deviceReadyChannelsArray);
 
@@ -1175,6 +1581,14 @@ exports.runs = function(moduleName) {
     addEntry('r', moduleName, null);
 };
 
+// Appends entries that were computed ahead of time, as flat [strategy, moduleName, symbolPath]
+// triples (see cordova/lib/bundle-plugins.js).
+exports.addEntries = function(entries) {
+    for (var i = 0; i < entries.length; i += 3) {
+        addEntry(entries[i], entries[i + 1], entries[i + 2]);
+    }
+};
+
 function prepareNamespace(symbolPath, context) {
     if (!symbolPath) {
         return context;
@@ -1253,6 +1667,7 @@ module.exports = {
 define("cordova/pluginloader", function(require, exports, module) {
 
 var modulemapper = require('cordova/modulemapper');
+var startup = require('cordova/startup');
 
 // Helper function to inject a <script> tag.
 function injectScript(url, onload, onerror) {
@@ -1351,6 +1766,20 @@ function findCordovaPath() {
 // This is an async process, but onDeviceReady is blocked on onPluginsReady.
 // onPluginsReady is fired when there are no plugins to load, or they are all done.
 exports.load = function(callback) {
+    // Builds that ran cordova/lib/bundle-plugins.js have the plugin modules and their module
+    // mapper entries linked into this file, so there is nothing to inject.
+    if ('cordova/plugin_bundle' in define.moduleMap) {
+        try {
+            modulemapper.addEntries(require('cordova/plugin_bundle'));
+        } catch (e) {
+            console.log('Failed to map bundled plugin modules: ' + e);
+        }
+        startup.mark('plugins-bundled');
+        callback();
+        return;
+    }
+
+    startup.mark('plugins-injected');
     var pathPrefix = findCordovaPath();
     if (pathPrefix === null) {
         console.log('Could not find cordova.js script tag. Plugin loading may fail.');
@@ -1360,6 +1789,45 @@ exports.load = function(callback) {
 };
 
 
+});
+
+// file: lib/common/startup.js
+define("cordova/startup", function(require, exports, module) {
+
+/**
+ * Timing marks for the phases of startup, in milliseconds since navigation start (or since
+ * cordova.js started initializing where navigation timing is not available). A normal launch
+ * records init, plugins-bundled or plugins-injected, nativeready, domcontentloaded, pluginsready,
+ * cordovaready and deviceready, though the order of the middle ones varies.
+ *
+ * The marks are also added to the performance timeline where the user timing API exists.
+ */
+var performance = window.performance,
+    origin = (performance && performance.timing && performance.timing.navigationStart) || +new Date(),
+    marks = [];
+
+exports.marks = marks;
+
+exports.mark = function(name) {
+    marks.push({name: name, ms: +new Date() - origin});
+    if (performance && performance.mark) {
+        performance.mark('cordova.' + name);
+    }
+};
+
+/**
+ * Returns {phase: ms} with the first mark of each phase.
+ */
+exports.summary = function() {
+    var result = {};
+    for (var i = 0; i < marks.length; i++) {
+        if (!(marks[i].name in result)) {
+            result[marks[i].name] = marks[i].ms;
+        }
+    }
+    return result;
+};
+
 });
 
 // file: lib/common/urlutil.js
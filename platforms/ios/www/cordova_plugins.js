@@ -1,3 +1,11 @@
 cordova.define('cordova/plugin_list', function(require, exports, module) {
-module.exports = []
+module.exports = [
+    {
+        "file": "plugins/com.mirasense.scanditsdk.plugin/www/ScanResult.js",
+        "id": "com.mirasense.scanditsdk.plugin.ScanResult",
+        "clobbers": [
+            "ScanditSDK.ScanResult"
+        ]
+    }
+]
 });
\ No newline at end of file